@@ -0,0 +1,506 @@
+#include "math.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Math;
+
+/*! Command line settings of a benchmark run.
+ */
+struct BenchOptions {
+
+   //! Minimum duration of one timed sample in seconds.
+   double min_time = 0.02;
+
+   //! Number of timed samples per case; the fastest is reported, since
+   //! interference from other processes only adds time.
+   size_t repetitions = 3;
+
+   //! Only cases with names containing this text are run.
+   std::string filter;
+
+   //! File receiving the results as JSON, "-" for standard output.
+   std::string json;
+
+   //! JSON file of an earlier run to compare against.
+   std::string baseline;
+
+   //! Slowdown in percent reported as a regression.
+   double threshold = 10.0;
+
+   //! @c true to count hardware events in an extra sample of every case.
+   bool counters = false;
+};
+
+/*! Measurement of one benchmark case.
+ */
+struct BenchResult {
+
+   //! Case name, operation/type/size.
+   std::string name;
+
+   //! Time of one operation in the fastest sample in nanoseconds.
+   double ns_per_op;
+
+   //! Floating point operations of one operation.
+   double flops;
+
+   //! Bytes of operands and results touched by one operation.
+   double bytes;
+
+   //! Number of operations in one timed sample.
+   size_t iterations;
+
+   //! Hardware events of one operation.
+   double events[PerfEventCount];
+
+   //! Bit 1 << event set for counted events, zero without --counters.
+   unsigned counted;
+
+   //! Heap allocations of one operation, counted with MATH_ACCOUNTING.
+   double allocations;
+
+   //! Bytes copied by one operation, counted with MATH_ACCOUNTING.
+   double copied_bytes;
+};
+
+//! JSON keys and table headers of hardware events.
+static const char* const event_names[PerfEventCount] = { "cycles", "instructions", "l1_misses", "llc_misses", "branch_misses" };
+
+/*! Keeps the compiler from optimizing away a value or from assuming that it
+ * stays unchanged between benchmark iterations.
+ */
+template <class T> inline void keep(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+   asm volatile("" : : "r"(&value) : "memory");
+#else
+   static volatile void* sink;
+   sink = (void*)&value;
+#endif
+}
+
+template <class T> static const char* type_name();
+
+template <> const char* type_name<float>() {
+   return "float";
+}
+
+template <> const char* type_name<double>() {
+   return "double";
+}
+
+static const char* isa_name(const SimdIsa& isa) {
+   switch (isa) {
+   case Sse2:
+      return "sse2";
+   case Avx2:
+      return "avx2";
+   case Avx512:
+      return "avx512";
+   default:
+      return "scalar";
+   }
+}
+
+/*! Times an operation. The number of iterations is raised until one sample
+ * lasts at least the minimum time, then the fastest sample is taken.
+ *
+ * @param name Case name.
+ * @param flops Floating point operations of one call.
+ * @param bytes Bytes touched by one call.
+ * @param f Operation.
+ * @param options Run settings.
+ * @param results Receives the measurement.
+ */
+template <class F> static void measure(const std::string& name, const double& flops, const double& bytes, F f, const BenchOptions& options, std::vector<BenchResult>& results) {
+   if (name.find(options.filter) == std::string::npos)
+      return;
+
+   typedef std::chrono::steady_clock clock;
+
+   const auto run = [&f](const size_t& iterations) {
+      const auto start = clock::now();
+
+      for (size_t i = 0; i < iterations; ++i)
+         f();
+
+      return std::chrono::duration<double>(clock::now() - start).count();
+   };
+
+   size_t iterations = 1;
+   double elapsed = run(iterations);
+
+   while (elapsed < options.min_time) {
+      const double estimate = elapsed > 0.0 ? 1.2 * options.min_time / elapsed * iterations : 2.0 * iterations;
+      iterations = std::max(iterations + 1, std::min((size_t)estimate, 100 * iterations));
+      elapsed = run(iterations);
+   }
+
+   for (size_t i = 1; i < options.repetitions; ++i)
+      elapsed = std::min(elapsed, run(iterations));
+
+   BenchResult result = { name, elapsed * 1e9 / (double)iterations, flops, bytes, iterations, {}, 0, 0.0, 0.0 };
+
+   // Counting in a separate sample keeps the reads out of the timings.
+   if (options.counters || accounting_enabled()) {
+      const PerfCounters& counters = PerfCounters::thread();
+      const PerfSample start = counters.sample();
+      const Accounting before = accounting_snapshot();
+
+      run(iterations);
+
+      const PerfSample end = counters.sample();
+      const Accounting after = accounting_snapshot();
+
+      bool multiplexed;
+      const PerfCounts counts = PerfCounters::difference(start, end, multiplexed);
+
+      for (size_t e = 0; options.counters && e < PerfEventCount; ++e)
+         result.events[e] = (double)counts[e] / (double)iterations;
+
+      result.counted = options.counters ? counters.events() : 0;
+      result.allocations = (double)(after.allocations - before.allocations) / (double)iterations;
+      result.copied_bytes = (double)(after.copied_bytes - before.copied_bytes) / (double)iterations;
+   }
+
+   results.push_back(result);
+}
+
+/*! Fills a matrix with values in [-1, 1] and adds a dominant diagonal, so
+ * that square matrices are well conditioned.
+ */
+template <size_t M, size_t N, class T> static void fill(Matrix<M, N, T>& m, unsigned seed) {
+   for (size_t i = 1; i <= M * N; ++i) {
+      seed = seed * 1664525u + 1013904223u;
+      m[i] = (T)((double)(seed >> 8) / (double)(1u << 23) - 1.0);
+   }
+
+   for (size_t i = 1; i <= (M < N ? M : N); ++i)
+      m(i, i) += (T)N;
+}
+
+template <size_t N, class T> static void matrix_cases(const BenchOptions& options, std::vector<BenchResult>& results) {
+   const std::string suffix = std::string("/") + type_name<T>() + "/" + std::to_string(N) + "x" + std::to_string(N);
+   const double n = (double)N, s = (double)sizeof(T);
+
+   Matrix<N, N, T> a, b, c;
+   Vector<N, T> v;
+
+   fill(a, 1);
+   fill(b, 2);
+   fill(v, 3);
+
+   measure("mul" + suffix, 2.0 * n * n * n, 3.0 * n * n * s, [&]() {
+      keep(a);
+      c = a * b;
+      keep(c);
+   }, options, results);
+
+   measure("add" + suffix, n * n, 3.0 * n * n * s, [&]() {
+      keep(a);
+      c = a + b;
+      keep(c);
+   }, options, results);
+
+   measure("transpose" + suffix, 0.0, 2.0 * n * n * s, [&]() {
+      keep(a);
+      c = ~a;
+      keep(c);
+   }, options, results);
+
+   // Factorizes a copy, since the factorization is in place.
+   std::array<size_t, N> pivots;
+
+   measure("lu" + suffix, 2.0 / 3.0 * n * n * n, 2.0 * n * n * s, [&]() {
+      keep(a);
+      c = a;
+      lu(c, pivots);
+      keep(c);
+   }, options, results);
+
+   measure("solve" + suffix, 2.0 / 3.0 * n * n * n + 2.0 * n * n, (n * n + 2.0 * n) * s, [&]() {
+      keep(a);
+      Vector<N, T> x = solve(a, v);
+      keep(x);
+   }, options, results);
+
+   measure("inv" + suffix, 2.0 * n * n * n, 2.0 * n * n * s, [&]() {
+      keep(a);
+      c = inv(a);
+      keep(c);
+   }, options, results);
+
+   measure("det" + suffix, 2.0 / 3.0 * n * n * n, n * n * s, [&]() {
+      keep(a);
+      T d = det(a);
+      keep(d);
+   }, options, results);
+}
+
+template <size_t L, class T> static void vector_cases(const BenchOptions& options, std::vector<BenchResult>& results) {
+   const std::string suffix = std::string("/") + type_name<T>() + "/" + std::to_string(L);
+   const double n = (double)L, s = (double)sizeof(T);
+
+   Vector<L, T> a, b, c;
+
+   fill(a, 4);
+   fill(b, 5);
+
+   measure("dot" + suffix, 2.0 * n, 2.0 * n * s, [&]() {
+      keep(a);
+      T d = a * b;
+      keep(d);
+   }, options, results);
+
+   measure("normalize" + suffix, 3.0 * n, 2.0 * n * s, [&]() {
+      keep(a);
+      c = normalize(a);
+      keep(c);
+   }, options, results);
+}
+
+/*! Runs the cases of one element type. Sizes cover small matrices, both
+ * sides of the stack allocation limit of 32x32 elements and heap matrices
+ * large enough for blocking and threading; vectors have as many elements
+ * as the matrices.
+ */
+template <class T> static void type_cases(const BenchOptions& options, std::vector<BenchResult>& results) {
+   matrix_cases<4, T>(options, results);
+   matrix_cases<16, T>(options, results);
+   matrix_cases<31, T>(options, results);
+   matrix_cases<32, T>(options, results);
+   matrix_cases<33, T>(options, results);
+   matrix_cases<64, T>(options, results);
+   matrix_cases<128, T>(options, results);
+   matrix_cases<256, T>(options, results);
+
+   vector_cases<16, T>(options, results);
+   vector_cases<256, T>(options, results);
+   vector_cases<961, T>(options, results);
+   vector_cases<1024, T>(options, results);
+   vector_cases<1089, T>(options, results);
+   vector_cases<4096, T>(options, results);
+   vector_cases<16384, T>(options, results);
+   vector_cases<65536, T>(options, results);
+}
+
+static void write_json(std::FILE* out, const std::vector<BenchResult>& results) {
+   std::fprintf(out, "{\n");
+   std::fprintf(out, "   \"context\": {\n");
+#if defined(__VERSION__)
+   std::fprintf(out, "      \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+   std::fprintf(out, "      \"simd\": \"%s\",\n", isa_name(simd_isa()));
+   std::fprintf(out, "      \"threads\": %zu\n", ThreadPool::instance().concurrency());
+   std::fprintf(out, "   },\n");
+   std::fprintf(out, "   \"benchmarks\": [\n");
+
+   for (size_t i = 0; i < results.size(); ++i) {
+      const BenchResult& r = results[i];
+
+      std::fprintf(out, "      { \"name\": \"%s\", \"ns_per_op\": %.6g, \"gflops\": %.6g, \"bytes_per_op\": %.0f, \"iterations\": %zu",
+         r.name.c_str(), r.ns_per_op, r.flops / r.ns_per_op, r.bytes, r.iterations);
+
+      for (size_t e = 0; e < PerfEventCount; ++e) {
+         if (r.counted & (1u << e))
+            std::fprintf(out, ", \"%s_per_op\": %.6g", event_names[e], r.events[e]);
+      }
+
+      if (accounting_enabled())
+         std::fprintf(out, ", \"allocations_per_op\": %.6g, \"copied_bytes_per_op\": %.6g", r.allocations, r.copied_bytes);
+
+      std::fprintf(out, " }%s\n", i + 1 < results.size() ? "," : "");
+   }
+
+   std::fprintf(out, "   ]\n}\n");
+}
+
+/*! Reads the times of a JSON file written by this program.
+ *
+ * @param path File name.
+ * @param times Receives the nanoseconds per operation by case name.
+ * @return @c true if the file could be read.
+ */
+static bool read_baseline(const std::string& path, std::map<std::string, double>& times) {
+   std::ifstream in(path.c_str());
+
+   if (!in)
+      return false;
+
+   std::stringstream buffer;
+   buffer << in.rdbuf();
+
+   const std::string text = buffer.str();
+   size_t pos = 0;
+
+   while ((pos = text.find("\"name\"", pos)) != std::string::npos) {
+      const size_t begin = text.find('"', text.find(':', pos)) + 1;
+      const size_t end = text.find('"', begin);
+      const size_t time = text.find("\"ns_per_op\"", end);
+
+      if (begin == 0 || end == std::string::npos || time == std::string::npos)
+         break;
+
+      times[text.substr(begin, end - begin)] = std::strtod(text.c_str() + text.find(':', time) + 1, nullptr);
+      pos = end;
+   }
+
+   return true;
+}
+
+/*! Prints the change of each case against the baseline.
+ *
+ * @return Number of cases slower than the threshold allows.
+ */
+static size_t compare(std::FILE* out, const std::vector<BenchResult>& results, const std::map<std::string, double>& baseline, const double& threshold) {
+   size_t regressions = 0;
+
+   std::fprintf(out, "\n%-28s %14s %14s %9s\n", "case", "baseline ns", "ns", "change");
+
+   for (const BenchResult& r : results) {
+      const auto it = baseline.find(r.name);
+
+      if (it == baseline.end() || it->second <= 0.0) {
+         std::fprintf(out, "%-28s %14s %14.1f %9s\n", r.name.c_str(), "-", r.ns_per_op, "new");
+         continue;
+      }
+
+      const double change = 100.0 * (r.ns_per_op / it->second - 1.0);
+      const bool regression = change > threshold;
+
+      regressions += regression ? 1 : 0;
+      std::fprintf(out, "%-28s %14.1f %14.1f %+8.1f%%%s\n", r.name.c_str(), it->second, r.ns_per_op, change, regression ? "  REGRESSION" : "");
+   }
+
+   std::fprintf(out, "\n%zu of %zu cases slower than %.1f%%\n", regressions, results.size(), threshold);
+   return regressions;
+}
+
+static void usage() {
+   std::fprintf(stderr,
+      "usage: bench [options]\n"
+      "  --filter TEXT       run cases whose name contains TEXT\n"
+      "  --min-time SECONDS  minimum duration of one sample (default 0.02)\n"
+      "  --repetitions N     samples per case, the fastest is reported (default 3)\n"
+      "  --threads N         number of threads for parallel operations\n"
+      "  --quick             short run for smoke testing\n"
+      "  --counters          count hardware events per operation (Linux)\n"
+      "  --json FILE         write results as JSON, - for standard output\n"
+      "  --baseline FILE     compare against the JSON of an earlier run;\n"
+      "                      exits with 1 on regressions\n"
+      "  --threshold PERCENT slowdown reported as a regression (default 10)\n");
+}
+
+int main(int argc, char** argv) {
+   BenchOptions options;
+
+   for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      const bool value = i + 1 < argc;
+
+      if (arg == "--filter" && value)
+         options.filter = argv[++i];
+      else if (arg == "--min-time" && value)
+         options.min_time = std::atof(argv[++i]);
+      else if (arg == "--repetitions" && value)
+         options.repetitions = (size_t)std::max(1, std::atoi(argv[++i]));
+      else if (arg == "--threads" && value)
+         ThreadPool::instance().set_concurrency((size_t)std::max(1, std::atoi(argv[++i])));
+      else if (arg == "--quick") {
+         options.min_time = 0.001;
+         options.repetitions = 1;
+      }
+      else if (arg == "--counters")
+         options.counters = true;
+      else if (arg == "--json" && value)
+         options.json = argv[++i];
+      else if (arg == "--baseline" && value)
+         options.baseline = argv[++i];
+      else if (arg == "--threshold" && value)
+         options.threshold = std::atof(argv[++i]);
+      else {
+         usage();
+         return 2;
+      }
+   }
+
+   std::map<std::string, double> baseline;
+
+   if (!options.baseline.empty() && !read_baseline(options.baseline, baseline)) {
+      std::fprintf(stderr, "cannot read baseline %s\n", options.baseline.c_str());
+      return 2;
+   }
+
+   // Counters are opened before timing, regions would open them on first
+   // use otherwise.
+   PerfCounters::thread();
+
+   // The table goes to standard error when standard output takes the JSON.
+   std::FILE* table = options.json == "-" ? stderr : stdout;
+   std::vector<BenchResult> results;
+
+   type_cases<float>(options, results);
+   type_cases<double>(options, results);
+
+   std::fprintf(table, "%-28s %14s %10s %14s", "case", "ns/op", "GFLOP/s", "bytes/op");
+
+   for (size_t e = 0; options.counters && e < PerfEventCount; ++e)
+      std::fprintf(table, " %14s", event_names[e]);
+
+   if (accounting_enabled())
+      std::fprintf(table, " %12s %14s", "allocations", "copied bytes");
+
+   std::fprintf(table, "\n");
+
+   for (const BenchResult& r : results) {
+      std::fprintf(table, "%-28s %14.1f %10.2f %14.0f", r.name.c_str(), r.ns_per_op, r.flops / r.ns_per_op, r.bytes);
+
+      for (size_t e = 0; options.counters && e < PerfEventCount; ++e) {
+         if (r.counted & (1u << e))
+            std::fprintf(table, " %14.1f", r.events[e]);
+         else
+            std::fprintf(table, " %14s", "-");
+      }
+
+      if (accounting_enabled())
+         std::fprintf(table, " %12.1f %14.0f", r.allocations, r.copied_bytes);
+
+      std::fprintf(table, "\n");
+   }
+
+   if (options.counters && !PerfCounters::thread().available())
+      std::fprintf(table, "\nhardware counters are not available\n");
+
+   // Regions of the library itself when built with MATH_PERF_COUNTERS.
+   if (options.counters && !PerfRegistry::instance().snapshot().empty()) {
+      std::fflush(table);
+      PerfRegistry::instance().dump(table == stdout ? std::cout : std::cerr);
+   }
+
+   if (options.json == "-")
+      write_json(stdout, results);
+   else if (!options.json.empty()) {
+      std::FILE* out = std::fopen(options.json.c_str(), "w");
+
+      if (!out) {
+         std::fprintf(stderr, "cannot write %s\n", options.json.c_str());
+         return 2;
+      }
+
+      write_json(out, results);
+      std::fclose(out);
+   }
+
+   if (!options.baseline.empty() && compare(table, results, baseline, options.threshold) > 0)
+      return 1;
+
+   return 0;
+}
@@ -2,6 +2,42 @@
 
 using namespace Math;
 
+template <class T> void Fill(T* values, const size_t& count) {
+   for (size_t k = 0; k < count; ++k)
+      values[k] = (T)(k % 7) - (T)3;
+}
+
+template <class T, class U> void Equals(const T& test, const U& excepted) {
+   if (!(test == excepted))
+      throw "Not equal";
+}
+
+template <size_t M, size_t N, size_t MDepth, size_t NDepth, class Apply, class T> struct unroll {
+   void operator ()() {
+      Apply::template Call<M, N, T>();
+      callM<M>();
+      callN<N>();
+   }
+
+private:
+
+   template <size_t P, typename std::enable_if<P < MDepth>::type* = nullptr>
+   void callM() {
+      unroll<P + 1, N, MDepth, NDepth, Apply, T>()();
+   }
+
+   template <size_t P, typename std::enable_if<P < NDepth>::type* = nullptr>
+   void callN() {
+      unroll<M, P + 1, MDepth, NDepth, Apply, T>()();
+   }
+
+   template <size_t P, typename std::enable_if<P >= MDepth>::type* = nullptr>
+   void callM() {}
+
+   template <size_t P, typename std::enable_if<P >= NDepth>::type* = nullptr>
+   void callN() {}
+};
+
 struct TestConstruction {
    template <size_t M, size_t N, class T>
    static void Call() {
@@ -21,11 +57,13 @@ struct TestConstruction {
 
       {
          T test[M * N];
+         Fill(test, M * N);
          Matrix<M, N, T> m(test, test + M * N);
          size_t k = 0;
 
-         for (size_t i = 1; i <= M; ++i) {
-            for (size_t j = 1; j <= N; ++j)
+         // Elements are given column by column.
+         for (size_t j = 1; j <= N; ++j) {
+            for (size_t i = 1; i <= M; ++i)
                Equals(m(i, j), test[k++]);
          }
       }
@@ -36,12 +74,13 @@ struct TestMatrixAddition {
    template <size_t M, size_t N, class T>
    static void Call() {
       T test[M * N];
+      Fill(test, M * N);
       Matrix<M, N, T> m(test, test + M * N);
       Matrix<M, N, T> out = m + m;
 
       size_t k = 0;
-      for (size_t i = 1; i <= M; ++i) {
-         for (size_t j = 1; j <= N; ++j) {
+      for (size_t j = 1; j <= N; ++j) {
+         for (size_t i = 1; i <= M; ++i) {
             Equals(out(i, j), test[k] + test[k]);
             ++k;
          }
@@ -53,12 +92,13 @@ struct TestScalarMultiplication {
    template <size_t M, size_t N, class T>
    static void Call() {
       T test[M * N];
+      Fill(test, M * N);
       Matrix<M, N, T> m(test, test + M * N);
       Matrix<M, N, T> out = m * 5.0;
 
       size_t k = 0;
-      for (size_t i = 1; i <= M; ++i) {
-         for (size_t j = 1; j <= N; ++j)
+      for (size_t j = 1; j <= N; ++j) {
+         for (size_t i = 1; i <= M; ++i)
             Equals(out(i, j), test[k++] * 5.0);
       }
    }
@@ -69,9 +109,11 @@ struct _TestMatrixMultiplication {
    template <size_t m, size_t n, class T>
    static void Call() {
       T src[M * N];
-      T dest[m * n];
+      T dest[N * n];
+      Fill(src, M * N);
+      Fill(dest, N * n);
       Matrix<M, N, T> a(src, src + M * N);
-      Matrix<N, n, T> b(dest, dest + m * n);
+      Matrix<N, n, T> b(dest, dest + N * n);
 
       Matrix<M, n, T> out = a * b;
 
@@ -98,7 +140,8 @@ struct TestMatrixMultiplication {
 struct TestTranspose {
    template <size_t M, size_t N, class T>
    static void Call() {
-      T test[M*N];
+      T test[M * N];
+      Fill(test, M * N);
       Matrix<M, N, T> m(test, test + M * N);
       Matrix<N, M, T> out = ~m;
 
@@ -109,6 +152,21 @@ struct TestTranspose {
    }
 };
 
+struct TestExpression {
+   template <size_t M, size_t N, class T>
+   static void Call() {
+      T test[M * N];
+      Fill(test, M * N);
+      Matrix<M, N, T> m(test, test + M * N);
+      Matrix<M, N, T> out = m * 2.0 + m - (-m);
+
+      for (size_t i = 1; i <= M; ++i) {
+         for (size_t j = 1; j <= N; ++j)
+            Equals(out(i, j), m(i, j) * 2.0 + m(i, j) + m(i, j));
+      }
+   }
+};
+
 struct TestAllocation {
    template <size_t M, size_t N, class T>
    static void Call() {
@@ -129,39 +187,9 @@ private:
    }
 };
 
-template <class T, class U> void Equals(const T& test, const U& excepted) {
-   if (!(test == excepted))
-      throw "Not equal";
-}
-
-template <size_t M, size_t N, size_t MDepth, size_t NDepth, class Apply, class T> struct unroll {
-   void operator ()() {
-      Apply::Call<M, N, T>();
-      callM<M>();
-      callN<N>();
-   }
-
-private:
-
-   template <size_t P, typename std::enable_if<P < MDepth>::type* = nullptr>
-   void callM() {
-      unroll<P + 1, N, MDepth, NDepth, Apply, T>()();
-   }
-
-   template <size_t P, typename std::enable_if<P < NDepth>::type* = nullptr>
-   void callN() {
-      unroll<M, P + 1, MDepth, NDepth, Apply, T>()();
-   }
-
-   template <size_t P, typename std::enable_if<P >= MDepth>::type* = nullptr>
-   void callM() {}
-
-   template <size_t P, typename std::enable_if<P >= NDepth>::type* = nullptr>
-   void callN() {}
-};
-
 static void test_3x3_lu() {
-   mat3x3 m({
+   // Initializer lists are column-major, the rows below are transposed.
+   const mat3x3 m = ~mat3x3({
       4, -2, 1,
       -3, -1, 4,
       1, -1, 3
@@ -201,7 +229,7 @@ static void test_3x3_lu() {
 }
 
 static void test_4x4_lu() {
-   mat4x4 m({
+   const mat4x4 m = ~mat4x4({
       11, 9, 24, 2,
       1, 5, 2, 6,
       3, 17, 18, 1,
@@ -244,6 +272,76 @@ static void test_4x4_lu() {
    }
 }
 
+static void test_transpose_aliasing() {
+   mat3x3 m({
+      4, -2, 1,
+      -3, -1, 4,
+      1, -1, 3
+   });
+
+   mat3x3 t = m;
+   t = ~t;
+
+   for (size_t i = 1; i <= m.rows(); ++i) {
+      for (size_t j = 1; j <= m.cols(); ++j)
+         Equals(t(i, j), m(j, i));
+   }
+}
+
+static void test_blocked_multiplication() {
+   Matrix<70, 50, double> a(false);
+   Matrix<50, 60, double> b(false);
+
+   for (size_t i = 1; i <= 70 * 50; ++i)
+      a[i] = (double)(i % 7);
+
+   for (size_t i = 1; i <= 50 * 60; ++i)
+      b[i] = (double)(i % 5);
+
+   Matrix<70, 60, double> out = a * b;
+
+   for (size_t i = 1; i <= 70; ++i) {
+      for (size_t j = 1; j <= 60; ++j) {
+         double sum = 0;
+
+         for (size_t r = 1; r <= 50; ++r)
+            sum += a(i, r) * b(r, j);
+
+         Equals(out(i, j), sum);
+      }
+   }
+}
+
+static void test_simd_kernels() {
+   double a[67], b[67], out[67];
+
+   for (size_t i = 0; i < 67; ++i) {
+      a[i] = (double)i;
+      b[i] = (double)(67 - i);
+   }
+
+   for (int isa = Scalar; isa <= simd_isa(); ++isa) {
+      auto kernels = simd_kernels<double>((SimdIsa)isa);
+
+      kernels.add(67, a, b, out);
+
+      for (size_t i = 0; i < 67; ++i)
+         Equals(out[i], 67.0);
+
+      kernels.negate(67, a, out);
+
+      for (size_t i = 0; i < 67; ++i)
+         Equals(out[i], -a[i]);
+
+      double dot = 0;
+
+      for (size_t i = 0; i < 67; ++i)
+         dot += a[i] * b[i];
+
+      Equals(kernels.dot(67, a, b), dot);
+   }
+}
+
 static void test_3x3_inv() {
    mat3x3 m({
       4, -2, 1,
@@ -283,16 +381,1218 @@ static void test_4x4_inv() {
    }
 }
 
+static void test_parallel_operations() {
+   const size_t threshold = parallel_threshold();
+   ThreadPool::instance().set_concurrency(4);
+   set_parallel_threshold(1024);
+
+   Matrix<70, 50, double> a(false), c(false);
+   Matrix<50, 60, double> b(false);
+
+   for (size_t i = 1; i <= 70 * 50; ++i) {
+      a[i] = (double)(i % 7);
+      c[i] = (double)(i % 3);
+   }
+
+   for (size_t i = 1; i <= 50 * 60; ++i)
+      b[i] = (double)(i % 5);
+
+   Matrix<70, 50, double> sum = a + c * 2.0;
+   Matrix<50, 70, double> t = ~a;
+   Matrix<70, 60, double> out = a * b;
+
+   for (size_t i = 1; i <= 70; ++i) {
+      for (size_t j = 1; j <= 50; ++j) {
+         Equals(sum(i, j), a(i, j) + c(i, j) * 2.0);
+         Equals(t(j, i), a(i, j));
+      }
+
+      for (size_t j = 1; j <= 60; ++j) {
+         double dot = 0;
+
+         for (size_t r = 1; r <= 50; ++r)
+            dot += a(i, r) * b(r, j);
+
+         Equals(out(i, j), dot);
+      }
+   }
+
+   set_parallel_threshold(threshold);
+   ThreadPool::instance().set_concurrency(1);
+}
+
+static void test_parallel_exceptions() {
+   ThreadPool::instance().set_concurrency(4);
+
+   // Chunks throwing on workers or on the waiting thread reach the caller.
+   for (size_t failing = 0; failing < 8; ++failing) {
+      std::atomic<size_t> done(0);
+      bool caught = false;
+
+      try {
+         ThreadPool::instance().parallel_for(0, 8, 1, [&done, failing](const size_t& begin, const size_t& end) {
+            for (size_t i = begin; i < end; ++i) {
+               if (i == failing)
+                  throw std::runtime_error("chunk failed");
+
+               ++done;
+            }
+         });
+      }
+      catch (const std::runtime_error&) {
+         caught = true;
+      }
+
+      Equals(caught, true);
+      Equals(done.load(), (size_t)7);
+   }
+
+   // The pool keeps working afterwards.
+   std::atomic<size_t> count(0);
+   ThreadPool::instance().parallel_for(0, 64, 1, [&count](const size_t& begin, const size_t& end) { count += end - begin; });
+   Equals(count.load(), (size_t)64);
+
+   ThreadPool::instance().set_concurrency(1);
+}
+
+static void test_dynamic_matrix() {
+   const mat3x3 fixed{2, 1, 0, 1, 3, 1, 0, 1, 4};
+   DynamicMatrix<double> a(fixed);
+   DynamicMatrix<double> b(3, 2, {1, 2, 3, 4, 5, 6});
+
+   Equals(a.rows(), (size_t)3);
+   Equals(a(2, 3), fixed(2, 3));
+   Equals(det(a), det(fixed));
+
+   auto x = solve(a, b);
+   auto r = a * x - b;
+
+   for (auto v : r)
+      Equals(Math::Abs(v) < 1e-12, true);
+
+   Equals(to_fixed<3, 3>(a) == fixed, true);
+
+   // Heap allocated matrices are converted without copying.
+   Matrix<40, 40, double> big;
+   const double* p = big.data();
+   DynamicMatrix<double> d(std::move(big));
+
+   Equals(d.data(), p);
+   Equals(to_fixed<40, 40>(std::move(d)).data(), p);
+
+   // Lvalues are copied once and left intact.
+   Matrix<40, 40, double> kept;
+   kept(2, 3) = 5.0;
+
+   accounting_reset();
+   const DynamicMatrix<double> copied(kept);
+   const DynamicMatrix<double> small(fixed);
+
+   Equals(copied.data() != kept.data(), true);
+   Equals(copied(2, 3), kept(2, 3));
+   Equals(small(3, 3), fixed(3, 3));
+   Equals(accounting_snapshot().copied_bytes, accounting_enabled() ? (uint64_t)((1600 + 9) * sizeof(double)) : (uint64_t)0);
+}
+
+static void test_aligned_storage() {
+   Matrix<40, 40, double> heap;
+   mat4x4 stack;
+   DynamicMatrix<float> dynamic(5, 3);
+
+   Equals((size_t)heap.data() % DefaultAlignment, (size_t)0);
+   Equals((size_t)stack.data() % MaxStackAlignment, (size_t)0);
+   Equals((size_t)dynamic.data() % DefaultAlignment, (size_t)0);
+   Equals(sizeof(vec3), 3 * sizeof(double));
+
+   AllocatedMatrix<40, 40, double, AlignedAllocator<double, 128> > custom;
+   Equals((size_t)custom.data() % 128, (size_t)0);
+
+   // Stack matrices stay valid in new expressions and standard containers.
+   std::vector<mat4x4> many(5);
+   std::unique_ptr<mat4x4> single(new mat4x4());
+
+   Equals(alignof(mat4x4) <= alignof(std::max_align_t), true);
+
+   for (const mat4x4& m : many)
+      Equals((size_t)m.data() % alignof(mat4x4), (size_t)0);
+
+   Equals((size_t)single->data() % alignof(mat4x4), (size_t)0);
+}
+
+static void test_matrix_views() {
+   mat3x3 m{1, 2, 3, 4, 5, 6, 7, 8, 10};
+   const mat3x3 original = m;
+
+   // Views write through to the viewed matrix.
+   swap(m.row(1), m.row(3));
+   Equals(m(1, 3), original(3, 3));
+   Equals(m(3, 1), original(1, 1));
+
+   // Overlapping source and destination blocks.
+   m = original;
+   m.sub<2, 2>(1, 1) = m.sub<2, 2>(2, 2);
+   Equals(m(1, 1), original(2, 2));
+   Equals(m(2, 2), original(3, 3));
+
+   Matrix<1, 3, double> r = original.row(1) * 2.0 + original.row(2);
+   Equals(r(1, 2), 2 * original(1, 2) + original(2, 2));
+   Equals(det(original.sub<2, 2>(1, 1)), det(original.get_sub<2, 2>(1, 1)));
+
+   DynamicMatrix<double> d(original);
+   swap(d.row(1), d.row(2));
+   d.row(1) = d.row(2);
+   Equals(d(1, 3), original(1, 3));
+
+   DynamicMatrix<double> p = d.sub(1, 1, 2, 3) * d.sub(1, 1, 3, 2);
+   Equals(p.rows(), (size_t)2);
+   Equals(p(2, 2), d(2, 1) * d(1, 2) + d(2, 2) * d(2, 2) + d(2, 3) * d(3, 2));
+}
+
+static void test_inplace_lu() {
+   // Needs a row swap after the first elimination step.
+   const mat3x3 m({
+      1, 1, 1,
+      1, 1, 2,
+      1, 2, 3
+   });
+
+   mat3x3 a = m;
+   std::array<size_t, 3> pivots;
+
+   Equals(lu(a, pivots), (size_t)1);
+   Equals(pivots[1], (size_t)2);
+   Equals(Round(det(m), 0.001), -1.0);
+
+   const vec3 b(1, 2, 3);
+   auto r = m * solve(m, b) - b;
+
+   for (size_t i = 1; i <= 3; ++i)
+      Equals(Round(r(i, 1), 0.001), 0.0);
+
+   DynamicMatrix<double> d(m);
+   std::vector<size_t> p;
+
+   lu(d, p);
+   Equals(d == DynamicMatrix<double>(a), true);
+   Equals(p[1], pivots[1]);
+}
+
+static void test_lu_factorization() {
+   const mat4x4 m({
+      11, 9, 24, 2,
+      1, 5, 2, 6,
+      3, 17, 18, 1,
+      2, 5, 7, 1
+   });
+
+   const LUFactorization<4> f(m);
+
+   Equals(f.singular(), false);
+   Equals(Round(f.det(), 0.001), Round(det(m), 0.001));
+
+   auto r = f.inv() * m;
+
+   for (size_t i = 1; i <= 4; ++i)
+      Equals(Round(r(i, i), 0.001), 1.0);
+
+   // Larger than one diagonal block of the triangular solves.
+   Matrix<100, 100, double> a;
+   Matrix<100, 70, double> b;
+
+   for (size_t j = 1; j <= 100; ++j) {
+      for (size_t i = 1; i <= 100; ++i)
+         a(i, j) = (double)((i * 7 + j * 13) % 17) + (i == j ? 100.0 : 0.0);
+   }
+
+   for (size_t j = 1; j <= 70; ++j) {
+      for (size_t i = 1; i <= 100; ++i)
+         b(i, j) = (double)((i + j) % 5);
+   }
+
+   const LUFactorization<100> g(a);
+   Matrix<100, 70, double> x = g.solve(b);
+   Matrix<100, 70, double> residual = a * x - b;
+
+   for (auto v : residual)
+      Equals(Abs(v) < 1e-10, true);
+
+   g.solve_in_place(b);
+   Equals(b == x, true);
+}
+
+static void test_blocked_lu() {
+   const size_t threshold = parallel_threshold();
+   ThreadPool::instance().set_concurrency(4);
+   set_parallel_threshold(1024);
+
+   // Three panels plus a partial one.
+   const size_t n = 3 * 64 + 20;
+   DynamicMatrix<double> a(n, n, false), b(n, 3, false);
+
+   unsigned seed = 1;
+
+   for (size_t i = 1; i <= n * n; ++i) {
+      seed = seed * 1103515245 + 12345;
+      a[i] = (double)((seed >> 16) % 2001) / 100.0 - 10.0;
+   }
+
+   for (size_t i = 1; i <= n * 3; ++i)
+      b[i] = (double)(i % 5);
+
+   DynamicMatrix<double> l, u, pivot;
+   lu(a, l, u, pivot);
+
+   for (auto v : pivot * a - l * u)
+      Equals(Abs(v) < 1e-10, true);
+
+   for (auto v : a * solve(a, b) - b)
+      Equals(Abs(v) < 1e-8, true);
+
+   set_parallel_threshold(threshold);
+   ThreadPool::instance().set_concurrency(1);
+}
+
+static void test_cholesky() {
+   const mat3x3 m({
+      4, 12, -16,
+      12, 37, -43,
+      -16, -43, 98
+   });
+
+   const double L[] = {
+      2, 0, 0,
+      6, 1, 0,
+      -8, 5, 3
+   };
+
+   mat3x3 l, ld;
+   vec3 d;
+
+   Equals(cholesky(m, l), true);
+   Equals(ldlt(m, ld, d), true);
+
+   size_t k = 0;
+   for (size_t i = 1; i <= 3; ++i) {
+      for (size_t j = 1; j <= 3; ++j)
+         Equals(Round(l(i, j), 0.001), L[k++]);
+
+      Equals(Round(d(i, 1), 0.001), L[(i - 1) * 4] * L[(i - 1) * 4]);
+   }
+
+   const vec3 b(1, 2, 3);
+   Matrix<3, 1, double> x;
+
+   Equals(solvespd(m, b, x), true);
+
+   for (size_t i = 1; i <= 3; ++i) {
+      Equals(Round(x(i, 1), 0.001), Round(solve(m, b)(i, 1), 0.001));
+      Equals(Round(solveldlt(ld, d, b)(i, 1), 0.001), Round(x(i, 1), 0.001));
+   }
+
+   mat3x3 indefinite = m;
+   indefinite(3, 3) = -1;
+
+   Equals(cholesky(indefinite, l), false);
+   Equals(solvespd(indefinite, b, x), false);
+}
+
+static void test_qr() {
+   // Elements are listed column by column.
+   const Matrix<4, 2, double> a({
+      1, 1, 1, 1,
+      1, 2, 3, 4
+   });
+
+   mat4x4 q;
+   Matrix<4, 2, double> r;
+   qr(a, q, r);
+
+   auto identity = ~q * q;
+   auto product = q * r;
+
+   for (size_t i = 1; i <= 4; ++i) {
+      for (size_t j = 1; j <= 4; ++j)
+         Equals(Round(identity(i, j), 0.001), i == j ? 1.0 : 0.0);
+
+      for (size_t j = 1; j <= 2; ++j)
+         Equals(Round(product(i, j), 0.001), a(i, j));
+   }
+
+   Equals(Round(r(2, 1), 0.001), 0.0);
+
+   // Line through (1, 6), (2, 5), (3, 7) and (4, 10).
+   const vec4 b(6, 5, 7, 10);
+   auto x = lstsq(a, b);
+
+   Equals(Round(x(1, 1), 0.001), 3.5);
+   Equals(Round(x(2, 1), 0.001), 1.4);
+
+   Matrix<4, 2, double> thin;
+   mat2x2 square;
+   thinqr(a, thin, square);
+
+   Equals(Round(Abs(square(1, 1)), 0.001), 2.0);
+}
+
+static void test_closed_form_inverse() {
+   const mat4x4 m({
+      11, 9, 24, 2,
+      1, 5, 2, 6,
+      3, 17, 18, 1,
+      2, 5, 7, 1
+   });
+
+   // Reference inverse and determinant from the LU decomposition.
+   mat4x4 factors(m);
+   std::array<size_t, 4> pivots;
+   const size_t swaps = lu(factors, pivots);
+   const mat4x4 reference = solvelu(factors, pivots, eye<4, double>());
+
+   double d = swaps % 2 == 0 ? 1.0 : -1.0;
+
+   for (size_t i = 1; i <= 4; ++i)
+      d *= factors(i, i);
+
+   Equals(Round(det(m), 0.001), Round(d, 0.001));
+
+   // 4x4 systems are solved with pivoting rather than by the inverse.
+   const vec4 rhs(1, 2, 3, 4);
+   const vec4 x = solve(m, rhs);
+   const vec4 lux = solvelu(factors, pivots, rhs);
+
+   for (size_t i = 1; i <= 4; ++i)
+      Equals(x[i], lux[i]);
+
+   const mat4x4 a = inv(m);
+   const Matrix<4, 4, float> f = inv(Matrix<4, 4, float>(m));
+
+   for (size_t i = 1; i <= 4; ++i) {
+      for (size_t j = 1; j <= 4; ++j) {
+         Equals(Round(a(i, j), 0.001), Round(reference(i, j), 0.001));
+         Equals(Round((double)f(i, j), 0.001), Round(reference(i, j), 0.001));
+      }
+   }
+
+   const mat3x3 b(m.get_sub<3, 3>(1, 1));
+   const mat3x3 rb = inv(b) * b;
+   const mat2x2 c(m.get_sub<2, 2>(2, 2));
+   const mat2x2 rc = inv(c) * c;
+
+   Equals(Round(det(c), 0.001), 5.0 * 18.0 - 17.0 * 2.0);
+
+   for (size_t i = 1; i <= 3; ++i) {
+      for (size_t j = 1; j <= 3; ++j)
+         Equals(Round(rb(i, j), 0.001), i == j ? 1.0 : 0.0);
+   }
+
+   for (size_t i = 1; i <= 2; ++i) {
+      for (size_t j = 1; j <= 2; ++j)
+         Equals(Round(rc(i, j), 0.001), i == j ? 1.0 : 0.0);
+   }
+
+   // Rotation about z followed by a translation.
+   const mat4x4 affine({
+      0, 1, 0, 0,
+      -1, 0, 0, 0,
+      0, 0, 2, 0,
+      3, 4, 5, 1
+   });
+
+   const mat4x4 ra = invaffine(affine) * affine;
+
+   for (size_t i = 1; i <= 4; ++i) {
+      for (size_t j = 1; j <= 4; ++j)
+         Equals(Round(ra(i, j), 0.001), i == j ? 1.0 : 0.0);
+   }
+}
+
+static void test_batches() {
+   const size_t n = 37;
+   const mat4x4f m({
+      1, 0, 0, 0,
+      0, 0, 2, 0,
+      0, -1, 0, 0,
+      3, 4, 5, 1
+   });
+
+   VectorBatch<4, float> v(n);
+   VectorBatch<3, float> p(n), q(n);
+   MatrixBatch<4, 4, float> a(n);
+   std::vector<float> raw(4 * n);
+
+   for (size_t k = 1; k <= n; ++k) {
+      const float f = (float)k;
+      v.set(k, vec4f(f, 1, 2, 1));
+      p.set(k, vec3f(f, 0, 0));
+      q.set(k, vec3f(0, f, 0));
+      a.set(k, mat4x4f(m * f));
+
+      for (size_t i = 0; i < 4; ++i)
+         raw[(k - 1) * 4 + i] = v.get(k)(i + 1, 1);
+   }
+
+   const VectorBatch<4, float> t = m * v;
+   const MatrixBatch<4, 4, float> products = a * a;
+   const VectorBatch<3, float> cross = p % q;
+   const DynamicVector<float> dots = dot(p, q);
+   const DynamicVector<float> lengths = length(p);
+   const VectorBatch<3, float> normalized = normalize(p);
+
+   VectorBatch<3, float> points(n);
+   transform(m, p, points);
+
+   // Interleaved vectors are gathered into batches chunk by chunk.
+   stream<4, 1, 4, 1>(raw.data(), n, raw.data(), [&m](const ConstMatrixBatchView<4, 1, float>& in, MatrixBatchView<4, 1, float>& out) {
+      transform(m, in, out);
+   });
+
+   for (size_t k = 1; k <= n; ++k) {
+      const float f = (float)k;
+      const vec4f expected = m * v.get(k);
+
+      for (size_t i = 1; i <= 4; ++i) {
+         Equals(t.get(k)(i, 1), expected(i, 1));
+         Equals(raw[(k - 1) * 4 + i - 1], expected(i, 1));
+      }
+
+      const mat4x4f scaled = m * f;
+      const mat4x4f square = scaled * scaled;
+
+      for (size_t i = 1; i <= 16; ++i)
+         Equals(products.get(k)[i], square[i]);
+
+      Equals(cross.get(k)(3, 1), f * f);
+      Equals(dots[k], 0.0f);
+      Equals(lengths[k], f);
+      Equals(normalized.get(k)(1, 1), 1.0f);
+      Equals(points.get(k)(1, 1), f + 3);
+      Equals(points.get(k)(2, 1), 4.0f);
+      Equals(points.get(k)(3, 1), 5.0f);
+   }
+
+   // Matrices larger than a batch element still transform batches.
+   Matrix<8, 8, double> big;
+   VectorBatch<8, double> w(n);
+
+   for (size_t i = 1; i <= 64; ++i)
+      big[i] = (double)(i % 7) - 3.0;
+
+   for (size_t k = 1; k <= n; ++k) {
+      Vector<8, double> e;
+
+      for (size_t i = 1; i <= 8; ++i)
+         e[i] = (double)(k + i);
+
+      w.set(k, e);
+   }
+
+   const VectorBatch<8, double> wt = big * w;
+
+   // Inputs and outputs of different sizes go to separate arrays.
+   std::vector<float> grown(4 * n);
+
+   stream<3, 1, 4, 1>(raw.data(), n, grown.data(), [](const ConstMatrixBatchView<3, 1, float>& in, MatrixBatchView<4, 1, float>& out) {
+      for (size_t k = 1; k <= in.size(); ++k) {
+         const vec3f e = in.get(k);
+         out.set(k, vec4f(e(1, 1), e(2, 1), e(3, 1), 1));
+      }
+   });
+
+   for (size_t k = 1; k <= n; ++k) {
+      const Vector<8, double> expected = big * w.get(k);
+
+      for (size_t i = 1; i <= 8; ++i)
+         Equals(wt.get(k)[i], expected[i]);
+
+      for (size_t i = 0; i < 3; ++i)
+         Equals(grown[(k - 1) * 4 + i], raw[(k - 1) * 3 + i]);
+
+      Equals(grown[(k - 1) * 4 + 3], 1.0f);
+   }
+
+   // Large matrices stream in parallel through heap buffers.
+   const size_t threshold = parallel_threshold();
+   ThreadPool::instance().set_concurrency(4);
+   set_parallel_threshold(1024);
+
+   const size_t count = 3 * StreamChunk + 5;
+   std::vector<double> square(36 * count), transposed(36 * count);
+
+   for (size_t e = 0; e < square.size(); ++e)
+      square[e] = (double)e;
+
+   stream<6, 6, 6, 6>(square.data(), count, transposed.data(), [](const ConstMatrixBatchView<6, 6, double>& in, MatrixBatchView<6, 6, double>& out) {
+      for (size_t k = 1; k <= in.size(); ++k)
+         out.set(k, Matrix<6, 6, double>(~in.get(k)));
+   });
+
+   for (size_t k = 0; k < count; ++k) {
+      for (size_t i = 0; i < 6; ++i) {
+         for (size_t j = 0; j < 6; ++j)
+            Equals(transposed[k * 36 + j * 6 + i], square[k * 36 + i * 6 + j]);
+      }
+   }
+
+   set_parallel_threshold(threshold);
+   ThreadPool::instance().set_concurrency(1);
+}
+
+static void test_batch_solve() {
+   const size_t n = 21;
+   MatrixBatch<3, 3, double> a(n);
+   MatrixBatch<3, 1, double> b(n);
+
+   for (size_t k = 1; k <= n; ++k) {
+      const double f = (double)k;
+
+      // Every other system needs a row exchange in the first column.
+      mat3x3 m({
+         k % 2 == 0 ? 0.0 : 4.0, 1, 2,
+         1, 3 + f, 1,
+         2, 1, 5
+      });
+
+      a.set(k, m);
+      b.set(k, m * vec3(1, f, -1));
+   }
+
+   const MatrixBatch<3, 1, double> x = solve(a, b);
+   const MatrixBatch<3, 3, double> inverses = inv(a);
+   const DynamicVector<double> determinants = det(a);
+
+   for (size_t k = 1; k <= n; ++k) {
+      const mat3x3 m = a.get(k);
+      const mat3x3 r = inverses.get(k) * m;
+
+      Equals(Round(x.get(k)(1, 1), 0.001), 1.0);
+      Equals(Round(x.get(k)(2, 1), 0.001), (double)k);
+      Equals(Round(x.get(k)(3, 1), 0.001), -1.0);
+      Equals(Round(determinants[k], 0.001), Round(det(m), 0.001));
+
+      for (size_t i = 1; i <= 3; ++i) {
+         for (size_t j = 1; j <= 3; ++j)
+            Equals(Round(r(i, j), 0.001), i == j ? 1.0 : 0.0);
+      }
+   }
+}
+
+static void test_quaternion() {
+   const quat a(vec3(1, 2, 3), Degree<double>(40));
+   const quat b(vec3(0, 0, 1), Degree<double>(90));
+   const vec3 v(0.3, -2, 1);
+
+   const vec3 composed = (a * b) * v;
+   const vec3 expected = a.matrix3() * (b.matrix3() * v);
+
+   for (size_t i = 1; i <= 3; ++i)
+      Equals(Round(composed(i, 1), 0.001), Round(expected(i, 1), 0.001));
+
+   const vec3 rotated = b * vec3(1, 0, 0);
+
+   Equals(Round(rotated.x(), 0.001), 0.0);
+   Equals(Round(rotated.y(), 0.001), 1.0);
+   Equals(Round((double)a.angle(), 0.001), 40.0);
+
+   const quat m(a.matrix4());
+
+   Equals(Round(Abs(dot(m, a)), 0.001), 1.0);
+   Equals(Round((inv(a) * a).w(), 0.001), 1.0);
+
+   // Half way from identity to 90 degrees about z.
+   const quat half = slerp(quat(), b, 0.5);
+
+   Equals(Round((double)half.angle(), 0.001), 45.0);
+   Equals(Round(dot(nlerp(quat(), b, 0.5), half), 0.001), 1.0);
+
+   VectorBatch<4, double> from(5), to(5);
+
+   for (size_t k = 1; k <= 5; ++k) {
+      from.set(k, quat().vector());
+      to.set(k, b.vector());
+   }
+
+   const VectorBatch<4, double> slerped = slerp(from, to, 0.5);
+   const VectorBatch<4, double> nlerped = nlerp(from, to, 0.5);
+
+   for (size_t k = 1; k <= 5; ++k) {
+      Equals(Round(dot(quat(Vector<4, double>(slerped.get(k))), half), 0.001), 1.0);
+      Equals(Round(dot(quat(Vector<4, double>(nlerped.get(k))), half), 0.001), 1.0);
+   }
+}
+
+static void test_affine() {
+   const mat3x3 r = quat(vec3(1, 2, 3), Degree<double>(40)).matrix3();
+   mat3x3 s = r;
+   s(1, 2) += 0.5;
+   s(3, 3) *= 2.0;
+
+   const affine3 a(r, vec3(1, 2, 3));
+   const affine3 b(s, vec3(-2, 0.5, 4));
+   const mat4x4 product = a.matrix() * b.matrix();
+   const mat4x4 composed = (a * b).matrix();
+
+   for (size_t i = 1; i <= 16; ++i)
+      Equals(Round(composed[i], 0.001), Round(product[i], 0.001));
+
+   const vec3 p(0.3, -1, 2);
+   const vec4 point = b.matrix() * vec4(p, 1);
+   const vec4 direction = b.matrix() * vec4(p, 0);
+   const vec3 transformed = transform_point(b, p);
+   const vec3 rotated = transform_direction(b, p);
+   const vec4 homogeneous = b * vec4(p, 1);
+
+   for (size_t i = 1; i <= 3; ++i) {
+      Equals(Round(transformed[i], 0.001), Round(point[i], 0.001));
+      Equals(Round(rotated[i], 0.001), Round(direction[i], 0.001));
+      Equals(Round(homogeneous[i], 0.001), Round(point[i], 0.001));
+   }
+
+   Equals(homogeneous.w(), 1.0);
+
+   const mat4x4 general = (inv(b) * b).matrix();
+   const mat4x4 rigid = (invrigid(a) * a).matrix();
+
+   for (size_t i = 1; i <= 4; ++i) {
+      for (size_t j = 1; j <= 4; ++j) {
+         Equals(Round(general(i, j), 0.001), i == j ? 1.0 : 0.0);
+         Equals(Round(rigid(i, j), 0.001), i == j ? 1.0 : 0.0);
+      }
+   }
+
+   const affine3 converted(b.matrix());
+
+   Equals(converted(2, 4), 0.5);
+   Equals(converted(3, 3), s(3, 3));
+}
+
+static void test_sparse() {
+   const size_t threshold = parallel_threshold();
+   ThreadPool::instance().set_concurrency(4);
+   set_parallel_threshold(64);
+
+   const size_t n = 60, m = 40;
+   SparseBuilder<double> builder(n, m);
+   matXd dense(n, m);
+
+   for (size_t k = 0; k < 400; ++k) {
+      const size_t i = (k * 7) % 50 + 1, j = (k * 13) % m + 1;
+      const double value = (double)(k % 9) - 4.0;
+
+      builder.add(i, j, value);
+      dense(i, j) += value;
+   }
+
+   const csrXd csr(builder);
+   const cscXd csc(builder);
+   const cscXd converted(csr);
+
+   Equals(csr.nonzeros(), csc.nonzeros());
+   Equals(csr.nonzeros(), converted.nonzeros());
+   Equals(csr.dense() == dense, true);
+   Equals(csc.dense() == dense, true);
+   Equals(csr(8, 14), dense(8, 14));
+   Equals(csr(60, 1), 0.0);
+
+   vecXd x(m), xt(n);
+
+   for (size_t j = 1; j <= m; ++j)
+      x[j] = (double)(j % 5);
+
+   for (size_t i = 1; i <= n; ++i)
+      xt[i] = (double)(i % 3);
+
+   const vecXd expected = dense * x;
+   const vecXd expectedt = (~dense) * xt;
+   vecXd y(m, false);
+
+   Equals(csr * x == expected, true);
+   Equals(csc * x == expected, true);
+
+   multiply_transposed(csr, xt, y);
+   Equals(y == expectedt, true);
+
+   multiply_transposed(csc, xt, y);
+   Equals(y == expectedt, true);
+   Equals((~csr) * xt == expectedt, true);
+
+   const matXd b = dense.get_sub(1, 1, m, 3);
+   Equals(csr * b == dense * b, true);
+   Equals(csc * b == dense * b, true);
+
+   const mat3x3 f { 1, 0, 2, 0, 0, 0, 3, 0, 4 };
+   const csrXd fs(f);
+
+   Equals(fs.nonzeros(), (size_t)4);
+   Equals(fs(3, 1), 2.0);
+   Equals(cscXd(dense).dense() == dense, true);
+
+   // Repeated scattering products reuse their partial sums.
+   vecXd yc(n, false);
+   multiply(csc, x, yc);
+
+   accounting_reset();
+   multiply(csc, x, yc);
+
+   Equals(yc == expected, true);
+   Equals(accounting_snapshot().allocations, (uint64_t)0);
+
+   set_parallel_threshold(threshold);
+   ThreadPool::instance().set_concurrency(1);
+}
+
+static void test_krylov() {
+   const size_t g = 12, n = g * g;
+   SparseBuilder<double> symmetric(n, n), general(n, n);
+
+   // Five-point Laplacian, and a version with convection terms.
+   for (size_t i = 0; i < g; ++i) {
+      for (size_t j = 0; j < g; ++j) {
+         const size_t k = i * g + j + 1;
+
+         symmetric.add(k, k, 4.0);
+         general.add(k, k, 4.0);
+
+         if (i > 0) {
+            symmetric.add(k, k - g, -1.0);
+            general.add(k, k - g, -1.5);
+         }
+
+         if (i + 1 < g) {
+            symmetric.add(k, k + g, -1.0);
+            general.add(k, k + g, -0.5);
+         }
+
+         if (j > 0) {
+            symmetric.add(k, k - 1, -1.0);
+            general.add(k, k - 1, -1.25);
+         }
+
+         if (j + 1 < g) {
+            symmetric.add(k, k + 1, -1.0);
+            general.add(k, k + 1, -0.75);
+         }
+      }
+   }
+
+   const csrXd s(symmetric), a(general);
+   const matXd dense = a.dense();
+   const IterativeOptions<double> options(1e-10, 500, 20);
+   KrylovWorkspace<double> workspace;
+   vecXd b(n);
+
+   for (size_t i = 1; i <= n; ++i)
+      b[i] = (double)(i % 7) - 3.0;
+
+   const auto check = [&](const csrXd& m, const vecXd& x, const IterativeResult<double>& result) {
+      const vecXd r = m * x;
+
+      Equals(result.converged, true);
+
+      for (size_t i = 1; i <= n; ++i)
+         Equals(Round(r[i], 0.000001), Round(b[i], 0.000001));
+   };
+
+   vecXd x;
+   const IterativeResult<double> plain = cg(s, b, x, IdentityPreconditioner<double>(), options, workspace);
+   check(s, x, plain);
+
+   x = vecXd();
+   const IterativeResult<double> preconditioned = cg(s, b, x, SsorPreconditioner<double>(s, 1.5), options, workspace);
+   check(s, x, preconditioned);
+   Equals(preconditioned.iterations < plain.iterations, true);
+
+   x = vecXd();
+   check(s, x, cg(s, b, x, JacobiPreconditioner<double>(s), options, workspace));
+
+   x = vecXd();
+   check(a, x, bicgstab(a, b, x, Ilu0Preconditioner<double>(a), options, workspace));
+
+   x = vecXd();
+   check(a, x, bicgstab(a, b, x, IdentityPreconditioner<double>(), options));
+
+   x = vecXd();
+   check(a, x, gmres(a, b, x, Ilu0Preconditioner<double>(a), options, workspace));
+
+   x = vecXd();
+   check(a, x, gmres(dense, b, x, JacobiPreconditioner<double>(dense), options, workspace));
+
+   x = vecXd();
+   check(a, x, gmres([&a](const vecXd& in, vecXd& out) { multiply(a, in, out); }, b, x, IdentityPreconditioner<double>(), options, workspace));
+
+   // A converged guess returns without iterating.
+   Equals(gmres(a, b, x, IdentityPreconditioner<double>(), options, workspace).iterations, (size_t)0);
+}
+
+static void test_eigen() {
+   const mat3x3 a { 4, 1, 2, 1, 3, 0, 2, 0, 5 };
+   vec3 values;
+   mat3x3 vectors;
+
+   eigsym(a, values, vectors);
+
+   const mat3x3 d { values[1], 0, 0, 0, values[2], 0, 0, 0, values[3] };
+   const mat3x3 rebuilt = vectors * d * ~vectors;
+   const mat3x3 identity = ~vectors * vectors;
+
+   for (size_t i = 1; i <= 9; ++i) {
+      Equals(Round(rebuilt[i], 0.000001), Round(a[i], 0.000001));
+      Equals(Round(identity[i], 0.000001), i % 4 == 1 ? 1.0 : 0.0);
+   }
+
+   Equals(values[1] <= values[2] && values[2] <= values[3], true);
+
+   // Repeated eigenvalues still give orthonormal vectors.
+   const mat3x3 twice { 2, 1, 0, 1, 2, 0, 0, 0, 3 };
+   eigsym(twice, values, vectors);
+
+   Equals(Round(values[1], 0.000001), 1.0);
+   Equals(Round(values[2], 0.000001), 3.0);
+   Equals(Round(values[3], 0.000001), 3.0);
+   Equals(Round(Vector<3, double>(vectors.column(2)) * Vector<3, double>(vectors.column(3)), 0.000001), 0.0);
+
+   // Jacobi path for small and tridiagonal QL for larger matrices.
+   Matrix<6, 6, double> s(false);
+   Matrix<20, 20, double> l(false);
+
+   for (size_t i = 1; i <= 6; ++i) {
+      for (size_t j = 1; j <= 6; ++j)
+         s(i, j) = i == j ? (double)i : 1.0 / (double)(i + j);
+   }
+
+   for (size_t i = 1; i <= 20; ++i) {
+      for (size_t j = 1; j <= 20; ++j)
+         l(i, j) = i == j ? 2.0 + (double)i : 1.0 / (double)(i + j);
+   }
+
+   Vector<6, double> sv;
+   Matrix<6, 6, double> sq;
+   Vector<20, double> lv;
+   Matrix<20, 20, double> lq;
+
+   eigsym(s, sv, sq);
+   eigsym(l, lv, lq);
+
+   const Matrix<6, 6, double> sr = s * sq;
+   const Matrix<20, 20, double> lr = l * lq;
+
+   for (size_t j = 1; j <= 6; ++j) {
+      for (size_t i = 1; i <= 6; ++i)
+         Equals(Round(sr(i, j), 0.000001), Round(sq(i, j) * sv[j], 0.000001));
+   }
+
+   for (size_t j = 1; j <= 20; ++j) {
+      for (size_t i = 1; i <= 20; ++i)
+         Equals(Round(lr(i, j), 0.000001), Round(lq(i, j) * lv[j], 0.000001));
+   }
+
+   const Vector<20, double> only = eigvalsym(l);
+   Vector<3, double> top;
+   Matrix<20, 3, double> tq;
+
+   topeigsym<3>(l, top, tq);
+
+   for (size_t j = 1; j <= 20; ++j)
+      Equals(Round(only[j], 0.000001), Round(lv[j], 0.000001));
+
+   for (size_t j = 1; j <= 3; ++j) {
+      Equals(Round(top[j], 0.000001), Round(lv[21 - j], 0.000001));
+      Equals(Round(Abs(Vector<20, double>(tq.column(j)) * Vector<20, double>(lq.column(21 - j))), 0.000001), 1.0);
+   }
+}
+
+static void test_svd() {
+   // A 6x7 Jacobian goes through one-sided Jacobi rotations.
+   Matrix<6, 7, double> j(false);
+
+   for (size_t r = 1; r <= 6; ++r) {
+      for (size_t c = 1; c <= 7; ++c)
+         j(r, c) = r == c ? (double)(7 - r) : 1.0 / (double)(r + c);
+   }
+
+   Matrix<6, 6, double> u;
+   Vector<6, double> s;
+   Matrix<7, 7, double> v;
+
+   svd(j, u, s, v);
+
+   const Matrix<7, 7, double> vv = ~v * v;
+
+   for (size_t r = 1; r <= 6; ++r) {
+      for (size_t c = 1; c <= 7; ++c) {
+         double x = 0.0;
+
+         for (size_t k = 1; k <= 6; ++k)
+            x += u(r, k) * s[k] * v(c, k);
+
+         Equals(Round(x, 0.000001), Round(j(r, c), 0.000001));
+      }
+   }
+
+   for (size_t i = 1; i <= 49; ++i)
+      Equals(Round(vv[i], 0.000001), i % 8 == 1 ? 1.0 : 0.0);
+
+   for (size_t k = 1; k < 6; ++k)
+      Equals(s[k] >= s[k + 1], true);
+
+   // Larger matrices are bidiagonalized; values-only and top-k agree with
+   // the thin decomposition.
+   Matrix<20, 12, double> l(false);
+
+   for (size_t r = 1; r <= 20; ++r) {
+      for (size_t c = 1; c <= 12; ++c)
+         l(r, c) = r == c ? 2.0 + (double)r : 1.0 / (double)(r + c);
+   }
+
+   Matrix<20, 12, double> lu;
+   Vector<12, double> ls;
+   Matrix<12, 12, double> lv;
+
+   thinsvd(l, lu, ls, lv);
+
+   const Matrix<20, 12, double> lr = l * lv;
+   const Vector<12, double> only = svdvals(l);
+
+   for (size_t c = 1; c <= 12; ++c) {
+      Equals(Round(only[c], 0.000001), Round(ls[c], 0.000001));
+
+      for (size_t r = 1; r <= 20; ++r)
+         Equals(Round(lr(r, c), 0.000001), Round(lu(r, c) * ls[c], 0.000001));
+   }
+
+   Matrix<20, 2, double> tu;
+   Vector<2, double> ts;
+   Matrix<12, 2, double> tv;
+
+   topsvd<2>(l, tu, ts, tv);
+
+   for (size_t k = 1; k <= 2; ++k) {
+      Equals(Round(ts[k], 0.000001), Round(ls[k], 0.000001));
+      Equals(Round(Abs(Vector<12, double>(tv.column(k)) * Vector<12, double>(lv.column(k))), 0.000001), 1.0);
+   }
+
+   // Rank deficient matrices.
+   const Matrix<3, 2, double> a { 1, 2, 3, 2, 4, 6 };
+   const Matrix<2, 3, double> p = pinv(a);
+   const Matrix<3, 2, double> apa = a * p * a;
+
+   Equals(rank(a), (size_t)1);
+   Equals(rank(a, 1.0), (size_t)1);
+   Equals(rank(a, 10.0), (size_t)0);
+   Equals(rank(mat3x3({ 2, 0, 0, 0, 1, 0, 0, 0, 0.001 }), 0.01), (size_t)2);
+
+   const Matrix<2, 3, double> pt = pinv(a, 1.0);
+   const Matrix<2, 3, double> pz = pinv(a, 10.0);
+
+   for (size_t i = 1; i <= 6; ++i) {
+      Equals(Round(apa[i], 0.000001), Round(a[i], 0.000001));
+      Equals(Round(pt[i], 0.000001), Round(p[i], 0.000001));
+      Equals(pz[i], 0.0);
+   }
+}
+
+static void test_randomized() {
+   // Rank 3 matrix with singular values 9, 4 and 1 is captured exactly.
+   const size_t m = 80, n = 48;
+   DynamicMatrix<double> x(m, 3), y(n, 3);
+
+   for (size_t i = 1; i <= m; ++i) {
+      x(i, 1) = 1.0 / Sqrt((double)m);
+      x(i, 2) = (i % 2 ? 1.0 : -1.0) / Sqrt((double)m);
+      x(i, 3) = (i <= m / 2 ? 1.0 : -1.0) * (i % 2 ? 1.0 : -1.0) / Sqrt((double)m);
+   }
+
+   for (size_t i = 1; i <= n; ++i) {
+      y(i, 1) = 9.0 / Sqrt((double)n);
+      y(i, 2) = 4.0 * (i % 2 ? 1.0 : -1.0) / Sqrt((double)n);
+      y(i, 3) = (i <= n / 2 ? 1.0 : -1.0) / Sqrt((double)n);
+   }
+
+   const DynamicMatrix<double> a = x * ~y;
+   DynamicMatrix<double> u, v, u2, v2;
+   DynamicVector<double> s, s2;
+
+   rsvd(a, 3, u, s, v, RandomizedOptions(5, 1, 42));
+
+   Equals(Round(s[1], 0.000001), 9.0);
+   Equals(Round(s[2], 0.000001), 4.0);
+   Equals(Round(s[3], 0.000001), 1.0);
+
+   const DynamicMatrix<double> r = u * DynamicMatrix<double>(3, 3, { s[1], 0, 0, 0, s[2], 0, 0, 0, s[3] }) * ~v;
+
+   for (size_t i = 1; i <= m * n; ++i)
+      Equals(Round(r[i], 0.000001), Round(a[i], 0.000001));
+
+   // Rows fed in blocks give the same result with the same seed.
+   RandomizedSketch<double> sketch(m, n, 3, RandomizedOptions(5, 1, 42));
+
+   Equals(sketch.passes(), (size_t)4);
+
+   while (sketch.next_pass()) {
+      for (size_t i = 1; i <= m; i += 30)
+         sketch.add(i, a.sub(i, 1, std::min((size_t)30, m - i + 1), n));
+   }
+
+   sketch.svd(u2, s2, v2);
+
+   for (size_t k = 1; k <= 3; ++k) {
+      Equals(Round(s2[k], 0.000001), Round(s[k], 0.000001));
+      Equals(Round(Abs(DynamicVector<double>(v.column(k)) * DynamicVector<double>(v2.column(k))), 0.000001), 1.0);
+   }
+
+   // Dominant eigenpairs of the Gram matrix.
+   const DynamicMatrix<double> gram = ~a * a;
+   DynamicVector<double> values;
+   DynamicMatrix<double> vectors;
+
+   reigsym(gram, 2, values, vectors);
+
+   Equals(Round(values[1], 0.000001), 81.0);
+   Equals(Round(values[2], 0.000001), 16.0);
+
+   const DynamicMatrix<double> gv = gram * vectors;
+
+   for (size_t i = 1; i <= n; ++i)
+      Equals(Round(gv(i, 2), 0.000001), Round(values[2] * vectors(i, 2), 0.000001));
+}
+
+static void test_perf_counters() {
+   PerfRegistry& registry = PerfRegistry::instance();
+   const PerfCounters& counters = PerfCounters::thread();
+
+   registry.reset();
+
+   for (size_t i = 0; i < 3; ++i) {
+      PerfScope scope("test region");
+   }
+
+   const std::vector<PerfRecord> records = registry.snapshot();
+
+   Equals(records.size(), (size_t)1);
+   Equals(records[0].name, std::string("test region"));
+   Equals(records[0].calls, (uint64_t)3);
+   Equals(records[0].events, counters.events());
+   Equals(records[0].multiplexed <= records[0].calls, true);
+
+   // Events that are not available read as zero.
+   const PerfCounts counts = counters.read();
+
+   for (size_t e = 0; e < PerfEventCount; ++e) {
+      Equals(counters.available((PerfEvent)e) || counts[e] == 0, true);
+      Equals(counters.available((PerfEvent)e) || records[0].counts[e] == 0, true);
+   }
+
+   // Deltas are scaled by the time counted between the samples only.
+   PerfSample start, end;
+   start.counts.fill(100);
+   start.enabled = 1000;
+   start.running = 1000;
+   end.counts.fill(150);
+   end.enabled = 2000;
+   end.running = 1500;
+
+   bool multiplexed = false;
+   const PerfCounts delta = PerfCounters::difference(start, end, multiplexed);
+
+   Equals(multiplexed, true);
+   Equals(delta[Cycles], (uint64_t)100);
+
+   end.running = 2000;
+   Equals(PerfCounters::difference(start, end, multiplexed)[Cycles], (uint64_t)50);
+   Equals(multiplexed, false);
+
+   registry.reset();
+   Equals(registry.snapshot().empty(), true);
+}
+
+static void test_accounting() {
+   Matrix<40, 40, double> a, b;
+
+   for (size_t i = 1; i <= 40; ++i) {
+      a(i, i) = 2.0;
+      b(i, i) = 3.0;
+   }
+
+   accounting_reset();
+
+   const Matrix<40, 40, double> c = a * b;
+   const Matrix<1, 40, double> row = c.get_row(2);
+   const DynamicMatrix<double> d(c);
+   const double determinant = det(d);
+
+   const Accounting counts = accounting_snapshot();
+
+   Equals(row(1, 2), 6.0);
+   Equals(determinant > 0.0, true);
+
+   if (accounting_enabled()) {
+      Equals(counts.calls[Multiply], (uint64_t)1);
+      Equals(counts.calls[Extract], (uint64_t)1);
+      Equals(counts.calls[Determinant], (uint64_t)1);
+      Equals(counts.calls[Lu], (uint64_t)1);
+      Equals(counts.allocations > 0, true);
+      Equals(counts.allocated_bytes >= 2 * 40 * 40 * sizeof(double), true);
+      Equals(counts.copied_bytes >= (40 * 40 + 40) * sizeof(double), true);
+      Equals(counts.flops >= (uint64_t)(2 * 40 * 40 * 40), true);
+   }
+   else {
+      Equals(counts.allocations, (uint64_t)0);
+      Equals(counts.copied_bytes, (uint64_t)0);
+      Equals(counts.flops, (uint64_t)0);
+   }
+
+   // Counters belong to the calling thread.
+   Accounting other;
+   std::thread thread([&other]() { other = accounting_snapshot(); });
+   thread.join();
+
+   Equals(other.flops, (uint64_t)0);
+   Equals(other.calls[Multiply], (uint64_t)0);
+
+   accounting_reset();
+
+   const Accounting cleared = accounting_snapshot();
+
+   Equals(cleared.allocations, (uint64_t)0);
+   Equals(cleared.flops, (uint64_t)0);
+   Equals(cleared.calls[Multiply], (uint64_t)0);
+}
+
 int main() {
    unroll<1, 1, 4, 4, TestConstruction, double>()();
    unroll<1, 1, 4, 4, TestMatrixAddition, double>()();
    unroll<1, 1, 4, 4, TestScalarMultiplication, double>()();
    unroll<1, 1, 4, 4, TestMatrixMultiplication, double>()();
    unroll<1, 1, 4, 4, TestTranspose, double>()();
+   unroll<1, 1, 4, 4, TestExpression, double>()();
    unroll<31, 31, 33, 33, TestAllocation, double>()();
 
    test_3x3_lu();
    test_4x4_lu();
+   test_transpose_aliasing();
+   test_blocked_multiplication();
+   test_simd_kernels();
+   test_parallel_operations();
+   test_parallel_exceptions();
+   test_dynamic_matrix();
+   test_aligned_storage();
+   test_matrix_views();
+   test_inplace_lu();
+   test_lu_factorization();
+   test_blocked_lu();
+   test_cholesky();
+   test_qr();
+   test_closed_form_inverse();
+   test_batches();
+   test_batch_solve();
+   test_quaternion();
+   test_affine();
+   test_sparse();
+   test_krylov();
+   test_eigen();
+   test_svd();
+   test_randomized();
+   test_perf_counters();
+   test_accounting();
    test_3x3_inv();
    test_4x4_inv();
 
@@ -1,7 +1,22 @@
 #pragma once
 
 #include "math/functions.hpp"
+#include "math/perfcounters.hpp"
+#include "math/accounting.hpp"
 #include "math/matrix.hpp"
 #include "math/vector.hpp"
+#include "math/dynamicmatrix.hpp"
+#include "math/dynamicvector.hpp"
+#include "math/batch.hpp"
+#include "math/quaternion.hpp"
+#include "math/affine.hpp"
+#include "math/sparse.hpp"
+#include "math/krylov.hpp"
 #include "math/linearalgebra.hpp"
+#include "math/lufactorization.hpp"
+#include "math/cholesky.hpp"
+#include "math/qr.hpp"
+#include "math/eigen.hpp"
+#include "math/svd.hpp"
+#include "math/randomized.hpp"
 #include "math/unit.hpp"
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Math {
+
+   /*! Operations counted when accounting is enabled.
+    */
+   enum AccountedOperation {
+      Multiply,
+      Extract,
+      Lu,
+      Solve,
+      Inverse,
+      Determinant,
+      AccountedOperationCount
+   };
+
+   /*! Work done by the library on one thread, counted when the library is
+    * compiled with MATH_ACCOUNTING defined:
+    *
+    *  - allocations and bytes allocated with @c AlignedAllocator, which
+    *    holds heap allocated and run-time sized matrices,
+    *  - bytes copied when copying heap allocated or run-time sized matrices
+    *    and when extracting rows, columns and sub matrices,
+    *  - floating point operations of matrix products, LU decompositions
+    *    and triangular solves,
+    *  - calls of every @c AccountedOperation.
+    *
+    * Operations count on the thread calling them, including work they split
+    * across the thread pool.
+    */
+   struct Accounting {
+
+      //! Number of heap allocations.
+      uint64_t allocations;
+
+      //! Bytes allocated from the heap.
+      uint64_t allocated_bytes;
+
+      //! Bytes copied between matrices.
+      uint64_t copied_bytes;
+
+      //! Floating point operations.
+      uint64_t flops;
+
+      //! Calls by operation.
+      std::array<uint64_t, AccountedOperationCount> calls;
+   };
+
+   /*! Tells whether the library was compiled with accounting.
+    *
+    * @return @c true if MATH_ACCOUNTING is defined.
+    */
+   constexpr bool accounting_enabled();
+
+   /*! Gets the counters of the calling thread.
+    *
+    * @return Counts since the thread started or since the last reset; all
+    *         zero when accounting is disabled.
+    */
+   Accounting accounting_snapshot();
+
+   /*! Resets the counters of the calling thread.
+    */
+   void accounting_reset();
+
+   namespace Detail {
+
+      /*! Gets the mutable counters of the calling thread.
+       */
+      Accounting& thread_accounting();
+   }
+}
+
+/*! Accounting hooks. They compile to nothing, without evaluating their
+ * arguments, unless MATH_ACCOUNTING is defined.
+ */
+#if defined(MATH_ACCOUNTING)
+#define MATH_ACCOUNT_CALL(operation, work) (::Math::Detail::thread_accounting().calls[operation] += 1, ::Math::Detail::thread_accounting().flops += (uint64_t)(work))
+#define MATH_ACCOUNT_FLOPS(work) (::Math::Detail::thread_accounting().flops += (uint64_t)(work))
+#define MATH_ACCOUNT_ALLOCATION(size) (::Math::Detail::thread_accounting().allocations += 1, ::Math::Detail::thread_accounting().allocated_bytes += (uint64_t)(size))
+#define MATH_ACCOUNT_COPY(size) (::Math::Detail::thread_accounting().copied_bytes += (uint64_t)(size))
+#else
+#define MATH_ACCOUNT_CALL(operation, work) ((void)0)
+#define MATH_ACCOUNT_FLOPS(work) ((void)0)
+#define MATH_ACCOUNT_ALLOCATION(size) ((void)0)
+#define MATH_ACCOUNT_COPY(size) ((void)0)
+#endif
+
+#include "accounting.inl"
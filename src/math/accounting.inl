@@ -0,0 +1,26 @@
+namespace Math {
+
+   constexpr bool accounting_enabled() {
+#if defined(MATH_ACCOUNTING)
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   namespace Detail {
+
+      inline Accounting& thread_accounting() {
+         static thread_local Accounting accounting = Accounting();
+         return accounting;
+      }
+   }
+
+   inline Accounting accounting_snapshot() {
+      return Detail::thread_accounting();
+   }
+
+   inline void accounting_reset() {
+      Detail::thread_accounting() = Accounting();
+   }
+}
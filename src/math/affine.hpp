@@ -0,0 +1,147 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "vector.hpp"
+#include "matrixview.hpp"
+#include "linearalgebra.hpp"
+
+namespace Math {
+
+   /*! Affine transformation in three dimensions, a 4x4 matrix whose bottom
+    * row is the implicit (0, 0, 0, 1). Only the upper 3x4 block is stored:
+    * the linear part in columns 1 to 3 and the translation in column 4, so
+    * composing and applying transformations skips the constant row.
+    */
+   template <class T = double> class Affine3 {
+   public:
+
+      //! Type alias for element types.
+      typedef T type;
+
+      /*! Constructs an identity transformation.
+       */
+      Affine3();
+
+      /*! Constructs a transformation from its parts.
+       *
+       * @param linear Linear part, e.g. a rotation matrix.
+       * @param translation Translation.
+       */
+      template <class C> Affine3(const Matrix<3, 3, T, C>& linear, const Vector<3, T>& translation);
+
+      /*! Converts a 4x4 matrix whose bottom row is (0, 0, 0, 1).
+       *
+       * @param m Matrix to convert.
+       */
+      template <class C> explicit Affine3(const Matrix<4, 4, T, C>& m);
+
+      /*! Access transformation elements.
+       *
+       * @param i Row number, 1-based, at most 3.
+       * @param j Column number, 1-based, at most 4.
+       * @return Element at given location.
+       */
+      T& operator ()(const size_t& i, const size_t& j);
+
+      /*! Access transformation elements.
+       *
+       * @param i Row number, 1-based, at most 3.
+       * @param j Column number, 1-based, at most 4.
+       * @return Const element at given location.
+       */
+      const T& operator ()(const size_t& i, const size_t& j) const;
+
+      /*! Views the linear part.
+       *
+       * @return View of the upper left 3x3 block.
+       */
+      MatrixView<3, 3, T> linear();
+
+      /*! Views the linear part.
+       *
+       * @return View of the upper left 3x3 block.
+       */
+      ConstMatrixView<3, 3, T> linear() const;
+
+      /*! Views the translation.
+       *
+       * @return View of the fourth column.
+       */
+      MatrixView<3, 1, T> translation();
+
+      /*! Views the translation.
+       *
+       * @return View of the fourth column.
+       */
+      ConstMatrixView<3, 1, T> translation() const;
+
+      /*! Converts to 4x4 matrix.
+       *
+       * @return Matrix with bottom row (0, 0, 0, 1).
+       */
+      Matrix<4, 4, T> matrix() const;
+
+      /*! Gets the stored 3x4 block.
+       *
+       * @return Const reference to the upper 3x4 block.
+       */
+      const Matrix<3, 4, T>& block() const;
+
+   private:
+      Matrix<3, 4, T> _m;
+   };
+
+   typedef Affine3<double> affine3;
+   typedef Affine3<float> affine3f;
+
+   /*! Transforms a point, translating it.
+    *
+    * @param a Transformation.
+    * @param p Point to transform.
+    * @return Transformed point.
+    */
+   template <class T> Vector<3, T> transform_point(const Affine3<T>& a, const Vector<3, T>& p);
+
+   /*! Transforms a direction, leaving out translation.
+    *
+    * @param a Transformation.
+    * @param d Direction to transform.
+    * @return Transformed direction.
+    */
+   template <class T> Vector<3, T> transform_direction(const Affine3<T>& a, const Vector<3, T>& d);
+
+   /*! Finds out the inverse transformation. The linear part is inverted in
+    * closed form.
+    *
+    * @param a Transformation with invertible linear part.
+    * @return Inverse transformation.
+    */
+   template <class T> Affine3<T> inv(const Affine3<T>& a);
+
+   /*! Finds out the inverse of a rigid transformation, i.e. a rotation and
+    * a translation, by transposing the rotation.
+    *
+    * @param a Rigid transformation.
+    * @return Inverse transformation.
+    */
+   template <class T> Affine3<T> invrigid(const Affine3<T>& a);
+}
+
+/*! Composes two transformations. The result applies @p rhs first and then
+ * @p lhs, like the product of the 4x4 matrices.
+ *
+ * @param lhs Left hand side transformation.
+ * @param rhs Right hand side transformation.
+ * @return Composed transformation.
+ */
+template <class T> Math::Affine3<T> operator *(const Math::Affine3<T>& lhs, const Math::Affine3<T>& rhs);
+
+/*! Transforms a homogeneous vector. Points have w = 1 and directions w = 0.
+ *
+ * @param lhs Transformation.
+ * @param rhs Vector to transform.
+ * @return Transformed vector, with the same w.
+ */
+template <class T> Math::Vector<4, T> operator *(const Math::Affine3<T>& lhs, const Math::Vector<4, T>& rhs);
+
+#include "affine.inl"
@@ -0,0 +1,131 @@
+namespace Math {
+
+   template <class T> inline
+   Affine3<T>::Affine3() : _m() {
+      _m(1, 1) = _m(2, 2) = _m(3, 3) = (T)1;
+   }
+
+   template <class T>
+   template <class C> inline
+   Affine3<T>::Affine3(const Matrix<3, 3, T, C>& linear, const Vector<3, T>& translation) : _m(false) {
+      this->linear() = linear;
+      this->translation() = translation;
+   }
+
+   template <class T>
+   template <class C> inline
+   Affine3<T>::Affine3(const Matrix<4, 4, T, C>& m) : _m(m.template get_sub<3, 4>(1, 1)) {
+      assert(m(4, 1) == 0 && m(4, 2) == 0 && m(4, 3) == 0 && m(4, 4) == 1);
+   }
+
+   template <class T> inline
+   T& Affine3<T>::operator ()(const size_t& i, const size_t& j) {
+      return _m(i, j);
+   }
+
+   template <class T> inline
+   const T& Affine3<T>::operator ()(const size_t& i, const size_t& j) const {
+      return _m(i, j);
+   }
+
+   template <class T> inline
+   MatrixView<3, 3, T> Affine3<T>::linear() {
+      return _m.template sub<3, 3>(1, 1);
+   }
+
+   template <class T> inline
+   ConstMatrixView<3, 3, T> Affine3<T>::linear() const {
+      return _m.template sub<3, 3>(1, 1);
+   }
+
+   template <class T> inline
+   MatrixView<3, 1, T> Affine3<T>::translation() {
+      return _m.column(4);
+   }
+
+   template <class T> inline
+   ConstMatrixView<3, 1, T> Affine3<T>::translation() const {
+      return _m.column(4);
+   }
+
+   template <class T> inline
+   Matrix<4, 4, T> Affine3<T>::matrix() const {
+      Matrix<4, 4, T> out;
+
+      out.set_sub(1, 1, _m);
+      out(4, 4) = (T)1;
+
+      return out;
+   }
+
+   template <class T> inline
+   const Matrix<3, 4, T>& Affine3<T>::block() const {
+      return _m;
+   }
+
+   template <class T> inline
+   Vector<3, T> transform_point(const Affine3<T>& a, const Vector<3, T>& p) {
+      return Vector<3, T>(
+         a(1, 1) * p.x() + a(1, 2) * p.y() + a(1, 3) * p.z() + a(1, 4),
+         a(2, 1) * p.x() + a(2, 2) * p.y() + a(2, 3) * p.z() + a(2, 4),
+         a(3, 1) * p.x() + a(3, 2) * p.y() + a(3, 3) * p.z() + a(3, 4));
+   }
+
+   template <class T> inline
+   Vector<3, T> transform_direction(const Affine3<T>& a, const Vector<3, T>& d) {
+      return Vector<3, T>(
+         a(1, 1) * d.x() + a(1, 2) * d.y() + a(1, 3) * d.z(),
+         a(2, 1) * d.x() + a(2, 2) * d.y() + a(2, 3) * d.z(),
+         a(3, 1) * d.x() + a(3, 2) * d.y() + a(3, 3) * d.z());
+   }
+
+   template <class T> inline
+   Affine3<T> inv(const Affine3<T>& a) {
+      const Matrix<3, 3, T> l = inv(Matrix<3, 3, T>(a.linear()));
+      Affine3<T> out(l, Vector<3, T>(false));
+
+      for (size_t i = 1; i <= 3; ++i)
+         out(i, 4) = -(l(i, 1) * a(1, 4) + l(i, 2) * a(2, 4) + l(i, 3) * a(3, 4));
+
+      return out;
+   }
+
+   template <class T> inline
+   Affine3<T> invrigid(const Affine3<T>& a) {
+      Affine3<T> out;
+
+      for (size_t i = 1; i <= 3; ++i) {
+         for (size_t j = 1; j <= 3; ++j)
+            out(i, j) = a(j, i);
+
+         out(i, 4) = -(a(1, i) * a(1, 4) + a(2, i) * a(2, 4) + a(3, i) * a(3, 4));
+      }
+
+      return out;
+   }
+}
+
+template <class T> inline
+Math::Affine3<T> operator *(const Math::Affine3<T>& lhs, const Math::Affine3<T>& rhs) {
+   Math::Affine3<T> out;
+
+   for (size_t j = 1; j <= 4; ++j) {
+      for (size_t i = 1; i <= 3; ++i)
+         out(i, j) = lhs(i, 1) * rhs(1, j) + lhs(i, 2) * rhs(2, j) + lhs(i, 3) * rhs(3, j);
+   }
+
+   // The implicit bottom row of rhs carries the translation of lhs.
+   for (size_t i = 1; i <= 3; ++i)
+      out(i, 4) += lhs(i, 4);
+
+   return out;
+}
+
+template <class T> inline
+Math::Vector<4, T> operator *(const Math::Affine3<T>& lhs, const Math::Vector<4, T>& rhs) {
+   return Math::Vector<4, T>(
+      lhs(1, 1) * rhs.x() + lhs(1, 2) * rhs.y() + lhs(1, 3) * rhs.z() + lhs(1, 4) * rhs.w(),
+      lhs(2, 1) * rhs.x() + lhs(2, 2) * rhs.y() + lhs(2, 3) * rhs.z() + lhs(2, 4) * rhs.w(),
+      lhs(3, 1) * rhs.x() + lhs(3, 2) * rhs.y() + lhs(3, 3) * rhs.z() + lhs(3, 4) * rhs.w(),
+      rhs.w());
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+#include "accounting.hpp"
+
+namespace Math {
+
+   //! Alignment of heap allocated matrix storage in bytes. Covers AVX-512
+   //! registers and cache lines.
+   const size_t DefaultAlignment = 64;
+
+   /*! Standard allocator returning storage aligned to a given boundary.
+    *
+    * @tparam Alignment Alignment in bytes, a power of two.
+    */
+   template <class T, size_t Alignment = DefaultAlignment> class AlignedAllocator {
+   public:
+      static_assert(Alignment >= sizeof(void*) && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+      //! Type alias for allocated elements.
+      typedef T value_type;
+
+      //! Allocator of another element type with the same alignment.
+      template <class U> struct rebind {
+         typedef AlignedAllocator<U, Alignment> other;
+      };
+
+      /*! Constructs an allocator.
+       */
+      AlignedAllocator() {};
+
+      /*! Converts an allocator of another element type.
+       */
+      template <class U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {};
+
+      /*! Allocates aligned storage.
+       *
+       * @param n Number of elements.
+       * @return Uninitialized storage for @p n elements.
+       */
+      T* allocate(const size_t& n);
+
+      /*! Releases storage allocated with @c allocate.
+       *
+       * @param p Storage to release.
+       * @param n Number of elements.
+       */
+      void deallocate(T* p, const size_t& n);
+
+      /*! Default-initializes an element, so that containers resized without
+       * a value leave arithmetic elements uninitialized like stack matrices.
+       *
+       * @param p Element storage.
+       */
+      template <class U> void construct(U* p);
+
+      /*! Constructs an element.
+       *
+       * @param p Element storage.
+       * @param args Constructor arguments.
+       */
+      template <class U, class... Args> void construct(U* p, Args&&... args);
+   };
+
+   /*! Aligned allocators are stateless, so all of them are equal.
+    */
+   template <class T, class U, size_t A> bool operator ==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&);
+
+   /*! Aligned allocators are stateless, so all of them are equal.
+    */
+   template <class T, class U, size_t A> bool operator !=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&);
+}
+
+#include "allocator.inl"
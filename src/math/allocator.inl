@@ -0,0 +1,45 @@
+namespace Math {
+
+   template <class T, size_t Alignment> inline
+   T* AlignedAllocator<T, Alignment>::allocate(const size_t& n) {
+      if (n > (std::numeric_limits<size_t>::max() - Alignment - sizeof(void*)) / sizeof(T))
+         throw std::bad_alloc();
+
+      // The block returned by operator new is stored just before the
+      // aligned address.
+      void* raw = ::operator new(n * sizeof(T) + Alignment + sizeof(void*));
+      MATH_ACCOUNT_ALLOCATION(n * sizeof(T));
+      const uintptr_t address = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+
+      reinterpret_cast<void**>(address)[-1] = raw;
+      return reinterpret_cast<T*>(address);
+   }
+
+   template <class T, size_t Alignment> inline
+   void AlignedAllocator<T, Alignment>::deallocate(T* p, const size_t&) {
+      if (p)
+         ::operator delete(reinterpret_cast<void**>(p)[-1]);
+   }
+
+   template <class T, size_t Alignment>
+   template <class U> inline
+   void AlignedAllocator<T, Alignment>::construct(U* p) {
+      ::new((void*)p) U;
+   }
+
+   template <class T, size_t Alignment>
+   template <class U, class... Args> inline
+   void AlignedAllocator<T, Alignment>::construct(U* p, Args&&... args) {
+      ::new((void*)p) U(std::forward<Args>(args)...);
+   }
+
+   template <class T, class U, size_t A> inline
+   bool operator ==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) {
+      return true;
+   }
+
+   template <class T, class U, size_t A> inline
+   bool operator !=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) {
+      return false;
+   }
+}
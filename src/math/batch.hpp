@@ -0,0 +1,331 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "dynamicvector.hpp"
+#include "allocator.hpp"
+#include "simd.hpp"
+#include "threadpool.hpp"
+#include <algorithm>
+#include <vector>
+#include <cassert>
+
+namespace Math {
+
+   /*! Read-only view of a batch of MxN matrices stored as arrays of
+    * components (structure of arrays). Element (i, j) of matrix k is
+    * located at offset ((j - 1) * M + i - 1) * stride + k - 1, so kernels
+    * process consecutive matrices with one SIMD register per element.
+    * Views may refer to caller-owned buffers.
+    */
+   template <size_t M, size_t N, class T> class ConstMatrixBatchView {
+   public:
+      static_assert(M * N <= BatchMaxElements, "Batches hold matrices of at most 36 elements");
+
+      //! Matrix row size constant.
+      static const size_t Rows = M;
+
+      //! Matrix column size constant.
+      static const size_t Cols = N;
+
+      //! Type alias for element types.
+      typedef T type;
+
+      /*! Constructs a view.
+       *
+       * @param data Pointer to the first component array.
+       * @param size Number of matrices.
+       * @param stride Distance between consecutive component arrays.
+       */
+      ConstMatrixBatchView(const T* data, const size_t& size, const size_t& stride);
+
+      /*! Tells the number of matrices.
+       *
+       * @return Number of matrices.
+       */
+      size_t size() const;
+
+      /*! Tells the distance between consecutive component arrays.
+       *
+       * @return Component stride.
+       */
+      size_t stride() const;
+
+      /*! Gets raw data pointer to the first component array.
+       *
+       * @return Const data pointer.
+       */
+      const T* data() const;
+
+      /*! Gets the array holding an element of all matrices.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Const pointer to @c size() elements.
+       */
+      const T* component(const size_t& i, const size_t& j = 1) const;
+
+      /*! Copies a matrix out of the batch.
+       *
+       * @param k Matrix index, 1-based.
+       * @return The matrix.
+       */
+      Matrix<M, N, T> get(const size_t& k) const;
+
+      /*! Views a range of matrices.
+       *
+       * @param k First matrix index, 1-based.
+       * @param size Number of matrices.
+       * @return View of the range.
+       */
+      ConstMatrixBatchView<M, N, T> sub(const size_t& k, const size_t& size) const;
+
+   protected:
+      const T* _data;
+      size_t _size;
+      size_t _stride;
+   };
+
+   /*! View of a batch of MxN matrices stored as arrays of components that
+    * can be written to.
+    */
+   template <size_t M, size_t N, class T> class MatrixBatchView : public ConstMatrixBatchView<M, N, T> {
+   public:
+      using ConstMatrixBatchView<M, N, T>::data;
+      using ConstMatrixBatchView<M, N, T>::component;
+      using ConstMatrixBatchView<M, N, T>::sub;
+
+      /*! Constructs a view.
+       *
+       * @param data Pointer to the first component array.
+       * @param size Number of matrices.
+       * @param stride Distance between consecutive component arrays.
+       */
+      MatrixBatchView(T* data, const size_t& size, const size_t& stride);
+
+      /*! Gets raw data pointer to the first component array.
+       *
+       * @return Data pointer.
+       */
+      T* data();
+
+      /*! Gets the array holding an element of all matrices.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Pointer to @c size() elements.
+       */
+      T* component(const size_t& i, const size_t& j = 1);
+
+      /*! Copies a matrix into the batch.
+       *
+       * @param k Matrix index, 1-based.
+       * @param m Matrix to copy.
+       */
+      template <class C> void set(const size_t& k, const Matrix<M, N, T, C>& m);
+
+      /*! Views a range of matrices.
+       *
+       * @param k First matrix index, 1-based.
+       * @param size Number of matrices.
+       * @return View of the range.
+       */
+      MatrixBatchView<M, N, T> sub(const size_t& k, const size_t& size);
+   };
+
+   /*! Batch of MxN matrices stored as arrays of components. Component arrays
+    * are aligned and padded to the default alignment. Batches are views of
+    * their own storage, so all batch operations accept them.
+    */
+   template <size_t M, size_t N, class T = double> class MatrixBatch : public MatrixBatchView<M, N, T> {
+   public:
+
+      //! Type alias for the container holding matrix elements.
+      typedef std::vector<T, AlignedAllocator<T> > container;
+
+      /*! Constructs a batch.
+       *
+       * @param size Number of matrices.
+       * @param initialize @c true to initialize all elements to zero;
+       *                   otherwise elements are left uninitialized.
+       */
+      explicit MatrixBatch(const size_t& size = 0, const bool& initialize = true);
+
+      /*! Copies the matrices of a view.
+       *
+       * @param view View to copy.
+       */
+      explicit MatrixBatch(const ConstMatrixBatchView<M, N, T>& view);
+
+      /*! Copy constructor.
+       *
+       * @param other Batch to copy.
+       */
+      MatrixBatch(const MatrixBatch& other);
+
+      /*! Move constructor.
+       *
+       * @param other Batch to move.
+       */
+      MatrixBatch(MatrixBatch&& other);
+
+      /*! Copy assignment.
+       *
+       * @param other Batch to copy.
+       * @return This batch.
+       */
+      MatrixBatch& operator =(const MatrixBatch& other);
+
+      /*! Move assignment.
+       *
+       * @param other Batch to move.
+       * @return This batch.
+       */
+      MatrixBatch& operator =(MatrixBatch&& other);
+
+      /*! Changes the number of matrices. Existing matrices are kept and new
+       * ones are initialized to zero.
+       *
+       * @param size New number of matrices.
+       */
+      void resize(const size_t& size);
+
+   private:
+      void attach(const size_t& size);
+
+      container _storage;
+   };
+
+   /*! Batch of N-dimensional vectors stored as arrays of components.
+    */
+   template <size_t N, class T = double> using VectorBatch = MatrixBatch<N, 1, T>;
+
+   //! Number of matrices passed at a time to functions run by @c stream.
+   const size_t StreamChunk = 256;
+
+   /*! Multiplies each matrix of a batch by a matrix. Vectors are multiplied
+    * as columns.
+    *
+    * @param m Matrix to apply.
+    * @param batch Batch of matrices or vectors.
+    * @param out View receiving the products. May be the batch itself.
+    */
+   template <size_t M, size_t N, size_t P, class T, class C> void transform(const Matrix<M, N, T, C>& m, const ConstMatrixBatchView<N, P, T>& batch, MatrixBatchView<M, P, T> out);
+
+   /*! Transforms a batch of points with an affine 4x4 matrix. The points are
+    * extended with w = 1 and the last row of the matrix is ignored.
+    *
+    * @param m Affine transformation matrix.
+    * @param points Batch of points.
+    * @param out View receiving transformed points. May be the batch itself.
+    */
+   template <class T, class C> void transform(const Matrix<4, 4, T, C>& m, const ConstMatrixBatchView<3, 1, T>& points, MatrixBatchView<3, 1, T> out);
+
+   /*! Multiplies matrices of two batches pairwise.
+    *
+    * @param a Batch of left hand side matrices.
+    * @param b Batch of right hand side matrices.
+    * @param out View receiving the products. May be one of the batches.
+    */
+   template <size_t M, size_t N, size_t P, class T> void multiply(const ConstMatrixBatchView<M, N, T>& a, const ConstMatrixBatchView<N, P, T>& b, MatrixBatchView<M, P, T> out);
+
+   /*! Calculates dot products of two batches of vectors pairwise.
+    *
+    * @param a Batch of vectors.
+    * @param b Batch of vectors.
+    * @return Dot products.
+    */
+   template <size_t N, class T> DynamicVector<T> dot(const ConstMatrixBatchView<N, 1, T>& a, const ConstMatrixBatchView<N, 1, T>& b);
+
+   /*! Calculates magnitudes of a batch of vectors.
+    *
+    * @param batch Batch of vectors.
+    * @return Magnitudes of the vectors.
+    */
+   template <size_t N, class T> DynamicVector<T> length(const ConstMatrixBatchView<N, 1, T>& batch);
+
+   /*! Normalizes a batch of vectors.
+    *
+    * @param batch Batch of vectors.
+    * @return Batch of normalized vectors.
+    */
+   template <size_t N, class T> MatrixBatch<N, 1, T> normalize(const ConstMatrixBatchView<N, 1, T>& batch);
+
+   /*! Solves a batch of linear systems, one per matrix. Systems are solved
+    * several at a time with partial pivoting that keeps SIMD lanes in
+    * lockstep, and large batches are split across threads.
+    *
+    * @param a Batch of coefficient matrices.
+    * @param b Batch of matrices to solve.
+    * @return Batch of solved matrices.
+    */
+   template <size_t N, size_t P, class T> MatrixBatch<N, P, T> solve(const ConstMatrixBatchView<N, N, T>& a, const ConstMatrixBatchView<N, P, T>& b);
+
+   /*! Finds out the inverse matrices of a batch.
+    *
+    * @param batch Batch of matrices.
+    * @return Batch of inverted matrices.
+    */
+   template <size_t N, class T> MatrixBatch<N, N, T> inv(const ConstMatrixBatchView<N, N, T>& batch);
+
+   /*! Finds out the determinants of a batch of matrices.
+    *
+    * @param batch Batch of matrices.
+    * @return Determinant values.
+    */
+   template <size_t N, class T> DynamicVector<T> det(const ConstMatrixBatchView<N, N, T>& batch);
+
+   /*! Streams a batch, e.g. one viewing caller-owned component arrays,
+    * through a batch function in chunks of @c StreamChunk matrices. Chunks
+    * stay in cache between the steps of the function and may be processed
+    * in parallel, so the function must be safe to call concurrently.
+    *
+    * @param in Input batch.
+    * @param out Output batch of the same size. May be the input itself.
+    * @param f Function called with a ConstMatrixBatchView<M, N, T> of inputs
+    *          and a MatrixBatchView<P, Q, T> receiving the outputs.
+    */
+   template <size_t M, size_t N, size_t P, size_t Q, class T, class F> void stream(const ConstMatrixBatchView<M, N, T>& in, MatrixBatchView<P, Q, T> out, const F& f);
+
+   /*! Streams matrices of caller-owned arrays through a batch function. The
+    * matrices are gathered @c StreamChunk at a time into batch layout, and
+    * results are scattered back. Chunks may be processed in parallel, so the
+    * function must be safe to call concurrently.
+    *
+    * @param in Input matrices, each stored as M * N contiguous elements in
+    *           column-major order.
+    * @param count Number of matrices.
+    * @param out Output matrices, each stored as P * Q contiguous elements.
+    *            May be the same array as @p in if P * Q equals M * N, since
+    *            every chunk is read before its results are written, and must
+    *            not overlap @p in otherwise.
+    * @param f Function called with a ConstMatrixBatchView<M, N, T> of inputs
+    *          and a MatrixBatchView<P, Q, T> receiving the outputs.
+    */
+   template <size_t M, size_t N, size_t P, size_t Q, class T, class F> void stream(const T* in, const size_t& count, T* out, const F& f);
+}
+
+/*! Multiplies a matrix by each matrix or vector of a batch.
+ *
+ * @param lhs Matrix to apply.
+ * @param rhs Batch of matrices or vectors.
+ * @return Batch of products.
+ */
+template <size_t M, size_t N, size_t P, class T, class C> Math::MatrixBatch<M, P, T> operator *(const Math::Matrix<M, N, T, C>& lhs, const Math::ConstMatrixBatchView<N, P, T>& rhs);
+
+/*! Multiplies matrices of two batches pairwise.
+ *
+ * @param lhs Batch of left hand side matrices.
+ * @param rhs Batch of right hand side matrices.
+ * @return Batch of products.
+ */
+template <size_t M, size_t N, size_t P, class T> Math::MatrixBatch<M, P, T> operator *(const Math::ConstMatrixBatchView<M, N, T>& lhs, const Math::ConstMatrixBatchView<N, P, T>& rhs);
+
+/*! Calculates cross products of two batches of vectors pairwise.
+ *
+ * @param lhs Batch of left hand side vectors.
+ * @param rhs Batch of right hand side vectors.
+ * @return Batch of cross products.
+ */
+template <class T> Math::MatrixBatch<3, 1, T> operator %(const Math::ConstMatrixBatchView<3, 1, T>& lhs, const Math::ConstMatrixBatchView<3, 1, T>& rhs);
+
+#include "batch.inl"
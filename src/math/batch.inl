@@ -0,0 +1,422 @@
+namespace Math {
+
+   namespace Detail {
+
+      /*! Rounds a number of matrices up so that consecutive component arrays
+       * start at the default alignment.
+       */
+      template <class T> inline
+      size_t batch_stride(const size_t& size) {
+         const size_t align = DefaultAlignment >= sizeof(T) ? DefaultAlignment / sizeof(T) : 1;
+         return (size + align - 1) / align * align;
+      }
+   }
+
+   template <size_t M, size_t N, class T> const size_t ConstMatrixBatchView<M, N, T>::Rows;
+   template <size_t M, size_t N, class T> const size_t ConstMatrixBatchView<M, N, T>::Cols;
+
+   template <size_t M, size_t N, class T> inline
+   ConstMatrixBatchView<M, N, T>::ConstMatrixBatchView(const T* data, const size_t& size, const size_t& stride)
+      : _data(data), _size(size), _stride(stride)
+   {
+      assert(stride >= size);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   size_t ConstMatrixBatchView<M, N, T>::size() const {
+      return _size;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   size_t ConstMatrixBatchView<M, N, T>::stride() const {
+      return _stride;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   const T* ConstMatrixBatchView<M, N, T>::data() const {
+      return _data;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   const T* ConstMatrixBatchView<M, N, T>::component(const size_t& i, const size_t& j) const {
+      assert(i > 0 && j > 0 && i <= M && j <= N);
+      return _data + ((j - 1) * M + i - 1) * _stride;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   Matrix<M, N, T> ConstMatrixBatchView<M, N, T>::get(const size_t& k) const {
+      assert(k > 0 && k <= _size);
+      Matrix<M, N, T> out(false);
+
+      for (size_t c = 0; c < M * N; ++c)
+         out.data()[c] = _data[c * _stride + k - 1];
+
+      return out;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   ConstMatrixBatchView<M, N, T> ConstMatrixBatchView<M, N, T>::sub(const size_t& k, const size_t& size) const {
+      assert(k > 0 && k + size - 1 <= _size);
+      return ConstMatrixBatchView<M, N, T>(_data + k - 1, size, _stride);
+   }
+
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatchView<M, N, T>::MatrixBatchView(T* data, const size_t& size, const size_t& stride)
+      : ConstMatrixBatchView<M, N, T>(data, size, stride)
+   {
+
+   }
+
+   template <size_t M, size_t N, class T> inline
+   T* MatrixBatchView<M, N, T>::data() {
+      return const_cast<T*>(this->_data);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   T* MatrixBatchView<M, N, T>::component(const size_t& i, const size_t& j) {
+      return const_cast<T*>(ConstMatrixBatchView<M, N, T>::component(i, j));
+   }
+
+   template <size_t M, size_t N, class T>
+   template <class C> inline
+   void MatrixBatchView<M, N, T>::set(const size_t& k, const Matrix<M, N, T, C>& m) {
+      assert(k > 0 && k <= this->_size);
+      T* out = data();
+
+      for (size_t c = 0; c < M * N; ++c)
+         out[c * this->_stride + k - 1] = m.data()[c];
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatchView<M, N, T> MatrixBatchView<M, N, T>::sub(const size_t& k, const size_t& size) {
+      assert(k > 0 && k + size - 1 <= this->_size);
+      return MatrixBatchView<M, N, T>(data() + k - 1, size, this->_stride);
+   }
+
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatch<M, N, T>::MatrixBatch(const size_t& size, const bool& initialize)
+      : MatrixBatchView<M, N, T>(nullptr, 0, 0)
+   {
+      if (initialize)
+         _storage.resize(M * N * Detail::batch_stride<T>(size), T());
+      else
+         _storage.resize(M * N * Detail::batch_stride<T>(size));
+
+      attach(size);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatch<M, N, T>::MatrixBatch(const ConstMatrixBatchView<M, N, T>& view)
+      : MatrixBatchView<M, N, T>(nullptr, 0, 0), _storage(M * N * Detail::batch_stride<T>(view.size()))
+   {
+      attach(view.size());
+
+      for (size_t c = 0; c < M * N; ++c)
+         std::copy(view.data() + c * view.stride(), view.data() + c * view.stride() + view.size(), this->data() + c * this->_stride);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatch<M, N, T>::MatrixBatch(const MatrixBatch& other)
+      : MatrixBatchView<M, N, T>(nullptr, 0, 0), _storage(other._storage)
+   {
+      attach(other._size);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatch<M, N, T>::MatrixBatch(MatrixBatch&& other)
+      : MatrixBatchView<M, N, T>(nullptr, 0, 0), _storage(std::move(other._storage))
+   {
+      attach(other._size);
+      other._storage.clear();
+      other.attach(0);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatch<M, N, T>& MatrixBatch<M, N, T>::operator =(const MatrixBatch& other) {
+      _storage = other._storage;
+      attach(other._size);
+
+      return *this;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixBatch<M, N, T>& MatrixBatch<M, N, T>::operator =(MatrixBatch&& other) {
+      const size_t size = other._size;
+
+      _storage = std::move(other._storage);
+      attach(size);
+      other._storage.clear();
+      other.attach(0);
+
+      return *this;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   void MatrixBatch<M, N, T>::resize(const size_t& size) {
+      const size_t stride = Detail::batch_stride<T>(size);
+
+      if (stride == this->_stride) {
+         // Components keep their place; only added matrices are cleared.
+         for (size_t c = 0; size > this->_size && c < M * N; ++c)
+            std::fill(_storage.begin() + c * stride + this->_size, _storage.begin() + c * stride + size, T());
+
+         attach(size);
+         return;
+      }
+
+      container storage(M * N * stride, T());
+      const size_t kept = size < this->_size ? size : this->_size;
+
+      for (size_t c = 0; c < M * N; ++c)
+         std::copy(_storage.begin() + c * this->_stride, _storage.begin() + c * this->_stride + kept, storage.begin() + c * stride);
+
+      _storage.swap(storage);
+      attach(size);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   void MatrixBatch<M, N, T>::attach(const size_t& size) {
+      this->_data = _storage.data();
+      this->_size = size;
+      this->_stride = Detail::batch_stride<T>(size);
+   }
+
+   template <size_t M, size_t N, size_t P, class T, class C> inline
+   void transform(const Matrix<M, N, T, C>& m, const ConstMatrixBatchView<N, P, T>& batch, MatrixBatchView<M, P, T> out) {
+      assert(out.size() == batch.size());
+
+      const T* a = m.data();
+      const T* b = batch.data();
+      T* o = out.data();
+      const size_t bs = batch.stride(), os = out.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, batch.size(), M * N * P, [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_transform(end - begin, M, N, P, a, nullptr, b + begin, bs, o + begin, os);
+      });
+   }
+
+   template <class T, class C> inline
+   void transform(const Matrix<4, 4, T, C>& m, const ConstMatrixBatchView<3, 1, T>& points, MatrixBatchView<3, 1, T> out) {
+      assert(out.size() == points.size());
+
+      const Matrix<3, 3, T> a = m.template get_sub<3, 3>(1, 1);
+      const T t[3] = { m(1, 4), m(2, 4), m(3, 4) };
+      const T* b = points.data();
+      T* o = out.data();
+      const size_t bs = points.stride(), os = out.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, points.size(), 12, [&, b, o, bs, os](const size_t& begin, const size_t& end) {
+         kernels.batch_transform(end - begin, 3, 3, 1, a.data(), t, b + begin, bs, o + begin, os);
+      });
+   }
+
+   template <size_t M, size_t N, size_t P, class T> inline
+   void multiply(const ConstMatrixBatchView<M, N, T>& a, const ConstMatrixBatchView<N, P, T>& b, MatrixBatchView<M, P, T> out) {
+      assert(a.size() == b.size() && out.size() == a.size());
+
+      const T* pa = a.data();
+      const T* pb = b.data();
+      T* o = out.data();
+      const size_t as = a.stride(), bs = b.stride(), os = out.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, a.size(), M * N * P, [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_multiply(end - begin, M, N, P, pa + begin, as, pb + begin, bs, o + begin, os);
+      });
+   }
+
+   template <size_t N, class T> inline
+   DynamicVector<T> dot(const ConstMatrixBatchView<N, 1, T>& a, const ConstMatrixBatchView<N, 1, T>& b) {
+      assert(a.size() == b.size());
+
+      DynamicVector<T> out(a.size(), false);
+      const T* pa = a.data();
+      const T* pb = b.data();
+      T* o = out.data();
+      const size_t as = a.stride(), bs = b.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, a.size(), N, [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_dot(end - begin, N, pa + begin, as, pb + begin, bs, o + begin);
+      });
+
+      return std::move(out);
+   }
+
+   template <size_t N, class T> inline
+   DynamicVector<T> length(const ConstMatrixBatchView<N, 1, T>& batch) {
+      DynamicVector<T> out(batch.size(), false);
+      const T* a = batch.data();
+      T* o = out.data();
+      const size_t as = batch.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, batch.size(), N + 1, [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_length(end - begin, N, a + begin, as, o + begin);
+      });
+
+      return std::move(out);
+   }
+
+   template <size_t N, class T> inline
+   MatrixBatch<N, 1, T> normalize(const ConstMatrixBatchView<N, 1, T>& batch) {
+      MatrixBatch<N, 1, T> out(batch.size(), false);
+      const T* a = batch.data();
+      T* o = out.data();
+      const size_t as = batch.stride(), os = out.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, batch.size(), 2 * N + 2, [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_normalize(end - begin, N, a + begin, as, o + begin, os);
+      });
+
+      return std::move(out);
+   }
+
+   template <size_t N, size_t P, class T> inline
+   MatrixBatch<N, P, T> solve(const ConstMatrixBatchView<N, N, T>& a, const ConstMatrixBatchView<N, P, T>& b) {
+      assert(a.size() == b.size());
+
+      MatrixBatch<N, P, T> out(a.size(), false);
+      const T* pa = a.data();
+      const T* pb = b.data();
+      T* o = out.data();
+      const size_t as = a.stride(), bs = b.stride(), os = out.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, a.size(), N * N * (N + P), [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_solve(end - begin, N, P, pa + begin, as, pb + begin, bs, o + begin, os, nullptr);
+      });
+
+      return std::move(out);
+   }
+
+   template <size_t N, class T> inline
+   MatrixBatch<N, N, T> inv(const ConstMatrixBatchView<N, N, T>& batch) {
+      MatrixBatch<N, N, T> out(batch.size(), false);
+      const T* a = batch.data();
+      T* o = out.data();
+      const size_t as = batch.stride(), os = out.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, batch.size(), 2 * N * N * N, [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_solve(end - begin, N, N, a + begin, as, nullptr, 0, o + begin, os, nullptr);
+      });
+
+      return std::move(out);
+   }
+
+   template <size_t N, class T> inline
+   DynamicVector<T> det(const ConstMatrixBatchView<N, N, T>& batch) {
+      DynamicVector<T> out(batch.size(), false);
+      const T* a = batch.data();
+      T* o = out.data();
+      const size_t as = batch.stride();
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+
+      parallel_for(0, batch.size(), N * N * N, [=, &kernels](const size_t& begin, const size_t& end) {
+         kernels.batch_solve(end - begin, N, 0, a + begin, as, nullptr, 0, nullptr, 0, o + begin);
+      });
+
+      return std::move(out);
+   }
+
+   template <size_t M, size_t N, size_t P, size_t Q, class T, class F> inline
+   void stream(const ConstMatrixBatchView<M, N, T>& in, MatrixBatchView<P, Q, T> out, const F& f) {
+      assert(out.size() == in.size());
+
+      const size_t chunks = (in.size() + StreamChunk - 1) / StreamChunk;
+
+      parallel_for(0, chunks, StreamChunk * (M * N + P * Q), [&](const size_t& begin, const size_t& end) {
+         for (size_t c = begin; c < end; ++c) {
+            const size_t first = c * StreamChunk + 1;
+            const size_t size = in.size() - first + 1 < StreamChunk ? in.size() - first + 1 : StreamChunk;
+
+            MatrixBatchView<P, Q, T> results = out.sub(first, size);
+            f(in.sub(first, size), results);
+         }
+      });
+   }
+
+   template <size_t M, size_t N, size_t P, size_t Q, class T, class F> inline
+   void stream(const T* in, const size_t& count, T* out, const F& f) {
+      // A chunk writes where other chunks read unless inputs and outputs
+      // have the same size.
+      assert(M * N == P * Q || in + count * M * N <= out || out + count * P * Q <= in);
+
+      const size_t chunks = (count + StreamChunk - 1) / StreamChunk;
+      const size_t total = count;
+
+      parallel_for(0, chunks, StreamChunk * (M * N + P * Q), [=, &f](const size_t& begin, const size_t& end) {
+         // Chunks of large matrices take too much stack for worker threads,
+         // so every range of chunks allocates its buffers once. They are
+         // not shared per thread, since f may wait for other chunks and run
+         // them on this thread meanwhile.
+         std::vector<T, AlignedAllocator<T> > buffer((M * N + P * Q) * StreamChunk);
+         T* const a = buffer.data();
+         T* const b = a + M * N * StreamChunk;
+
+         for (size_t c = begin; c < end; ++c) {
+            const size_t first = c * StreamChunk;
+            const size_t size = total - first < StreamChunk ? total - first : StreamChunk;
+
+            const T* source = in + first * M * N;
+
+            for (size_t e = 0; e < M * N; ++e) {
+               for (size_t k = 0; k < size; ++k)
+                  a[e * StreamChunk + k] = source[k * M * N + e];
+            }
+
+            MatrixBatchView<P, Q, T> results(b, size, StreamChunk);
+            f(ConstMatrixBatchView<M, N, T>(a, size, StreamChunk), results);
+
+            T* target = out + first * P * Q;
+
+            for (size_t e = 0; e < P * Q; ++e) {
+               for (size_t k = 0; k < size; ++k)
+                  target[k * P * Q + e] = b[e * StreamChunk + k];
+            }
+         }
+      });
+   }
+}
+
+template <size_t M, size_t N, size_t P, class T, class C> inline
+Math::MatrixBatch<M, P, T> operator *(const Math::Matrix<M, N, T, C>& lhs, const Math::ConstMatrixBatchView<N, P, T>& rhs) {
+   Math::MatrixBatch<M, P, T> out(rhs.size(), false);
+
+   Math::transform(lhs, rhs, out);
+
+   return std::move(out);
+}
+
+template <size_t M, size_t N, size_t P, class T> inline
+Math::MatrixBatch<M, P, T> operator *(const Math::ConstMatrixBatchView<M, N, T>& lhs, const Math::ConstMatrixBatchView<N, P, T>& rhs) {
+   Math::MatrixBatch<M, P, T> out(lhs.size(), false);
+
+   Math::multiply(lhs, rhs, out);
+
+   return std::move(out);
+}
+
+template <class T> inline
+Math::MatrixBatch<3, 1, T> operator %(const Math::ConstMatrixBatchView<3, 1, T>& lhs, const Math::ConstMatrixBatchView<3, 1, T>& rhs) {
+   assert(lhs.size() == rhs.size());
+
+   Math::MatrixBatch<3, 1, T> out(lhs.size(), false);
+   const T* a = lhs.data();
+   const T* b = rhs.data();
+   T* o = out.data();
+   const size_t as = lhs.stride(), bs = rhs.stride(), os = out.stride();
+   const Math::SimdKernels<T>& kernels = Math::simd_kernels<T>();
+
+   Math::parallel_for(0, lhs.size(), 9, [=, &kernels](const size_t& begin, const size_t& end) {
+      kernels.batch_cross(end - begin, a + begin, as, b + begin, bs, o + begin, os);
+   });
+
+   return std::move(out);
+}
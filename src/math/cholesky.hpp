@@ -0,0 +1,84 @@
+#pragma once
+
+#include "linearalgebra.hpp"
+
+namespace Math {
+
+   /*! Calculates a Cholesky decomposition m = l * ~l of a symmetric positive
+    * definite matrix in place. Only the lower triangle of @p a is read; it is
+    * overwritten by l. The strictly upper triangle is left untouched.
+    *
+    * @param a Subject matrix, overwritten by its decomposition.
+    * @return @c false if the matrix is not positive definite, in which case
+    *         @p a is partially overwritten.
+    */
+   template <size_t N, class T, class C> bool cholesky(Matrix<N, N, T, C>& a);
+
+   /*! Calculates a Cholesky decomposition m = l * ~l of a symmetric positive
+    * definite matrix. Only the lower triangle of @p m is read.
+    *
+    * @param m Subject matrix.
+    * @param l Lower triangulation element matrix.
+    * @return @c false if the matrix is not positive definite.
+    */
+   template <size_t N, class T, class C> bool cholesky(const Matrix<N, N, T, C>& m, Matrix<N, N, T>& l);
+
+   /*! Calculates a decomposition m = l * d * ~l of a symmetric matrix in
+    * place without pivoting, where l is unit lower triangular and d is
+    * diagonal. Only the lower triangle of @p a is read; its strictly lower
+    * part is overwritten by l and its diagonal by d.
+    *
+    * @param a Subject matrix, overwritten by its decomposition.
+    * @return @c false if a zero pivot was met, in which case @p a is
+    *         partially overwritten.
+    */
+   template <size_t N, class T, class C> bool ldlt(Matrix<N, N, T, C>& a);
+
+   /*! Calculates a decomposition m = l * d * ~l of a symmetric matrix
+    * without pivoting. Only the lower triangle of @p m is read.
+    *
+    * @param m Subject matrix.
+    * @param l Unit lower triangulation element matrix.
+    * @param d Diagonal elements of d.
+    * @return @c false if a zero pivot was met.
+    */
+   template <size_t N, class T, class C> bool ldlt(const Matrix<N, N, T, C>& m, Matrix<N, N, T>& l, Vector<N, T>& d);
+
+   /*! Solves linear equations using a Cholesky decomposition.
+    *
+    * @param l Decomposition from @c cholesky, only its lower triangle is read.
+    * @param b Right hand side columns to solve.
+    * @return Solved columns.
+    */
+   template <size_t N, size_t P, class T, class C, class D> Matrix<N, P, T> solvecholesky(const Matrix<N, N, T, C>& l, const Matrix<N, P, T, D>& b);
+
+   /*! Solves linear equations using an in-place l * d * ~l decomposition.
+    *
+    * @param ld Decomposition from @c ldlt, only its lower triangle is read.
+    * @param b Right hand side columns to solve.
+    * @return Solved columns.
+    */
+   template <size_t N, size_t P, class T, class C, class D> Matrix<N, P, T> solveldlt(const Matrix<N, N, T, C>& ld, const Matrix<N, P, T, D>& b);
+
+   /*! Solves linear equations using a l * d * ~l decomposition.
+    *
+    * @param l Unit lower triangulation element matrix.
+    * @param d Diagonal elements of d.
+    * @param b Right hand side columns to solve.
+    * @return Solved columns.
+    */
+   template <size_t N, size_t P, class T, class C, class D> Matrix<N, P, T> solveldlt(const Matrix<N, N, T, C>& l, const Vector<N, T>& d, const Matrix<N, P, T, D>& b);
+
+   /*! Solves a symmetric positive definite linear system using a Cholesky
+    * decomposition. Only the lower triangle of @p a is read.
+    *
+    * @param a Coefficient matrix.
+    * @param b Right hand side columns to solve.
+    * @param x Receives the solved columns.
+    * @return @c false if @p a is not positive definite, in which case @p x
+    *         is left unchanged.
+    */
+   template <size_t N, size_t P, class T, class C, class D> bool solvespd(const Matrix<N, N, T, C>& a, const Matrix<N, P, T, D>& b, Matrix<N, P, T>& x);
+}
+
+#include "cholesky.inl"
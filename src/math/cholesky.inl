@@ -0,0 +1,326 @@
+namespace Math {
+
+   namespace Detail {
+
+      //! Columns of the panels of blocked symmetric decompositions.
+      const size_t SymmetricBlock = 64;
+
+      /*! Calculates the Cholesky decomposition of the leading columns of a
+       * lower triangle in place, one column at a time. Rows below the
+       * leading n ones are scaled and updated as well, so that an m x n
+       * panel yields both its diagonal block and the block below it.
+       *
+       * @param m Number of rows.
+       * @param n Number of columns, at most @p m.
+       * @param a Lower triangle to decompose.
+       * @param lda Distance between columns of @p a.
+       * @param parallel @c true to allow splitting the work across threads.
+       * @return @c false at the first non-positive pivot.
+       */
+      template <class T> inline
+      bool potf2(const size_t& m, const size_t& n, T* a, const size_t& lda, const bool& parallel) {
+         for (size_t j = 0; j < n; ++j) {
+            T* const col = a + j * lda;
+
+            if (!(col[j] > (T)0))
+               return false;
+
+            col[j] = Math::Sqrt(col[j]);
+            const T r = (T)1 / col[j];
+
+            for (size_t i = j + 1; i < m; ++i)
+               col[i] *= r;
+
+            // Columns of the trailing triangle are updated independently.
+            const auto update = [=](const size_t& begin, const size_t& end) {
+               for (size_t c = begin; c < end; ++c) {
+                  T* const x = a + c * lda;
+                  const T s = col[c];
+
+                  for (size_t i = c; i < m; ++i)
+                     x[i] -= col[i] * s;
+               }
+            };
+
+            if (parallel)
+               parallel_for(j + 1, n, m - j, update);
+            else
+               update(j + 1, n);
+         }
+
+         return true;
+      }
+
+      /*! Calculates the l * d * ~l decomposition of the leading columns of a
+       * lower triangle in place, see @c potf2.
+       *
+       * @return @c false at the first zero pivot.
+       */
+      template <class T> inline
+      bool ldl2(const size_t& m, const size_t& n, T* a, const size_t& lda, const bool& parallel) {
+         for (size_t j = 0; j < n; ++j) {
+            T* const col = a + j * lda;
+
+            if (!(Math::Abs(col[j]) > (T)0))
+               return false;
+
+            const T r = (T)1 / col[j];
+
+            // Columns of the trailing triangle are updated independently.
+            const auto update = [=](const size_t& begin, const size_t& end) {
+               for (size_t c = begin; c < end; ++c) {
+                  T* const x = a + c * lda;
+                  const T s = col[c] * r;
+
+                  for (size_t i = c; i < m; ++i)
+                     x[i] -= col[i] * s;
+               }
+            };
+
+            if (parallel)
+               parallel_for(j + 1, n, m - j, update);
+            else
+               update(j + 1, n);
+
+            for (size_t i = j + 1; i < m; ++i)
+               col[i] *= r;
+         }
+
+         return true;
+      }
+
+      /*! Computes the lower triangle of C -= L * D * ~L, where D is diagonal.
+       * The triangle is processed in column blocks; each block below the
+       * diagonal is a single matrix product.
+       *
+       * @param n Order of C.
+       * @param k Number of columns of L.
+       * @param l Matrix L.
+       * @param lda Distance between columns of @p l.
+       * @param d Diagonal elements of D, or @c nullptr for the identity.
+       * @param incd Distance between elements of @p d.
+       * @param c Matrix C.
+       * @param ldc Distance between columns of @p c.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void syrk_lower(const size_t& n, const size_t& k, const T* l, const size_t& lda, const T* d, const size_t& incd, T* c, const size_t& ldc, const bool& parallel) {
+         // Scaled transpose of L, the right hand side of every product.
+         std::vector<T, AlignedAllocator<T> > w(k * n);
+
+         for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < k; ++j)
+               w[i * k + j] = l[j * lda + i] * (d ? d[j * incd] : (T)1);
+         }
+
+         const T* wt = w.data();
+
+         const auto columns = [=](const size_t& begin, const size_t& end) {
+            std::vector<T> diagonal(SymmetricBlock * SymmetricBlock);
+
+            for (size_t b = begin; b < end; ++b) {
+               const size_t j = b * SymmetricBlock, jb = std::min(SymmetricBlock, n - j);
+
+               // The upper part of the diagonal block must not be written.
+               gemm_serial(jb, jb, k, (T)1, l + j, lda, wt + j * k, k, (T)0, diagonal.data(), jb);
+
+               for (size_t jj = 0; jj < jb; ++jj) {
+                  for (size_t ii = jj; ii < jb; ++ii)
+                     c[(j + jj) * ldc + j + ii] -= diagonal[jj * jb + ii];
+               }
+
+               if (j + jb < n)
+                  gemm_serial(n - j - jb, jb, k, (T)-1, l + j + jb, lda, wt + j * k, k, (T)1, c + j * ldc + j + jb, ldc);
+            }
+         };
+
+         const size_t blocks = (n + SymmetricBlock - 1) / SymmetricBlock;
+
+         if (parallel)
+            parallel_for(0, blocks, n * SymmetricBlock * k / 2, columns);
+         else
+            columns(0, blocks);
+      }
+
+      /*! Calculates a Cholesky or l * d * ~l decomposition of a lower
+       * triangle in place. Large matrices are decomposed in panels of
+       * @c SymmetricBlock columns, and the trailing triangle is updated with
+       * matrix products.
+       *
+       * @param n Order of the matrix.
+       * @param a Lower triangle to decompose.
+       * @param lda Distance between columns of @p a.
+       * @param ldl @c true for l * d * ~l, @c false for Cholesky.
+       * @param parallel @c true to allow splitting the work across threads.
+       * @return @c false if the decomposition failed.
+       */
+      template <class T> inline
+      bool symmetric_factorization(const size_t& n, T* a, const size_t& lda, const bool& ldl, const bool& parallel) {
+         const auto panel = [=](const size_t& m, const size_t& k, T* p) {
+            return ldl ? ldl2(m, k, p, lda, parallel) : potf2(m, k, p, lda, parallel);
+         };
+
+         if (n <= 2 * SymmetricBlock)
+            return panel(n, n, a);
+
+         for (size_t j = 0; j < n; j += SymmetricBlock) {
+            const size_t jb = std::min(SymmetricBlock, n - j), r = j + jb;
+            T* const p = a + j * lda + j;
+
+            if (!panel(n - j, jb, p))
+               return false;
+
+            if (r < n)
+               syrk_lower(n - r, jb, p + jb, lda, ldl ? p : nullptr, lda + 1, a + r * lda + r, lda, parallel);
+         }
+
+         return true;
+      }
+
+      /*! Solves L * D * ~L * X = B in place, one right hand side column at
+       * a time.
+       *
+       * @param n Order of L.
+       * @param nrhs Number of right hand side columns.
+       * @param l Matrix holding L below its diagonal. Its diagonal is used
+       *          too unless @p d is given.
+       * @param lda Distance between columns of @p l.
+       * @param d Diagonal elements of D, or @c nullptr for a Cholesky
+       *          decomposition, where D is the identity and L has a
+       *          non-unit diagonal.
+       * @param incd Distance between elements of @p d.
+       * @param b Right hand sides, overwritten by the solution.
+       * @param ldb Distance between columns of @p b.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void symmetric_solve(const size_t& n, const size_t& nrhs, const T* l, const size_t& lda, const T* d, const size_t& incd, T* b, const size_t& ldb, const bool& parallel) {
+         // Right hand side columns are solved independently.
+         const auto columns = [=](const size_t& begin, const size_t& end) {
+            for (size_t c = begin; c < end; ++c) {
+               T* const x = b + c * ldb;
+
+               // Forward solve L * y = b.
+               for (size_t j = 0; j < n; ++j) {
+                  const T* col = l + j * lda;
+
+                  if (!d)
+                     x[j] /= col[j];
+
+                  const T s = x[j];
+
+                  for (size_t i = j + 1; i < n; ++i)
+                     x[i] -= col[i] * s;
+               }
+
+               if (d) {
+                  for (size_t j = 0; j < n; ++j)
+                     x[j] /= d[j * incd];
+               }
+
+               // Backward solve ~L * x = y.
+               for (size_t j = n; j-- > 0; ) {
+                  const T* col = l + j * lda;
+                  T s = x[j];
+
+                  for (size_t i = j + 1; i < n; ++i)
+                     s -= col[i] * x[i];
+
+                  x[j] = d ? s : s / col[j];
+               }
+            }
+         };
+
+         if (parallel)
+            parallel_for(0, nrhs, n * n, columns);
+         else
+            columns(0, nrhs);
+      }
+   }
+
+   template <size_t N, class T, class C> inline
+   bool cholesky(Matrix<N, N, T, C>& a) {
+      return Detail::symmetric_factorization(N, a.data(), N, false, MatrixChunk<N, N, T>::Location == Heap);
+   }
+
+   template <size_t N, class T, class C> inline
+   bool cholesky(const Matrix<N, N, T, C>& m, Matrix<N, N, T>& l) {
+      Matrix<N, N, T> a(m);
+
+      if (!cholesky(a))
+         return false;
+
+      l = Matrix<N, N, T>();
+
+      for (size_t j = 1; j <= N; ++j) {
+         for (size_t i = j; i <= N; ++i)
+            l(i, j) = a(i, j);
+      }
+
+      return true;
+   }
+
+   template <size_t N, class T, class C> inline
+   bool ldlt(Matrix<N, N, T, C>& a) {
+      return Detail::symmetric_factorization(N, a.data(), N, true, MatrixChunk<N, N, T>::Location == Heap);
+   }
+
+   template <size_t N, class T, class C> inline
+   bool ldlt(const Matrix<N, N, T, C>& m, Matrix<N, N, T>& l, Vector<N, T>& d) {
+      Matrix<N, N, T> a(m);
+
+      if (!ldlt(a))
+         return false;
+
+      l = Matrix<N, N, T>();
+
+      for (size_t j = 1; j <= N; ++j) {
+         l(j, j) = (T)1;
+         d(j, 1) = a(j, j);
+
+         for (size_t i = j + 1; i <= N; ++i)
+            l(i, j) = a(i, j);
+      }
+
+      return true;
+   }
+
+   template <size_t N, size_t P, class T, class C, class D> inline
+   Matrix<N, P, T> solvecholesky(const Matrix<N, N, T, C>& l, const Matrix<N, P, T, D>& b) {
+      Matrix<N, P, T> x(b);
+
+      Detail::symmetric_solve(N, P, l.data(), N, (const T*)nullptr, 0, x.data(), N, MatrixChunk<N, P, T>::Location == Heap);
+
+      return std::move(x);
+   }
+
+   template <size_t N, size_t P, class T, class C, class D> inline
+   Matrix<N, P, T> solveldlt(const Matrix<N, N, T, C>& ld, const Matrix<N, P, T, D>& b) {
+      Matrix<N, P, T> x(b);
+
+      Detail::symmetric_solve(N, P, ld.data(), N, ld.data(), N + 1, x.data(), N, MatrixChunk<N, P, T>::Location == Heap);
+
+      return std::move(x);
+   }
+
+   template <size_t N, size_t P, class T, class C, class D> inline
+   Matrix<N, P, T> solveldlt(const Matrix<N, N, T, C>& l, const Vector<N, T>& d, const Matrix<N, P, T, D>& b) {
+      Matrix<N, P, T> x(b);
+
+      Detail::symmetric_solve(N, P, l.data(), N, d.data(), 1, x.data(), N, MatrixChunk<N, P, T>::Location == Heap);
+
+      return std::move(x);
+   }
+
+   template <size_t N, size_t P, class T, class C, class D> inline
+   bool solvespd(const Matrix<N, N, T, C>& a, const Matrix<N, P, T, D>& b, Matrix<N, P, T>& x) {
+      Matrix<N, N, T> l(a);
+
+      if (!cholesky(l))
+         return false;
+
+      x = solvecholesky(l, b);
+
+      return true;
+   }
+}
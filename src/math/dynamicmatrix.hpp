@@ -0,0 +1,405 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "dynamicmatrixview.hpp"
+#include <vector>
+#include <cassert>
+#include <utility>
+
+namespace Math {
+
+   namespace Detail {
+
+      /*! Result type of arithmetic on run-time sized matrices or views with
+       * the same element type.
+       */
+      template <class L, class R = L, bool = is_dynamic_matrix<L>::value && is_dynamic_matrix<R>::value> struct dynamic_result {
+      };
+
+      template <class L, class R> struct dynamic_result<L, R, true>
+         : std::enable_if<std::is_same<typename L::type, typename R::type>::value, DynamicMatrix<typename L::type> > {
+      };
+   }
+
+   /*! Matrix with dimensions given at run time. Elements are stored in
+    * column-major order like in fixed size matrices, and arithmetic uses the
+    * same kernels. Arithmetic is evaluated eagerly.
+    */
+   template <class T> class DynamicMatrix : public DynamicMatrixBase {
+   public:
+
+      //! Type alias for element types.
+      typedef T type;
+
+      //! Type alias for the container holding matrix elements.
+      typedef std::vector<T, AlignedAllocator<T> > container;
+
+      /*! Constructs an empty matrix.
+       */
+      DynamicMatrix();
+
+      /*! Constructs a matrix.
+       *
+       * @param rows Number of rows.
+       * @param cols Number of columns.
+       * @param initialize @c true to initialize all elements to zero;
+       *                   otherwise elements are left uninitialized.
+       */
+      DynamicMatrix(const size_t& rows, const size_t& cols, const bool& initialize = true);
+
+      /*! Constructs a matrix from range.
+       *
+       * @param rows Number of rows.
+       * @param cols Number of columns.
+       * @param begin Range begin.
+       * @param end Range end.
+       */
+      template <class Iter> DynamicMatrix(const size_t& rows, const size_t& cols, Iter begin, Iter end);
+
+      /*! Constructs a matrix from an intializer list.
+       *
+       * @param rows Number of rows.
+       * @param cols Number of columns.
+       * @param list The initializer list.
+       */
+      DynamicMatrix(const size_t& rows, const size_t& cols, const std::initializer_list<T>& list);
+
+      /*! Copies a matrix.
+       *
+       * @param other Matrix to copy.
+       */
+      DynamicMatrix(const DynamicMatrix<T>& other);
+
+      /*! Takes over the storage of a matrix, leaving it empty.
+       *
+       * @param other Matrix to move.
+       */
+      DynamicMatrix(DynamicMatrix<T>&& other) = default;
+
+      /*! Copies a matrix.
+       *
+       * @param other Matrix to copy.
+       * @return Reference to this matrix.
+       */
+      DynamicMatrix<T>& operator =(const DynamicMatrix<T>& other);
+
+      /*! Takes over the storage of a matrix, leaving it empty.
+       *
+       * @param other Matrix to move.
+       * @return Reference to this matrix.
+       */
+      DynamicMatrix<T>& operator =(DynamicMatrix<T>&& other) = default;
+
+      /*! Converts a fixed size matrix by copying its elements.
+       *
+       * @param other Matrix to convert.
+       */
+      template <size_t M, size_t N, class C> DynamicMatrix(const Matrix<M, N, T, C>& other);
+
+      /*! Converts a fixed size matrix. Storage of heap allocated matrices
+       * using the default allocator is taken over without copying, other
+       * matrices are copied.
+       *
+       * @param other Matrix to convert.
+       */
+      template <size_t M, size_t N, class C> DynamicMatrix(Matrix<M, N, T, C>&& other);
+
+      /*! Copies the elements of a view.
+       *
+       * @param view View to copy.
+       */
+      explicit DynamicMatrix(const ConstDynamicMatrixView<T>& view);
+
+      /*! Constructs a matrix by evaluating a fixed size expression.
+       *
+       * @param expression Expression to evaluate.
+       */
+      template <class E> explicit DynamicMatrix(const MatrixExpression<E>& expression, typename std::enable_if<std::is_same<typename E::type, T>::value>::type* = nullptr);
+
+      /*! Tells the number of rows.
+       *
+       * @return Number of rows.
+       */
+      size_t rows() const;
+
+      /*! Tells the number of columns.
+       *
+       * @return Number of columns.
+       */
+      size_t cols() const;
+
+      /*! Gets raw data pointer to matrix data.
+       *
+       * @return Data pointer to matrix data.
+       */
+      T* data();
+
+      /*! Gets raw data pointer to matrix data.
+       *
+       * @return Const data pointer to matrix data.
+       */
+      const T* data() const;
+
+      /*! Access matrix elements.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Element at given location.
+       */
+      T& operator ()(const size_t& i, const size_t& j);
+
+      /*! Access matrix elements.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Const element at given location.
+       */
+      const T& operator ()(const size_t& i, const size_t& j) const;
+
+      /*! Access flattened matrix elements.
+       *
+       * @param index Element index, 1-based.
+       * @return Element at given location.
+       */
+      T& operator [](const size_t& index);
+
+      /*! Access flattened matrix elements.
+       *
+       * @param index Element index, 1-based.
+       * @return Const element at given location.
+       */
+      const T& operator [](const size_t& index) const;
+
+      /*! Compares equality of two matrix elements.
+       *
+       * @param other Matrix to compare.
+       * @return @c true if matrix dimensions and elements are equal;
+       *         otherwise @c false.
+       */
+      bool operator ==(const DynamicMatrix<T>& other) const;
+
+      /*! Gets matrix column at given location.
+       *
+       * @param column Column index, 1-based.
+       * @return Sub matrix for given column.
+       */
+      DynamicMatrix<T> get_column(const size_t& column) const;
+
+      /*! Gets matrix row at given location.
+       *
+       * @param row Row index, 1-based.
+       * @return Sub matrix for given row.
+       */
+      DynamicMatrix<T> get_row(const size_t& row) const;
+
+      /*! Gets a sub matrix at given location.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @param rows Number of sub matrix rows.
+       * @param cols Number of sub matrix columns.
+       * @return Extracted sub matrix.
+       */
+      DynamicMatrix<T> get_sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) const;
+
+      /*! Sets matrix column.
+       *
+       * @param column Column index, 1-based.
+       * @param m Matrix or view to set to given column.
+       */
+      void set_column(const size_t& column, const ConstDynamicMatrixView<T>& m);
+
+      /*! Sets matrix row.
+       *
+       * @param row Row index, 1-based.
+       * @param m Matrix or view to set to given row.
+       */
+      void set_row(const size_t& row, const ConstDynamicMatrixView<T>& m);
+
+      /*! Sets a sub matrix at given location.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @param matrix Sub marix or view to set.
+       */
+      void set_sub(const size_t& i, const size_t& j, const ConstDynamicMatrixView<T>& matrix);
+
+      /*! Views a matrix column without copying.
+       *
+       * @param column Column index, 1-based.
+       * @return View of the column.
+       */
+      DynamicMatrixView<T> column(const size_t& column);
+
+      /*! Views a matrix column without copying.
+       *
+       * @param column Column index, 1-based.
+       * @return Const view of the column.
+       */
+      ConstDynamicMatrixView<T> column(const size_t& column) const;
+
+      /*! Views a matrix row without copying.
+       *
+       * @param row Row index, 1-based.
+       * @return View of the row.
+       */
+      DynamicMatrixView<T> row(const size_t& row);
+
+      /*! Views a matrix row without copying.
+       *
+       * @param row Row index, 1-based.
+       * @return Const view of the row.
+       */
+      ConstDynamicMatrixView<T> row(const size_t& row) const;
+
+      /*! Views a sub matrix without copying.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @param rows Number of sub matrix rows.
+       * @param cols Number of sub matrix columns.
+       * @return View of the sub matrix.
+       */
+      DynamicMatrixView<T> sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols);
+
+      /*! Views a sub matrix without copying.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @param rows Number of sub matrix rows.
+       * @param cols Number of sub matrix columns.
+       * @return Const view of the sub matrix.
+       */
+      ConstDynamicMatrixView<T> sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) const;
+
+      /*! Gets begin iterator of a matrix.
+       *
+       * @return Begin iterator of the matrix.
+       */
+      typename container::const_iterator begin() const;
+
+      /*! Gets end iterator of a matrix.
+       *
+       * @return End iterator of the matrix.
+       */
+      typename container::const_iterator end() const;
+
+      /*! Takes over the matrix storage, leaving an empty matrix.
+       *
+       * @return Matrix elements in column-major order.
+       */
+      container release();
+
+   private:
+      size_t _rows;
+      size_t _cols;
+      container _data;
+   };
+
+   typedef DynamicMatrix<double> matXd;
+   typedef DynamicMatrix<float> matXf;
+
+   /*! Constructs an identity matrix of given size.
+    *
+    * @param n Number of rows and columns.
+    * @return Identity matrix of size nxn.
+    */
+   template <class T = double> DynamicMatrix<T> eye(const size_t& n);
+
+   /*! Converts a matrix to fixed size. Storage is taken over without copying
+    * when the matrix is passed as an rvalue and the fixed size matrix is heap
+    * allocated.
+    *
+    * @param m Matrix to convert. Must have M rows and N columns.
+    * @return Fixed size matrix.
+    */
+   template <size_t M, size_t N, class T> Matrix<M, N, T> to_fixed(DynamicMatrix<T> m);
+}
+
+/*! Negates a matrix or a view.
+ *
+ * @param m Matrix to negate.
+ * @return Negated matrix.
+ */
+template <class E> typename Math::Detail::dynamic_result<E>::type operator -(const E& m);
+
+/*! Negates a matrix, reusing its storage.
+ *
+ * @param m Matrix to negate.
+ * @return Negated matrix.
+ */
+template <class T> Math::DynamicMatrix<T> operator -(Math::DynamicMatrix<T>&& m);
+
+/*! Transposes a matrix or a view.
+ *
+ * @param m Matrix to transpose.
+ * @return Transposed matrix.
+ */
+template <class E> typename Math::Detail::dynamic_result<E>::type operator ~(const E& m);
+
+/*! Adds two matrices or views.
+ *
+ * @param lhs Left hand side matrix.
+ * @param rhs Right hand side matrix.
+ * @return Added matrix.
+ */
+template <class L, class R> typename Math::Detail::dynamic_result<L, R>::type operator +(const L& lhs, const R& rhs);
+
+/*! Adds two matrices, reusing the storage of the left hand side.
+ *
+ * @param lhs Left hand side matrix.
+ * @param rhs Right hand side matrix or view.
+ * @return Added matrix.
+ */
+template <class T, class R> typename Math::Detail::dynamic_result<Math::DynamicMatrix<T>, R>::type operator +(Math::DynamicMatrix<T>&& lhs, const R& rhs);
+
+/*! Substracts two matrices or views.
+ *
+ * @param lhs Left hand side matrix.
+ * @param rhs Right hand side matrix.
+ * @return Substracted matrix.
+ */
+template <class L, class R> typename Math::Detail::dynamic_result<L, R>::type operator -(const L& lhs, const R& rhs);
+
+/*! Substracts two matrices, reusing the storage of the left hand side.
+ *
+ * @param lhs Left hand side matrix.
+ * @param rhs Right hand side matrix or view.
+ * @return Substracted matrix.
+ */
+template <class T, class R> typename Math::Detail::dynamic_result<Math::DynamicMatrix<T>, R>::type operator -(Math::DynamicMatrix<T>&& lhs, const R& rhs);
+
+/*! Multiplies a matrix or a view with a scalar.
+ *
+ * @param m Matrix to multiply.
+ * @param n Scalar to multiply with.
+ * @return Multiplied matrix.
+ */
+template <class E> typename Math::Detail::dynamic_result<E>::type operator *(const E& m, const typename E::type& n);
+
+/*! Multiplies matrix with a scalar, reusing its storage.
+ *
+ * @param m Matrix to multiply.
+ * @param n Scalar to multiply with.
+ * @return Multiplied matrix.
+ */
+template <class T> Math::DynamicMatrix<T> operator *(Math::DynamicMatrix<T>&& m, const typename Math::DynamicMatrix<T>::type& n);
+
+/*! Multiplies two matrices or views. Views with unit row stride are
+ * multiplied in place; other views are copied first.
+ *
+ * @param lhs Left hand side matrix.
+ * @param rhs Right hand side matrix.
+ * @return Multiplied matrix.
+ */
+template <class L, class R> typename Math::Detail::dynamic_result<L, R>::type operator *(const L& lhs, const R& rhs);
+
+/*! Compares two matrices.
+ *
+ * @param lhs Left hand side matrix to compare.
+ * @param rhs Right hand side matrix to compare.
+ * @return @c true if @p lhs is not equal to @p rhs.
+ */
+template <class T> bool operator !=(const Math::DynamicMatrix<T>& lhs, const Math::DynamicMatrix<T>& rhs);
+
+#include "dynamicmatrix.inl"
@@ -0,0 +1,448 @@
+namespace Math {
+
+   namespace Detail {
+
+      /*! Tells whether a dynamic matrix can take over the storage of a fixed
+       * size matrix chunk.
+       */
+      template <class C, class T> struct is_shared_storage
+         : std::integral_constant<bool, C::Location == Heap && std::is_same<typename C::allocator_type, AlignedAllocator<T> >::value> {
+      };
+
+      /*! Takes over the storage of a heap allocated matrix.
+       */
+      template <size_t M, size_t N, class T, class C> inline
+      typename DynamicMatrix<T>::container matrix_storage(Matrix<M, N, T, C>& m, std::true_type) {
+         return m.storage().release();
+      }
+
+      /*! Copies the elements of a matrix.
+       */
+      template <size_t M, size_t N, class T, class C> inline
+      typename DynamicMatrix<T>::container matrix_storage(const Matrix<M, N, T, C>& m, std::false_type) {
+         MATH_ACCOUNT_COPY(M * N * sizeof(T));
+         return typename DynamicMatrix<T>::container(m.data(), m.data() + M * N);
+      }
+
+      template <size_t M, size_t N, class T> inline
+      Matrix<M, N, T> fixed_matrix(typename DynamicMatrix<T>::container&& data, std::true_type) {
+         return Matrix<M, N, T>(MatrixChunk<M, N, T>(std::move(data)));
+      }
+
+      template <size_t M, size_t N, class T> inline
+      Matrix<M, N, T> fixed_matrix(typename DynamicMatrix<T>::container&& data, std::false_type) {
+         return Matrix<M, N, T>(data.begin(), data.end());
+      }
+
+      /*! Applies an element-wise kernel to contiguous arrays of n elements,
+       * splitting large arrays across threads.
+       *
+       * @param n Number of elements.
+       * @param f Function called with the begin and end of each chunk.
+       */
+      template <class F> inline
+      void elementwise(const size_t& n, const F& f) {
+         parallel_for(0, n, 1, f);
+      }
+
+      /*! Applies a binary element-wise kernel to two equally sized views.
+       * Contiguous views are processed as flat arrays and views with unit
+       * row stride column by column. Other views are copied first.
+       *
+       * @param a Left hand side view.
+       * @param b Right hand side view.
+       * @param p Contiguous output storage.
+       * @param f Kernel called with a count and input and output pointers.
+       */
+      template <class T, class F> inline
+      void elementwise(const ConstDynamicMatrixView<T>& a, const ConstDynamicMatrixView<T>& b, T* p, const F& f) {
+         assert(a.rows() == b.rows() && a.cols() == b.cols());
+         const T* x = a.data();
+         const T* y = b.data();
+         const size_t rows = a.rows(), xs = a.col_stride(), ys = b.col_stride();
+
+         if (a.contiguous() && b.contiguous()) {
+            elementwise(rows * a.cols(), [=](const size_t& begin, const size_t& end) {
+               f(end - begin, x + begin, y + begin, p + begin);
+            });
+         }
+         else if (a.row_stride() == 1 && b.row_stride() == 1) {
+            parallel_for(0, a.cols(), rows, [=](const size_t& begin, const size_t& end) {
+               for (size_t j = begin; j < end; ++j)
+                  f(rows, x + j * xs, y + j * ys, p + j * rows);
+            });
+         }
+         else if (a.row_stride() != 1) {
+            elementwise<T>(DynamicMatrix<T>(a), b, p, f);
+         }
+         else {
+            elementwise<T>(a, DynamicMatrix<T>(b), p, f);
+         }
+      }
+
+      /*! Gets the leading dimension of a view that can be passed to gemm
+       * as is, or copies the view.
+       *
+       * @param v Subject view.
+       * @param tmp Storage for a copy when the view has no unit row stride.
+       * @param p Receives the pointer to the first element.
+       * @return Leading dimension.
+       */
+      template <class T> inline
+      size_t gemm_operand(const ConstDynamicMatrixView<T>& v, DynamicMatrix<T>& tmp, const T*& p) {
+         if (v.row_stride() == 1 || v.rows() <= 1) {
+            p = v.data();
+            return v.cols() > 1 ? v.col_stride() : v.rows();
+         }
+
+         tmp = DynamicMatrix<T>(v);
+         p = tmp.data();
+         return tmp.rows();
+      }
+   }
+
+   template <class T> inline
+   DynamicMatrix<T>::DynamicMatrix() : _rows(0), _cols(0) {
+
+   }
+
+   template <class T> inline
+   DynamicMatrix<T>::DynamicMatrix(const size_t& rows, const size_t& cols, const bool& initialize)
+      : _rows(rows), _cols(cols), _data(initialize ? container(rows * cols, (T)0) : container(rows * cols))
+   {
+
+   }
+
+   template <class T>
+   template <class Iter> inline
+   DynamicMatrix<T>::DynamicMatrix(const size_t& rows, const size_t& cols, Iter begin, Iter end) : _rows(rows), _cols(cols), _data(rows * cols) {
+      size_t i = 0;
+      for (Iter it = begin; it != end; ++it)
+         _data[i++] = (T)*it;
+   }
+
+   template <class T> inline
+   DynamicMatrix<T>::DynamicMatrix(const size_t& rows, const size_t& cols, const std::initializer_list<T>& list) : _rows(rows), _cols(cols), _data(rows * cols, (T)0) {
+      assert(list.size() <= rows * cols);
+
+      size_t i = 0;
+      for (auto &item : list)
+         _data[i++] = item;
+   }
+
+   template <class T> inline
+   DynamicMatrix<T>::DynamicMatrix(const ConstDynamicMatrixView<T>& view)
+      : _rows(view.rows()), _cols(view.cols()), _data(view.rows() * view.cols())
+   {
+      Detail::strided_copy(view, _data.data(), 1, _rows);
+      MATH_ACCOUNT_COPY(_data.size() * sizeof(T));
+   }
+
+   template <class T> inline
+   DynamicMatrix<T>::DynamicMatrix(const DynamicMatrix<T>& other) : _rows(other._rows), _cols(other._cols), _data(other._data) {
+      MATH_ACCOUNT_COPY(_data.size() * sizeof(T));
+   }
+
+   template <class T> inline
+   DynamicMatrix<T>& DynamicMatrix<T>::operator =(const DynamicMatrix<T>& other) {
+      _rows = other._rows;
+      _cols = other._cols;
+      _data = other._data;
+      MATH_ACCOUNT_COPY(_data.size() * sizeof(T));
+      return *this;
+   }
+
+   template <class T>
+   template <size_t M, size_t N, class C> inline
+   DynamicMatrix<T>::DynamicMatrix(const Matrix<M, N, T, C>& other)
+      : _rows(M), _cols(N), _data(Detail::matrix_storage(other, std::false_type()))
+   {
+
+   }
+
+   template <class T>
+   template <size_t M, size_t N, class C> inline
+   DynamicMatrix<T>::DynamicMatrix(Matrix<M, N, T, C>&& other)
+      : _rows(M), _cols(N), _data(Detail::matrix_storage(other, Detail::is_shared_storage<C, T>()))
+   {
+
+   }
+
+   template <class T>
+   template <class E> inline
+   DynamicMatrix<T>::DynamicMatrix(const MatrixExpression<E>& expression, typename std::enable_if<std::is_same<typename E::type, T>::value>::type*)
+      : _rows(E::Rows), _cols(E::Cols), _data(E::Rows * E::Cols)
+   {
+      Detail::evaluate(expression.derived(), data(), std::true_type());
+   }
+
+   template <class T> inline
+   size_t DynamicMatrix<T>::rows() const {
+      return _rows;
+   }
+
+   template <class T> inline
+   size_t DynamicMatrix<T>::cols() const {
+      return _cols;
+   }
+
+   template <class T> inline
+   T* DynamicMatrix<T>::data() {
+      return _data.data();
+   }
+
+   template <class T> inline
+   const T* DynamicMatrix<T>::data() const {
+      return _data.data();
+   }
+
+   template <class T> inline
+   T& DynamicMatrix<T>::operator ()(const size_t& i, const size_t& j) {
+      assert(i > 0 && j > 0 && i <= _rows && j <= _cols);
+      return _data[(j - 1) * _rows + (i - 1)];
+   }
+
+   template <class T> inline
+   const T& DynamicMatrix<T>::operator ()(const size_t& i, const size_t& j) const {
+      assert(i > 0 && j > 0 && i <= _rows && j <= _cols);
+      return _data[(j - 1) * _rows + (i - 1)];
+   }
+
+   template <class T> inline
+   T& DynamicMatrix<T>::operator [](const size_t& index) {
+      assert(index > 0 && index <= _data.size());
+      return _data[index - 1];
+   }
+
+   template <class T> inline
+   const T& DynamicMatrix<T>::operator [](const size_t& index) const {
+      assert(index > 0 && index <= _data.size());
+      return _data[index - 1];
+   }
+
+   template <class T> inline
+   bool DynamicMatrix<T>::operator ==(const DynamicMatrix<T>& other) const {
+      return _rows == other._rows && _cols == other._cols && _data == other._data;
+   }
+
+   template <class T> inline
+   DynamicMatrix<T> DynamicMatrix<T>::get_column(const size_t& column) const {
+      MATH_ACCOUNT_CALL(Extract, 0);
+      return DynamicMatrix<T>(this->column(column));
+   }
+
+   template <class T> inline
+   DynamicMatrix<T> DynamicMatrix<T>::get_row(const size_t& row) const {
+      MATH_ACCOUNT_CALL(Extract, 0);
+      return DynamicMatrix<T>(this->row(row));
+   }
+
+   template <class T> inline
+   DynamicMatrix<T> DynamicMatrix<T>::get_sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) const {
+      MATH_ACCOUNT_CALL(Extract, 0);
+      return DynamicMatrix<T>(sub(i, j, rows, cols));
+   }
+
+   template <class T> inline
+   void DynamicMatrix<T>::set_column(const size_t& column, const ConstDynamicMatrixView<T>& m) {
+      assert(m.rows() * m.cols() == _rows);
+      this->column(column) = m.rows() == _rows ? m : m.transpose();
+   }
+
+   template <class T> inline
+   void DynamicMatrix<T>::set_row(const size_t& row, const ConstDynamicMatrixView<T>& m) {
+      assert(m.rows() * m.cols() == _cols);
+      this->row(row) = m.cols() == _cols ? m : m.transpose();
+   }
+
+   template <class T> inline
+   void DynamicMatrix<T>::set_sub(const size_t& i, const size_t& j, const ConstDynamicMatrixView<T>& matrix) {
+      sub(i, j, matrix.rows(), matrix.cols()) = matrix;
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T> DynamicMatrix<T>::column(const size_t& column) {
+      return sub(1, column, _rows, 1);
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T> DynamicMatrix<T>::column(const size_t& column) const {
+      return sub(1, column, _rows, 1);
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T> DynamicMatrix<T>::row(const size_t& row) {
+      return sub(row, 1, 1, _cols);
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T> DynamicMatrix<T>::row(const size_t& row) const {
+      return sub(row, 1, 1, _cols);
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T> DynamicMatrix<T>::sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) {
+      return DynamicMatrixView<T>(*this).sub(i, j, rows, cols);
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T> DynamicMatrix<T>::sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) const {
+      return ConstDynamicMatrixView<T>(*this).sub(i, j, rows, cols);
+   }
+
+   template <class T> inline
+   typename DynamicMatrix<T>::container::const_iterator DynamicMatrix<T>::begin() const {
+      return _data.cbegin();
+   }
+
+   template <class T> inline
+   typename DynamicMatrix<T>::container::const_iterator DynamicMatrix<T>::end() const {
+      return _data.cend();
+   }
+
+   template <class T> inline
+   typename DynamicMatrix<T>::container DynamicMatrix<T>::release() {
+      _rows = _cols = 0;
+      return std::move(_data);
+   }
+
+
+   template <class T> inline
+   DynamicMatrix<T> eye(const size_t& n) {
+      DynamicMatrix<T> out(n, n);
+
+      for (size_t i = 1; i <= n; ++i)
+         out(i, i) = (T)1;
+
+      return std::move(out);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   Matrix<M, N, T> to_fixed(DynamicMatrix<T> m) {
+      assert(m.rows() == M && m.cols() == N);
+      return Detail::fixed_matrix<M, N, T>(m.release(), std::integral_constant<bool, MatrixChunk<M, N, T>::Location == Heap>());
+   }
+}
+
+
+template <class E> inline
+typename Math::Detail::dynamic_result<E>::type operator -(const E& m) {
+   return -Math::DynamicMatrix<typename E::type>(m);
+}
+
+template <class T> inline
+Math::DynamicMatrix<T> operator -(Math::DynamicMatrix<T>&& m) {
+   T* p = m.data();
+
+   Math::Detail::elementwise(m.rows() * m.cols(), [p](const size_t& begin, const size_t& end) {
+      Math::simd_kernels<T>().negate(end - begin, p + begin, p + begin);
+   });
+
+   return std::move(m);
+}
+
+template <class E> inline
+typename Math::Detail::dynamic_result<E>::type operator ~(const E& m) {
+   return Math::DynamicMatrix<typename E::type>(Math::ConstDynamicMatrixView<typename E::type>(m).transpose());
+}
+
+template <class L, class R> inline
+typename Math::Detail::dynamic_result<L, R>::type operator +(const L& lhs, const R& rhs) {
+   typedef typename L::type T;
+   const Math::ConstDynamicMatrixView<T> a(lhs), b(rhs);
+   Math::DynamicMatrix<T> out(a.rows(), a.cols(), false);
+
+   Math::Detail::elementwise(a, b, out.data(), [](const size_t& n, const T* x, const T* y, T* p) {
+      Math::simd_kernels<T>().add(n, x, y, p);
+   });
+
+   return std::move(out);
+}
+
+template <class T, class R> inline
+typename Math::Detail::dynamic_result<Math::DynamicMatrix<T>, R>::type operator +(Math::DynamicMatrix<T>&& lhs, const R& rhs) {
+   const Math::ConstDynamicMatrixView<T> b(rhs);
+   T* p = lhs.data();
+
+   // Elements of a view into the left hand side could be overwritten before
+   // they are read.
+   if (b.references(p, p + lhs.rows() * lhs.cols()) && !(b.data() == p && b.contiguous()))
+      return static_cast<const Math::DynamicMatrix<T>&>(lhs) + rhs;
+
+   Math::Detail::elementwise<T>(lhs, b, p, [](const size_t& n, const T* x, const T* y, T* p) {
+      Math::simd_kernels<T>().add(n, x, y, p);
+   });
+
+   return std::move(lhs);
+}
+
+template <class L, class R> inline
+typename Math::Detail::dynamic_result<L, R>::type operator -(const L& lhs, const R& rhs) {
+   typedef typename L::type T;
+   const Math::ConstDynamicMatrixView<T> a(lhs), b(rhs);
+   Math::DynamicMatrix<T> out(a.rows(), a.cols(), false);
+
+   Math::Detail::elementwise(a, b, out.data(), [](const size_t& n, const T* x, const T* y, T* p) {
+      Math::simd_kernels<T>().subtract(n, x, y, p);
+   });
+
+   return std::move(out);
+}
+
+template <class T, class R> inline
+typename Math::Detail::dynamic_result<Math::DynamicMatrix<T>, R>::type operator -(Math::DynamicMatrix<T>&& lhs, const R& rhs) {
+   const Math::ConstDynamicMatrixView<T> b(rhs);
+   T* p = lhs.data();
+
+   // Elements of a view into the left hand side could be overwritten before
+   // they are read.
+   if (b.references(p, p + lhs.rows() * lhs.cols()) && !(b.data() == p && b.contiguous()))
+      return static_cast<const Math::DynamicMatrix<T>&>(lhs) - rhs;
+
+   Math::Detail::elementwise<T>(lhs, b, p, [](const size_t& n, const T* x, const T* y, T* p) {
+      Math::simd_kernels<T>().subtract(n, x, y, p);
+   });
+
+   return std::move(lhs);
+}
+
+template <class E> inline
+typename Math::Detail::dynamic_result<E>::type operator *(const E& m, const typename E::type& n) {
+   return Math::DynamicMatrix<typename E::type>(m) * n;
+}
+
+template <class T> inline
+Math::DynamicMatrix<T> operator *(Math::DynamicMatrix<T>&& m, const typename Math::DynamicMatrix<T>::type& n) {
+   T* p = m.data();
+
+   Math::Detail::elementwise(m.rows() * m.cols(), [=](const size_t& begin, const size_t& end) {
+      Math::simd_kernels<T>().scale(end - begin, p + begin, n, p + begin);
+   });
+
+   return std::move(m);
+}
+
+template <class L, class R> inline
+typename Math::Detail::dynamic_result<L, R>::type operator *(const L& lhs, const R& rhs) {
+   typedef typename L::type T;
+   MATH_PERF_SCOPE("multiply");
+   MATH_ACCOUNT_CALL(Math::Multiply, 2 * lhs.rows() * lhs.cols() * rhs.cols());
+
+   const Math::ConstDynamicMatrixView<T> a(lhs), b(rhs);
+   assert(a.cols() == b.rows());
+   Math::DynamicMatrix<T> out(a.rows(), b.cols(), false), ta, tb;
+   const T* pa;
+   const T* pb;
+
+   const size_t lda = Math::Detail::gemm_operand(a, ta, pa);
+   const size_t ldb = Math::Detail::gemm_operand(b, tb, pb);
+
+   Math::gemm(a.rows(), b.cols(), a.cols(), (T)1, pa, lda, pb, ldb, (T)0, out.data(), out.rows());
+
+   return std::move(out);
+}
+
+template <class T> inline
+bool operator !=(const Math::DynamicMatrix<T>& lhs, const Math::DynamicMatrix<T>& rhs) {
+   return !(lhs == rhs);
+}
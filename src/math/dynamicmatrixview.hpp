@@ -0,0 +1,239 @@
+#pragma once
+
+#include "expression.hpp"
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace Math {
+
+   template <class T> class DynamicMatrix;
+
+   //! Tag base of run-time sized matrices and views.
+   class DynamicMatrixBase {
+   };
+
+   /*! Tells whether a type is a run-time sized matrix or view.
+    */
+   template <class E> struct is_dynamic_matrix : std::is_base_of<DynamicMatrixBase, E> {
+   };
+
+   /*! Read-only view of existing matrix storage with dimensions given at run
+    * time. Element (i, j) is located at offset i * row stride + j * column
+    * stride (0-based), so rows, columns, sub matrices and transposes of a
+    * matrix can be viewed without copying.
+    */
+   template <class T> class ConstDynamicMatrixView : public DynamicMatrixBase {
+   public:
+
+      //! Type alias for element types.
+      typedef T type;
+
+      /*! Constructs a view.
+       *
+       * @param data Pointer to the first element.
+       * @param rows Number of rows.
+       * @param cols Number of columns.
+       * @param rowStride Distance between elements of consecutive rows.
+       * @param colStride Distance between elements of consecutive columns.
+       */
+      ConstDynamicMatrixView(const T* data, const size_t& rows, const size_t& cols, const size_t& rowStride, const size_t& colStride);
+
+      /*! Constructs a view of a whole matrix.
+       *
+       * @param m Matrix to view.
+       */
+      ConstDynamicMatrixView(const DynamicMatrix<T>& m);
+
+      /*! Tells the number of rows.
+       *
+       * @return Number of rows.
+       */
+      size_t rows() const;
+
+      /*! Tells the number of columns.
+       *
+       * @return Number of columns.
+       */
+      size_t cols() const;
+
+      /*! Gets raw data pointer to the first element.
+       *
+       * @return Const data pointer to the first element.
+       */
+      const T* data() const;
+
+      /*! Tells the distance between elements of consecutive rows.
+       *
+       * @return Row stride.
+       */
+      size_t row_stride() const;
+
+      /*! Tells the distance between elements of consecutive columns.
+       *
+       * @return Column stride.
+       */
+      size_t col_stride() const;
+
+      /*! Tells whether the viewed elements are contiguous in column-major
+       * order.
+       *
+       * @return @c true if the view can be used as a dense matrix.
+       */
+      bool contiguous() const;
+
+      /*! Access view elements.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Const element at given location.
+       */
+      const T& operator ()(const size_t& i, const size_t& j) const;
+
+      /*! Views a row.
+       *
+       * @param row Row index, 1-based.
+       * @return View of the row.
+       */
+      ConstDynamicMatrixView<T> row(const size_t& row) const;
+
+      /*! Views a column.
+       *
+       * @param column Column index, 1-based.
+       * @return View of the column.
+       */
+      ConstDynamicMatrixView<T> column(const size_t& column) const;
+
+      /*! Views a sub matrix.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @param rows Number of sub matrix rows.
+       * @param cols Number of sub matrix columns.
+       * @return View of the sub matrix.
+       */
+      ConstDynamicMatrixView<T> sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) const;
+
+      /*! Views the transpose.
+       *
+       * @return Transposed view.
+       */
+      ConstDynamicMatrixView<T> transpose() const;
+
+      /*! Tells whether the viewed storage overlaps given storage.
+       *
+       * @param begin Storage begin.
+       * @param end Storage end.
+       * @return @c true if the storage overlaps viewed elements.
+       */
+      bool references(const void* begin, const void* end) const;
+
+   protected:
+
+      //! Gets the end of the viewed storage range.
+      const T* storage_end() const;
+
+      const T* _data;
+      size_t _rows;
+      size_t _cols;
+      size_t _rowStride;
+      size_t _colStride;
+   };
+
+   /*! View of existing matrix storage with dimensions given at run time that
+    * can be assigned to. Assigning to a view writes the viewed elements.
+    */
+   template <class T> class DynamicMatrixView : public ConstDynamicMatrixView<T> {
+   public:
+      using ConstDynamicMatrixView<T>::data;
+      using ConstDynamicMatrixView<T>::operator ();
+      using ConstDynamicMatrixView<T>::row;
+      using ConstDynamicMatrixView<T>::column;
+      using ConstDynamicMatrixView<T>::sub;
+      using ConstDynamicMatrixView<T>::transpose;
+
+      /*! Constructs a view.
+       *
+       * @param data Pointer to the first element.
+       * @param rows Number of rows.
+       * @param cols Number of columns.
+       * @param rowStride Distance between elements of consecutive rows.
+       * @param colStride Distance between elements of consecutive columns.
+       */
+      DynamicMatrixView(T* data, const size_t& rows, const size_t& cols, const size_t& rowStride, const size_t& colStride);
+
+      /*! Constructs a view of a whole matrix.
+       *
+       * @param m Matrix to view.
+       */
+      DynamicMatrixView(DynamicMatrix<T>& m);
+
+      /*! Copies elements of another view into the viewed elements.
+       *
+       * @param other View to copy. Must have the same dimensions.
+       * @return This view.
+       */
+      DynamicMatrixView& operator =(const DynamicMatrixView& other);
+
+      /*! Copies elements of a matrix or a view into the viewed elements.
+       *
+       * @param other Matrix or view to copy. Must have the same dimensions.
+       * @return This view.
+       */
+      DynamicMatrixView& operator =(const ConstDynamicMatrixView<T>& other);
+
+      /*! Gets raw data pointer to the first element.
+       *
+       * @return Data pointer to the first element.
+       */
+      T* data();
+
+      /*! Access view elements.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Element at given location.
+       */
+      T& operator ()(const size_t& i, const size_t& j);
+
+      /*! Views a row.
+       *
+       * @param row Row index, 1-based.
+       * @return View of the row.
+       */
+      DynamicMatrixView<T> row(const size_t& row);
+
+      /*! Views a column.
+       *
+       * @param column Column index, 1-based.
+       * @return View of the column.
+       */
+      DynamicMatrixView<T> column(const size_t& column);
+
+      /*! Views a sub matrix.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @param rows Number of sub matrix rows.
+       * @param cols Number of sub matrix columns.
+       * @return View of the sub matrix.
+       */
+      DynamicMatrixView<T> sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols);
+
+      /*! Views the transpose.
+       *
+       * @return Transposed view.
+       */
+      DynamicMatrixView<T> transpose();
+   };
+
+   /*! Swaps the elements of two equally sized views, e.g. two rows of a
+    * matrix.
+    *
+    * @param a First view.
+    * @param b Second view.
+    */
+   template <class T> void swap(DynamicMatrixView<T> a, DynamicMatrixView<T> b);
+}
+
+#include "dynamicmatrixview.inl"
@@ -0,0 +1,184 @@
+namespace Math {
+
+   namespace Detail {
+
+      /*! Copies the elements of a view to strided storage, splitting large
+       * views across threads by columns.
+       *
+       * @param src View to copy.
+       * @param out Pointer to the first destination element.
+       * @param rowStride Destination row stride.
+       * @param colStride Destination column stride.
+       */
+      template <class T> inline
+      void strided_copy(const ConstDynamicMatrixView<T>& src, T* out, const size_t& rowStride, const size_t& colStride) {
+         const T* in = src.data();
+         const size_t rows = src.rows(), irs = src.row_stride(), ics = src.col_stride();
+
+         parallel_for(0, src.cols(), rows, [=](const size_t& begin, const size_t& end) {
+            for (size_t j = begin; j < end; ++j) {
+               for (size_t i = 0; i < rows; ++i)
+                  out[i * rowStride + j * colStride] = in[i * irs + j * ics];
+            }
+         });
+      }
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T>::ConstDynamicMatrixView(const T* data, const size_t& rows, const size_t& cols, const size_t& rowStride, const size_t& colStride)
+      : _data(data), _rows(rows), _cols(cols), _rowStride(rowStride), _colStride(colStride)
+   {
+
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T>::ConstDynamicMatrixView(const DynamicMatrix<T>& m)
+      : _data(m.data()), _rows(m.rows()), _cols(m.cols()), _rowStride(1), _colStride(m.rows())
+   {
+
+   }
+
+   template <class T> inline
+   size_t ConstDynamicMatrixView<T>::rows() const {
+      return _rows;
+   }
+
+   template <class T> inline
+   size_t ConstDynamicMatrixView<T>::cols() const {
+      return _cols;
+   }
+
+   template <class T> inline
+   const T* ConstDynamicMatrixView<T>::data() const {
+      return _data;
+   }
+
+   template <class T> inline
+   size_t ConstDynamicMatrixView<T>::row_stride() const {
+      return _rowStride;
+   }
+
+   template <class T> inline
+   size_t ConstDynamicMatrixView<T>::col_stride() const {
+      return _colStride;
+   }
+
+   template <class T> inline
+   bool ConstDynamicMatrixView<T>::contiguous() const {
+      return (_rowStride == 1 || _rows <= 1) && (_colStride == _rows || _cols <= 1);
+   }
+
+   template <class T> inline
+   const T& ConstDynamicMatrixView<T>::operator ()(const size_t& i, const size_t& j) const {
+      assert(i > 0 && j > 0 && i <= _rows && j <= _cols);
+      return _data[(i - 1) * _rowStride + (j - 1) * _colStride];
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T> ConstDynamicMatrixView<T>::row(const size_t& row) const {
+      return sub(row, 1, 1, _cols);
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T> ConstDynamicMatrixView<T>::column(const size_t& column) const {
+      return sub(1, column, _rows, 1);
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T> ConstDynamicMatrixView<T>::sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) const {
+      assert(i > 0 && j > 0 && i + rows - 1 <= _rows && j + cols - 1 <= _cols);
+      return ConstDynamicMatrixView<T>(_data + (i - 1) * _rowStride + (j - 1) * _colStride, rows, cols, _rowStride, _colStride);
+   }
+
+   template <class T> inline
+   ConstDynamicMatrixView<T> ConstDynamicMatrixView<T>::transpose() const {
+      return ConstDynamicMatrixView<T>(_data, _cols, _rows, _colStride, _rowStride);
+   }
+
+   template <class T> inline
+   bool ConstDynamicMatrixView<T>::references(const void* begin, const void* end) const {
+      return Detail::overlaps(_data, storage_end(), begin, end);
+   }
+
+   template <class T> inline
+   const T* ConstDynamicMatrixView<T>::storage_end() const {
+      if (_rows == 0 || _cols == 0)
+         return _data;
+
+      return _data + (_rows - 1) * _rowStride + (_cols - 1) * _colStride + 1;
+   }
+
+
+   template <class T> inline
+   DynamicMatrixView<T>::DynamicMatrixView(T* data, const size_t& rows, const size_t& cols, const size_t& rowStride, const size_t& colStride)
+      : ConstDynamicMatrixView<T>(data, rows, cols, rowStride, colStride)
+   {
+
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T>::DynamicMatrixView(DynamicMatrix<T>& m)
+      : ConstDynamicMatrixView<T>(m)
+   {
+
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T>& DynamicMatrixView<T>::operator =(const DynamicMatrixView& other) {
+      return *this = static_cast<const ConstDynamicMatrixView<T>&>(other);
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T>& DynamicMatrixView<T>::operator =(const ConstDynamicMatrixView<T>& other) {
+      assert(other.rows() == this->_rows && other.cols() == this->_cols);
+
+      // Overlapping elements may be overwritten before they are read.
+      if (other.references(this->_data, this->storage_end()))
+         Detail::strided_copy<T>(DynamicMatrix<T>(other), data(), this->_rowStride, this->_colStride);
+      else
+         Detail::strided_copy(other, data(), this->_rowStride, this->_colStride);
+
+      return *this;
+   }
+
+   template <class T> inline
+   T* DynamicMatrixView<T>::data() {
+      return const_cast<T*>(this->_data);
+   }
+
+   template <class T> inline
+   T& DynamicMatrixView<T>::operator ()(const size_t& i, const size_t& j) {
+      return const_cast<T&>(ConstDynamicMatrixView<T>::operator ()(i, j));
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T> DynamicMatrixView<T>::row(const size_t& row) {
+      return sub(row, 1, 1, this->_cols);
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T> DynamicMatrixView<T>::column(const size_t& column) {
+      return sub(1, column, this->_rows, 1);
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T> DynamicMatrixView<T>::sub(const size_t& i, const size_t& j, const size_t& rows, const size_t& cols) {
+      assert(i > 0 && j > 0 && i + rows - 1 <= this->_rows && j + cols - 1 <= this->_cols);
+      return DynamicMatrixView<T>(data() + (i - 1) * this->_rowStride + (j - 1) * this->_colStride, rows, cols, this->_rowStride, this->_colStride);
+   }
+
+   template <class T> inline
+   DynamicMatrixView<T> DynamicMatrixView<T>::transpose() {
+      return DynamicMatrixView<T>(data(), this->_cols, this->_rows, this->_colStride, this->_rowStride);
+   }
+
+   template <class T> inline
+   void swap(DynamicMatrixView<T> a, DynamicMatrixView<T> b) {
+      assert(a.rows() == b.rows() && a.cols() == b.cols());
+
+      for (size_t j = 1; j <= a.cols(); ++j) {
+         for (size_t i = 1; i <= a.rows(); ++i)
+            std::swap(a(i, j), b(i, j));
+      }
+   }
+}
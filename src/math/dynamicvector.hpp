@@ -0,0 +1,92 @@
+#pragma once
+
+#include "dynamicmatrix.hpp"
+#include "vector.hpp"
+#include "functions.hpp"
+
+namespace Math {
+
+   /*! Column vector with its dimension given at run time.
+    */
+   template <class T> class DynamicVector : public DynamicMatrix<T> {
+   public:
+
+      /*! Constructs an empty vector.
+       */
+      DynamicVector();
+
+      /*! Constructs a vector.
+       *
+       * @param n Number of elements.
+       * @param initialize @c true to initialize all elements to zero;
+       *                   otherwise elements are left uninitialized.
+       */
+      explicit DynamicVector(const size_t& n, const bool& initialize = true);
+
+      /*! Constructs a vector from an intializer list.
+       *
+       * @param list The initializer list.
+       */
+      DynamicVector(const std::initializer_list<T>& list);
+
+      /*! Converts a single column matrix to vector.
+       *
+       * @param other Matrix to convert.
+       */
+      DynamicVector(const DynamicMatrix<T>& other);
+
+      /*! Converts a single column matrix to vector, taking over its storage.
+       *
+       * @param other Matrix to convert.
+       */
+      DynamicVector(DynamicMatrix<T>&& other);
+
+      /*! Copies the elements of a single column view.
+       *
+       * @param view View to copy.
+       */
+      explicit DynamicVector(const ConstDynamicMatrixView<T>& view);
+
+      /*! Converts a fixed size vector. Storage of heap allocated vectors is
+       * taken over without copying when the vector is passed as an rvalue.
+       *
+       * @param other Vector to convert.
+       */
+      template <size_t N, class C> DynamicVector(Matrix<N, 1, T, C> other);
+   };
+
+   typedef DynamicVector<double> vecXd;
+   typedef DynamicVector<float> vecXf;
+
+   /*! Normalizes a vector.
+    *
+    * @param vector Subject vector.
+    * @return A normalized vector.
+    */
+   template <class T> DynamicVector<T> normalize(const DynamicVector<T>& vector);
+
+   /*! Find outs the magnitude of a vector.
+    *
+    * @return Magnitude of the vector.
+    */
+   template <class T> T length(const DynamicVector<T>& vector);
+
+   /*! Converts a vector to fixed size. Storage is taken over without copying
+    * when the vector is passed as an rvalue and the fixed size vector is heap
+    * allocated.
+    *
+    * @param v Vector to convert. Must have N elements.
+    * @return Fixed size vector.
+    */
+   template <size_t N, class T> Vector<N, T> to_fixed(DynamicVector<T> v);
+}
+
+/*! Calculates a dot product of two vectors.
+ *
+ * @param lhs Left hand side vector.
+ * @param rhs Right hand side vector.
+ * @return Dot product result.
+ */
+template <class T> T operator *(const Math::DynamicVector<T>& lhs, const Math::DynamicVector<T>& rhs);
+
+#include "dynamicvector.inl"
@@ -0,0 +1,59 @@
+namespace Math {
+
+   template <class T> inline
+   DynamicVector<T>::DynamicVector() : DynamicMatrix<T>() {
+
+   }
+
+   template <class T> inline
+   DynamicVector<T>::DynamicVector(const size_t& n, const bool& initialize) : DynamicMatrix<T>(n, 1, initialize) {
+
+   }
+
+   template <class T> inline
+   DynamicVector<T>::DynamicVector(const std::initializer_list<T>& list) : DynamicMatrix<T>(list.size(), 1, list) {
+
+   }
+
+   template <class T> inline
+   DynamicVector<T>::DynamicVector(const DynamicMatrix<T>& other) : DynamicMatrix<T>(other) {
+      assert(other.cols() == 1 || other.rows() == 0);
+   }
+
+   template <class T> inline
+   DynamicVector<T>::DynamicVector(DynamicMatrix<T>&& other) : DynamicMatrix<T>(std::move(other)) {
+      assert(this->cols() == 1 || this->rows() == 0);
+   }
+
+   template <class T> inline
+   DynamicVector<T>::DynamicVector(const ConstDynamicMatrixView<T>& view) : DynamicMatrix<T>(view) {
+      assert(view.cols() == 1 || view.rows() == 0);
+   }
+
+   template <class T>
+   template <size_t N, class C> inline
+   DynamicVector<T>::DynamicVector(Matrix<N, 1, T, C> other) : DynamicMatrix<T>(std::move(other)) {
+
+   }
+
+   template <class T> inline
+   DynamicVector<T> normalize(const DynamicVector<T>& vector) {
+      return DynamicVector<T>(vector * ((T)1 / length(vector)));
+   }
+
+   template <class T> inline
+   T length(const DynamicVector<T>& vector) {
+      return Math::Sqrt(vector * vector);
+   }
+
+   template <size_t N, class T> inline
+   Vector<N, T> to_fixed(DynamicVector<T> v) {
+      return Vector<N, T>(to_fixed<N, 1>(static_cast<DynamicMatrix<T>&&>(v)));
+   }
+}
+
+template <class T> inline
+T operator *(const Math::DynamicVector<T>& lhs, const Math::DynamicVector<T>& rhs) {
+   assert(lhs.rows() == rhs.rows());
+   return Math::Detail::dot(lhs.rows(), lhs.data(), rhs.data());
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "qr.hpp"
+
+namespace Math {
+
+   /*! Calculates the eigenvalues and eigenvectors of a symmetric matrix, so
+    * that m = vectors * diag(values) * ~vectors. 3x3 matrices are solved
+    * in closed form, other small matrices by cyclic Jacobi rotations and
+    * larger ones by Householder tridiagonalization followed by the
+    * implicit QL method.
+    *
+    * @param m Symmetric subject matrix.
+    * @param values Eigenvalues in ascending order.
+    * @param vectors Orthonormal eigenvectors in the columns, in the order
+    *                of @p values.
+    */
+   template <size_t N, class T, class C> void eigsym(const Matrix<N, N, T, C>& m, Vector<N, T>& values, Matrix<N, N, T>& vectors);
+
+   /*! Calculates the eigenvalues of a symmetric matrix without forming
+    * eigenvectors, which saves most of the work for larger matrices.
+    *
+    * @param m Symmetric subject matrix.
+    * @return Eigenvalues in ascending order.
+    */
+   template <size_t N, class T, class C> Vector<N, T> eigvalsym(const Matrix<N, N, T, C>& m);
+
+   /*! Calculates the K algebraically largest eigenvalues of a symmetric
+    * matrix and their eigenvectors, e.g. the principal components of a
+    * covariance matrix. For larger matrices the eigenvalues of the
+    * tridiagonal form are found first, and eigenvectors only for the
+    * selected ones by inverse iteration.
+    *
+    * @tparam K Number of eigenpairs, at most N.
+    * @param m Symmetric subject matrix.
+    * @param values Eigenvalues in descending order.
+    * @param vectors Orthonormal eigenvectors in the columns, in the order
+    *                of @p values.
+    */
+   template <size_t K, size_t N, class T, class C> void topeigsym(const Matrix<N, N, T, C>& m, Vector<K, T>& values, Matrix<N, K, T>& vectors);
+}
+
+#include "eigen.inl"
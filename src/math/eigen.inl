@@ -0,0 +1,647 @@
+namespace Math {
+
+   namespace Detail {
+
+      //! Largest symmetric matrices solved by cyclic Jacobi rotations.
+      const size_t JacobiEigenLimit = 8;
+
+      /*! Reduces a symmetric matrix to tridiagonal form T = ~Q * A * Q
+       * with Householder reflections Q = H(0) * ... * H(n - 3). The
+       * reflection vectors are stored below the subdiagonal; the rest of
+       * the matrix is overwritten.
+       *
+       * @param n Order of the matrix.
+       * @param a Matrix to reduce.
+       * @param lda Distance between columns of @p a.
+       * @param d Receives the n diagonal elements.
+       * @param e Receives the n - 1 subdiagonal elements.
+       * @param tau Receives the n - 2 reflection factors.
+       * @param work Work space of n elements.
+       */
+      template <class T> inline
+      void sytrd(const size_t& n, T* a, const size_t& lda, T* d, T* e, T* tau, T* work) {
+         for (size_t k = 0; k + 2 < n; ++k) {
+            const size_t m = n - k - 1;
+            T* v = a + k * lda + k + 1;
+            T* b = a + (k + 1) * lda + k + 1;
+
+            householder(m, v, tau[k]);
+            d[k] = a[k * lda + k];
+            e[k] = v[0];
+
+            if (tau[k] == (T)0)
+               continue;
+
+            // B = H * B * H is computed as B - v * ~w - w * ~v with
+            // p = tau * B * v and w = p - tau / 2 * (~p * v) * v.
+            v[0] = (T)1;
+
+            for (size_t i = 0; i < m; ++i)
+               work[i] = (T)0;
+
+            for (size_t j = 0; j < m; ++j) {
+               const T s = tau[k] * v[j];
+
+               for (size_t i = 0; i < m; ++i)
+                  work[i] += b[j * lda + i] * s;
+            }
+
+            T pv = (T)0;
+
+            for (size_t i = 0; i < m; ++i)
+               pv += work[i] * v[i];
+
+            const T alpha = -tau[k] * pv / (T)2;
+
+            for (size_t i = 0; i < m; ++i)
+               work[i] += alpha * v[i];
+
+            for (size_t j = 0; j < m; ++j) {
+               for (size_t i = 0; i < m; ++i)
+                  b[j * lda + i] -= v[i] * work[j] + work[i] * v[j];
+            }
+
+            v[0] = e[k];
+         }
+
+         if (n >= 2) {
+            e[n - 2] = a[(n - 2) * lda + n - 1];
+            d[n - 2] = a[(n - 2) * lda + n - 2];
+         }
+
+         d[n - 1] = a[(n - 1) * lda + n - 1];
+      }
+
+      /*! Multiplies a matrix by the orthogonal matrix of @c sytrd, Z = Q * Z.
+       *
+       * @param n Order of Q.
+       * @param a Reduced matrix holding the reflection vectors.
+       * @param lda Distance between columns of @p a.
+       * @param tau Reflection factors.
+       * @param k Number of columns of Z.
+       * @param z Matrix Z with n rows.
+       * @param ldz Distance between columns of @p z.
+       */
+      template <class T> inline
+      void ormtr(const size_t& n, const T* a, const size_t& lda, const T* tau, const size_t& k, T* z, const size_t& ldz) {
+         for (size_t j = n > 2 ? n - 2 : 0; j-- > 0;)
+            larf(n - j - 1, k, a + j * lda + j + 1, tau[j], z + j + 1, ldz);
+      }
+
+      /*! Calculates the eigenvalues of a symmetric tridiagonal matrix by
+       * the implicit QL method with Wilkinson shifts. The rotations are
+       * accumulated into Z when given, so that Z = Q yields the
+       * eigenvectors of the original matrix.
+       *
+       * @param n Order of the matrix.
+       * @param d Diagonal elements; receive the unordered eigenvalues.
+       * @param e Subdiagonal elements followed by one spare element;
+       *          destroyed.
+       * @param z Null, or n-row matrix of which columns are rotated.
+       * @param ldz Distance between columns of @p z.
+       */
+      template <class T> inline
+      void steqr(const size_t& n, T* d, T* e, T* z, const size_t& ldz) {
+         const T eps = std::numeric_limits<T>::epsilon();
+
+         e[n - 1] = (T)0;
+
+         for (size_t l = 0; l < n; ++l) {
+            size_t iterations = 0, m;
+
+            do {
+               for (m = l; m + 1 < n; ++m) {
+                  if (Abs(e[m]) <= eps * (Abs(d[m]) + Abs(d[m + 1])))
+                     break;
+               }
+
+               // An eigenvalue that does not converge in 60 sweeps is
+               // accepted as it is.
+               if (m == l || iterations++ == 60)
+                  break;
+
+               T g = (d[l + 1] - d[l]) / ((T)2 * e[l]);
+               T r = std::hypot(g, (T)1);
+               g = d[m] - d[l] + e[l] / (g + (g >= (T)0 ? r : -r));
+
+               T s = (T)1, c = (T)1, p = (T)0;
+               bool deflated = false;
+
+               for (size_t i = m; i-- > l;) {
+                  const T f = s * e[i];
+                  const T b = c * e[i];
+
+                  e[i + 1] = r = std::hypot(f, g);
+
+                  if (r == (T)0) {
+                     d[i + 1] -= p;
+                     e[m] = (T)0;
+                     deflated = true;
+                     break;
+                  }
+
+                  s = f / r;
+                  c = g / r;
+                  g = d[i + 1] - p;
+                  r = (d[i] - g) * s + (T)2 * c * b;
+                  p = s * r;
+                  d[i + 1] = g + p;
+                  g = c * r - b;
+
+                  if (z) {
+                     T* zi = z + i * ldz;
+                     T* zj = z + (i + 1) * ldz;
+
+                     for (size_t k = 0; k < n; ++k) {
+                        const T t = zj[k];
+                        zj[k] = s * zi[k] + c * t;
+                        zi[k] = c * zi[k] - s * t;
+                     }
+                  }
+               }
+
+               if (deflated)
+                  continue;
+
+               d[l] -= p;
+               e[l] = g;
+               e[m] = (T)0;
+            } while (m != l);
+         }
+      }
+
+      /*! Calculates eigenvalues and optionally eigenvectors of a small
+       * symmetric matrix by cyclic Jacobi rotations.
+       *
+       * @param n Order of the matrix.
+       * @param a Matrix, destroyed.
+       * @param lda Distance between columns of @p a.
+       * @param d Receives the unordered eigenvalues.
+       * @param v Null, or matrix receiving the eigenvectors in columns.
+       * @param ldv Distance between columns of @p v.
+       */
+      template <class T> inline
+      void syevj(const size_t& n, T* a, const size_t& lda, T* d, T* v, const size_t& ldv) {
+         const T eps = std::numeric_limits<T>::epsilon();
+
+         if (v) {
+            for (size_t j = 0; j < n; ++j) {
+               for (size_t i = 0; i < n; ++i)
+                  v[j * ldv + i] = i == j ? (T)1 : (T)0;
+            }
+         }
+
+         T norm = (T)0;
+
+         for (size_t j = 0; j < n; ++j) {
+            for (size_t i = 0; i < n; ++i)
+               norm += a[j * lda + i] * a[j * lda + i];
+         }
+
+         for (size_t sweep = 0; sweep < 50; ++sweep) {
+            T off = (T)0;
+
+            for (size_t q = 1; q < n; ++q) {
+               for (size_t p = 0; p < q; ++p)
+                  off += a[q * lda + p] * a[q * lda + p];
+            }
+
+            if (off <= eps * eps * norm)
+               break;
+
+            for (size_t q = 1; q < n; ++q) {
+               for (size_t p = 0; p < q; ++p) {
+                  const T apq = a[q * lda + p];
+
+                  if (apq == (T)0)
+                     continue;
+
+                  // The rotation zeroes a(p, q) of ~J * A * J.
+                  const T theta = (a[q * lda + q] - a[p * lda + p]) / ((T)2 * apq);
+                  const T t = (theta >= (T)0 ? (T)1 : (T)-1) / (Abs(theta) + Sqrt(theta * theta + (T)1));
+                  const T c = (T)1 / Sqrt(t * t + (T)1);
+                  const T s = t * c;
+
+                  for (size_t k = 0; k < n; ++k) {
+                     const T x = a[p * lda + k], y = a[q * lda + k];
+                     a[p * lda + k] = c * x - s * y;
+                     a[q * lda + k] = s * x + c * y;
+                  }
+
+                  for (size_t k = 0; k < n; ++k) {
+                     const T x = a[k * lda + p], y = a[k * lda + q];
+                     a[k * lda + p] = c * x - s * y;
+                     a[k * lda + q] = s * x + c * y;
+                  }
+
+                  if (v) {
+                     for (size_t k = 0; k < n; ++k) {
+                        const T x = v[p * ldv + k], y = v[q * ldv + k];
+                        v[p * ldv + k] = c * x - s * y;
+                        v[q * ldv + k] = s * x + c * y;
+                     }
+                  }
+               }
+            }
+         }
+
+         for (size_t i = 0; i < n; ++i)
+            d[i] = a[i * lda + i];
+      }
+
+      /*! Calculates eigenvalues and optionally eigenvectors of a symmetric
+       * 3x3 matrix in closed form. The roots of the characteristic
+       * polynomial by the trigonometric method tell the eigenvalue farthest
+       * from the others, whose vector is the cross product of two rows of
+       * A - lambda * I. The remaining two pairs are found by a rotation
+       * within the plane orthogonal to it, which keeps them accurate and
+       * orthogonal for close eigenvalues.
+       *
+       * @param a Column-major matrix.
+       * @param d Receives the eigenvalues in ascending order.
+       * @param v Null, or column-major matrix receiving the eigenvectors.
+       */
+      template <class T> inline
+      void syev3(const T* a, T* d, T* v) {
+         T scale = (T)0;
+
+         for (size_t i = 0; i < 9; ++i)
+            scale = Abs(a[i]) > scale ? Abs(a[i]) : scale;
+
+         const T q = (a[0] + a[4] + a[8]) / (T)3;
+         const T b11 = scale > (T)0 ? (a[0] - q) / scale : (T)0;
+         const T b22 = scale > (T)0 ? (a[4] - q) / scale : (T)0;
+         const T b33 = scale > (T)0 ? (a[8] - q) / scale : (T)0;
+         const T b21 = scale > (T)0 ? a[1] / scale : (T)0;
+         const T b31 = scale > (T)0 ? a[2] / scale : (T)0;
+         const T b32 = scale > (T)0 ? a[5] / scale : (T)0;
+         const T p2 = b11 * b11 + b22 * b22 + b33 * b33 + (T)2 * (b21 * b21 + b31 * b31 + b32 * b32);
+
+         if (p2 == (T)0) {
+            for (size_t i = 0; i < 3; ++i)
+               d[i] = q;
+
+            if (v) {
+               for (size_t i = 0; i < 9; ++i)
+                  v[i] = i % 4 == 0 ? (T)1 : (T)0;
+            }
+
+            return;
+         }
+
+         // Eigenvalues of B = (A - q * I) / scale are 2 * p * cos(phi + 2 * k * pi / 3).
+         const T p = Sqrt(p2 / (T)6);
+         const T det = b11 * (b22 * b33 - b32 * b32) - b21 * (b21 * b33 - b32 * b31) + b31 * (b21 * b32 - b22 * b31);
+         const T r = Clamp(det / ((T)2 * p * p * p), (T)-1, (T)1);
+         const T phi = std::acos(r) / (T)3;
+         const T third = (T)2 * (T)Pi<T>() / (T)3;
+         const T l1 = (T)2 * p * std::cos(phi);
+         const T l3 = (T)2 * p * std::cos(phi + third);
+         const T l2 = -l1 - l3;
+
+         // The roots lose half of the digits near multiple eigenvalues, so
+         // they only select the vector computed first, also when just the
+         // eigenvalues are wanted.
+         const T far = l1 - l2 >= l2 - l3 ? l1 : l3;
+         const T r0[3] = { b11 - far, b21, b31 };
+         const T r1[3] = { b21, b22 - far, b32 };
+         const T r2[3] = { b31, b32, b33 - far };
+         const T* rows[3][2] = { { r0, r1 }, { r0, r2 }, { r1, r2 } };
+         T u[3] = { (T)0, (T)0, (T)0 }, best = (T)0;
+
+         for (size_t k = 0; k < 3; ++k) {
+            const T* x = rows[k][0];
+            const T* y = rows[k][1];
+            const T c[3] = { x[1] * y[2] - x[2] * y[1], x[2] * y[0] - x[0] * y[2], x[0] * y[1] - x[1] * y[0] };
+            const T n = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+
+            if (n > best) {
+               best = n;
+               u[0] = c[0];
+               u[1] = c[1];
+               u[2] = c[2];
+            }
+         }
+
+         const T un = (T)1 / Sqrt(best);
+         u[0] *= un;
+         u[1] *= un;
+         u[2] *= un;
+
+         // Orthonormal basis w0, w1 of the plane orthogonal to u.
+         T w0[3], w1[3];
+
+         if (Abs(u[0]) > Abs(u[1])) {
+            const T s = (T)1 / Sqrt(u[0] * u[0] + u[2] * u[2]);
+            w0[0] = -u[2] * s;
+            w0[1] = (T)0;
+            w0[2] = u[0] * s;
+         }
+         else {
+            const T s = (T)1 / Sqrt(u[1] * u[1] + u[2] * u[2]);
+            w0[0] = (T)0;
+            w0[1] = u[2] * s;
+            w0[2] = -u[1] * s;
+         }
+
+         w1[0] = u[1] * w0[2] - u[2] * w0[1];
+         w1[1] = u[2] * w0[0] - u[0] * w0[2];
+         w1[2] = u[0] * w0[1] - u[1] * w0[0];
+
+         const auto quadratic = [&](const T* x, const T* y) {
+            return x[0] * (b11 * y[0] + b21 * y[1] + b31 * y[2])
+               + x[1] * (b21 * y[0] + b22 * y[1] + b32 * y[2])
+               + x[2] * (b31 * y[0] + b32 * y[1] + b33 * y[2]);
+         };
+
+         const T lu = quadratic(u, u);
+         const T a00 = quadratic(w0, w0), a01 = quadratic(w0, w1), a11 = quadratic(w1, w1);
+         T c = (T)1, s = (T)0, t = (T)0;
+
+         if (a01 != (T)0) {
+            const T theta = (a11 - a00) / ((T)2 * a01);
+            t = (theta >= (T)0 ? (T)1 : (T)-1) / (Abs(theta) + Sqrt(theta * theta + (T)1));
+            c = (T)1 / Sqrt(t * t + (T)1);
+            s = t * c;
+         }
+
+         T values[3] = { lu, a00 - t * a01, a11 + t * a01 };
+         T vectors[3][3] = {
+            { u[0], u[1], u[2] },
+            { c * w0[0] - s * w1[0], c * w0[1] - s * w1[1], c * w0[2] - s * w1[2] },
+            { s * w0[0] + c * w1[0], s * w0[1] + c * w1[1], s * w0[2] + c * w1[2] }
+         };
+         size_t order[3] = { 0, 1, 2 };
+
+         for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = i + 1; j < 3; ++j) {
+               if (values[order[j]] < values[order[i]])
+                  std::swap(order[i], order[j]);
+            }
+         }
+
+         for (size_t j = 0; j < 3; ++j) {
+            d[j] = q + values[order[j]] * scale;
+
+            for (size_t i = 0; v && i < 3; ++i)
+               v[j * 3 + i] = vectors[order[j]][i];
+         }
+      }
+
+      /*! Sorts eigenvalues in ascending order, permuting the columns of Z
+       * along when given.
+       */
+      template <class T> inline
+      void sort_eigen(const size_t& n, T* d, T* z, const size_t& ldz) {
+         for (size_t i = 0; i + 1 < n; ++i) {
+            size_t k = i;
+
+            for (size_t j = i + 1; j < n; ++j) {
+               if (d[j] < d[k])
+                  k = j;
+            }
+
+            if (k == i)
+               continue;
+
+            std::swap(d[i], d[k]);
+
+            if (z)
+               std::swap_ranges(z + i * ldz, z + i * ldz + n, z + k * ldz);
+         }
+      }
+
+      /*! Calculates eigenvectors of a symmetric tridiagonal matrix for
+       * given eigenvalues by inverse iteration. Vectors of eigenvalues
+       * closer than a thousandth of the matrix norm are orthogonalized
+       * against each other.
+       *
+       * @param n Order of the matrix.
+       * @param d Diagonal elements.
+       * @param e Subdiagonal elements.
+       * @param k Number of eigenvalues.
+       * @param w Eigenvalues, sorted ascending or descending.
+       * @param z Matrix receiving the eigenvectors in k columns.
+       * @param ldz Distance between columns of @p z.
+       * @param work Work space of 6 * n elements.
+       */
+      template <class T> inline
+      void stein(const size_t& n, const T* d, const T* e, const size_t& k, const T* w, T* z, const size_t& ldz, T* work) {
+         const T eps = std::numeric_limits<T>::epsilon();
+         T norm = (T)0;
+
+         for (size_t i = 0; i < n; ++i) {
+            const T row = Abs(d[i]) + (i > 0 ? Abs(e[i - 1]) : (T)0) + (i + 1 < n ? Abs(e[i]) : (T)0);
+            norm = row > norm ? row : norm;
+         }
+
+         const T tiny = norm > (T)0 ? eps * norm : eps;
+         const T gap = (T)1e-3 * norm;
+         T* u0 = work;
+         T* u1 = u0 + n;
+         T* u2 = u1 + n;
+         T* l = u2 + n;
+         T* swapped = l + n;
+         T* x = swapped + n;
+         size_t cluster = 0;
+
+         for (size_t j = 0; j < k; ++j) {
+            T* zj = z + j * ldz;
+
+            if (j > 0 && Abs(w[j] - w[j - 1]) > gap)
+               cluster = j;
+
+            // LU factorization of T - w * I with partial pivoting, U having
+            // two superdiagonals.
+            T pivot = d[0] - w[j], upper = n > 1 ? e[0] : (T)0;
+
+            for (size_t i = 0; i + 1 < n; ++i) {
+               const T below = e[i], next = d[i + 1] - w[j], after = i + 2 < n ? e[i + 1] : (T)0;
+
+               if (Abs(below) > Abs(pivot)) {
+                  const T f = pivot / below;
+
+                  u0[i] = below;
+                  u1[i] = next;
+                  u2[i] = after;
+                  l[i] = f;
+                  swapped[i] = (T)1;
+                  pivot = upper - f * next;
+                  upper = -f * after;
+               }
+               else {
+                  const T f = pivot != (T)0 ? below / pivot : (T)0;
+
+                  u0[i] = pivot;
+                  u1[i] = upper;
+                  u2[i] = (T)0;
+                  l[i] = f;
+                  swapped[i] = (T)0;
+                  pivot = next - f * upper;
+                  upper = after;
+               }
+            }
+
+            u0[n - 1] = pivot;
+
+            for (size_t i = 0; i < n; ++i) {
+               if (Abs(u0[i]) < tiny)
+                  u0[i] = u0[i] < (T)0 ? -tiny : tiny;
+            }
+
+            // The start vector has no special direction.
+            for (size_t i = 0; i < n; ++i)
+               zj[i] = (T)1 + (T)((i * 7 + j * 3) % 11) / (T)16;
+
+            for (size_t iteration = 0; iteration < 3; ++iteration) {
+               for (size_t i = 0; i < n; ++i)
+                  x[i] = zj[i];
+
+               for (size_t i = 0; i + 1 < n; ++i) {
+                  if (swapped[i] != (T)0)
+                     std::swap(x[i], x[i + 1]);
+
+                  x[i + 1] -= l[i] * x[i];
+               }
+
+               for (size_t i = n; i-- > 0;) {
+                  T s = x[i];
+
+                  if (i + 1 < n)
+                     s -= u1[i] * x[i + 1];
+
+                  if (i + 2 < n)
+                     s -= u2[i] * x[i + 2];
+
+                  x[i] = s / u0[i];
+               }
+
+               for (size_t c = cluster; c < j; ++c) {
+                  const T* zc = z + c * ldz;
+                  T dot = (T)0;
+
+                  for (size_t i = 0; i < n; ++i)
+                     dot += x[i] * zc[i];
+
+                  for (size_t i = 0; i < n; ++i)
+                     x[i] -= dot * zc[i];
+               }
+
+               T length = (T)0;
+
+               for (size_t i = 0; i < n; ++i)
+                  length += x[i] * x[i];
+
+               length = (T)1 / Sqrt(length);
+
+               for (size_t i = 0; i < n; ++i)
+                  zj[i] = x[i] * length;
+            }
+         }
+      }
+
+      /*! Calculates eigenvalues and optionally eigenvectors of a symmetric
+       * matrix, choosing the method by its size.
+       *
+       * @param n Order of the matrix.
+       * @param a Matrix, destroyed.
+       * @param d Receives the eigenvalues in ascending order.
+       * @param v Null, or matrix receiving the eigenvectors in columns.
+       * @param work Work space of 3 * n elements.
+       */
+      template <class T> inline
+      void syev(const size_t& n, T* a, T* d, T* v, T* work) {
+         if (n == 3) {
+            syev3(a, d, v);
+            return;
+         }
+
+         if (n <= JacobiEigenLimit) {
+            syevj(n, a, n, d, v, n);
+            sort_eigen(n, d, v, n);
+            return;
+         }
+
+         T* e = work;
+         T* tau = e + n;
+
+         sytrd(n, a, n, d, e, tau, tau + n);
+
+         if (v) {
+            for (size_t j = 0; j < n; ++j) {
+               for (size_t i = 0; i < n; ++i)
+                  v[j * n + i] = i == j ? (T)1 : (T)0;
+            }
+
+            ormtr(n, a, n, tau, n, v, n);
+         }
+
+         steqr(n, d, e, v, n);
+         sort_eigen(n, d, v, n);
+      }
+   }
+
+   template <size_t N, class T, class C> inline
+   void eigsym(const Matrix<N, N, T, C>& m, Vector<N, T>& values, Matrix<N, N, T>& vectors) {
+      Matrix<N, N, T> a(m);
+      T work[3 * N];
+
+      Detail::syev(N, a.data(), values.data(), vectors.data(), work);
+   }
+
+   template <size_t N, class T, class C> inline
+   Vector<N, T> eigvalsym(const Matrix<N, N, T, C>& m) {
+      Matrix<N, N, T> a(m);
+      Vector<N, T> values(false);
+      T work[3 * N];
+
+      Detail::syev(N, a.data(), values.data(), (T*)nullptr, work);
+
+      return std::move(values);
+   }
+
+   template <size_t K, size_t N, class T, class C> inline
+   void topeigsym(const Matrix<N, N, T, C>& m, Vector<K, T>& values, Matrix<N, K, T>& vectors) {
+      static_assert(K >= 1 && K <= N, "Number of eigenpairs must be between 1 and N");
+
+      if (N <= Detail::JacobiEigenLimit) {
+         Vector<N, T> d(false);
+         Matrix<N, N, T> v(false);
+
+         eigsym(m, d, v);
+
+         for (size_t j = 1; j <= K; ++j) {
+            values[j] = d[N + 1 - j];
+
+            for (size_t i = 1; i <= N; ++i)
+               vectors(i, j) = v(i, N + 1 - j);
+         }
+
+         return;
+      }
+
+      // Eigenvalues of the tridiagonal form cost O(N^2); inverse iteration
+      // and back transformation cost O(N^2 * K) for the selected ones.
+      Matrix<N, N, T> a(m);
+      std::vector<T> work(11 * N);
+      T* d = work.data();
+      T* e = d + N;
+      T* tau = e + N;
+      T* w = tau + N;
+      T* f = w + N;
+
+      Detail::sytrd(N, a.data(), N, d, e, tau, w);
+
+      std::copy(d, d + N, w);
+      std::copy(e, e + N - 1, f);
+      Detail::steqr(N, w, f, (T*)nullptr, 0);
+      Detail::sort_eigen(N, w, (T*)nullptr, 0);
+      std::reverse(w, w + N);
+
+      Detail::stein(N, d, e, K, w, vectors.data(), N, f);
+      Detail::ormtr(N, a.data(), N, tau, K, vectors.data(), N);
+
+      for (size_t j = 0; j < K; ++j)
+         values[j + 1] = w[j];
+   }
+}
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include "simd.hpp"
+#include "threadpool.hpp"
+
+namespace Math {
+
+   /*! Tag base of all matrix expressions. Used to detect expression types.
+    */
+   class MatrixExpressionBase {
+   };
+
+   /*! Base class of lazily evaluated matrix expressions. Matrix arithmetic
+    * builds a tree of expression nodes and the whole tree is evaluated
+    * element by element when it is assigned into a matrix, so no
+    * intermediate matrices are created.
+    *
+    * Every expression provides @c Rows, @c Cols and @c type constants and
+    * unchecked, 0-based element access through @c coeff.
+    */
+   template <class E> class MatrixExpression : public MatrixExpressionBase {
+   public:
+
+      /*! Gets the concrete expression.
+       *
+       * @return The concrete expression.
+       */
+      const E& derived() const;
+
+      /*! Tells the number of rows.
+       *
+       * @return Number of rows.
+       */
+      size_t rows() const;
+
+      /*! Tells the number of columns.
+       *
+       * @return Number of columns.
+       */
+      size_t cols() const;
+
+      /*! Evaluates a single element of the expression.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Element at given location.
+       */
+      template <class U = E> typename U::type operator ()(const size_t& i, const size_t& j) const;
+   };
+
+   namespace Detail {
+
+      /*! Tells whether two storage ranges overlap.
+       *
+       * @param begin First range begin.
+       * @param end First range end.
+       * @param otherBegin Second range begin.
+       * @param otherEnd Second range end.
+       * @return @c true if the ranges share any byte.
+       */
+      bool overlaps(const void* begin, const void* end, const void* otherBegin, const void* otherEnd);
+   }
+
+   /*! Tells whether a type is a matrix expression.
+    */
+   template <class E> struct is_matrix_expression
+      : std::is_base_of<MatrixExpressionBase, typename std::decay<E>::type> {
+   };
+
+   /*! Selects how an expression node stores its operand. Matrices passed as
+    * lvalues are referenced, everything else is stored by value so that
+    * temporaries stay alive as long as the expression does.
+    */
+   template <class E> struct expression_operand {
+      typedef typename std::decay<E>::type decayed;
+      typedef typename std::conditional<
+         std::is_lvalue_reference<E>::value && decayed::Leaf,
+         const decayed&,
+         decayed
+      >::type type;
+   };
+
+   /*! Element-wise addition.
+    */
+   struct AddOp {
+      template <class T> T operator ()(const T& lhs, const T& rhs) const { return lhs + rhs; }
+   };
+
+   /*! Element-wise substraction.
+    */
+   struct SubtractOp {
+      template <class T> T operator ()(const T& lhs, const T& rhs) const { return lhs - rhs; }
+   };
+
+   /*! Element-wise negation.
+    */
+   struct NegateOp {
+      template <class T> T operator ()(const T& value) const { return -value; }
+   };
+
+   /*! Multiplication by a scalar.
+    */
+   template <class T> struct ScaleOp {
+      ScaleOp(const T& scalar) : scalar(scalar) {}
+      T operator ()(const T& value) const { return value * scalar; }
+      T scalar;
+   };
+
+   /*! Element-wise binary expression of two equally sized operands.
+    */
+   template <class L, class R, class Op>
+   class MatrixBinaryExpression : public MatrixExpression< MatrixBinaryExpression<L, R, Op> > {
+   public:
+
+      typedef typename std::decay<L>::type lhs_type;
+      typedef typename std::decay<R>::type rhs_type;
+
+      static_assert(lhs_type::Rows == rhs_type::Rows && lhs_type::Cols == rhs_type::Cols, "Operand dimensions must match.");
+
+      //! Expression row size constant.
+      static const size_t Rows = lhs_type::Rows;
+
+      //! Expression column size constant.
+      static const size_t Cols = lhs_type::Cols;
+
+      //! Tells that the expression is not a leaf node.
+      static const bool Leaf = false;
+
+      //! Tells if the expression can be evaluated in flat storage order.
+      static const bool Linear = lhs_type::Linear && rhs_type::Linear;
+
+      //! Type alias for element types.
+      typedef typename lhs_type::type type;
+
+      /*! Constructs an expression.
+       *
+       * @param lhs Left hand side operand.
+       * @param rhs Right hand side operand.
+       * @param op Element operation.
+       */
+      MatrixBinaryExpression(L lhs, R rhs, const Op& op = Op());
+
+      /*! Evaluates an element.
+       *
+       * @param i Row index, 0-based.
+       * @param j Column index, 0-based.
+       * @return Evaluated element.
+       */
+      type coeff(const size_t& i, const size_t& j) const;
+
+      /*! Evaluates an element in flat storage order.
+       *
+       * @param index Element index, 0-based.
+       * @return Evaluated element.
+       */
+      type coeff(const size_t& index) const;
+
+      /*! Tells whether the expression reads from given storage.
+       *
+       * @param begin Storage begin.
+       * @param end Storage end.
+       * @return @c true if any operand overlaps the storage.
+       */
+      bool references(const void* begin, const void* end) const;
+
+      /*! Tells whether evaluating the expression directly into a dense
+       * matrix would overwrite elements before they are read.
+       *
+       * @param begin Destination storage begin.
+       * @param end Destination storage end.
+       * @return @c true if a temporary is required.
+       */
+      bool aliases(const void* begin, const void* end) const;
+
+      //! Left hand side operand.
+      const lhs_type& lhs() const;
+
+      //! Right hand side operand.
+      const rhs_type& rhs() const;
+
+      //! Element operation.
+      const Op& op() const;
+
+   private:
+      L _lhs;
+      R _rhs;
+      Op _op;
+   };
+
+   /*! Element-wise unary expression.
+    */
+   template <class E, class Op>
+   class MatrixUnaryExpression : public MatrixExpression< MatrixUnaryExpression<E, Op> > {
+   public:
+
+      typedef typename std::decay<E>::type operand_type;
+
+      //! Expression row size constant.
+      static const size_t Rows = operand_type::Rows;
+
+      //! Expression column size constant.
+      static const size_t Cols = operand_type::Cols;
+
+      //! Tells that the expression is not a leaf node.
+      static const bool Leaf = false;
+
+      //! Tells if the expression can be evaluated in flat storage order.
+      static const bool Linear = operand_type::Linear;
+
+      //! Type alias for element types.
+      typedef typename operand_type::type type;
+
+      /*! Constructs an expression.
+       *
+       * @param operand Expression operand.
+       * @param op Element operation.
+       */
+      MatrixUnaryExpression(E operand, const Op& op = Op());
+
+      /*! Evaluates an element.
+       *
+       * @param i Row index, 0-based.
+       * @param j Column index, 0-based.
+       * @return Evaluated element.
+       */
+      type coeff(const size_t& i, const size_t& j) const;
+
+      /*! Evaluates an element in flat storage order.
+       *
+       * @param index Element index, 0-based.
+       * @return Evaluated element.
+       */
+      type coeff(const size_t& index) const;
+
+      /*! Tells whether the expression reads from given storage.
+       *
+       * @param begin Storage begin.
+       * @param end Storage end.
+       * @return @c true if the operand overlaps the storage.
+       */
+      bool references(const void* begin, const void* end) const;
+
+      /*! Tells whether evaluating the expression directly into a dense
+       * matrix would overwrite elements before they are read.
+       *
+       * @param begin Destination storage begin.
+       * @param end Destination storage end.
+       * @return @c true if a temporary is required.
+       */
+      bool aliases(const void* begin, const void* end) const;
+
+      //! Expression operand.
+      const operand_type& operand() const;
+
+      //! Element operation.
+      const Op& op() const;
+
+   private:
+      E _operand;
+      Op _op;
+   };
+
+   /*! Transpose expression.
+    */
+   template <class E>
+   class MatrixTransposeExpression : public MatrixExpression< MatrixTransposeExpression<E> > {
+   public:
+
+      typedef typename std::decay<E>::type operand_type;
+
+      //! Expression row size constant.
+      static const size_t Rows = operand_type::Cols;
+
+      //! Expression column size constant.
+      static const size_t Cols = operand_type::Rows;
+
+      //! Tells that the expression is not a leaf node.
+      static const bool Leaf = false;
+
+      //! Transposed elements cannot be evaluated in flat storage order.
+      static const bool Linear = false;
+
+      //! Type alias for element types.
+      typedef typename operand_type::type type;
+
+      /*! Constructs an expression.
+       *
+       * @param operand Expression operand.
+       */
+      MatrixTransposeExpression(E operand);
+
+      /*! Evaluates an element.
+       *
+       * @param i Row index, 0-based.
+       * @param j Column index, 0-based.
+       * @return Evaluated element.
+       */
+      type coeff(const size_t& i, const size_t& j) const;
+
+      /*! Tells whether the expression reads from given storage.
+       *
+       * @param begin Storage begin.
+       * @param end Storage end.
+       * @return @c true if the operand overlaps the storage.
+       */
+      bool references(const void* begin, const void* end) const;
+
+      /*! Tells whether evaluating the expression directly into a dense
+       * matrix would overwrite elements before they are read.
+       *
+       * @param begin Destination storage begin.
+       * @param end Destination storage end.
+       * @return @c true if a temporary is required.
+       */
+      bool aliases(const void* begin, const void* end) const;
+
+      //! Expression operand.
+      const operand_type& operand() const;
+
+   private:
+      E _operand;
+   };
+
+   /*! Tells whether two expressions can be combined element-wise.
+    */
+   template <class L, class R> struct are_elementwise_compatible {
+      typedef typename std::decay<L>::type lhs_type;
+      typedef typename std::decay<R>::type rhs_type;
+
+      static const bool value =
+         lhs_type::Rows == rhs_type::Rows &&
+         lhs_type::Cols == rhs_type::Cols &&
+         std::is_same<typename lhs_type::type, typename rhs_type::type>::value;
+   };
+
+   /*! Tells whether two expressions can be multiplied as matrices.
+    */
+   template <class L, class R> struct are_product_compatible {
+      typedef typename std::decay<L>::type lhs_type;
+      typedef typename std::decay<R>::type rhs_type;
+
+      static const bool value =
+         lhs_type::Cols == rhs_type::Rows &&
+         std::is_same<typename lhs_type::type, typename rhs_type::type>::value;
+   };
+
+   /*! Resolves the type of an element-wise binary expression, if both operands
+    * are compatible matrix expressions.
+    */
+   template <class L, class R, class Op, class Enable = void> struct binary_expression {
+   };
+
+   template <class L, class R, class Op>
+   struct binary_expression<L, R, Op, typename std::enable_if<
+      std::conditional<
+         is_matrix_expression<L>::value && is_matrix_expression<R>::value,
+         are_elementwise_compatible<L, R>,
+         std::false_type
+      >::type::value
+   >::type> {
+      typedef MatrixBinaryExpression<typename expression_operand<L>::type, typename expression_operand<R>::type, Op> type;
+   };
+
+   /*! Resolves the type of a unary expression, if the operand is a matrix
+    * expression.
+    */
+   template <class E, class Op, class Enable = void> struct unary_expression {
+   };
+
+   template <class E, class Op>
+   struct unary_expression<E, Op, typename std::enable_if<is_matrix_expression<E>::value>::type> {
+      typedef MatrixUnaryExpression<typename expression_operand<E>::type, Op> type;
+   };
+
+   /*! Resolves the type of a transpose expression, if the operand is a
+    * matrix expression.
+    */
+   template <class E, class Enable = void> struct transpose_expression {
+   };
+
+   template <class E>
+   struct transpose_expression<E, typename std::enable_if<is_matrix_expression<E>::value>::type> {
+      typedef MatrixTransposeExpression<typename expression_operand<E>::type> type;
+   };
+}
+
+#include "expression.inl"
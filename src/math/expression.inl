@@ -0,0 +1,251 @@
+
+namespace Math {
+
+   template <class E> inline
+   const E& MatrixExpression<E>::derived() const {
+      return static_cast<const E&>(*this);
+   }
+
+   template <class E> inline
+   size_t MatrixExpression<E>::rows() const {
+      return E::Rows;
+   }
+
+   template <class E> inline
+   size_t MatrixExpression<E>::cols() const {
+      return E::Cols;
+   }
+
+   template <class E>
+   template <class U> inline
+   typename U::type MatrixExpression<E>::operator ()(const size_t& i, const size_t& j) const {
+      return derived().coeff(i - 1, j - 1);
+   }
+
+
+   template <class L, class R, class Op> inline
+   MatrixBinaryExpression<L, R, Op>::MatrixBinaryExpression(L lhs, R rhs, const Op& op)
+      : _lhs(std::forward<L>(lhs)), _rhs(std::forward<R>(rhs)), _op(op)
+   {
+
+   }
+
+   template <class L, class R, class Op> inline
+   typename MatrixBinaryExpression<L, R, Op>::type MatrixBinaryExpression<L, R, Op>::coeff(const size_t& i, const size_t& j) const {
+      return _op(_lhs.coeff(i, j), _rhs.coeff(i, j));
+   }
+
+   template <class L, class R, class Op> inline
+   typename MatrixBinaryExpression<L, R, Op>::type MatrixBinaryExpression<L, R, Op>::coeff(const size_t& index) const {
+      return _op(_lhs.coeff(index), _rhs.coeff(index));
+   }
+
+   template <class L, class R, class Op> inline
+   bool MatrixBinaryExpression<L, R, Op>::references(const void* begin, const void* end) const {
+      return _lhs.references(begin, end) || _rhs.references(begin, end);
+   }
+
+   template <class L, class R, class Op> inline
+   bool MatrixBinaryExpression<L, R, Op>::aliases(const void* begin, const void* end) const {
+      return _lhs.aliases(begin, end) || _rhs.aliases(begin, end);
+   }
+
+   template <class L, class R, class Op> inline
+   const typename MatrixBinaryExpression<L, R, Op>::lhs_type& MatrixBinaryExpression<L, R, Op>::lhs() const {
+      return _lhs;
+   }
+
+   template <class L, class R, class Op> inline
+   const typename MatrixBinaryExpression<L, R, Op>::rhs_type& MatrixBinaryExpression<L, R, Op>::rhs() const {
+      return _rhs;
+   }
+
+   template <class L, class R, class Op> inline
+   const Op& MatrixBinaryExpression<L, R, Op>::op() const {
+      return _op;
+   }
+
+
+   template <class E, class Op> inline
+   MatrixUnaryExpression<E, Op>::MatrixUnaryExpression(E operand, const Op& op)
+      : _operand(std::forward<E>(operand)), _op(op)
+   {
+
+   }
+
+   template <class E, class Op> inline
+   typename MatrixUnaryExpression<E, Op>::type MatrixUnaryExpression<E, Op>::coeff(const size_t& i, const size_t& j) const {
+      return _op(_operand.coeff(i, j));
+   }
+
+   template <class E, class Op> inline
+   typename MatrixUnaryExpression<E, Op>::type MatrixUnaryExpression<E, Op>::coeff(const size_t& index) const {
+      return _op(_operand.coeff(index));
+   }
+
+   template <class E, class Op> inline
+   bool MatrixUnaryExpression<E, Op>::references(const void* begin, const void* end) const {
+      return _operand.references(begin, end);
+   }
+
+   template <class E, class Op> inline
+   bool MatrixUnaryExpression<E, Op>::aliases(const void* begin, const void* end) const {
+      return _operand.aliases(begin, end);
+   }
+
+   template <class E, class Op> inline
+   const typename MatrixUnaryExpression<E, Op>::operand_type& MatrixUnaryExpression<E, Op>::operand() const {
+      return _operand;
+   }
+
+   template <class E, class Op> inline
+   const Op& MatrixUnaryExpression<E, Op>::op() const {
+      return _op;
+   }
+
+
+   template <class E> inline
+   MatrixTransposeExpression<E>::MatrixTransposeExpression(E operand)
+      : _operand(std::forward<E>(operand))
+   {
+
+   }
+
+   template <class E> inline
+   typename MatrixTransposeExpression<E>::type MatrixTransposeExpression<E>::coeff(const size_t& i, const size_t& j) const {
+      return _operand.coeff(j, i);
+   }
+
+   template <class E> inline
+   bool MatrixTransposeExpression<E>::references(const void* begin, const void* end) const {
+      return _operand.references(begin, end);
+   }
+
+   template <class E> inline
+   bool MatrixTransposeExpression<E>::aliases(const void* begin, const void* end) const {
+      // Elements are read from mirrored locations, so any reference to the
+      // destination makes direct evaluation unsafe.
+      return _operand.references(begin, end);
+   }
+
+   template <class E> inline
+   const typename MatrixTransposeExpression<E>::operand_type& MatrixTransposeExpression<E>::operand() const {
+      return _operand;
+   }
+
+
+   namespace Detail {
+
+      inline bool overlaps(const void* begin, const void* end, const void* otherBegin, const void* otherEnd) {
+         const std::less<const void*> less;
+         return less(begin, otherEnd) && less(otherBegin, end);
+      }
+
+      /*! Tells whether an operand is a matrix with contiguous storage.
+       */
+      template <class E> struct is_dense_leaf
+         : std::integral_constant<bool, std::decay<E>::type::Leaf && std::decay<E>::type::Linear> {
+      };
+
+      /*! Evaluates an expression with a SIMD kernel, if one matches the
+       * expression and the range is large enough.
+       *
+       * @param e Expression to evaluate.
+       * @param out Destination storage.
+       * @param begin First element index, 0-based.
+       * @param end One past the last element index.
+       * @return @c true if the expression was evaluated.
+       */
+      template <class E, class T> inline
+      bool evaluate_kernel(const E&, T*, const size_t&, const size_t&) {
+         return false;
+      }
+
+      template <class L, class R, class T> inline
+      typename std::enable_if<SimdTraits<T>::Enabled && is_dense_leaf<L>::value && is_dense_leaf<R>::value, bool>::type
+      evaluate_kernel(const MatrixBinaryExpression<L, R, AddOp>& e, T* out, const size_t& begin, const size_t& end) {
+         if (end - begin < SimdTraits<T>::Threshold)
+            return false;
+
+         Math::simd_kernels<T>().add(end - begin, e.lhs().data() + begin, e.rhs().data() + begin, out + begin);
+         return true;
+      }
+
+      template <class L, class R, class T> inline
+      typename std::enable_if<SimdTraits<T>::Enabled && is_dense_leaf<L>::value && is_dense_leaf<R>::value, bool>::type
+      evaluate_kernel(const MatrixBinaryExpression<L, R, SubtractOp>& e, T* out, const size_t& begin, const size_t& end) {
+         if (end - begin < SimdTraits<T>::Threshold)
+            return false;
+
+         Math::simd_kernels<T>().subtract(end - begin, e.lhs().data() + begin, e.rhs().data() + begin, out + begin);
+         return true;
+      }
+
+      template <class E, class T> inline
+      typename std::enable_if<SimdTraits<T>::Enabled && is_dense_leaf<E>::value, bool>::type
+      evaluate_kernel(const MatrixUnaryExpression<E, NegateOp>& e, T* out, const size_t& begin, const size_t& end) {
+         if (end - begin < SimdTraits<T>::Threshold)
+            return false;
+
+         Math::simd_kernels<T>().negate(end - begin, e.operand().data() + begin, out + begin);
+         return true;
+      }
+
+      template <class E, class T> inline
+      typename std::enable_if<SimdTraits<T>::Enabled && is_dense_leaf<E>::value, bool>::type
+      evaluate_kernel(const MatrixUnaryExpression<E, ScaleOp<T> >& e, T* out, const size_t& begin, const size_t& end) {
+         if (end - begin < SimdTraits<T>::Threshold)
+            return false;
+
+         Math::simd_kernels<T>().scale(end - begin, e.operand().data() + begin, e.op().scalar, out + begin);
+         return true;
+      }
+
+      // Evaluates elements [begin, end) in flat storage order.
+      template <class E, class T> inline
+      void evaluate_range(const E& e, T* out, const size_t& begin, const size_t& end, std::true_type) {
+         if (evaluate_kernel(e, out, begin, end))
+            return;
+
+         for (size_t k = begin; k < end; ++k)
+            out[k] = e.coeff(k);
+      }
+
+      // Evaluates columns [begin, end) in column-major order.
+      template <class E, class T> inline
+      void evaluate_range(const E& e, T* out, const size_t& begin, const size_t& end, std::false_type) {
+         for (size_t j = begin; j < end; ++j) {
+            T* p = out + j * E::Rows;
+
+            for (size_t i = 0; i < E::Rows; ++i)
+               p[i] = e.coeff(i, j);
+         }
+      }
+
+      /*! Evaluates an expression into dense column-major storage on the
+       * calling thread.
+       *
+       * @param e Expression to evaluate.
+       * @param out Destination storage.
+       */
+      template <class E, class T> inline
+      void evaluate(const E& e, T* out, std::false_type) {
+         evaluate_range(e, out, 0, E::Linear ? E::Rows * E::Cols : E::Cols, std::integral_constant<bool, E::Linear>());
+      }
+
+      /*! Evaluates an expression into dense column-major storage, splitting
+       * large expressions across threads.
+       *
+       * @param e Expression to evaluate.
+       * @param out Destination storage.
+       */
+      template <class E, class T> inline
+      void evaluate(const E& e, T* out, std::true_type) {
+         const size_t n = E::Linear ? E::Rows * E::Cols : E::Cols;
+
+         parallel_for(0, n, E::Linear ? 1 : E::Rows, [&e, out](const size_t& begin, const size_t& end) {
+            evaluate_range(e, out, begin, end, std::integral_constant<bool, E::Linear>());
+         });
+      }
+   }
+}
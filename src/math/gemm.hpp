@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "simd.hpp"
+#include "perfcounters.hpp"
+#include "threadpool.hpp"
+
+namespace Math {
+
+   /*! Blocking parameters of the packed matrix multiplication kernel.
+    *
+    * The product is computed in MCxKC blocks of the left hand side and
+    * KCxNC blocks of the right hand side, which are packed into contiguous
+    * panels so that the micro-kernel streams through memory linearly. The
+    * micro-kernel computes a register tile of the result, its size depends
+    * on the instruction set selected by @c simd_kernels.
+    */
+   template <class T> struct GemmBlocking {
+
+      //! Rows of the left hand side block kept in L2 cache.
+      static const size_t MC = 128;
+
+      //! Shared dimension of a block kept in L1 cache.
+      static const size_t KC = 256;
+
+      //! Columns of the right hand side block kept in L3 cache.
+      static const size_t NC = 4096;
+
+      //! Products with fewer multiply-adds than this use a plain loop.
+      static const size_t Threshold = 32 * 32 * 32;
+
+      //! Rows or columns of the result computed by one thread at a time.
+      static const size_t ParallelBlock = 32;
+
+      //! Fixed size products with at most this many multiply-adds are fully unrolled.
+      static const size_t UnrollLimit = 4 * 4 * 4;
+   };
+
+   /*! Computes a general matrix product C = alpha * A * B + beta * C. All
+    * matrices are stored in column-major order. When @p beta is zero, C is
+    * not read. Products above @c parallel_threshold are split across
+    * threads.
+    *
+    * @param m Number of rows of A and C.
+    * @param n Number of columns of B and C.
+    * @param k Number of columns of A and rows of B.
+    * @param alpha Product multiplier.
+    * @param a Left hand side matrix data.
+    * @param lda Distance between columns of A.
+    * @param b Right hand side matrix data.
+    * @param ldb Distance between columns of B.
+    * @param beta Result multiplier.
+    * @param c Result matrix data.
+    * @param ldc Distance between columns of C.
+    */
+   template <class T> void gemm(const size_t& m, const size_t& n, const size_t& k, const T& alpha, const T* a, const size_t& lda, const T* b, const size_t& ldb, const T& beta, T* c, const size_t& ldc);
+
+   /*! Computes a fixed size matrix product C = A * B of densely stored
+    * column-major matrices. Tiny products are fully unrolled at compile
+    * time, larger ones are dispatched to @c gemm.
+    *
+    * @tparam Parallel @c true to allow splitting the product across threads.
+    * @param a MxN left hand side matrix data.
+    * @param b NxP right hand side matrix data.
+    * @param c MxP result matrix data.
+    */
+   template <size_t M, size_t N, size_t P, bool Parallel = false, class T> void product(const T* a, const T* b, T* c);
+}
+
+#include "gemm.inl"
@@ -0,0 +1,271 @@
+
+namespace Math {
+
+   namespace Detail {
+
+      /*! Micro-kernel used by the packed matrix multiplication.
+       */
+      template <class T> struct GemmKernel {
+
+         /*! Computes an MRxNR tile C = alpha * A * B + beta * C from packed
+          * panels, writing only the leading m x n part of the tile.
+          */
+         typedef void (*function)(const size_t& kc, const T* a, const T* b, T* c, const size_t& ldc, const T& alpha, const T& beta, const size_t& m, const size_t& n);
+
+         //! Register tile rows.
+         size_t mr;
+
+         //! Register tile columns.
+         size_t nr;
+
+         //! Kernel function.
+         function kernel;
+      };
+
+      template <class T, size_t MR, size_t NR> inline
+      void gemm_micro(const size_t& kc, const T* a, const T* b, T* c, const size_t& ldc, const T& alpha, const T& beta, const size_t& m, const size_t& n) {
+         T acc[MR * NR];
+
+         for (size_t i = 0; i < MR * NR; ++i)
+            acc[i] = (T)0;
+
+         for (size_t p = 0; p < kc; ++p) {
+            for (size_t j = 0; j < NR; ++j) {
+               const T bj = b[j];
+
+               for (size_t i = 0; i < MR; ++i)
+                  acc[j * MR + i] += a[i] * bj;
+            }
+
+            a += MR;
+            b += NR;
+         }
+
+         for (size_t j = 0; j < n; ++j) {
+            T* cj = c + j * ldc;
+
+            if (beta == (T)0) {
+               for (size_t i = 0; i < m; ++i)
+                  cj[i] = alpha * acc[j * MR + i];
+            }
+            else {
+               for (size_t i = 0; i < m; ++i)
+                  cj[i] = alpha * acc[j * MR + i] + beta * cj[i];
+            }
+         }
+      }
+
+      /*! Selects the micro-kernel for an element type.
+       *
+       * @return Micro-kernel and its register tile size.
+       */
+      template <class T> inline
+      GemmKernel<T> gemm_kernel() {
+         const SimdKernels<T>& simd = Math::simd_kernels<T>();
+         GemmKernel<T> k = { simd.mr, simd.nr, simd.gemm };
+         return k;
+      }
+
+      /*! Gets a per-thread scratch buffer which is reused between calls.
+       *
+       * @param slot Buffer slot.
+       * @param size Minimum number of elements.
+       * @return Buffer data.
+       */
+      template <class T> inline
+      T* gemm_workspace(const size_t& slot, const size_t& size) {
+         static thread_local std::vector<T, AlignedAllocator<T> > buffers[2];
+
+         if (buffers[slot].size() < size)
+            buffers[slot].resize(size);
+
+         return buffers[slot].data();
+      }
+
+      // Packs an mc x kc block of A into panels of mr rows. Each panel
+      // stores mr consecutive elements per column and is zero padded.
+      template <class T> inline
+      void gemm_pack_a(const size_t& mc, const size_t& kc, const T* a, const size_t& lda, const size_t& mr, T* out) {
+         for (size_t i0 = 0; i0 < mc; i0 += mr) {
+            const size_t m = mc - i0 < mr ? mc - i0 : mr;
+
+            for (size_t p = 0; p < kc; ++p) {
+               const T* src = a + i0 + p * lda;
+               size_t i = 0;
+
+               for (; i < m; ++i)
+                  *out++ = src[i];
+
+               for (; i < mr; ++i)
+                  *out++ = (T)0;
+            }
+         }
+      }
+
+      // Packs a kc x nc block of B into panels of nr columns. Each panel
+      // stores nr consecutive elements per row and is zero padded.
+      template <class T> inline
+      void gemm_pack_b(const size_t& kc, const size_t& nc, const T* b, const size_t& ldb, const size_t& nr, T* out) {
+         for (size_t j0 = 0; j0 < nc; j0 += nr) {
+            const size_t n = nc - j0 < nr ? nc - j0 : nr;
+
+            for (size_t p = 0; p < kc; ++p) {
+               size_t j = 0;
+
+               for (; j < n; ++j)
+                  *out++ = b[p + (j0 + j) * ldb];
+
+               for (; j < nr; ++j)
+                  *out++ = (T)0;
+            }
+         }
+      }
+
+      template <class T> inline
+      void gemm_small(const size_t& m, const size_t& n, const size_t& k, const T& alpha, const T* a, const size_t& lda, const T* b, const size_t& ldb, const T& beta, T* c, const size_t& ldc) {
+         for (size_t j = 0; j < n; ++j) {
+            T* cj = c + j * ldc;
+
+            if (beta == (T)0) {
+               for (size_t i = 0; i < m; ++i)
+                  cj[i] = (T)0;
+            }
+            else if (beta != (T)1) {
+               for (size_t i = 0; i < m; ++i)
+                  cj[i] *= beta;
+            }
+
+            for (size_t p = 0; p < k; ++p) {
+               const T t = alpha * b[p + j * ldb];
+               const T* ap = a + p * lda;
+
+               for (size_t i = 0; i < m; ++i)
+                  cj[i] += t * ap[i];
+            }
+         }
+      }
+
+      template <class T> inline
+      void gemm_packed(const size_t& m, const size_t& n, const size_t& k, const T& alpha, const T* a, const size_t& lda, const T* b, const size_t& ldb, const T& beta, T* c, const size_t& ldc) {
+         typedef GemmBlocking<T> blocking;
+
+         const GemmKernel<T> kernel = gemm_kernel<T>();
+         const size_t mr = kernel.mr, nr = kernel.nr;
+         const size_t mcmax = (blocking::MC + mr - 1) / mr * mr;
+         const size_t ncmax = (blocking::NC + nr - 1) / nr * nr;
+
+         T* pa = gemm_workspace<T>(0, mcmax * blocking::KC);
+         T* pb = gemm_workspace<T>(1, ncmax * blocking::KC);
+
+         for (size_t jc = 0; jc < n; jc += blocking::NC) {
+            const size_t nc = n - jc < blocking::NC ? n - jc : blocking::NC;
+
+            for (size_t pc = 0; pc < k; pc += blocking::KC) {
+               const size_t kc = k - pc < blocking::KC ? k - pc : blocking::KC;
+
+               // The first block along k applies beta, the others accumulate.
+               const T b0 = pc == 0 ? beta : (T)1;
+
+               gemm_pack_b(kc, nc, b + pc + jc * ldb, ldb, nr, pb);
+
+               for (size_t ic = 0; ic < m; ic += blocking::MC) {
+                  const size_t mc = m - ic < blocking::MC ? m - ic : blocking::MC;
+
+                  gemm_pack_a(mc, kc, a + ic + pc * lda, lda, mr, pa);
+
+                  for (size_t jr = 0; jr < nc; jr += nr) {
+                     const size_t nn = nc - jr < nr ? nc - jr : nr;
+
+                     for (size_t ir = 0; ir < mc; ir += mr) {
+                        const size_t mm = mc - ir < mr ? mc - ir : mr;
+
+                        kernel.kernel(kc, pa + ir * kc, pb + jr * kc, c + (ic + ir) + (jc + jr) * ldc, ldc, alpha, b0, mm, nn);
+                     }
+                  }
+               }
+            }
+         }
+      }
+
+      template <size_t M, size_t N, size_t I, size_t J, size_t R>
+      struct UnrolledDot {
+         template <class T> static T apply(const T* a, const T* b, const T& acc) {
+            return UnrolledDot<M, N, I, J, R + 1>::apply(a, b, acc + a[I + R * M] * b[R + J * N]);
+         }
+      };
+
+      template <size_t M, size_t N, size_t I, size_t J>
+      struct UnrolledDot<M, N, I, J, N> {
+         template <class T> static T apply(const T*, const T*, const T& acc) {
+            return acc;
+         }
+      };
+
+      template <size_t M, size_t N, size_t P, size_t K, size_t End = M * P>
+      struct UnrolledProduct {
+         template <class T> static void apply(const T* a, const T* b, T* c) {
+            c[K] = UnrolledDot<M, N, K % M, K / M, 0>::apply(a, b, (T)0);
+            UnrolledProduct<M, N, P, K + 1, End>::apply(a, b, c);
+         }
+      };
+
+      template <size_t M, size_t N, size_t P, size_t End>
+      struct UnrolledProduct<M, N, P, End, End> {
+         template <class T> static void apply(const T*, const T*, T*) {}
+      };
+
+      /*! Computes a general matrix product on the calling thread, see
+       * @c gemm.
+       */
+      template <class T> inline
+      void gemm_serial(const size_t& m, const size_t& n, const size_t& k, const T& alpha, const T* a, const size_t& lda, const T* b, const size_t& ldb, const T& beta, T* c, const size_t& ldc) {
+         if (m == 0 || n == 0)
+            return;
+
+         if (m * n * k < GemmBlocking<T>::Threshold)
+            gemm_small(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+         else
+            gemm_packed(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+      }
+
+      template <size_t M, size_t N, size_t P, bool Parallel, class T> inline
+      void product(const T* a, const T* b, T* c, std::true_type) {
+         UnrolledProduct<M, N, P, 0>::apply(a, b, c);
+      }
+
+      template <size_t M, size_t N, size_t P, bool Parallel, class T> inline
+      void product(const T* a, const T* b, T* c, std::false_type) {
+         if (Parallel)
+            gemm(M, P, N, (T)1, a, M, b, N, (T)0, c, M);
+         else
+            gemm_serial(M, P, N, (T)1, a, M, b, N, (T)0, c, M);
+      }
+   }
+
+   template <class T> inline
+   void gemm(const size_t& m, const size_t& n, const size_t& k, const T& alpha, const T* a, const size_t& lda, const T* b, const size_t& ldb, const T& beta, T* c, const size_t& ldc) {
+      const size_t block = GemmBlocking<T>::ParallelBlock;
+
+      // The result is split into independent row or column blocks along its
+      // longer side; every block packs its own panels.
+      if (m >= n) {
+         parallel_for(0, (m + block - 1) / block, block * n * k, [=](const size_t& begin, const size_t& end) {
+            const size_t i0 = begin * block, i1 = end * block < m ? end * block : m;
+            Detail::gemm_serial(i1 - i0, n, k, alpha, a + i0, lda, b, ldb, beta, c + i0, ldc);
+         });
+      }
+      else {
+         parallel_for(0, (n + block - 1) / block, block * m * k, [=](const size_t& begin, const size_t& end) {
+            const size_t j0 = begin * block, j1 = end * block < n ? end * block : n;
+            Detail::gemm_serial(m, j1 - j0, k, alpha, a, lda, b + j0 * ldb, ldb, beta, c + j0 * ldc, ldc);
+         });
+      }
+   }
+
+   template <size_t M, size_t N, size_t P, bool Parallel, class T> inline
+   void product(const T* a, const T* b, T* c) {
+      MATH_PERF_SCOPE("multiply");
+      MATH_ACCOUNT_CALL(Multiply, 2 * M * N * P);
+      Detail::product<M, N, P, Parallel>(a, b, c, std::integral_constant<bool, M * N * P <= GemmBlocking<T>::UnrollLimit>());
+   }
+}
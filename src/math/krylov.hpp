@@ -0,0 +1,276 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "dynamicmatrix.hpp"
+#include "dynamicvector.hpp"
+#include "sparse.hpp"
+#include "functions.hpp"
+#include "threadpool.hpp"
+#include <vector>
+#include <cassert>
+
+namespace Math {
+
+   /*! Stopping criteria of iterative solvers. Iteration stops when the
+    * residual norm |b - A x| falls to tolerance * |b| or to
+    * absolute_tolerance, whichever is larger.
+    */
+   template <class T = double> struct IterativeOptions {
+
+      /*! Constructs solver options.
+       *
+       * @param tolerance Residual norm relative to the norm of b.
+       * @param maxIterations Maximum number of operator applications.
+       * @param restart Krylov subspace dimension of GMRES.
+       * @param absoluteTolerance Residual norm regardless of b.
+       */
+      IterativeOptions(const T& tolerance = (T)1e-10, const size_t& maxIterations = 1000, const size_t& restart = 30, const T& absoluteTolerance = T());
+
+      //! Residual norm relative to the norm of b.
+      T tolerance;
+
+      //! Maximum number of iterations.
+      size_t max_iterations;
+
+      //! Krylov subspace dimension of GMRES before restarting.
+      size_t restart;
+
+      //! Residual norm regardless of b.
+      T absolute_tolerance;
+   };
+
+   /*! Outcome of an iterative solver.
+    */
+   template <class T = double> struct IterativeResult {
+
+      //! Number of iterations run.
+      size_t iterations;
+
+      //! Norm of the final residual.
+      T residual;
+
+      //! @c true if the stopping criteria were met.
+      bool converged;
+   };
+
+   /*! Work vectors of iterative solvers. Vectors are kept between calls
+    * and reallocated only when the system size or the number of vectors
+    * grows, so that repeated solves of equally sized systems allocate
+    * nothing.
+    */
+   template <class T = double> class KrylovWorkspace {
+   public:
+
+      /*! Constructs an empty workspace.
+       */
+      KrylovWorkspace();
+
+      /*! Makes sure the workspace holds enough vectors and scalars.
+       * References to vectors taken before are invalidated when the
+       * number of vectors grows.
+       *
+       * @param count Number of vectors.
+       * @param n Size of each vector.
+       * @param scalars Number of scalars.
+       */
+      void prepare(const size_t& count, const size_t& n, const size_t& scalars = 0);
+
+      /*! Gets a work vector.
+       *
+       * @param k Vector number, 0-based.
+       * @return Reference to the vector.
+       */
+      DynamicVector<T>& operator [](const size_t& k);
+
+      /*! Gets scalar storage.
+       *
+       * @return Pointer to the scalars.
+       */
+      T* scalars();
+
+   private:
+      std::vector<DynamicVector<T> > _vectors;
+      std::vector<T> _scalars;
+   };
+
+   /*! Preconditioner doing nothing, z = r.
+    */
+   template <class T = double> class IdentityPreconditioner {
+   public:
+
+      /*! Applies the preconditioner.
+       *
+       * @param r Residual.
+       * @param z Output, same size as @p r.
+       */
+      void operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const;
+   };
+
+   /*! Jacobi preconditioner, which scales the residual by the inverse
+    * diagonal of the matrix.
+    */
+   template <class T = double> class JacobiPreconditioner {
+   public:
+
+      /*! Constructs a preconditioner of a sparse matrix.
+       *
+       * @param a Square matrix without zeros on the diagonal.
+       */
+      template <SparseFormat F> explicit JacobiPreconditioner(const SparseMatrix<T, F>& a);
+
+      /*! Constructs a preconditioner of a dense matrix.
+       *
+       * @param a Square matrix without zeros on the diagonal.
+       */
+      explicit JacobiPreconditioner(const ConstDynamicMatrixView<T>& a);
+
+      /*! Applies the preconditioner.
+       *
+       * @param r Residual.
+       * @param z Output, same size as @p r.
+       */
+      void operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const;
+
+   private:
+      DynamicVector<T> _inverse;
+   };
+
+   /*! Incomplete LU factorization without fill-in. The factors have the
+    * sparsity pattern of the matrix, L with implicit unit diagonal.
+    */
+   template <class T = double> class Ilu0Preconditioner {
+   public:
+
+      /*! Factorizes a matrix.
+       *
+       * @param a Square matrix with every diagonal element stored and
+       *          nonzero pivots.
+       */
+      explicit Ilu0Preconditioner(const SparseMatrix<T, Csr>& a);
+
+      /*! Applies the preconditioner by forward and backward substitution.
+       *
+       * @param r Residual.
+       * @param z Output, same size as @p r.
+       */
+      void operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const;
+
+   private:
+      SparseMatrix<T, Csr> _lu;
+      std::vector<size_t> _diagonal;
+   };
+
+   /*! Symmetric successive over-relaxation preconditioner. It is symmetric
+    * for symmetric matrices and therefore suits conjugate gradients.
+    */
+   template <class T = double> class SsorPreconditioner {
+   public:
+
+      /*! Constructs a preconditioner.
+       *
+       * @param a Square matrix with every diagonal element stored and
+       *          nonzero.
+       * @param omega Relaxation factor between 0 and 2; 1 gives symmetric
+       *              Gauss-Seidel.
+       */
+      explicit SsorPreconditioner(const SparseMatrix<T, Csr>& a, const T& omega = (T)1);
+
+      /*! Applies the preconditioner by a forward and a backward sweep.
+       *
+       * @param r Residual.
+       * @param z Output, same size as @p r.
+       */
+      void operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const;
+
+   private:
+      SparseMatrix<T, Csr> _a;
+      std::vector<size_t> _diagonal;
+      T _omega;
+   };
+
+   /*! Solves a symmetric positive definite system A x = b with the
+    * preconditioned conjugate gradient method.
+    *
+    * The operator may be a SparseMatrix, a DynamicMatrix, a square Matrix
+    * or a callable f(x, y) computing y = A x. The preconditioner is a
+    * callable p(r, z) computing z = M^-1 r, symmetric positive definite.
+    *
+    * @param a Operator.
+    * @param b Right hand side.
+    * @param x Initial guess, overwritten by the solution. An empty vector
+    *          starts from zero.
+    * @param preconditioner Preconditioner.
+    * @param options Stopping criteria.
+    * @param workspace Work vectors, reused across calls.
+    * @return Iterations, residual and convergence.
+    */
+   template <class T, class A, class P> IterativeResult<T> cg(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options, KrylovWorkspace<T>& workspace);
+
+   /*! Solves a symmetric positive definite system with the preconditioned
+    * conjugate gradient method, using temporary work vectors.
+    *
+    * @param a Operator.
+    * @param b Right hand side.
+    * @param x Initial guess, overwritten by the solution.
+    * @param preconditioner Preconditioner.
+    * @param options Stopping criteria.
+    * @return Iterations, residual and convergence.
+    */
+   template <class T, class A, class P = IdentityPreconditioner<T> > IterativeResult<T> cg(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner = P(), const IterativeOptions<T>& options = IterativeOptions<T>());
+
+   /*! Solves a general system A x = b with the right preconditioned
+    * stabilized biconjugate gradient method. Operators and preconditioners
+    * are as in @c cg. Each iteration applies the operator twice.
+    *
+    * @param a Operator.
+    * @param b Right hand side.
+    * @param x Initial guess, overwritten by the solution. An empty vector
+    *          starts from zero.
+    * @param preconditioner Preconditioner.
+    * @param options Stopping criteria.
+    * @param workspace Work vectors, reused across calls.
+    * @return Iterations, residual and convergence.
+    */
+   template <class T, class A, class P> IterativeResult<T> bicgstab(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options, KrylovWorkspace<T>& workspace);
+
+   /*! Solves a general system with the stabilized biconjugate gradient
+    * method, using temporary work vectors.
+    *
+    * @param a Operator.
+    * @param b Right hand side.
+    * @param x Initial guess, overwritten by the solution.
+    * @param preconditioner Preconditioner.
+    * @param options Stopping criteria.
+    * @return Iterations, residual and convergence.
+    */
+   template <class T, class A, class P = IdentityPreconditioner<T> > IterativeResult<T> bicgstab(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner = P(), const IterativeOptions<T>& options = IterativeOptions<T>());
+
+   /*! Solves a general system A x = b with the right preconditioned GMRES
+    * method, restarted after options.restart iterations. Operators and
+    * preconditioners are as in @c cg.
+    *
+    * @param a Operator.
+    * @param b Right hand side.
+    * @param x Initial guess, overwritten by the solution. An empty vector
+    *          starts from zero.
+    * @param preconditioner Preconditioner.
+    * @param options Stopping criteria and restart length.
+    * @param workspace Work vectors, reused across calls.
+    * @return Iterations, residual and convergence.
+    */
+   template <class T, class A, class P> IterativeResult<T> gmres(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options, KrylovWorkspace<T>& workspace);
+
+   /*! Solves a general system with the restarted GMRES method, using
+    * temporary work vectors.
+    *
+    * @param a Operator.
+    * @param b Right hand side.
+    * @param x Initial guess, overwritten by the solution.
+    * @param preconditioner Preconditioner.
+    * @param options Stopping criteria and restart length.
+    * @return Iterations, residual and convergence.
+    */
+   template <class T, class A, class P = IdentityPreconditioner<T> > IterativeResult<T> gmres(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner = P(), const IterativeOptions<T>& options = IterativeOptions<T>());
+}
+
+#include "krylov.inl"
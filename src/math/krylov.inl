@@ -0,0 +1,549 @@
+namespace Math {
+
+   namespace Detail {
+
+      /*! Applies a callable operator, y = A x.
+       */
+      template <class A, class T> inline
+      void apply_operator(const A& a, const DynamicVector<T>& x, DynamicVector<T>& y) {
+         a(x, y);
+      }
+
+      template <class T, SparseFormat F> inline
+      void apply_operator(const SparseMatrix<T, F>& a, const DynamicVector<T>& x, DynamicVector<T>& y) {
+         multiply(a, x, y);
+      }
+
+      /*! Multiplies a dense column-major matrix by a vector without
+       * temporaries, in parallel over row ranges.
+       */
+      template <class T> inline
+      void dense_operator(const size_t& m, const size_t& n, const T* a, const size_t& lda, const T* x, T* y) {
+         parallel_for(0, m, n, [=](const size_t& begin, const size_t& end) {
+            for (size_t i = begin; i < end; ++i)
+               y[i] = T();
+
+            for (size_t j = 0; j < n; ++j) {
+               const T* column = a + j * lda;
+               const T s = x[j];
+
+               for (size_t i = begin; i < end; ++i)
+                  y[i] += column[i] * s;
+            }
+         });
+      }
+
+      template <class T> inline
+      void apply_operator(const DynamicMatrix<T>& a, const DynamicVector<T>& x, DynamicVector<T>& y) {
+         assert(a.cols() == x.rows() && a.rows() == y.rows());
+         dense_operator(a.rows(), a.cols(), a.data(), a.rows(), x.data(), y.data());
+      }
+
+      template <size_t N, class T, class C> inline
+      void apply_operator(const Matrix<N, N, T, C>& a, const DynamicVector<T>& x, DynamicVector<T>& y) {
+         assert(x.rows() == N && y.rows() == N);
+         dense_operator(N, N, a.data(), N, x.data(), y.data());
+      }
+
+      /*! Computes y = y + a x.
+       */
+      template <class T> inline
+      void axpy(const size_t& n, const T& a, const T* x, T* y) {
+         for (size_t i = 0; i < n; ++i)
+            y[i] += a * x[i];
+      }
+
+      /*! Computes r = b - A x, starting x from zero when it is empty.
+       */
+      template <class T, class A> inline
+      void residual(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, DynamicVector<T>& r) {
+         const size_t n = b.rows();
+
+         if (x.rows() == 0)
+            x = DynamicVector<T>(n);
+
+         assert(x.rows() == n);
+
+         apply_operator(a, x, r);
+
+         T* pr = r.data();
+         const T* pb = b.data();
+
+         for (size_t i = 0; i < n; ++i)
+            pr[i] = pb[i] - pr[i];
+      }
+
+      /*! Tells the residual norm at which iteration stops.
+       */
+      template <class T> inline
+      T stopping_residual(const DynamicVector<T>& b, const IterativeOptions<T>& options) {
+         const T scaled = options.tolerance * Sqrt(dot(b.rows(), b.data(), b.data()));
+         return scaled > options.absolute_tolerance ? scaled : options.absolute_tolerance;
+      }
+
+      /*! Finds the positions of diagonal elements in compressed rows.
+       */
+      template <class T> inline
+      std::vector<size_t> diagonal_positions(const SparseMatrix<T, Csr>& a) {
+         assert(a.rows() == a.cols());
+
+         std::vector<size_t> out(a.rows());
+         const size_t* pointers = a.pointers();
+         const size_t* indices = a.indices();
+
+         for (size_t i = 0; i < a.rows(); ++i) {
+            const size_t* at = std::lower_bound(indices + pointers[i], indices + pointers[i + 1], i);
+            assert(at != indices + pointers[i + 1] && *at == i);
+            out[i] = at - indices;
+         }
+
+         return out;
+      }
+   }
+
+   template <class T> inline
+   IterativeOptions<T>::IterativeOptions(const T& tolerance, const size_t& maxIterations, const size_t& restart, const T& absoluteTolerance)
+      : tolerance(tolerance), max_iterations(maxIterations), restart(restart), absolute_tolerance(absoluteTolerance) {
+
+   }
+
+   template <class T> inline
+   KrylovWorkspace<T>::KrylovWorkspace() {
+
+   }
+
+   template <class T> inline
+   void KrylovWorkspace<T>::prepare(const size_t& count, const size_t& n, const size_t& scalars) {
+      if (_vectors.size() < count)
+         _vectors.resize(count);
+
+      for (size_t k = 0; k < count; ++k) {
+         if (_vectors[k].rows() != n)
+            _vectors[k] = DynamicVector<T>(n, false);
+      }
+
+      if (_scalars.size() < scalars)
+         _scalars.resize(scalars);
+   }
+
+   template <class T> inline
+   DynamicVector<T>& KrylovWorkspace<T>::operator [](const size_t& k) {
+      assert(k < _vectors.size());
+      return _vectors[k];
+   }
+
+   template <class T> inline
+   T* KrylovWorkspace<T>::scalars() {
+      return _scalars.data();
+   }
+
+   template <class T> inline
+   void IdentityPreconditioner<T>::operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const {
+      std::copy(r.data(), r.data() + r.rows(), z.data());
+   }
+
+   template <class T>
+   template <SparseFormat F> inline
+   JacobiPreconditioner<T>::JacobiPreconditioner(const SparseMatrix<T, F>& a) : _inverse(a.rows(), false) {
+      assert(a.rows() == a.cols());
+
+      for (size_t i = 1; i <= a.rows(); ++i) {
+         assert(a(i, i) != T());
+         _inverse[i] = (T)1 / a(i, i);
+      }
+   }
+
+   template <class T> inline
+   JacobiPreconditioner<T>::JacobiPreconditioner(const ConstDynamicMatrixView<T>& a) : _inverse(a.rows(), false) {
+      assert(a.rows() == a.cols());
+
+      for (size_t i = 1; i <= a.rows(); ++i) {
+         assert(a(i, i) != T());
+         _inverse[i] = (T)1 / a(i, i);
+      }
+   }
+
+   template <class T> inline
+   void JacobiPreconditioner<T>::operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const {
+      const T* pr = r.data();
+      const T* d = _inverse.data();
+      T* pz = z.data();
+
+      for (size_t i = 0; i < r.rows(); ++i)
+         pz[i] = pr[i] * d[i];
+   }
+
+   template <class T> inline
+   Ilu0Preconditioner<T>::Ilu0Preconditioner(const SparseMatrix<T, Csr>& a) : _lu(a), _diagonal(Detail::diagonal_positions(a)) {
+      const size_t n = a.rows();
+      const size_t* pointers = _lu.pointers();
+      const size_t* indices = _lu.indices();
+      T* values = _lu.values();
+
+      // Position of each column in the current row, n when not stored.
+      std::vector<size_t> position(n, n);
+
+      for (size_t i = 0; i < n; ++i) {
+         for (size_t k = pointers[i]; k < pointers[i + 1]; ++k)
+            position[indices[k]] = k;
+
+         for (size_t k = pointers[i]; k < _diagonal[i]; ++k) {
+            const size_t r = indices[k];
+            assert(values[_diagonal[r]] != T());
+
+            const T l = values[k] /= values[_diagonal[r]];
+
+            // Row r of U updates the stored elements of row i only.
+            for (size_t q = _diagonal[r] + 1; q < pointers[r + 1]; ++q) {
+               if (position[indices[q]] != n)
+                  values[position[indices[q]]] -= l * values[q];
+            }
+         }
+
+         for (size_t k = pointers[i]; k < pointers[i + 1]; ++k)
+            position[indices[k]] = n;
+      }
+   }
+
+   template <class T> inline
+   void Ilu0Preconditioner<T>::operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const {
+      const size_t n = r.rows();
+      const size_t* pointers = _lu.pointers();
+      const size_t* indices = _lu.indices();
+      const T* values = _lu.values();
+      const T* pr = r.data();
+      T* pz = z.data();
+
+      for (size_t i = 0; i < n; ++i) {
+         T sum = pr[i];
+
+         for (size_t k = pointers[i]; k < _diagonal[i]; ++k)
+            sum -= values[k] * pz[indices[k]];
+
+         pz[i] = sum;
+      }
+
+      for (size_t i = n; i-- > 0;) {
+         T sum = pz[i];
+
+         for (size_t k = _diagonal[i] + 1; k < pointers[i + 1]; ++k)
+            sum -= values[k] * pz[indices[k]];
+
+         pz[i] = sum / values[_diagonal[i]];
+      }
+   }
+
+   template <class T> inline
+   SsorPreconditioner<T>::SsorPreconditioner(const SparseMatrix<T, Csr>& a, const T& omega) : _a(a), _diagonal(Detail::diagonal_positions(a)), _omega(omega) {
+      assert(omega > T() && omega < (T)2);
+   }
+
+   template <class T> inline
+   void SsorPreconditioner<T>::operator ()(const DynamicVector<T>& r, DynamicVector<T>& z) const {
+      const size_t n = r.rows();
+      const size_t* pointers = _a.pointers();
+      const size_t* indices = _a.indices();
+      const T* values = _a.values();
+      const T* pr = r.data();
+      T* pz = z.data();
+
+      // z = (2 - w) / w (D / w + U)^-1 (D / w) (D / w + L)^-1 r.
+      for (size_t i = 0; i < n; ++i) {
+         T sum = pr[i];
+
+         for (size_t k = pointers[i]; k < _diagonal[i]; ++k)
+            sum -= values[k] * pz[indices[k]];
+
+         pz[i] = sum * _omega / values[_diagonal[i]];
+      }
+
+      for (size_t i = 0; i < n; ++i)
+         pz[i] *= values[_diagonal[i]] / _omega;
+
+      for (size_t i = n; i-- > 0;) {
+         T sum = pz[i];
+
+         for (size_t k = _diagonal[i] + 1; k < pointers[i + 1]; ++k)
+            sum -= values[k] * pz[indices[k]];
+
+         pz[i] = sum * _omega / values[_diagonal[i]];
+      }
+
+      const T scale = ((T)2 - _omega) / _omega;
+
+      for (size_t i = 0; i < n; ++i)
+         pz[i] *= scale;
+   }
+
+   template <class T, class A, class P> inline
+   IterativeResult<T> cg(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options, KrylovWorkspace<T>& workspace) {
+      const size_t n = b.rows();
+      workspace.prepare(4, n);
+
+      DynamicVector<T>& r = workspace[0];
+      DynamicVector<T>& z = workspace[1];
+      DynamicVector<T>& p = workspace[2];
+      DynamicVector<T>& q = workspace[3];
+
+      Detail::residual(a, b, x, r);
+
+      const T stop = Detail::stopping_residual(b, options);
+      IterativeResult<T> result = { 0, Sqrt(Detail::dot(n, r.data(), r.data())), false };
+
+      if (result.residual <= stop) {
+         result.converged = true;
+         return result;
+      }
+
+      preconditioner(r, z);
+      std::copy(z.data(), z.data() + n, p.data());
+
+      T rz = Detail::dot(n, r.data(), z.data());
+
+      while (result.iterations < options.max_iterations) {
+         Detail::apply_operator(a, p, q);
+
+         const T alpha = rz / Detail::dot(n, p.data(), q.data());
+
+         Detail::axpy(n, alpha, p.data(), x.data());
+         Detail::axpy(n, -alpha, q.data(), r.data());
+
+         ++result.iterations;
+         result.residual = Sqrt(Detail::dot(n, r.data(), r.data()));
+
+         if (result.residual <= stop) {
+            result.converged = true;
+            break;
+         }
+
+         preconditioner(r, z);
+
+         const T next = Detail::dot(n, r.data(), z.data());
+         const T beta = next / rz;
+         T* pp = p.data();
+         const T* pz = z.data();
+
+         for (size_t i = 0; i < n; ++i)
+            pp[i] = pz[i] + beta * pp[i];
+
+         rz = next;
+      }
+
+      return result;
+   }
+
+   template <class T, class A, class P> inline
+   IterativeResult<T> cg(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options) {
+      KrylovWorkspace<T> workspace;
+      return cg(a, b, x, preconditioner, options, workspace);
+   }
+
+   template <class T, class A, class P> inline
+   IterativeResult<T> bicgstab(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options, KrylovWorkspace<T>& workspace) {
+      const size_t n = b.rows();
+      workspace.prepare(7, n);
+
+      DynamicVector<T>& r = workspace[0];
+      DynamicVector<T>& shadow = workspace[1];
+      DynamicVector<T>& p = workspace[2];
+      DynamicVector<T>& v = workspace[3];
+      DynamicVector<T>& y = workspace[4];
+      DynamicVector<T>& z = workspace[5];
+      DynamicVector<T>& t = workspace[6];
+
+      Detail::residual(a, b, x, r);
+
+      const T stop = Detail::stopping_residual(b, options);
+      IterativeResult<T> result = { 0, Sqrt(Detail::dot(n, r.data(), r.data())), false };
+
+      if (result.residual <= stop) {
+         result.converged = true;
+         return result;
+      }
+
+      std::copy(r.data(), r.data() + n, shadow.data());
+      std::fill(p.data(), p.data() + n, T());
+      std::fill(v.data(), v.data() + n, T());
+
+      T rho = 1, alpha = 1, omega = 1;
+
+      while (result.iterations < options.max_iterations) {
+         const T next = Detail::dot(n, shadow.data(), r.data());
+
+         // The shadow residual became orthogonal to the residual.
+         if (next == T())
+            break;
+
+         const T beta = (next / rho) * (alpha / omega);
+         T* pp = p.data();
+         const T* pr = r.data();
+         const T* pv = v.data();
+
+         for (size_t i = 0; i < n; ++i)
+            pp[i] = pr[i] + beta * (pp[i] - omega * pv[i]);
+
+         preconditioner(p, y);
+         Detail::apply_operator(a, y, v);
+
+         alpha = next / Detail::dot(n, shadow.data(), v.data());
+         rho = next;
+
+         // r becomes the intermediate residual s = r - alpha v.
+         Detail::axpy(n, alpha, y.data(), x.data());
+         Detail::axpy(n, -alpha, v.data(), r.data());
+
+         ++result.iterations;
+         result.residual = Sqrt(Detail::dot(n, r.data(), r.data()));
+
+         if (result.residual <= stop) {
+            result.converged = true;
+            break;
+         }
+
+         preconditioner(r, z);
+         Detail::apply_operator(a, z, t);
+
+         const T tt = Detail::dot(n, t.data(), t.data());
+
+         if (tt == T())
+            break;
+
+         omega = Detail::dot(n, t.data(), r.data()) / tt;
+
+         Detail::axpy(n, omega, z.data(), x.data());
+         Detail::axpy(n, -omega, t.data(), r.data());
+
+         result.residual = Sqrt(Detail::dot(n, r.data(), r.data()));
+
+         if (result.residual <= stop) {
+            result.converged = true;
+            break;
+         }
+
+         if (omega == T())
+            break;
+      }
+
+      return result;
+   }
+
+   template <class T, class A, class P> inline
+   IterativeResult<T> bicgstab(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options) {
+      KrylovWorkspace<T> workspace;
+      return bicgstab(a, b, x, preconditioner, options, workspace);
+   }
+
+   template <class T, class A, class P> inline
+   IterativeResult<T> gmres(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options, KrylovWorkspace<T>& workspace) {
+      const size_t n = b.rows();
+      const size_t m = options.restart > 0 ? options.restart : 1;
+
+      // Vectors 0 to m hold the Krylov basis, followed by two work vectors.
+      // Scalars hold the (m + 1) x m Hessenberg matrix, the rotations and
+      // the rotated right hand side.
+      workspace.prepare(m + 3, n, (m + 1) * m + 3 * m + 1);
+
+      DynamicVector<T>& w = workspace[m + 1];
+      DynamicVector<T>& z = workspace[m + 2];
+      T* h = workspace.scalars();
+      T* cs = h + (m + 1) * m;
+      T* sn = cs + m;
+      T* g = sn + m;
+
+      const T stop = Detail::stopping_residual(b, options);
+      IterativeResult<T> result = { 0, T(), false };
+
+      for (;;) {
+         DynamicVector<T>& v0 = workspace[0];
+         Detail::residual(a, b, x, v0);
+
+         const T beta = Sqrt(Detail::dot(n, v0.data(), v0.data()));
+         result.residual = beta;
+
+         if (beta <= stop) {
+            result.converged = true;
+            break;
+         }
+
+         if (result.iterations >= options.max_iterations)
+            break;
+
+         Detail::scalar_scale(n, v0.data(), (T)1 / beta, v0.data());
+
+         std::fill(g, g + m + 1, T());
+         g[0] = beta;
+
+         size_t k = 0;
+
+         while (k < m && result.iterations < options.max_iterations) {
+            T* column = h + k * (m + 1);
+
+            preconditioner(workspace[k], z);
+            Detail::apply_operator(a, z, w);
+
+            // Modified Gram-Schmidt against the basis so far.
+            for (size_t i = 0; i <= k; ++i) {
+               column[i] = Detail::dot(n, w.data(), workspace[i].data());
+               Detail::axpy(n, -column[i], workspace[i].data(), w.data());
+            }
+
+            column[k + 1] = Sqrt(Detail::dot(n, w.data(), w.data()));
+
+            if (column[k + 1] != T())
+               Detail::scalar_scale(n, w.data(), (T)1 / column[k + 1], workspace[k + 1].data());
+
+            // Earlier rotations are applied to the new column, and a new
+            // rotation eliminates its subdiagonal element.
+            for (size_t i = 0; i < k; ++i) {
+               const T u = cs[i] * column[i] + sn[i] * column[i + 1];
+               column[i + 1] = -sn[i] * column[i] + cs[i] * column[i + 1];
+               column[i] = u;
+            }
+
+            const T norm = Sqrt(column[k] * column[k] + column[k + 1] * column[k + 1]);
+
+            cs[k] = norm != T() ? column[k] / norm : (T)1;
+            sn[k] = norm != T() ? column[k + 1] / norm : T();
+            column[k] = norm;
+            column[k + 1] = T();
+
+            g[k + 1] = -sn[k] * g[k];
+            g[k] = cs[k] * g[k];
+
+            ++k;
+            ++result.iterations;
+            result.residual = Abs(g[k]);
+
+            if (result.residual <= stop)
+               break;
+         }
+
+         // The least squares solution of the rotated Hessenberg system
+         // combines the basis into the correction of x.
+         for (size_t i = k; i-- > 0;) {
+            T sum = g[i];
+
+            for (size_t j = i + 1; j < k; ++j)
+               sum -= h[j * (m + 1) + i] * g[j];
+
+            g[i] = sum / h[i * (m + 1) + i];
+         }
+
+         std::fill(w.data(), w.data() + n, T());
+
+         for (size_t i = 0; i < k; ++i)
+            Detail::axpy(n, g[i], workspace[i].data(), w.data());
+
+         preconditioner(w, z);
+         Detail::axpy(n, (T)1, z.data(), x.data());
+      }
+
+      return result;
+   }
+
+   template <class T, class A, class P> inline
+   IterativeResult<T> gmres(const A& a, const DynamicVector<T>& b, DynamicVector<T>& x, const P& preconditioner, const IterativeOptions<T>& options) {
+      KrylovWorkspace<T> workspace;
+      return gmres(a, b, x, preconditioner, options, workspace);
+   }
+}
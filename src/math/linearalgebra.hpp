@@ -2,7 +2,11 @@
 
 #include <type_traits>
 #include <limits>
+#include <algorithm>
+#include <array>
+#include <vector>
 #include "matrix.hpp"
+#include "dynamicvector.hpp"
 #include "functions.hpp"
 
 namespace Math {
@@ -27,6 +31,26 @@ namespace Math {
     */
    template <size_t M, size_t N, class T> Vector<M, T> solvelu(const Matrix<M, M, T>& l, const Matrix<M, N, T>& u, const Matrix<M, M, T>& pivot, const Vector<M, T>& b);
 
+   /*! Calculates a LU decomposition with partial pivoting in place. On
+    * return the strictly lower part of @p a holds the unit lower
+    * triangulation element matrix and the rest holds the upper one.
+    *
+    * @param a Subject matrix, overwritten by its decomposition.
+    * @param pivots Receives 0-based row indices; row i was swapped with row
+    *               pivots[i] at step i.
+    * @return Number of swaps made.
+    */
+   template <size_t N, class T, class C> size_t lu(Matrix<N, N, T, C>& a, std::array<size_t, N>& pivots);
+
+   /*! Solves linear equations using an in-place LU decomposition.
+    *
+    * @param lu Decomposed matrix from @c lu.
+    * @param pivots Row swaps from @c lu.
+    * @param b Right hand side columns to solve.
+    * @return Solved columns.
+    */
+   template <size_t N, size_t P, class T, class C, class D> Matrix<N, P, T> solvelu(const Matrix<N, N, T, C>& lu, const std::array<size_t, N>& pivots, const Matrix<N, P, T, D>& b);
+
    /*! Finds out the determinant value of a matrix.
     *
     * @param m Subject matrix.
@@ -41,6 +65,14 @@ namespace Math {
     */
    template <size_t M, size_t N, class T, class C> Matrix<M, N, T> inv(const Matrix<M, N, T, C>& m);
 
+   /*! Finds out the inverse of an affine transformation matrix, whose last
+    * row is (0, 0, 0, 1). Only the upper left 3x3 block is inverted.
+    *
+    * @param m Affine transformation matrix.
+    * @return An inverted affine transformation matrix.
+    */
+   template <class T, class C> Matrix<4, 4, T> invaffine(const Matrix<4, 4, T, C>& m);
+
    /*! Solves a linear system.
     *
     * @param a Coefficient matrix.
@@ -48,6 +80,112 @@ namespace Math {
     * @return A solved matrix.
     */
    template <size_t M, size_t N, size_t P, class T, class C, class D> Matrix<M, P, T> solve(const Matrix<M, N, T, C>& a, const Matrix<N, P, T, D>& b);
+
+   /*! Finds out the determinant value of a matrix expression.
+    *
+    * @param m Subject expression.
+    * @return A determinant value.
+    */
+   template <class E> typename std::enable_if<E::Rows == E::Cols && E::Rows >= 2, typename E::type>::type det(const MatrixExpression<E>& m);
+
+   /*! Finds out the inverse matrix of a matrix expression.
+    *
+    * @param m Subject expression.
+    * @return An inverted matrix.
+    */
+   template <class E> Matrix<E::Rows, E::Cols, typename E::type> inv(const MatrixExpression<E>& m);
+
+   /*! Solves a linear system given as matrix expressions.
+    *
+    * @param a Coefficient expression.
+    * @param b Expression to solve.
+    * @return A solved matrix.
+    */
+   template <class E, class F> typename std::enable_if<E::Cols == F::Rows, Matrix<E::Rows, F::Cols, typename E::type> >::type solve(const MatrixExpression<E>& a, const MatrixExpression<F>& b);
+
+   /*! Calculates a LU decomposition of a square matrix and returns
+    * individual element matrices.
+    *
+    * @param m Subject matrix.
+    * @param l Lower triangulation element matrix.
+    * @param u Upper triangulation element matrix.
+    * @param pivot A pivot or permutation matrix.
+    * @return Number of swaps made to produce a permutation matrix.
+    */
+   template <class T> size_t lu(const DynamicMatrix<T>& m, DynamicMatrix<T>& l, DynamicMatrix<T>& u, DynamicMatrix<T>& pivot);
+
+   /*! Solves a linear equation using LU decomposition.
+    *
+    * @param l Lower triangulated matrix.
+    * @param u Upper triangulated matrix.
+    * @param pivot Permutation matrix.
+    * @param b Vector to solve.
+    * @return A solved vector.
+    */
+   template <class T> DynamicVector<T> solvelu(const DynamicMatrix<T>& l, const DynamicMatrix<T>& u, const DynamicMatrix<T>& pivot, const DynamicVector<T>& b);
+
+   /*! Calculates a LU decomposition of a square matrix with partial
+    * pivoting in place.
+    *
+    * @param a Subject matrix, overwritten by its decomposition.
+    * @param pivots Receives 0-based row indices; row i was swapped with row
+    *               pivots[i] at step i.
+    * @return Number of swaps made.
+    */
+   template <class T> size_t lu(DynamicMatrix<T>& a, std::vector<size_t>& pivots);
+
+   /*! Solves linear equations using an in-place LU decomposition.
+    *
+    * @param lu Decomposed matrix from @c lu.
+    * @param pivots Row swaps from @c lu.
+    * @param b Right hand side columns to solve.
+    * @return Solved columns.
+    */
+   template <class T> DynamicMatrix<T> solvelu(const DynamicMatrix<T>& lu, const std::vector<size_t>& pivots, const DynamicMatrix<T>& b);
+
+   /*! Finds out the determinant value of a square matrix.
+    *
+    * @param m Subject matrix.
+    * @return A determinant value.
+    */
+   template <class T> T det(const DynamicMatrix<T>& m);
+
+   /*! Finds out the inverse matrix.
+    *
+    * @param m Subject matrix.
+    * @return An inverted matrix.
+    */
+   template <class T> DynamicMatrix<T> inv(const DynamicMatrix<T>& m);
+
+   /*! Solves a linear system.
+    *
+    * @param a Square coefficient matrix.
+    * @param b Matrix to solve.
+    * @return A solved matrix.
+    */
+   template <class T> DynamicMatrix<T> solve(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b);
+
+   /*! Finds out the determinant value of a square view.
+    *
+    * @param m Subject view.
+    * @return A determinant value.
+    */
+   template <class T> T det(const ConstDynamicMatrixView<T>& m);
+
+   /*! Finds out the inverse matrix of a view.
+    *
+    * @param m Subject view.
+    * @return An inverted matrix.
+    */
+   template <class T> DynamicMatrix<T> inv(const ConstDynamicMatrixView<T>& m);
+
+   /*! Solves a linear system given as run-time sized matrices or views.
+    *
+    * @param a Square coefficient matrix or view.
+    * @param b Matrix or view to solve.
+    * @return A solved matrix.
+    */
+   template <class A, class B> typename Detail::dynamic_result<A, B>::type solve(const A& a, const B& b);
 }
 
 #include "linearalgebra.inl"
@@ -1,124 +1,866 @@
 namespace Math {
 
-   template <size_t M, size_t N, class T> inline
-   size_t lu(const Matrix<M, N, T>& m, Matrix<M, M, T>& l, Matrix<M, N, T>& u, Matrix<M, M, T>& pivot) {
-      pivot = eye<M, T>();
-      l = Matrix<M, M, T>();
-      u = Matrix<M, N, T>();
-      size_t swaps = 0;
-
-      // Make a permutation matrix from the identity matrix. And count how
-      // many swaps were made.
-      for (size_t i = 1; i <= M; ++i) {
-         auto max = m(i, i);
-         size_t row = i;
-
-         for (size_t j = i; j <= M; ++j) {
-            if (m(j, i) > max) {
-               max = m(j, i);
-               row = j;
+   namespace Detail {
+
+      //! Order of the diagonal blocks of blocked triangular solves.
+      const size_t TriangularBlock = 64;
+
+      //! Columns of the panels of blocked LU decompositions.
+      const size_t LuBlock = 64;
+
+      /*! Computes C = alpha * A * B + beta * C, see @c gemm.
+       *
+       * @param parallel @c true to allow splitting the product across
+       *                 threads.
+       */
+      template <class T> inline
+      void gemm(const size_t& m, const size_t& n, const size_t& k, const T& alpha, const T* a, const size_t& lda, const T* b, const size_t& ldb, const T& beta, T* c, const size_t& ldc, const bool& parallel) {
+         if (parallel)
+            Math::gemm(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+         else
+            gemm_serial(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+      }
+
+      /*! Solves L * X = B in place for a unit lower triangular L, one right
+       * hand side column at a time.
+       */
+      template <class T> inline
+      void trsm_lower_unblocked(const size_t& n, const size_t& nrhs, const T* a, const size_t& lda, T* b, const size_t& ldb, const bool& parallel) {
+         // Right hand side columns are solved independently.
+         const auto columns = [=](const size_t& begin, const size_t& end) {
+            for (size_t c = begin; c < end; ++c) {
+               T* const x = b + c * ldb;
+
+               for (size_t j = 0; j < n; ++j) {
+                  const T s = x[j];
+                  const T* l = a + j * lda;
+
+                  for (size_t i = j + 1; i < n; ++i)
+                     x[i] -= l[i] * s;
+               }
             }
+         };
+
+         if (parallel)
+            parallel_for(0, nrhs, n * n / 2, columns);
+         else
+            columns(0, nrhs);
+      }
+
+      /*! Solves U * X = B in place for an upper triangular U, one right hand
+       * side column at a time.
+       */
+      template <class T> inline
+      void trsm_upper_unblocked(const size_t& n, const size_t& nrhs, const T* a, const size_t& lda, T* b, const size_t& ldb, const bool& parallel) {
+         // Right hand side columns are solved independently.
+         const auto columns = [=](const size_t& begin, const size_t& end) {
+            for (size_t c = begin; c < end; ++c) {
+               T* const x = b + c * ldb;
+
+               for (size_t j = n; j-- > 0; ) {
+                  const T* u = a + j * lda;
+                  const T s = x[j] /= u[j];
+
+                  for (size_t i = 0; i < j; ++i)
+                     x[i] -= u[i] * s;
+               }
+            }
+         };
+
+         if (parallel)
+            parallel_for(0, nrhs, n * n / 2, columns);
+         else
+            columns(0, nrhs);
+      }
+
+      /*! Solves L * X = B in place for a unit lower triangular L. Diagonal
+       * blocks are solved for all right hand sides together, and the rows
+       * below each block are updated with a single matrix product.
+       *
+       * @param n Order of L.
+       * @param nrhs Number of right hand side columns.
+       * @param a Matrix holding L below its diagonal.
+       * @param lda Distance between columns of @p a.
+       * @param b Right hand sides, overwritten by the solution.
+       * @param ldb Distance between columns of @p b.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void trsm_lower(const size_t& n, const size_t& nrhs, const T* a, const size_t& lda, T* b, const size_t& ldb, const bool& parallel) {
+         for (size_t k = 0; k < n; k += TriangularBlock) {
+            const size_t kb = std::min(TriangularBlock, n - k);
+
+            trsm_lower_unblocked(kb, nrhs, a + k * lda + k, lda, b + k, ldb, parallel);
+
+            if (k + kb < n)
+               gemm(n - k - kb, nrhs, kb, (T)-1, a + k * lda + k + kb, lda, b + k, ldb, (T)1, b + k + kb, ldb, parallel);
          }
+      }
 
-         // Swap the rows.
-         if (i != row) {
-            auto tmp = pivot.get_row(i);
-            pivot.set_row(i, pivot.get_row(row));
-            pivot.set_row(row, tmp);
-            ++swaps;
+      /*! Solves U * X = B in place for an upper triangular U. Diagonal
+       * blocks are solved from the bottom up for all right hand sides
+       * together, and the rows above each block are updated with a single
+       * matrix product.
+       *
+       * @param n Order of U.
+       * @param nrhs Number of right hand side columns.
+       * @param a Matrix holding U on and above its diagonal.
+       * @param lda Distance between columns of @p a.
+       * @param b Right hand sides, overwritten by the solution.
+       * @param ldb Distance between columns of @p b.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void trsm_upper(const size_t& n, const size_t& nrhs, const T* a, const size_t& lda, T* b, const size_t& ldb, const bool& parallel) {
+         for (size_t end = n; end > 0; ) {
+            const size_t k = end > TriangularBlock ? end - TriangularBlock : 0;
+
+            trsm_upper_unblocked(end - k, nrhs, a + k * lda + k, lda, b + k, ldb, parallel);
+
+            if (k > 0)
+               gemm(k, nrhs, end - k, (T)-1, a + k * lda, lda, b + k, ldb, (T)1, b, ldb, parallel);
+
+            end = k;
          }
       }
 
-      auto a = pivot * m;
+      /*! Solves A * X = B in place for a matrix factorized with @c getrf.
+       *
+       * @param n Order of the factorized matrix.
+       * @param nrhs Number of right hand side columns.
+       * @param lu Factorized matrix.
+       * @param lda Distance between columns of @p lu.
+       * @param pivots Row swaps from @c getrf.
+       * @param b Right hand sides, overwritten by the solution.
+       * @param ldb Distance between columns of @p b.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void getrs(const size_t& n, const size_t& nrhs, const T* lu, const size_t& lda, const size_t* pivots, T* b, const size_t& ldb, const bool& parallel) {
+         MATH_ACCOUNT_FLOPS(2 * n * n * nrhs);
+
+         for (size_t c = 0; c < nrhs; ++c) {
+            T* const x = b + c * ldb;
+
+            for (size_t j = 0; j < n; ++j)
+               std::swap(x[j], x[pivots[j]]);
+         }
+
+         trsm_lower(n, nrhs, lu, lda, b, ldb, parallel);
+         trsm_upper(n, nrhs, lu, lda, b, ldb, parallel);
+      }
+
+      /*! Factorizes a column-major matrix in place with partial pivoting,
+       * one column at a time, so that the matrix equals P * L * U. L is unit lower triangular and
+       * stored below the diagonal, U is stored on and above the diagonal.
+       * Pivots are chosen during elimination by the largest magnitude in the
+       * column. A zero pivot leaves the column uneliminated and a zero on the
+       * diagonal of U.
+       *
+       * @param m Number of rows.
+       * @param n Number of columns.
+       * @param a Matrix to factorize.
+       * @param lda Distance between columns of @p a.
+       * @param pivots Receives min(m, n) 0-based row indices; row j was
+       *               swapped with row pivots[j] at step j.
+       * @param parallel @c true to allow splitting the work across threads.
+       * @return Number of row swaps made.
+       */
+      template <class T> inline
+      size_t getf2(const size_t& m, const size_t& n, T* a, const size_t& lda, size_t* pivots, const bool& parallel) {
+         const size_t k = std::min(m, n);
+         size_t swaps = 0;
+
+         for (size_t j = 0; j < k; ++j) {
+            T* const col = a + j * lda;
+            auto max = Math::Abs(col[j]);
+            size_t row = j;
+
+            for (size_t i = j + 1; i < m; ++i) {
+               if (Math::Abs(col[i]) > max) {
+                  max = Math::Abs(col[i]);
+                  row = i;
+               }
+            }
+
+            pivots[j] = row;
+
+            // Swap the rows.
+            if (row != j) {
+               for (size_t c = 0; c < n; ++c)
+                  std::swap(a[c * lda + j], a[c * lda + row]);
+
+               ++swaps;
+            }
 
-      for (size_t j = 0; j < M; ++j) {
-         l(j + 1, j + 1) = (T)1;
+            if (col[j] == (T)0)
+               continue;
 
-         for (size_t i = 0; i <= j; ++i) {
-            auto s1 = (T)0;
+            const T r = (T)1 / col[j];
 
-            for (size_t k = 0; k < i; ++k)
-               s1 += u(k + 1, j + 1) * l(i + 1, k + 1);
+            for (size_t i = j + 1; i < m; ++i)
+               col[i] *= r;
 
-            u(i + 1, j + 1) = a(i + 1, j + 1) - s1;
+            // Columns of the trailing matrix are updated independently.
+            const auto update = [=](const size_t& begin, const size_t& end) {
+               for (size_t c = begin; c < end; ++c) {
+                  T* const x = a + c * lda;
+                  const T s = x[j];
+
+                  for (size_t i = j + 1; i < m; ++i)
+                     x[i] -= col[i] * s;
+               }
+            };
+
+            if (parallel)
+               parallel_for(j + 1, n, m - j, update);
+            else
+               update(j + 1, n);
          }
 
-         for (size_t i = j; i < M; ++i) {
-            auto s2 = (T)0;
+         return swaps;
+      }
 
-            for (size_t k = 0; k < j; ++k)
-               s2 += u(k + 1, j + 1) * l(i + 1, k + 1);
+      /*! Applies the row swaps of a factorized panel to a range of columns.
+       *
+       * @param a Matrix data.
+       * @param lda Distance between columns of @p a.
+       * @param begin First column.
+       * @param end Column range end.
+       * @param k0 First pivot index.
+       * @param k1 Pivot index range end.
+       * @param pivots Row swaps from @c getrf.
+       */
+      template <class T> inline
+      void laswp(T* a, const size_t& lda, const size_t& begin, const size_t& end, const size_t& k0, const size_t& k1, const size_t* pivots) {
+         for (size_t c = begin; c < end; ++c) {
+            T* const x = a + c * lda;
+
+            for (size_t i = k0; i < k1; ++i)
+               std::swap(x[i], x[pivots[i]]);
+         }
+      }
 
-            l(i + 1, j + 1) = (a(i + 1, j + 1) - s2) / u(j + 1, j + 1);
+      /*! Tells the floating point operations of an LU decomposition.
+       */
+      inline double getrf_flops(const size_t& m, const size_t& n) {
+         const double k = (double)std::min(m, n);
+         return 2.0 * ((double)m * (double)n * k - 0.5 * (double)(m + n) * k * k + k * k * k / 3.0);
+      }
+
+      /*! Factorizes a column-major matrix in place with partial pivoting,
+       * so that the matrix equals P * L * U. L is unit lower triangular and
+       * stored below the diagonal, U is stored on and above the diagonal.
+       * Pivots are chosen during elimination by the largest magnitude in the
+       * column. A zero pivot leaves the column uneliminated and a zero on the
+       * diagonal of U.
+       *
+       * Large matrices are factorized in panels of @c LuBlock columns. The
+       * trailing matrix is updated with matrix products, and the next panel
+       * is factorized while the rest of the trailing matrix is updated.
+       *
+       * @param m Number of rows.
+       * @param n Number of columns.
+       * @param a Matrix to factorize.
+       * @param lda Distance between columns of @p a.
+       * @param pivots Receives min(m, n) 0-based row indices; row j was
+       *               swapped with row pivots[j] at step j.
+       * @param parallel @c true to allow splitting the work across threads.
+       * @return Number of row swaps made.
+       */
+      template <class T> inline
+      size_t getrf(const size_t& m, const size_t& n, T* a, const size_t& lda, size_t* pivots, const bool& parallel) {
+         MATH_PERF_SCOPE("lu");
+         MATH_ACCOUNT_CALL(Lu, getrf_flops(m, n));
+
+         const size_t k = std::min(m, n);
+
+         if (k <= 2 * LuBlock)
+            return getf2(m, n, a, lda, pivots, parallel);
+
+         size_t swaps = getf2(m, LuBlock, a, lda, pivots, false);
+
+         for (size_t j = 0; j < k; j += LuBlock) {
+            const size_t jb = std::min(LuBlock, k - j), r = j + jb;
+
+            // Rows of the factorized panel are swapped in the other columns.
+            laswp(a, lda, 0, j, j, r, pivots);
+            laswp(a, lda, r, n, j, r, pivots);
+
+            if (r >= n)
+               break;
+
+            // U12 = L11^-1 * A12.
+            trsm_lower_unblocked(jb, n - r, a + j * lda + j, lda, a + r * lda + j, lda, parallel);
+
+            // The next panel is updated first, so that it can be factorized
+            // while the remaining columns are updated.
+            const size_t next = r < k ? std::min(LuBlock, k - r) : 0;
+            const auto update = [=](const size_t& begin, const size_t& end) {
+               gemm(m - r, end - begin, jb, (T)-1, a + j * lda + r, lda, a + begin * lda + j, lda, (T)1, a + begin * lda + r, lda, parallel);
+            };
+
+            update(r, r + next);
+
+            TaskGroup group;
+
+            if (parallel)
+               group.run([&]() { update(r + next, n); });
+            else
+               update(r + next, n);
+
+            if (next > 0) {
+               swaps += getf2(m - r, next, a + r * lda + r, lda, pivots + r, false);
+
+               for (size_t i = r; i < r + next; ++i)
+                  pivots[i] += r;
+            }
+
+            group.wait();
          }
+
+         return swaps;
       }
 
-      return swaps;
-   }
+      /*! Closed form determinant of a 2x2 matrix.
+       */
+      template <class A> inline
+      typename A::type det(const A& m, std::integral_constant<size_t, 2>) {
+         return m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+      }
 
-   template <size_t M, size_t N, class T> inline
-   Vector<M, T> solvelu(const Matrix<M, M, T>& l, const Matrix<M, N, T>& u, const Matrix<M, M, T>& pivot, const Vector<M, T>& b) {
-      Vector<M, T> x(false), y(false);
+      /*! Closed form determinant of a 3x3 matrix, expanded along the first
+       * row.
+       */
+      template <class A> inline
+      typename A::type det(const A& m, std::integral_constant<size_t, 3>) {
+         return m(1, 1) * (m(2, 2) * m(3, 3) - m(2, 3) * m(3, 2))
+              - m(1, 2) * (m(2, 1) * m(3, 3) - m(2, 3) * m(3, 1))
+              + m(1, 3) * (m(2, 1) * m(3, 2) - m(2, 2) * m(3, 1));
+      }
+
+      /*! Closed form determinant of a 4x4 matrix, expanded in 2x2 minors of
+       * the upper and lower two rows.
+       */
+      template <class A> inline
+      typename A::type det(const A& m, std::integral_constant<size_t, 4>) {
+         const auto s0 = m(1, 1) * m(2, 2) - m(2, 1) * m(1, 2);
+         const auto s1 = m(1, 1) * m(2, 3) - m(2, 1) * m(1, 3);
+         const auto s2 = m(1, 1) * m(2, 4) - m(2, 1) * m(1, 4);
+         const auto s3 = m(1, 2) * m(2, 3) - m(2, 2) * m(1, 3);
+         const auto s4 = m(1, 2) * m(2, 4) - m(2, 2) * m(1, 4);
+         const auto s5 = m(1, 3) * m(2, 4) - m(2, 3) * m(1, 4);
+
+         const auto c5 = m(3, 3) * m(4, 4) - m(4, 3) * m(3, 4);
+         const auto c4 = m(3, 2) * m(4, 4) - m(4, 2) * m(3, 4);
+         const auto c3 = m(3, 2) * m(4, 3) - m(4, 2) * m(3, 3);
+         const auto c2 = m(3, 1) * m(4, 4) - m(4, 1) * m(3, 4);
+         const auto c1 = m(3, 1) * m(4, 3) - m(4, 1) * m(3, 3);
+         const auto c0 = m(3, 1) * m(4, 2) - m(4, 1) * m(3, 2);
+
+         return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+      }
 
-      // Rearrange the elements in b.
-      auto pb = pivot * b;
+      /*! Determinant of a larger matrix using an in-place LU decomposition.
+       */
+      template <size_t N, class T, class C> inline
+      T det(const Matrix<N, N, T, C>& m, std::integral_constant<size_t, 0>) {
+         Matrix<N, N, T> a(m);
+         std::array<size_t, N> pivots;
+         const T sgn = (T)(lu(a, pivots) % 2 == 0 ? +1 : -1);
 
-      // Forward solve Ly = b.
-      for (size_t i = 0; i < M; ++i) {
-         y(i + 1, 1) = pb(i + 1, 1);
+         auto out = a(1, 1) * sgn;
 
-         for (size_t j = 0; j < i; ++j)
-            y(i + 1, 1) -= l(i + 1, j + 1) * y(j + 1, 1);
+         for (size_t i = 2; i <= N; ++i)
+            out *= a(i, i);
 
-         y(i + 1, 1) /= l(i + 1, i + 1);
+         return out;
       }
 
-      // Backward solve Ux = y.
-      for (size_t i = M - 1; ; --i) {
-         x(i + 1, 1) = y(i + 1, 1);
+      /*! Closed form inverse of a 1x1 matrix.
+       */
+      template <class T, class C> inline
+      Matrix<1, 1, T> inverse(const Matrix<1, 1, T, C>& m, std::integral_constant<size_t, 1>) {
+         return Matrix<1, 1, T>((T)1 / m(1, 1));
+      }
+
+      /*! Closed form inverse of a 2x2 matrix.
+       */
+      template <class T, class C> inline
+      Matrix<2, 2, T> inverse(const Matrix<2, 2, T, C>& m, std::integral_constant<size_t, 2>) {
+         const T r = (T)1 / det(m, std::integral_constant<size_t, 2>());
+         Matrix<2, 2, T> out(false);
 
-         for (size_t j = i + 1; j < M; ++j)
-            x(i + 1, 1) -= u(i + 1, j + 1) * x(j + 1, 1);
+         out(1, 1) = m(2, 2) * r;
+         out(1, 2) = -m(1, 2) * r;
+         out(2, 1) = -m(2, 1) * r;
+         out(2, 2) = m(1, 1) * r;
 
-         x(i + 1, 1) /= u(i + 1, i + 1);
+         return out;
+      }
+
+      /*! Closed form inverse of a 3x3 matrix, the transposed cofactor matrix
+       * divided by the determinant.
+       */
+      template <class T, class C> inline
+      Matrix<3, 3, T> inverse(const Matrix<3, 3, T, C>& m, std::integral_constant<size_t, 3>) {
+         Matrix<3, 3, T> out(false);
+
+         out(1, 1) = m(2, 2) * m(3, 3) - m(2, 3) * m(3, 2);
+         out(2, 1) = m(2, 3) * m(3, 1) - m(2, 1) * m(3, 3);
+         out(3, 1) = m(2, 1) * m(3, 2) - m(2, 2) * m(3, 1);
+
+         const T r = (T)1 / (m(1, 1) * out(1, 1) + m(1, 2) * out(2, 1) + m(1, 3) * out(3, 1));
+
+         out(1, 1) *= r;
+         out(2, 1) *= r;
+         out(3, 1) *= r;
+         out(1, 2) = (m(1, 3) * m(3, 2) - m(1, 2) * m(3, 3)) * r;
+         out(2, 2) = (m(1, 1) * m(3, 3) - m(1, 3) * m(3, 1)) * r;
+         out(3, 2) = (m(1, 2) * m(3, 1) - m(1, 1) * m(3, 2)) * r;
+         out(1, 3) = (m(1, 2) * m(2, 3) - m(1, 3) * m(2, 2)) * r;
+         out(2, 3) = (m(1, 3) * m(2, 1) - m(1, 1) * m(2, 3)) * r;
+         out(3, 3) = (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1)) * r;
+
+         return out;
+      }
 
-         if (i == 0)
-            break;
+      /*! Closed form inverse of a 4x4 matrix, the adjugate expressed in 2x2
+       * minors of the upper and lower two rows divided by the determinant.
+       */
+      template <class T, class C> inline
+      Matrix<4, 4, T> inverse(const Matrix<4, 4, T, C>& m, std::integral_constant<size_t, 4>) {
+         const T s0 = m(1, 1) * m(2, 2) - m(2, 1) * m(1, 2);
+         const T s1 = m(1, 1) * m(2, 3) - m(2, 1) * m(1, 3);
+         const T s2 = m(1, 1) * m(2, 4) - m(2, 1) * m(1, 4);
+         const T s3 = m(1, 2) * m(2, 3) - m(2, 2) * m(1, 3);
+         const T s4 = m(1, 2) * m(2, 4) - m(2, 2) * m(1, 4);
+         const T s5 = m(1, 3) * m(2, 4) - m(2, 3) * m(1, 4);
+
+         const T c5 = m(3, 3) * m(4, 4) - m(4, 3) * m(3, 4);
+         const T c4 = m(3, 2) * m(4, 4) - m(4, 2) * m(3, 4);
+         const T c3 = m(3, 2) * m(4, 3) - m(4, 2) * m(3, 3);
+         const T c2 = m(3, 1) * m(4, 4) - m(4, 1) * m(3, 4);
+         const T c1 = m(3, 1) * m(4, 3) - m(4, 1) * m(3, 3);
+         const T c0 = m(3, 1) * m(4, 2) - m(4, 1) * m(3, 2);
+
+         const T r = (T)1 / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+         Matrix<4, 4, T> out(false);
+
+         out(1, 1) = ( m(2, 2) * c5 - m(2, 3) * c4 + m(2, 4) * c3) * r;
+         out(1, 2) = (-m(1, 2) * c5 + m(1, 3) * c4 - m(1, 4) * c3) * r;
+         out(1, 3) = ( m(4, 2) * s5 - m(4, 3) * s4 + m(4, 4) * s3) * r;
+         out(1, 4) = (-m(3, 2) * s5 + m(3, 3) * s4 - m(3, 4) * s3) * r;
+
+         out(2, 1) = (-m(2, 1) * c5 + m(2, 3) * c2 - m(2, 4) * c1) * r;
+         out(2, 2) = ( m(1, 1) * c5 - m(1, 3) * c2 + m(1, 4) * c1) * r;
+         out(2, 3) = (-m(4, 1) * s5 + m(4, 3) * s2 - m(4, 4) * s1) * r;
+         out(2, 4) = ( m(3, 1) * s5 - m(3, 3) * s2 + m(3, 4) * s1) * r;
+
+         out(3, 1) = ( m(2, 1) * c4 - m(2, 2) * c2 + m(2, 4) * c0) * r;
+         out(3, 2) = (-m(1, 1) * c4 + m(1, 2) * c2 - m(1, 4) * c0) * r;
+         out(3, 3) = ( m(4, 1) * s4 - m(4, 2) * s2 + m(4, 4) * s0) * r;
+         out(3, 4) = (-m(3, 1) * s4 + m(3, 2) * s2 - m(3, 4) * s0) * r;
+
+         out(4, 1) = (-m(2, 1) * c3 + m(2, 2) * c1 - m(2, 3) * c0) * r;
+         out(4, 2) = ( m(1, 1) * c3 - m(1, 2) * c1 + m(1, 3) * c0) * r;
+         out(4, 3) = (-m(4, 1) * s3 + m(4, 2) * s1 - m(4, 3) * s0) * r;
+         out(4, 4) = ( m(3, 1) * s3 - m(3, 2) * s1 + m(3, 3) * s0) * r;
+
+         return out;
       }
 
+#if defined(MATH_SIMD_X86)
+      /*! Inverts a 4x4 single precision matrix with SSE using Cramer's
+       * rule. The four columns are transposed into registers, and the
+       * cofactors of all of them are computed together with shuffled
+       * products of 2x2 minors.
+       *
+       * @param src Matrix elements in column-major order.
+       * @param dst Receives the inverse in column-major order.
+       */
+      inline MATH_TARGET_SSE2
+      void inverse4x4(const float* src, float* dst) {
+         const __m128 a0 = _mm_loadu_ps(src), a1 = _mm_loadu_ps(src + 4);
+         const __m128 a2 = _mm_loadu_ps(src + 8), a3 = _mm_loadu_ps(src + 12);
+
+         // Rows of the transpose, with the second and fourth row swapped in
+         // halves so that products of pairs form 2x2 minors.
+         __m128 tmp = _mm_movelh_ps(a0, a1);
+         __m128 row1 = _mm_movelh_ps(a2, a3);
+         const __m128 row0 = _mm_shuffle_ps(tmp, row1, 0x88);
+         row1 = _mm_shuffle_ps(row1, tmp, 0xDD);
+         tmp = _mm_movehl_ps(a1, a0);
+         __m128 row3 = _mm_movehl_ps(a3, a2);
+         __m128 row2 = _mm_shuffle_ps(tmp, row3, 0x88);
+         row3 = _mm_shuffle_ps(row3, tmp, 0xDD);
+
+         __m128 minor0, minor1, minor2, minor3;
+
+         tmp = _mm_mul_ps(row2, row3);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+         minor0 = _mm_mul_ps(row1, tmp);
+         minor1 = _mm_mul_ps(row0, tmp);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+         minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp), minor0);
+         minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor1);
+         minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+         tmp = _mm_mul_ps(row1, row2);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+         minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor0);
+         minor3 = _mm_mul_ps(row0, tmp);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+         minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp));
+         minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor3);
+         minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+         tmp = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+         row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+         minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor0);
+         minor2 = _mm_mul_ps(row0, tmp);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+         minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp));
+         minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor2);
+         minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+         tmp = _mm_mul_ps(row0, row1);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+         minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor2);
+         minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp), minor3);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+         minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp), minor2);
+         minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp));
+
+         tmp = _mm_mul_ps(row0, row3);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+         minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp));
+         minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor2);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+         minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor1);
+         minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp));
+
+         tmp = _mm_mul_ps(row0, row2);
+         tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+         minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor1);
+         minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp));
+         tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+         minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp));
+         minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor3);
+
+         // Determinant from the first row and its cofactors.
+         __m128 det = _mm_mul_ps(row0, minor0);
+         det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+         det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+         det = _mm_div_ss(_mm_set_ss(1.0f), det);
+         det = _mm_shuffle_ps(det, det, 0x00);
+
+         _mm_storeu_ps(dst, _mm_mul_ps(det, minor0));
+         _mm_storeu_ps(dst + 4, _mm_mul_ps(det, minor1));
+         _mm_storeu_ps(dst + 8, _mm_mul_ps(det, minor2));
+         _mm_storeu_ps(dst + 12, _mm_mul_ps(det, minor3));
+      }
+
+      /*! Inverse of a 4x4 single precision matrix using SSE.
+       */
+      template <class C> inline
+      Matrix<4, 4, float> inverse(const Matrix<4, 4, float, C>& m, std::integral_constant<size_t, 4>) {
+         Matrix<4, 4, float> out(false);
+
+         inverse4x4(m.data(), out.data());
+
+         return out;
+      }
+#endif
+
+      /*! Inverse of a larger matrix by solving against the identity.
+       */
+      template <size_t M, size_t N, class T, class C> inline
+      Matrix<M, N, T> inverse(const Matrix<M, N, T, C>& m, std::integral_constant<size_t, 0>) {
+         return std::move(solve(m, eye<N, T>()));
+      }
+
+      /*! Size tag selecting closed form inverses and determinants of
+       * matrices up to 4x4, or zero for the general algorithms.
+       */
+      template <size_t M, size_t N> struct closed_form : std::integral_constant<size_t, (M == N && N <= 4) ? N : 0> {
+      };
+
+      /*! Unpacks a matrix factorized with @c getrf into separate element
+       * matrices.
+       *
+       * @param a Factorized matrix.
+       * @param pivots Row swaps from @c getrf.
+       * @param l Zero initialized lower triangulation element matrix.
+       * @param u Zero initialized upper triangulation element matrix.
+       * @param pivot Identity matrix, turned into a permutation matrix.
+       */
+      template <class A, class L, class U, class P> inline
+      void unpack_lu(const A& a, const size_t* pivots, L& l, U& u, P& pivot) {
+         typedef typename A::type T;
+         const size_t M = a.rows(), N = a.cols();
+
+         for (size_t j = 1; j <= N; ++j) {
+            for (size_t i = 1; i <= M; ++i) {
+               if (i > j)
+                  l(i, j) = a(i, j);
+               else
+                  u(i, j) = a(i, j);
+            }
+         }
+
+         for (size_t i = 1; i <= M; ++i)
+            l(i, i) = (T)1;
+
+         // Row swaps of the elimination, so that pivot * m = l * u.
+         for (size_t j = 0; j < std::min(M, N); ++j) {
+            if (pivots[j] != j)
+               swap(pivot.row(j + 1), pivot.row(pivots[j] + 1));
+         }
+      }
+
+      /*! Solves a linear equation using LU decomposition of a fixed or
+       * dynamic size matrix.
+       *
+       * @param l Lower triangulated matrix.
+       * @param u Upper triangulated matrix.
+       * @param pivot Permutation matrix.
+       * @param b Vector to solve.
+       * @param y Intermediate vector of the same size as @p b.
+       * @param x Solved vector of the same size as @p b.
+       */
+      template <class L, class U, class P, class V> inline
+      void solvelu(const L& l, const U& u, const P& pivot, const V& b, V& y, V& x) {
+         const size_t M = b.rows();
+
+         // Rearrange the elements in b.
+         auto pb = pivot * b;
+
+         // Forward solve Ly = b.
+         for (size_t i = 0; i < M; ++i) {
+            y(i + 1, 1) = pb(i + 1, 1);
+
+            for (size_t j = 0; j < i; ++j)
+               y(i + 1, 1) -= l(i + 1, j + 1) * y(j + 1, 1);
+
+            y(i + 1, 1) /= l(i + 1, i + 1);
+         }
+
+         // Backward solve Ux = y.
+         for (size_t i = M - 1; ; --i) {
+            x(i + 1, 1) = y(i + 1, 1);
+
+            for (size_t j = i + 1; j < M; ++j)
+               x(i + 1, 1) -= u(i + 1, j + 1) * x(j + 1, 1);
+
+            x(i + 1, 1) /= u(i + 1, i + 1);
+
+            if (i == 0)
+               break;
+         }
+      }
+   }
+
+   template <size_t M, size_t N, class T> inline
+   size_t lu(const Matrix<M, N, T>& m, Matrix<M, M, T>& l, Matrix<M, N, T>& u, Matrix<M, M, T>& pivot) {
+      Matrix<M, N, T> a(m);
+      size_t pivots[M < N ? M : N];
+
+      const size_t swaps = Detail::getrf(M, N, a.data(), M, pivots, MatrixChunk<M, N, T>::Location == Heap);
+
+      pivot = eye<M, T>();
+      l = Matrix<M, M, T>();
+      u = Matrix<M, N, T>();
+      Detail::unpack_lu(a, pivots, l, u, pivot);
+
+      return swaps;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   Vector<M, T> solvelu(const Matrix<M, M, T>& l, const Matrix<M, N, T>& u, const Matrix<M, M, T>& pivot, const Vector<M, T>& b) {
+      Vector<M, T> x(false), y(false);
+
+      Detail::solvelu(l, u, pivot, b, y, x);
+
       return std::move(x);
    }
 
    template <size_t N, class T, class C> inline
-   typename std::enable_if<N >= 2, T>::type det(const Matrix<N, N, T, C>& m) {
-      Matrix<N, N, T> l(false), u(false), pivot(false);
-      const T sgn = (T)(lu(m, l, u, pivot) % 2 == 0 ? +1 : -1);
+   size_t lu(Matrix<N, N, T, C>& a, std::array<size_t, N>& pivots) {
+      return Detail::getrf(N, N, a.data(), N, pivots.data(), MatrixChunk<N, N, T>::Location == Heap);
+   }
 
-      auto out = u(1, 1) * sgn;
+   template <size_t N, size_t P, class T, class C, class D> inline
+   Matrix<N, P, T> solvelu(const Matrix<N, N, T, C>& lu, const std::array<size_t, N>& pivots, const Matrix<N, P, T, D>& b) {
+      Matrix<N, P, T> x(b);
 
-      for (size_t i = 2; i <= N; ++i)
-         out *= u(i, i);
+      Detail::getrs(N, P, lu.data(), N, pivots.data(), x.data(), N, MatrixChunk<N, P, T>::Location == Heap);
 
-      return out;
+      return std::move(x);
+   }
+
+   template <size_t N, class T, class C> inline
+   typename std::enable_if<N >= 2, T>::type det(const Matrix<N, N, T, C>& m) {
+      MATH_ACCOUNT_CALL(Determinant, 0);
+      return Detail::det(m, std::integral_constant<size_t, Detail::closed_form<N, N>::value>());
    }
 
    template <size_t M, size_t N, class T, class C> inline
    Matrix<M, N, T> inv(const Matrix<M, N, T, C>& m) {
-      return std::move(solve(m, eye<N, T>()));
+      MATH_ACCOUNT_CALL(Inverse, 0);
+      return std::move(Detail::inverse(m, std::integral_constant<size_t, Detail::closed_form<M, N>::value>()));
+   }
+
+   template <class T, class C> inline
+   Matrix<4, 4, T> invaffine(const Matrix<4, 4, T, C>& m) {
+      assert(m(4, 1) == 0 && m(4, 2) == 0 && m(4, 3) == 0 && m(4, 4) == 1);
+
+      const Matrix<3, 3, T> a = Detail::inverse(m.template get_sub<3, 3>(1, 1), std::integral_constant<size_t, 3>());
+      Matrix<4, 4, T> out(false);
+
+      for (size_t i = 1; i <= 3; ++i) {
+         out(i, 1) = a(i, 1);
+         out(i, 2) = a(i, 2);
+         out(i, 3) = a(i, 3);
+         out(i, 4) = -(a(i, 1) * m(1, 4) + a(i, 2) * m(2, 4) + a(i, 3) * m(3, 4));
+         out(4, i) = 0;
+      }
+
+      out(4, 4) = 1;
+
+      return out;
    }
 
    template <size_t M, size_t N, size_t P, class T, class C, class D> inline
    Matrix<M, P, T> solve(const Matrix<M, N, T, C>& a, const Matrix<N, P, T, D>& b) {
-      Matrix<M, M, T> l(false), pivot(false);
-      Matrix<M, N, T> u(false);
-      Matrix<M, P, T> out(false);
+      static_assert(M == N, "Coefficient matrix must be square");
+      MATH_PERF_SCOPE("solve");
+      MATH_ACCOUNT_CALL(Solve, 0);
 
-      lu(a, l, u, pivot);
+      // Systems of up to three unknowns are solved by Cramer's rule through
+      // the closed form inverse. Larger ones pivot, which the adjugate of a
+      // 4x4 matrix cannot, so that ill-conditioned systems stay accurate.
+      if (Detail::closed_form<M, N>::value != 0 && N <= 3)
+         return std::move(inv(a) * b);
 
-      for (size_t i = 1; i <= P; ++i)
-         out.set_column(i, solvelu(l, u, pivot, Vector<N, T>(b.get_column(i))));
+      Matrix<N, N, T> factors(a);
+      std::array<size_t, N> pivots;
 
-      return std::move(out);
+      lu(factors, pivots);
+
+      return std::move(solvelu(factors, pivots, b));
+   }
+
+   template <class E> inline
+   typename std::enable_if<E::Rows == E::Cols && E::Rows >= 2, typename E::type>::type det(const MatrixExpression<E>& m) {
+      return det(eval(m.derived()));
+   }
+
+   template <class E> inline
+   Matrix<E::Rows, E::Cols, typename E::type> inv(const MatrixExpression<E>& m) {
+      return std::move(inv(eval(m.derived())));
    }
 
+   template <class E, class F> inline
+   typename std::enable_if<E::Cols == F::Rows, Matrix<E::Rows, F::Cols, typename E::type> >::type solve(const MatrixExpression<E>& a, const MatrixExpression<F>& b) {
+      return std::move(solve(eval(a.derived()), eval(b.derived())));
+   }
+
+
+   template <class T> inline
+   size_t lu(const DynamicMatrix<T>& m, DynamicMatrix<T>& l, DynamicMatrix<T>& u, DynamicMatrix<T>& pivot) {
+      assert(m.rows() == m.cols());
+      DynamicMatrix<T> a(m);
+      std::vector<size_t> pivots;
+
+      const size_t swaps = lu(a, pivots);
+
+      pivot = eye<T>(m.rows());
+      l = DynamicMatrix<T>(m.rows(), m.rows());
+      u = DynamicMatrix<T>(m.rows(), m.cols());
+      Detail::unpack_lu(a, pivots.data(), l, u, pivot);
+
+      return swaps;
+   }
+
+   template <class T> inline
+   DynamicVector<T> solvelu(const DynamicMatrix<T>& l, const DynamicMatrix<T>& u, const DynamicMatrix<T>& pivot, const DynamicVector<T>& b) {
+      DynamicVector<T> x(b.rows(), false), y(b.rows(), false);
+
+      Detail::solvelu(l, u, pivot, b, y, x);
+
+      return std::move(x);
+   }
+
+   template <class T> inline
+   size_t lu(DynamicMatrix<T>& a, std::vector<size_t>& pivots) {
+      assert(a.rows() == a.cols());
+      pivots.resize(a.rows());
+
+      return Detail::getrf(a.rows(), a.cols(), a.data(), a.rows(), pivots.data(), true);
+   }
+
+   template <class T> inline
+   DynamicMatrix<T> solvelu(const DynamicMatrix<T>& lu, const std::vector<size_t>& pivots, const DynamicMatrix<T>& b) {
+      assert(lu.rows() == lu.cols() && lu.cols() == b.rows() && pivots.size() == lu.rows());
+      DynamicMatrix<T> x(b);
+
+      Detail::getrs(lu.rows(), b.cols(), lu.data(), lu.rows(), pivots.data(), x.data(), x.rows(), true);
+
+      return std::move(x);
+   }
+
+   template <class T> inline
+   T det(const DynamicMatrix<T>& m) {
+      assert(m.rows() == m.cols() && m.rows() >= 1);
+      MATH_ACCOUNT_CALL(Determinant, 0);
+
+      DynamicMatrix<T> a(m);
+      std::vector<size_t> pivots;
+      const T sgn = (T)(lu(a, pivots) % 2 == 0 ? +1 : -1);
+
+      auto out = a(1, 1) * sgn;
+
+      for (size_t i = 2; i <= m.rows(); ++i)
+         out *= a(i, i);
+
+      return out;
+   }
+
+   template <class T> inline
+   DynamicMatrix<T> inv(const DynamicMatrix<T>& m) {
+      MATH_ACCOUNT_CALL(Inverse, 0);
+      return std::move(solve(m, eye<T>(m.rows())));
+   }
+
+   template <class T> inline
+   DynamicMatrix<T> solve(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b) {
+      assert(a.rows() == a.cols() && a.cols() == b.rows());
+      MATH_PERF_SCOPE("solve");
+      MATH_ACCOUNT_CALL(Solve, 0);
+
+      DynamicMatrix<T> factors(a);
+      std::vector<size_t> pivots;
+
+      lu(factors, pivots);
+
+      return std::move(solvelu(factors, pivots, b));
+   }
+
+   template <class T> inline
+   T det(const ConstDynamicMatrixView<T>& m) {
+      return det(DynamicMatrix<T>(m));
+   }
+
+   template <class T> inline
+   DynamicMatrix<T> inv(const ConstDynamicMatrixView<T>& m) {
+      return std::move(inv(DynamicMatrix<T>(m)));
+   }
+
+   template <class A, class B> inline
+   typename Detail::dynamic_result<A, B>::type solve(const A& a, const B& b) {
+      typedef typename A::type T;
+      return std::move(solve(DynamicMatrix<T>(ConstDynamicMatrixView<T>(a)), DynamicMatrix<T>(ConstDynamicMatrixView<T>(b))));
+   }
 }
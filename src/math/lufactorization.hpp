@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include "linearalgebra.hpp"
+
+namespace Math {
+
+   /*! LU decomposition of a square matrix with partial pivoting, kept for
+    * solving any number of right hand sides without factorizing again.
+    */
+   template <size_t N, class T = double> class LUFactorization {
+   public:
+
+      /*! Factorizes a matrix.
+       *
+       * @param m Subject matrix or expression.
+       */
+      template <class E> explicit LUFactorization(const MatrixExpression<E>& m, typename std::enable_if<E::Rows == N && E::Cols == N>::type* = nullptr);
+
+      /*! Factorizes another matrix, reusing the storage of this object.
+       *
+       * @param m Subject matrix or expression.
+       */
+      template <class E> typename std::enable_if<E::Rows == N && E::Cols == N>::type factorize(const MatrixExpression<E>& m);
+
+      /*! Tells whether the factorized matrix is singular.
+       *
+       * @return @c true if U has a zero on its diagonal.
+       */
+      bool singular() const;
+
+      /*! Finds out the determinant value of the factorized matrix.
+       *
+       * @return A determinant value.
+       */
+      T det() const;
+
+      /*! Solves linear equations for all columns of a matrix at once.
+       *
+       * @param b Right hand side columns to solve.
+       * @return Solved columns.
+       */
+      template <class E> typename std::enable_if<E::Rows == N, Matrix<N, E::Cols, T> >::type solve(const MatrixExpression<E>& b) const;
+
+      /*! Solves linear equations for all columns of a matrix at once,
+       * overwriting the matrix with the solution.
+       *
+       * @param b Right hand side columns to solve.
+       */
+      template <size_t P, class C> void solve_in_place(Matrix<N, P, T, C>& b) const;
+
+      /*! Finds out the inverse of the factorized matrix.
+       *
+       * @return An inverted matrix.
+       */
+      Matrix<N, N, T> inv() const;
+
+      /*! Gets the decomposition. The strictly lower part holds the unit
+       * lower triangulation element matrix and the rest holds the upper one.
+       *
+       * @return Decomposed matrix.
+       */
+      const Matrix<N, N, T>& factors() const;
+
+      /*! Gets the row swaps; row i was swapped with row pivots[i] at step i.
+       *
+       * @return 0-based row indices.
+       */
+      const std::array<size_t, N>& pivots() const;
+
+   private:
+      Matrix<N, N, T> _lu;
+      std::array<size_t, N> _pivots;
+      size_t _swaps;
+   };
+}
+
+#include "lufactorization.inl"
@@ -0,0 +1,68 @@
+namespace Math {
+
+   template <size_t N, class T>
+   template <class E> inline
+   LUFactorization<N, T>::LUFactorization(const MatrixExpression<E>& m, typename std::enable_if<E::Rows == N && E::Cols == N>::type*)
+      : _lu(m)
+   {
+      _swaps = lu(_lu, _pivots);
+   }
+
+   template <size_t N, class T>
+   template <class E> inline
+   typename std::enable_if<E::Rows == N && E::Cols == N>::type LUFactorization<N, T>::factorize(const MatrixExpression<E>& m) {
+      _lu = m;
+      _swaps = lu(_lu, _pivots);
+   }
+
+   template <size_t N, class T> inline
+   bool LUFactorization<N, T>::singular() const {
+      for (size_t i = 1; i <= N; ++i) {
+         if (_lu(i, i) == (T)0)
+            return true;
+      }
+
+      return false;
+   }
+
+   template <size_t N, class T> inline
+   T LUFactorization<N, T>::det() const {
+      auto out = (T)(_swaps % 2 == 0 ? +1 : -1);
+
+      for (size_t i = 1; i <= N; ++i)
+         out *= _lu(i, i);
+
+      return out;
+   }
+
+   template <size_t N, class T>
+   template <class E> inline
+   typename std::enable_if<E::Rows == N, Matrix<N, E::Cols, T> >::type LUFactorization<N, T>::solve(const MatrixExpression<E>& b) const {
+      Matrix<N, E::Cols, T> x(b);
+
+      solve_in_place(x);
+
+      return std::move(x);
+   }
+
+   template <size_t N, class T>
+   template <size_t P, class C> inline
+   void LUFactorization<N, T>::solve_in_place(Matrix<N, P, T, C>& b) const {
+      Detail::getrs(N, P, _lu.data(), N, _pivots.data(), b.data(), N, MatrixChunk<N, P, T>::Location == Heap);
+   }
+
+   template <size_t N, class T> inline
+   Matrix<N, N, T> LUFactorization<N, T>::inv() const {
+      return std::move(solve(eye<N, T>()));
+   }
+
+   template <size_t N, class T> inline
+   const Matrix<N, N, T>& LUFactorization<N, T>::factors() const {
+      return _lu;
+   }
+
+   template <size_t N, class T> inline
+   const std::array<size_t, N>& LUFactorization<N, T>::pivots() const {
+      return _pivots;
+   }
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "matrixchunk.hpp"
+#include "expression.hpp"
+#include "matrixview.hpp"
+#include "gemm.hpp"
 #include <cstring>
 #include <cassert>
 #include <utility>
@@ -10,7 +13,7 @@ namespace Math {
    /*! MxN matrix.
     */
    template < size_t M, size_t N, class T, class Chunk = MatrixChunk<M, N, T> >
-   class Matrix {
+   class Matrix : public MatrixExpression< Matrix<M, N, T, Chunk> > {
    public:
 
       //! Matrix row size constant.
@@ -19,6 +22,12 @@ namespace Math {
       //! Matrix column size constant.
       static const size_t Cols = N;
 
+      //! Tells that a matrix is a leaf of an expression.
+      static const bool Leaf = true;
+
+      //! Tells that matrix elements can be accessed in flat storage order.
+      static const bool Linear = true;
+
       //! Type alias for element types.
       typedef T type;
 
@@ -51,6 +60,25 @@ namespace Math {
        */
       template <class t> explicit Matrix(const Matrix<M, N, t>& other);
 
+      /*! Constructs a matrix that takes over given storage.
+       *
+       * @param storage Storage to take over.
+       */
+      explicit Matrix(Chunk&& storage);
+
+      /*! Constructs a matrix by evaluating an expression.
+       *
+       * @param expression Expression to evaluate.
+       */
+      template <class E> Matrix(const MatrixExpression<E>& expression, typename std::enable_if<E::Rows == M && E::Cols == N && std::is_same<typename E::type, T>::value>::type* = nullptr);
+
+      /*! Assigns an evaluated expression to a matrix.
+       *
+       * @param expression Expression to evaluate.
+       * @return This matrix.
+       */
+      template <class E> typename std::enable_if<E::Rows == M && E::Cols == N && std::is_same<typename E::type, T>::value, Matrix&>::type operator =(const MatrixExpression<E>& expression);
+
       /*! Tells the number of rows.
        *
        * @return Number of rows.
@@ -69,6 +97,12 @@ namespace Math {
        */
       T* data();
 
+      /*! Gets the matrix storage.
+       *
+       * @return Matrix storage.
+       */
+      Chunk& storage();
+
       /*! Access matrix elements.
        *
        * @param i Row number, 1-based.
@@ -141,6 +175,13 @@ namespace Math {
        */
       void set_column(const size_t& column, const Matrix<M, 1, T>& m);
 
+      /*! Sets matrix column from an expression, e.g. a view.
+       *
+       * @param column Column index, 1-based.
+       * @param m Expression to set to given column.
+       */
+      template <class E> typename std::enable_if<E::Rows == M && E::Cols == 1>::type set_column(const size_t& column, const MatrixExpression<E>& m);
+
       /*! Sets matrix row.
        *
        * @param row Row index, 1-based.
@@ -148,13 +189,64 @@ namespace Math {
        */
       void set_row(const size_t& row, const Matrix<1, N, T>& m);
 
+      /*! Sets matrix row from an expression, e.g. a view.
+       *
+       * @param row Row index, 1-based.
+       * @param m Expression to set to given row.
+       */
+      template <class E> typename std::enable_if<E::Rows == 1 && E::Cols == N>::type set_row(const size_t& row, const MatrixExpression<E>& m);
+
       /*! Sets a sub matrix at given location.
        *
        * @param i Sub matrix first row index, 1-based.
        * @param j Sub matrix first column index, 1-based.
-       * @param matrix Sub marix to set.
+       * @param matrix Sub marix or expression to set.
+       */
+      template <class E> void set_sub(const size_t& i, const size_t& j, const MatrixExpression<E>& matrix);
+
+      /*! Views a matrix column without copying.
+       *
+       * @param column Column index, 1-based.
+       * @return View of the column.
+       */
+      MatrixView<M, 1, T> column(const size_t& column);
+
+      /*! Views a matrix column without copying.
+       *
+       * @param column Column index, 1-based.
+       * @return Const view of the column.
+       */
+      ConstMatrixView<M, 1, T> column(const size_t& column) const;
+
+      /*! Views a matrix row without copying.
+       *
+       * @param row Row index, 1-based.
+       * @return View of the row.
+       */
+      MatrixView<1, N, T> row(const size_t& row);
+
+      /*! Views a matrix row without copying.
+       *
+       * @param row Row index, 1-based.
+       * @return Const view of the row.
+       */
+      ConstMatrixView<1, N, T> row(const size_t& row) const;
+
+      /*! Views a sub matrix without copying.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @return View of the sub matrix.
+       */
+      template <size_t m, size_t n> MatrixView<m, n, T> sub(const size_t& i, const size_t& j);
+
+      /*! Views a sub matrix without copying.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @return Const view of the sub matrix.
        */
-      template <size_t m, size_t n, class c> void set_sub(const size_t& i, const size_t& j, const Matrix<m, n, T, c>& matrix);
+      template <size_t m, size_t n> ConstMatrixView<m, n, T> sub(const size_t& i, const size_t& j) const;
 
       /*! Gets begin iterator of a matrix.
        *
@@ -168,13 +260,49 @@ namespace Math {
        */
       auto end() const -> decltype(std::declval<Chunk>().end());
 
+      /*! Access matrix elements without bounds checking.
+       *
+       * @param i Row number, 0-based.
+       * @param j Column number, 0-based.
+       * @return Const element at given location.
+       */
+      const T& coeff(const size_t& i, const size_t& j) const;
+
+      /*! Access flattened matrix elements without bounds checking.
+       *
+       * @param index Element index, 0-based.
+       * @return Const element at given location.
+       */
+      const T& coeff(const size_t& index) const;
+
+      /*! Tells whether the matrix storage overlaps given storage.
+       *
+       * @param begin Storage begin.
+       * @param end Storage end.
+       * @return @c true if the storage overlaps matrix data.
+       */
+      bool references(const void* begin, const void* end) const;
+
+      /*! Tells whether evaluating the matrix into a dense matrix requires a
+       * temporary. Elements are read from the same location they are
+       * written to when the destination is this matrix, so this is only
+       * the case for destinations partially overlapping the matrix.
+       *
+       * @param begin Destination storage begin.
+       * @param end Destination storage end.
+       * @return @c true if a temporary is required.
+       */
+      bool aliases(const void* begin, const void* end) const;
+
    private:
+      template <class E> void evaluate(const MatrixExpression<E>& expression);
+
       Chunk _data;
    };
 
    /*! Scalar specialization of 1 by 1 dimensional matrix.
     */
-   template < class T, class Chunk> class Matrix< 1, 1, T, Chunk> {
+   template < class T, class Chunk> class Matrix< 1, 1, T, Chunk> : public MatrixExpression< Matrix<1, 1, T, Chunk> > {
    public:
 
       //! Matrix row size constant.
@@ -183,6 +311,12 @@ namespace Math {
       //! Matrix column size constant.
       static const size_t Cols = 1;
 
+      //! Tells that a matrix is a leaf of an expression.
+      static const bool Leaf = true;
+
+      //! Tells that matrix elements can be accessed in flat storage order.
+      static const bool Linear = true;
+
       //! Type alias for element types.
       typedef T type;
 
@@ -206,6 +340,12 @@ namespace Math {
        */
       Matrix(const T& value);
 
+      /*! Constructs a matrix by evaluating an expression.
+       *
+       * @param expression Expression to evaluate.
+       */
+      template <class E> Matrix(const MatrixExpression<E>& expression, typename std::enable_if<E::Rows == 1 && E::Cols == 1 && std::is_same<typename E::type, T>::value>::type* = nullptr);
+
       /*! Implicitly converts matrix to a scalar.
        */
       operator T() const;
@@ -264,6 +404,38 @@ namespace Math {
        */
       const T* data() const;
 
+      /*! Access matrix elements without bounds checking.
+       *
+       * @param i Row number, 0-based. Must always be 0.
+       * @param j Column number, 0-based. Must always be 0.
+       * @return Const element at given location.
+       */
+      const T& coeff(const size_t& i, const size_t& j) const;
+
+      /*! Access flattened matrix elements without bounds checking.
+       *
+       * @param index Element index, 0-based. Must always be 0.
+       * @return Const element at given location.
+       */
+      const T& coeff(const size_t& index) const;
+
+      /*! Tells whether the matrix storage overlaps given storage.
+       *
+       * @param begin Storage begin.
+       * @param end Storage end.
+       * @return @c true if the storage overlaps matrix data.
+       */
+      bool references(const void* begin, const void* end) const;
+
+      /*! Tells whether evaluating the matrix into a dense matrix requires a
+       * temporary.
+       *
+       * @param begin Destination storage begin.
+       * @param end Destination storage end.
+       * @return Always @c false.
+       */
+      bool aliases(const void* begin, const void* end) const;
+
    private:
       T _value;
    };
@@ -275,58 +447,96 @@ namespace Math {
    typedef Matrix<4, 4, double> mat4x4;
    typedef Matrix<4, 4, float> mat4x4f;
 
+   /*! MxN matrix allocating its storage with a custom allocator when it is
+    * too large for stack.
+    */
+   template <size_t M, size_t N, class T, class Allocator>
+   using AllocatedMatrix = Matrix<M, N, T, MatrixChunk<M, N, T, DefaultMaxStackAllocSize, Allocator> >;
+
    /*! Constructs an identity matrix of given size.
     *
     * @return Identity matrix of size NxN.
     */
    template <size_t N, class T = double> Matrix<N, N, T> eye();
+
+   /*! Evaluates an expression into a matrix.
+    *
+    * @param expression Expression to evaluate.
+    * @return Evaluated matrix.
+    */
+   template <class E> Matrix<E::Rows, E::Cols, typename E::type> eval(const MatrixExpression<E>& expression);
+
+   /*! Evaluates a matrix. Matrices are already evaluated, so this is a no-op.
+    *
+    * @param m Matrix to evaluate.
+    * @return The same matrix.
+    */
+   template <size_t M, size_t N, class T, class C> const Matrix<M, N, T, C>& eval(const Matrix<M, N, T, C>& m);
+
+   /*! Resolves the result type of a matrix product, if both operands are
+    * matrix expressions of compatible dimensions.
+    */
+   template <class L, class R, class Enable = void> struct product_expression {
+   };
+
+   template <class L, class R>
+   struct product_expression<L, R, typename std::enable_if<
+      std::conditional<
+         is_matrix_expression<L>::value && is_matrix_expression<R>::value,
+         are_product_compatible<L, R>,
+         std::false_type
+      >::type::value
+   >::type> {
+      typedef Matrix<std::decay<L>::type::Rows, std::decay<R>::type::Cols, typename std::decay<L>::type::type> type;
+   };
 }
 
-/*! Negates a matrix.
+/*! Negates a matrix expression.
  *
  * @param m Matrix to negate.
- * @return Negated matrix.
+ * @return Negated matrix expression.
  */
-template <size_t M, size_t N, class T, class C> Math::Matrix<M, N, T> operator -(const Math::Matrix<M, N, T, C>& m);
+template <class E> typename Math::unary_expression<E, Math::NegateOp>::type operator -(E&& m);
 
-/*! Transposes a matrix.
+/*! Transposes a matrix expression.
  *
  * @param m Matrix to transpose.
- * @return Transposed matrix.
+ * @return Transposed matrix expression.
  */
-template <size_t M, size_t N, class T, class C> Math::Matrix<N, M, T> operator ~(const Math::Matrix<M, N, T, C>& m);
+template <class E> typename Math::transpose_expression<E>::type operator ~(E&& m);
 
-/*! Adds two matrices.
+/*! Adds two matrix expressions.
  *
  * @param lhs Left hand side matrix.
  * @param rhs Right hand side matrix.
- * @return Added matrix.
+ * @return Added matrix expression.
  */
-template <size_t M, size_t N, class T, class C, class D> Math::Matrix<M, N, T> operator +(const Math::Matrix<M, N, T, C>& lhs, const Math::Matrix<M, N, T, D>& rhs);
+template <class L, class R> typename Math::binary_expression<L, R, Math::AddOp>::type operator +(L&& lhs, R&& rhs);
 
-/*! Substracts two matrices.
+/*! Substracts two matrix expressions.
  *
  * @param lhs Left hand side matrix.
  * @param rhs Right hand side matrix.
- * @return Substracted matrix.
+ * @return Substracted matrix expression.
  */
-template <size_t M, size_t N, class T, class C, class D> Math::Matrix<M, N, T> operator -(const Math::Matrix<M, N, T, C>& lhs, const Math::Matrix<M, N, T, D>& rhs);
+template <class L, class R> typename Math::binary_expression<L, R, Math::SubtractOp>::type operator -(L&& lhs, R&& rhs);
 
-/*! Multiplies matrix with a scalar.
+/*! Multiplies matrix expression with a scalar.
  *
  * @param m Matrix to multiply.
  * @param n Scalar to multiply with.
- * @return Multiplied matrix.
+ * @return Multiplied matrix expression.
  */
-template <size_t M, size_t N, class T, class C> Math::Matrix<M, N, T> operator *(const Math::Matrix<M, N, T, C>& m, const T& n);
+template <class E> typename Math::unary_expression<E, Math::ScaleOp<typename std::decay<E>::type::type> >::type operator *(E&& m, const typename std::decay<E>::type::type& n);
 
-/*! Multiplies two matrices.
+/*! Multiplies two matrices. Products are evaluated eagerly, operand
+ * expressions are evaluated once before multiplying.
  *
  * @param lhs Left hand side matrix.
  * @param rhs Right hand side matrix.
  * @return Multiplied matrix.
  */
-template <size_t M, size_t N, size_t P, class T, class C, class D> Math::Matrix<M, P, T> operator *(const Math::Matrix<M, N, T, C>& lhs, const Math::Matrix<N, P, T, D>& rhs);
+template <class L, class R> typename Math::product_expression<L, R>::type operator *(L&& lhs, R&& rhs);
 
 /*! Compares two matrices.
  *
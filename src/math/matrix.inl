@@ -1,6 +1,11 @@
 
 namespace Math {
 
+   template <size_t M, size_t N, class T, class C> const size_t Matrix<M, N, T, C>::Rows;
+   template <size_t M, size_t N, class T, class C> const size_t Matrix<M, N, T, C>::Cols;
+   template <class T, class C> const size_t Matrix<1, 1, T, C>::Rows;
+   template <class T, class C> const size_t Matrix<1, 1, T, C>::Cols;
+
    template <size_t M, size_t N, class T, class C> inline
    Matrix<M, N, T, C>::Matrix(const bool& initialize) : _data() {
       if (initialize) {
@@ -33,6 +38,36 @@ namespace Math {
       }
    }
 
+   template <size_t M, size_t N, class T, class C> inline
+   Matrix<M, N, T, C>::Matrix(C&& storage) : _data(std::move(storage)) {
+
+   }
+
+   template <size_t M, size_t N, class T, class C>
+   template <class E> inline
+   Matrix<M, N, T, C>::Matrix(const MatrixExpression<E>& expression, typename std::enable_if<E::Rows == M && E::Cols == N && std::is_same<typename E::type, T>::value>::type*) : _data() {
+      evaluate(expression);
+   }
+
+   template <size_t M, size_t N, class T, class C>
+   template <class E> inline
+   typename std::enable_if<E::Rows == M && E::Cols == N && std::is_same<typename E::type, T>::value, Matrix<M, N, T, C>&>::type Matrix<M, N, T, C>::operator =(const MatrixExpression<E>& expression) {
+      if (expression.derived().aliases(data(), data() + M * N))
+         evaluate(Matrix<M, N, T>(expression));
+      else
+         evaluate(expression);
+
+      return *this;
+   }
+
+   template <size_t M, size_t N, class T, class C>
+   template <class E> inline
+   void Matrix<M, N, T, C>::evaluate(const MatrixExpression<E>& expression) {
+      // Only heap allocated matrices are large enough to be split across
+      // threads; stack matrices are always evaluated inline.
+      Detail::evaluate(expression.derived(), data(), std::integral_constant<bool, C::Location == Heap>());
+   }
+
    template <size_t M, size_t N, class T, class C> inline
    size_t Matrix<M, N, T, C>::rows() const {
       return M;
@@ -48,6 +83,11 @@ namespace Math {
       return _data;
    }
 
+   template <size_t M, size_t N, class T, class C> inline
+   C& Matrix<M, N, T, C>::storage() {
+      return _data;
+   }
+
    template <size_t M, size_t N, class T, class C> inline
    T& Matrix<M, N, T, C>::operator ()(const size_t& i, const size_t& j) {
       assert(i > 0 && j > 0 && i <= M && j <= N);
@@ -91,60 +131,90 @@ namespace Math {
 
    template <size_t M, size_t N, class T, class C> inline
    Matrix<M, 1, T> Matrix<M, N, T, C>::get_column(const size_t& column) const {
-      Matrix<M, 1, T> m(false);
+      MATH_ACCOUNT_CALL(Extract, 0);
+      MATH_ACCOUNT_COPY(M * sizeof(T));
+      return Matrix<M, 1, T>(this->column(column));
+   }
 
-      for (size_t i = 1; i <= M; ++i)
-         m(i, 1) = (*this)(i, column);
+   template <size_t M, size_t N, class T, class C> inline
+   Matrix<1, N, T> Matrix<M, N, T, C>::get_row(const size_t& row) const {
+      MATH_ACCOUNT_CALL(Extract, 0);
+      MATH_ACCOUNT_COPY(N * sizeof(T));
+      return Matrix<1, N, T>(this->row(row));
+   }
 
-      return std::move(m);
+   template <size_t M, size_t N, class T, class C>
+   template <size_t m, size_t n> inline
+   Matrix<m, n, T> Matrix<M, N, T, C>::get_sub(const size_t& i, const size_t& j) const {
+      MATH_ACCOUNT_CALL(Extract, 0);
+      MATH_ACCOUNT_COPY(m * n * sizeof(T));
+      return Matrix<m, n, T>(sub<m, n>(i, j));
    }
 
    template <size_t M, size_t N, class T, class C> inline
-   Matrix<1, N, T> Matrix<M, N, T, C>::get_row(const size_t& row) const {
-      Matrix<1, M, T> m(false);
+   void Matrix<M, N, T, C>::set_column(const size_t& column, const Matrix<M, 1, T>& m) {
+      this->column(column) = m;
+   }
 
-      for (size_t i = 1; i <= N; ++i)
-         m(1, i) = (*this)(row, i);
+   template <size_t M, size_t N, class T, class C>
+   template <class E> inline
+   typename std::enable_if<E::Rows == M && E::Cols == 1>::type Matrix<M, N, T, C>::set_column(const size_t& column, const MatrixExpression<E>& m) {
+      this->column(column) = m;
+   }
 
-      return std::move(m);
+   template <size_t M, size_t N, class T, class C> inline
+   void Matrix<M, N, T, C>::set_row(const size_t& row, const Matrix<1, N, T>& m) {
+      this->row(row) = m;
    }
 
    template <size_t M, size_t N, class T, class C>
-   template <size_t m, size_t n> inline
-   Matrix<m, n, T> Matrix<M, N, T, C>::get_sub(const size_t& ii, const size_t& jj) const {
-      Matrix<m, n, T> out(false);
+   template <class E> inline
+   typename std::enable_if<E::Rows == 1 && E::Cols == N>::type Matrix<M, N, T, C>::set_row(const size_t& row, const MatrixExpression<E>& m) {
+      this->row(row) = m;
+   }
 
-      for (size_t i = ii; i <= m; ++i) {
-         for (size_t j = jj; j <= n; ++j)
-            out((size_t)(i - ii) + 1, (size_t)(j - jj) + 1) = (*this)(i, j);
-      }
+   template <size_t M, size_t N, class T, class C>
+   template <class E> inline
+   void Matrix<M, N, T, C>::set_sub(const size_t& i, const size_t& j, const MatrixExpression<E>& matrix) {
+      sub<E::Rows, E::Cols>(i, j) = matrix;
+   }
 
-      return std::move(out);
+   template <size_t M, size_t N, class T, class C> inline
+   MatrixView<M, 1, T> Matrix<M, N, T, C>::column(const size_t& column) {
+      assert(column > 0 && column <= N);
+      return MatrixView<M, 1, T>(data() + (column - 1) * M, 1, M);
    }
 
    template <size_t M, size_t N, class T, class C> inline
-   void Matrix<M, N, T, C>::set_column(const size_t& column, const Matrix<M, 1, T>& m) {
-      auto p = m.data();
+   ConstMatrixView<M, 1, T> Matrix<M, N, T, C>::column(const size_t& column) const {
+      assert(column > 0 && column <= N);
+      return ConstMatrixView<M, 1, T>(data() + (column - 1) * M, 1, M);
+   }
 
-      for (size_t i = 1; i <= M; ++i)
-         (*this)(i, column) = *p++;
+   template <size_t M, size_t N, class T, class C> inline
+   MatrixView<1, N, T> Matrix<M, N, T, C>::row(const size_t& row) {
+      assert(row > 0 && row <= M);
+      return MatrixView<1, N, T>(data() + (row - 1), 1, M);
    }
 
    template <size_t M, size_t N, class T, class C> inline
-   void Matrix<M, N, T, C>::set_row(const size_t& row, const Matrix<1, N, T>& m) {
-      auto p = m.data();
+   ConstMatrixView<1, N, T> Matrix<M, N, T, C>::row(const size_t& row) const {
+      assert(row > 0 && row <= M);
+      return ConstMatrixView<1, N, T>(data() + (row - 1), 1, M);
+   }
 
-      for (size_t i = 1; i <= N; ++i)
-         (*this)(row, i) = *p++;
+   template <size_t M, size_t N, class T, class C>
+   template <size_t m, size_t n> inline
+   MatrixView<m, n, T> Matrix<M, N, T, C>::sub(const size_t& i, const size_t& j) {
+      assert(i > 0 && j > 0 && i + m - 1 <= M && j + n - 1 <= N);
+      return MatrixView<m, n, T>(data() + (j - 1) * M + (i - 1), 1, M);
    }
 
    template <size_t M, size_t N, class T, class C>
-   template <size_t m, size_t n, class c> inline
-   void Matrix<M, N, T, C>::set_sub(const size_t& ii, const size_t& jj, const Matrix<m, n, T, c>& matrix) {
-      for (size_t i = ii; i <= m; ++i) {
-         for (size_t j = jj; j <= n; ++j)
-            (*this)(i, j) = matrix((size_t)(i - ii) + 1, (size_t)(j - jj) + 1);
-      }
+   template <size_t m, size_t n> inline
+   ConstMatrixView<m, n, T> Matrix<M, N, T, C>::sub(const size_t& i, const size_t& j) const {
+      assert(i > 0 && j > 0 && i + m - 1 <= M && j + n - 1 <= N);
+      return ConstMatrixView<m, n, T>(data() + (j - 1) * M + (i - 1), 1, M);
    }
 
    template <size_t M, size_t N, class T, class C> inline
@@ -157,6 +227,26 @@ namespace Math {
       return _data.end();
    }
 
+   template <size_t M, size_t N, class T, class C> inline
+   const T& Matrix<M, N, T, C>::coeff(const size_t& i, const size_t& j) const {
+      return data()[j * M + i];
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   const T& Matrix<M, N, T, C>::coeff(const size_t& index) const {
+      return data()[index];
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   bool Matrix<M, N, T, C>::references(const void* begin, const void* end) const {
+      return Detail::overlaps(data(), data() + M * N, begin, end);
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   bool Matrix<M, N, T, C>::aliases(const void* begin, const void* end) const {
+      return begin != data() && references(begin, end);
+   }
+
 
    template <class T, class Chunk> inline
    Matrix<1, 1, T, Chunk>::Matrix(const bool& initialize) {
@@ -176,6 +266,12 @@ namespace Math {
       _value = value;
    }
 
+   template <class T, class Chunk>
+   template <class E> inline
+   Matrix<1, 1, T, Chunk>::Matrix(const MatrixExpression<E>& expression, typename std::enable_if<E::Rows == 1 && E::Cols == 1 && std::is_same<typename E::type, T>::value>::type*) {
+      _value = expression.derived().coeff(0, 0);
+   }
+
    template <class T, class Chunk> inline
    Matrix<1, 1, T, Chunk>::operator T() const {
       return _value;
@@ -225,6 +321,26 @@ namespace Math {
       return &_value;
    }
 
+   template <class T, class Chunk> inline
+   const T& Matrix<1, 1, T, Chunk>::coeff(const size_t&, const size_t&) const {
+      return _value;
+   }
+
+   template <class T, class Chunk> inline
+   const T& Matrix<1, 1, T, Chunk>::coeff(const size_t&) const {
+      return _value;
+   }
+
+   template <class T, class Chunk> inline
+   bool Matrix<1, 1, T, Chunk>::references(const void* begin, const void* end) const {
+      return Detail::overlaps(&_value, &_value + 1, begin, end);
+   }
+
+   template <class T, class Chunk> inline
+   bool Matrix<1, 1, T, Chunk>::aliases(const void*, const void*) const {
+      return false;
+   }
+
 
    template <size_t N, class T> inline
    Matrix<N, N, T> eye() {
@@ -237,74 +353,56 @@ namespace Math {
 
       return std::move(out);
    }
-}
-
 
-template <size_t M, size_t N, class T, class C> inline
-Math::Matrix<M, N, T> operator -(const Math::Matrix<M, N, T, C>& m) {
-   Math::Matrix<M, N, T> out(false);
-
-   for (size_t i = 1; i <= M; ++i) {
-      for (size_t j = 1; j <= N; ++j)
-         out(i, j) = -m(i, j);
+   template <class E> inline
+   Matrix<E::Rows, E::Cols, typename E::type> eval(const MatrixExpression<E>& expression) {
+      return Matrix<E::Rows, E::Cols, typename E::type>(expression);
    }
 
-   return std::move(out);
-}
-
-template <size_t M, size_t N, class T, class C> inline
-Math::Matrix<N, M, T> operator ~(const Math::Matrix<M, N, T, C>& m) {
-   Math::Matrix<N, M, T> out(false);
-
-   for (size_t i = 1; i <= M; ++i) {
-      for (size_t j = 1; j <= N; ++j)
-         out(j, i) = m(i, j);
+   template <size_t M, size_t N, class T, class C> inline
+   const Matrix<M, N, T, C>& eval(const Matrix<M, N, T, C>& m) {
+      return m;
    }
-
-   return std::move(out);
 }
 
-template <size_t M, size_t N, class T, class C, class D> inline
-Math::Matrix<M, N, T> operator +(const Math::Matrix<M, N, T, C>& lhs, const Math::Matrix<M, N, T, D>& rhs) {
-   Math::Matrix<M, N, T> out(false);
 
-   for (size_t i = 1; i <= M; ++i) {
-      for (size_t j = 1; j <= N; ++j)
-         out(i, j) = lhs(i, j) + rhs(i, j);
-   }
-
-   return std::move(out);
+template <class E> inline
+typename Math::unary_expression<E, Math::NegateOp>::type operator -(E&& m) {
+   return typename Math::unary_expression<E, Math::NegateOp>::type(std::forward<E>(m));
 }
 
-template <size_t M, size_t N, class T, class C, class D> inline
-Math::Matrix<M, N, T> operator -(const Math::Matrix<M, N, T, C>& lhs, const Math::Matrix<M, N, T, D>& rhs) {
-   return std::move(lhs + (-rhs));
+template <class E> inline
+typename Math::transpose_expression<E>::type operator ~(E&& m) {
+   return typename Math::transpose_expression<E>::type(std::forward<E>(m));
 }
 
-template <size_t M, size_t N, class T, class C> inline
-Math::Matrix<M, N, T> operator *(const Math::Matrix<M, N, T, C>& m, const T& n) {
-   Math::Matrix<M, N, T> out(false);
+template <class L, class R> inline
+typename Math::binary_expression<L, R, Math::AddOp>::type operator +(L&& lhs, R&& rhs) {
+   return typename Math::binary_expression<L, R, Math::AddOp>::type(std::forward<L>(lhs), std::forward<R>(rhs));
+}
 
-   for (size_t i = 1; i <= M; ++i) {
-      for (size_t j = 1; j <= N; ++j)
-         out(i, j) = m(i, j) * n;
-   }
+template <class L, class R> inline
+typename Math::binary_expression<L, R, Math::SubtractOp>::type operator -(L&& lhs, R&& rhs) {
+   return typename Math::binary_expression<L, R, Math::SubtractOp>::type(std::forward<L>(lhs), std::forward<R>(rhs));
+}
 
-   return std::move(out);
+template <class E> inline
+typename Math::unary_expression<E, Math::ScaleOp<typename std::decay<E>::type::type> >::type operator *(E&& m, const typename std::decay<E>::type::type& n) {
+   typedef typename std::decay<E>::type::type T;
+   return typename Math::unary_expression<E, Math::ScaleOp<T> >::type(std::forward<E>(m), Math::ScaleOp<T>(n));
 }
 
-template <size_t M, size_t N, size_t P, class T, class C, class D> inline
-Math::Matrix<M, P, T> operator *(const Math::Matrix<M, N, T, C>& lhs, const Math::Matrix<N, P, T, D>& rhs) {
-   Math::Matrix<M, P, T> out(false);
+template <class L, class R> inline
+typename Math::product_expression<L, R>::type operator *(L&& lhs, R&& rhs) {
+   typedef typename Math::product_expression<L, R>::type result;
+   const size_t M = result::Rows, N = std::decay<L>::type::Cols, P = result::Cols;
 
-   for (size_t i = 1; i <= M; ++i) {
-      for (size_t j = 1; j <= P; ++j) {
-         out(i, j) = (T)0;
+   const auto& a = Math::eval(lhs);
+   const auto& b = Math::eval(rhs);
+   result out(false);
 
-         for (size_t r = 1; r <= N; ++r)
-            out(i, j) += lhs(i, r) * rhs(r, j);
-      }
-   }
+   // Only products into heap allocated matrices are split across threads.
+   Math::product<M, N, P, Math::MatrixChunk<M, P, typename result::type>::Location == Math::Heap>(a.data(), b.data(), out.data());
 
    return std::move(out);
 }
@@ -2,16 +2,29 @@
 
 #include <type_traits>
 #include <array>
+#include <cstddef>
 #include <vector>
 #include <cstring>
+#include <cassert>
+#include <utility>
+#include "allocator.hpp"
 
 namespace Math {
 
+   //! Number of elements up to which matrices are allocated in stack.
+   const size_t DefaultMaxStackAllocSize = 32 * 32;
+
+   /*! Largest alignment of stack allocated matrix storage in bytes. C++11
+    * new expressions and standard containers only guarantee the alignment of
+    * std::max_align_t, so over-aligned matrices would be misaligned there.
+    */
+   const size_t MaxStackAlignment = alignof(std::max_align_t) < DefaultAlignment ? alignof(std::max_align_t) : DefaultAlignment;
+
    /*! Abstracts matrix memory access. Small matrices are allocated in 
     * stack and when the allocation size is greater than a threshold value, 
-    * memory is allocated from heap.
+    * memory is allocated from heap with the given allocator.
     */
-   template <size_t M, size_t N, class T, size_t MaxStackAllocSize = 32 * 32, class Enable = void>
+   template <size_t M, size_t N, class T, size_t MaxStackAllocSize = DefaultMaxStackAllocSize, class Allocator = AlignedAllocator<T>, class Enable = void>
    class MatrixChunk;
 
    enum ChunkLocation {
@@ -19,18 +32,33 @@ namespace Math {
       Heap
    };
 
-   template <size_t M, size_t N, class T, size_t MaxStackAllocSize>
-   class MatrixChunk<M, N, T, MaxStackAllocSize, typename std::enable_if<M * N <= MaxStackAllocSize>::type> {
+   namespace Detail {
+
+      /*! Finds the largest power of two up to @p alignment that divides
+       * @p size, so that aligning storage of @p size bytes adds no padding.
+       */
+      constexpr size_t stack_alignment(const size_t size, const size_t alignment) {
+         return alignment <= 1 || size % alignment == 0 ? alignment : stack_alignment(size, alignment / 2);
+      }
+   }
+
+   template <size_t M, size_t N, class T, size_t MaxStackAllocSize, class Allocator>
+   class MatrixChunk<M, N, T, MaxStackAllocSize, Allocator, typename std::enable_if<M * N <= MaxStackAllocSize>::type> {
    public:
 
       static const ChunkLocation Location = Stack;
 
+      //! Allocator used if the matrix were heap allocated.
+      typedef Allocator allocator_type;
+
       T& operator [](const size_t& index) {
-         return _data.at(index);
+         assert(index < M * N);
+         return _data[index];
       }
 
       const T& operator [](const size_t& index) const {
-         return _data.at(index);
+         assert(index < M * N);
+         return _data[index];
       }
 
       operator T*() {
@@ -50,25 +78,56 @@ namespace Math {
       }
 
    private:
-      std::array<T, M * N> _data;
+      // Aligned as far as heap allocation allows without growing the matrix.
+      alignas(Detail::stack_alignment(sizeof(T) * M * N, MaxStackAlignment)) std::array<T, M * N> _data;
    };
 
-   template <size_t M, size_t N, class T, size_t MaxStackAllocSize>
-   class MatrixChunk<M, N, T, MaxStackAllocSize, typename std::enable_if<M * N >= MaxStackAllocSize + 1>::type> {
+   template <size_t M, size_t N, class T, size_t MaxStackAllocSize, class Allocator>
+   class MatrixChunk<M, N, T, MaxStackAllocSize, Allocator, typename std::enable_if<M * N >= MaxStackAllocSize + 1>::type> {
    public:
 
       static const ChunkLocation Location = Heap;
 
+      //! Allocator of the matrix storage.
+      typedef Allocator allocator_type;
+
+      //! Type alias for the container holding matrix elements.
+      typedef std::vector<T, Allocator> container;
+
       MatrixChunk() : _data(M * N) {
 
       }
 
+      MatrixChunk(const MatrixChunk& other) : _data(other._data) {
+         MATH_ACCOUNT_COPY(M * N * sizeof(T));
+      }
+
+      MatrixChunk(MatrixChunk&& other) = default;
+
+      MatrixChunk& operator =(const MatrixChunk& other) {
+         _data = other._data;
+         MATH_ACCOUNT_COPY(M * N * sizeof(T));
+         return *this;
+      }
+
+      MatrixChunk& operator =(MatrixChunk&& other) = default;
+
+      /*! Constructs a chunk that takes over given elements.
+       *
+       * @param data M*N elements in column-major order.
+       */
+      explicit MatrixChunk(container&& data) : _data(std::move(data)) {
+         assert(_data.size() == M * N);
+      }
+
       T& operator [](const size_t& index) {
-         return _data.at(index);
+         assert(index < M * N);
+         return _data[index];
       }
 
       const T& operator [](const size_t& index) const {
-         return _data.at(index);
+         assert(index < M * N);
+         return _data[index];
       }
 
       operator T*() {
@@ -79,15 +138,24 @@ namespace Math {
          return _data.data();
       }
 
-      auto begin() const -> decltype(std::declval<std::vector<T>>().cbegin()) {
+      auto begin() const -> decltype(std::declval<container>().cbegin()) {
          return _data.cbegin();
       }
 
-      auto end() const -> decltype(std::declval<std::vector<T>>().cend()) {
+      auto end() const -> decltype(std::declval<container>().cend()) {
          return _data.cend();
       }
 
+      /*! Takes over the elements. The chunk must not be accessed afterwards
+       * except for assigning or destroying it.
+       *
+       * @return Elements in column-major order.
+       */
+      container release() {
+         return std::move(_data);
+      }
+
    private:
-      std::vector<T> _data;
+      container _data;
    };
 }
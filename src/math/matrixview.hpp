@@ -0,0 +1,233 @@
+#pragma once
+
+#include "expression.hpp"
+#include "matrixchunk.hpp"
+#include <cassert>
+
+namespace Math {
+
+   template <size_t M, size_t N, class T, class Chunk> class Matrix;
+
+   /*! Read-only MxN view of existing matrix storage. Element (i, j) is
+    * located at offset i * row stride + j * column stride (0-based), so
+    * rows, columns, sub matrices and transposes of a matrix can be viewed
+    * without copying. Views are leaves of matrix expressions.
+    */
+   template <size_t M, size_t N, class T> class ConstMatrixView : public MatrixExpression< ConstMatrixView<M, N, T> > {
+   public:
+
+      //! View row size constant.
+      static const size_t Rows = M;
+
+      //! View column size constant.
+      static const size_t Cols = N;
+
+      //! Tells that a view is a leaf of an expression.
+      static const bool Leaf = true;
+
+      //! Viewed elements are not contiguous in general.
+      static const bool Linear = false;
+
+      //! Type alias for element types.
+      typedef T type;
+
+      /*! Constructs a view.
+       *
+       * @param data Pointer to the first element.
+       * @param rowStride Distance between elements of consecutive rows.
+       * @param colStride Distance between elements of consecutive columns.
+       */
+      ConstMatrixView(const T* data, const size_t& rowStride = 1, const size_t& colStride = M);
+
+      /*! Constructs a view of a whole matrix.
+       *
+       * @param m Matrix to view.
+       */
+      template <class C> ConstMatrixView(const Matrix<M, N, T, C>& m);
+
+      /*! Gets raw data pointer to the first element.
+       *
+       * @return Const data pointer to the first element.
+       */
+      const T* data() const;
+
+      /*! Tells the distance between elements of consecutive rows.
+       *
+       * @return Row stride.
+       */
+      size_t row_stride() const;
+
+      /*! Tells the distance between elements of consecutive columns.
+       *
+       * @return Column stride.
+       */
+      size_t col_stride() const;
+
+      /*! Access view elements.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Const element at given location.
+       */
+      const T& operator ()(const size_t& i, const size_t& j) const;
+
+      /*! Views a row.
+       *
+       * @param row Row index, 1-based.
+       * @return View of the row.
+       */
+      ConstMatrixView<1, N, T> row(const size_t& row) const;
+
+      /*! Views a column.
+       *
+       * @param column Column index, 1-based.
+       * @return View of the column.
+       */
+      ConstMatrixView<M, 1, T> column(const size_t& column) const;
+
+      /*! Views a sub matrix.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @return View of the sub matrix.
+       */
+      template <size_t m, size_t n> ConstMatrixView<m, n, T> sub(const size_t& i, const size_t& j) const;
+
+      /*! Views the transpose.
+       *
+       * @return Transposed view.
+       */
+      ConstMatrixView<N, M, T> transpose() const;
+
+      /*! Access view elements without bounds checking.
+       *
+       * @param i Row number, 0-based.
+       * @param j Column number, 0-based.
+       * @return Const element at given location.
+       */
+      const T& coeff(const size_t& i, const size_t& j) const;
+
+      /*! Tells whether the viewed storage overlaps given storage.
+       *
+       * @param begin Storage begin.
+       * @param end Storage end.
+       * @return @c true if the storage overlaps viewed elements.
+       */
+      bool references(const void* begin, const void* end) const;
+
+      /*! Tells whether evaluating the view into a dense matrix requires a
+       * temporary. This is the case when the destination overlaps the view,
+       * unless the view covers the destination exactly.
+       *
+       * @param begin Destination storage begin.
+       * @param end Destination storage end.
+       * @return @c true if a temporary is required.
+       */
+      bool aliases(const void* begin, const void* end) const;
+
+   protected:
+
+      //! Gets the end of the viewed storage range.
+      const T* storage_end() const;
+
+      const T* _data;
+      size_t _rowStride;
+      size_t _colStride;
+   };
+
+   /*! MxN view of existing matrix storage that can be assigned to. Assigning
+    * an expression to a view writes the viewed elements.
+    */
+   template <size_t M, size_t N, class T> class MatrixView : public ConstMatrixView<M, N, T> {
+   public:
+      using ConstMatrixView<M, N, T>::data;
+      using ConstMatrixView<M, N, T>::operator ();
+      using ConstMatrixView<M, N, T>::row;
+      using ConstMatrixView<M, N, T>::column;
+      using ConstMatrixView<M, N, T>::sub;
+      using ConstMatrixView<M, N, T>::transpose;
+
+      /*! Constructs a view.
+       *
+       * @param data Pointer to the first element.
+       * @param rowStride Distance between elements of consecutive rows.
+       * @param colStride Distance between elements of consecutive columns.
+       */
+      MatrixView(T* data, const size_t& rowStride = 1, const size_t& colStride = M);
+
+      /*! Constructs a view of a whole matrix.
+       *
+       * @param m Matrix to view.
+       */
+      template <class C> MatrixView(Matrix<M, N, T, C>& m);
+
+      /*! Copies elements of another view into the viewed elements.
+       *
+       * @param other View to copy.
+       * @return This view.
+       */
+      MatrixView& operator =(const MatrixView& other);
+
+      /*! Assigns an evaluated expression to the viewed elements.
+       *
+       * @param expression Expression to evaluate.
+       * @return This view.
+       */
+      template <class E> typename std::enable_if<E::Rows == M && E::Cols == N && std::is_same<typename E::type, T>::value, MatrixView&>::type operator =(const MatrixExpression<E>& expression);
+
+      /*! Gets raw data pointer to the first element.
+       *
+       * @return Data pointer to the first element.
+       */
+      T* data();
+
+      /*! Access view elements.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Element at given location.
+       */
+      T& operator ()(const size_t& i, const size_t& j);
+
+      /*! Views a row.
+       *
+       * @param row Row index, 1-based.
+       * @return View of the row.
+       */
+      MatrixView<1, N, T> row(const size_t& row);
+
+      /*! Views a column.
+       *
+       * @param column Column index, 1-based.
+       * @return View of the column.
+       */
+      MatrixView<M, 1, T> column(const size_t& column);
+
+      /*! Views a sub matrix.
+       *
+       * @param i Sub matrix first row index, 1-based.
+       * @param j Sub matrix first column index, 1-based.
+       * @return View of the sub matrix.
+       */
+      template <size_t m, size_t n> MatrixView<m, n, T> sub(const size_t& i, const size_t& j);
+
+      /*! Views the transpose.
+       *
+       * @return Transposed view.
+       */
+      MatrixView<N, M, T> transpose();
+
+   private:
+      template <class E> void assign(const E& e);
+   };
+
+   /*! Swaps the elements of two equally sized views, e.g. two rows of a
+    * matrix.
+    *
+    * @param a First view.
+    * @param b Second view.
+    */
+   template <size_t M, size_t N, class T> void swap(MatrixView<M, N, T> a, MatrixView<M, N, T> b);
+}
+
+#include "matrixview.inl"
@@ -0,0 +1,184 @@
+namespace Math {
+
+   template <size_t M, size_t N, class T> const size_t ConstMatrixView<M, N, T>::Rows;
+   template <size_t M, size_t N, class T> const size_t ConstMatrixView<M, N, T>::Cols;
+
+   template <size_t M, size_t N, class T> inline
+   ConstMatrixView<M, N, T>::ConstMatrixView(const T* data, const size_t& rowStride, const size_t& colStride)
+      : _data(data), _rowStride(rowStride), _colStride(colStride)
+   {
+
+   }
+
+   template <size_t M, size_t N, class T>
+   template <class C> inline
+   ConstMatrixView<M, N, T>::ConstMatrixView(const Matrix<M, N, T, C>& m)
+      : _data(m.data()), _rowStride(1), _colStride(M)
+   {
+
+   }
+
+   template <size_t M, size_t N, class T> inline
+   const T* ConstMatrixView<M, N, T>::data() const {
+      return _data;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   size_t ConstMatrixView<M, N, T>::row_stride() const {
+      return _rowStride;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   size_t ConstMatrixView<M, N, T>::col_stride() const {
+      return _colStride;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   const T& ConstMatrixView<M, N, T>::operator ()(const size_t& i, const size_t& j) const {
+      assert(i > 0 && j > 0 && i <= M && j <= N);
+      return _data[(i - 1) * _rowStride + (j - 1) * _colStride];
+   }
+
+   template <size_t M, size_t N, class T> inline
+   ConstMatrixView<1, N, T> ConstMatrixView<M, N, T>::row(const size_t& row) const {
+      assert(row > 0 && row <= M);
+      return ConstMatrixView<1, N, T>(_data + (row - 1) * _rowStride, _rowStride, _colStride);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   ConstMatrixView<M, 1, T> ConstMatrixView<M, N, T>::column(const size_t& column) const {
+      assert(column > 0 && column <= N);
+      return ConstMatrixView<M, 1, T>(_data + (column - 1) * _colStride, _rowStride, _colStride);
+   }
+
+   template <size_t M, size_t N, class T>
+   template <size_t m, size_t n> inline
+   ConstMatrixView<m, n, T> ConstMatrixView<M, N, T>::sub(const size_t& i, const size_t& j) const {
+      assert(i > 0 && j > 0 && i + m - 1 <= M && j + n - 1 <= N);
+      return ConstMatrixView<m, n, T>(_data + (i - 1) * _rowStride + (j - 1) * _colStride, _rowStride, _colStride);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   ConstMatrixView<N, M, T> ConstMatrixView<M, N, T>::transpose() const {
+      return ConstMatrixView<N, M, T>(_data, _colStride, _rowStride);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   const T& ConstMatrixView<M, N, T>::coeff(const size_t& i, const size_t& j) const {
+      return _data[i * _rowStride + j * _colStride];
+   }
+
+   template <size_t M, size_t N, class T> inline
+   bool ConstMatrixView<M, N, T>::references(const void* begin, const void* end) const {
+      return Detail::overlaps(_data, storage_end(), begin, end);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   bool ConstMatrixView<M, N, T>::aliases(const void* begin, const void* end) const {
+      const bool dense = begin == _data && _rowStride == 1 && _colStride == M;
+      return !dense && references(begin, end);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   const T* ConstMatrixView<M, N, T>::storage_end() const {
+      return _data + (M - 1) * _rowStride + (N - 1) * _colStride + 1;
+   }
+
+
+   template <size_t M, size_t N, class T> inline
+   MatrixView<M, N, T>::MatrixView(T* data, const size_t& rowStride, const size_t& colStride)
+      : ConstMatrixView<M, N, T>(data, rowStride, colStride)
+   {
+
+   }
+
+   template <size_t M, size_t N, class T>
+   template <class C> inline
+   MatrixView<M, N, T>::MatrixView(Matrix<M, N, T, C>& m)
+      : ConstMatrixView<M, N, T>(m.data(), 1, M)
+   {
+
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixView<M, N, T>& MatrixView<M, N, T>::operator =(const MatrixView& other) {
+      return *this = static_cast<const MatrixExpression< ConstMatrixView<M, N, T> >&>(other);
+   }
+
+   template <size_t M, size_t N, class T>
+   template <class E> inline
+   typename std::enable_if<E::Rows == M && E::Cols == N && std::is_same<typename E::type, T>::value, MatrixView<M, N, T>&>::type MatrixView<M, N, T>::operator =(const MatrixExpression<E>& expression) {
+      // Any overlap may overwrite elements before they are read, since the
+      // destination is not laid out like the expression operands.
+      if (expression.derived().references(this->_data, this->storage_end())) {
+         const Matrix<M, N, T, MatrixChunk<M, N, T> > tmp(expression);
+         assign(tmp);
+      }
+      else {
+         assign(expression.derived());
+      }
+
+      return *this;
+   }
+
+   template <size_t M, size_t N, class T> inline
+   T* MatrixView<M, N, T>::data() {
+      return const_cast<T*>(this->_data);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   T& MatrixView<M, N, T>::operator ()(const size_t& i, const size_t& j) {
+      return const_cast<T&>(ConstMatrixView<M, N, T>::operator ()(i, j));
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixView<1, N, T> MatrixView<M, N, T>::row(const size_t& row) {
+      assert(row > 0 && row <= M);
+      return MatrixView<1, N, T>(data() + (row - 1) * this->_rowStride, this->_rowStride, this->_colStride);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixView<M, 1, T> MatrixView<M, N, T>::column(const size_t& column) {
+      assert(column > 0 && column <= N);
+      return MatrixView<M, 1, T>(data() + (column - 1) * this->_colStride, this->_rowStride, this->_colStride);
+   }
+
+   template <size_t M, size_t N, class T>
+   template <size_t m, size_t n> inline
+   MatrixView<m, n, T> MatrixView<M, N, T>::sub(const size_t& i, const size_t& j) {
+      assert(i > 0 && j > 0 && i + m - 1 <= M && j + n - 1 <= N);
+      return MatrixView<m, n, T>(data() + (i - 1) * this->_rowStride + (j - 1) * this->_colStride, this->_rowStride, this->_colStride);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   MatrixView<N, M, T> MatrixView<M, N, T>::transpose() {
+      return MatrixView<N, M, T>(data(), this->_colStride, this->_rowStride);
+   }
+
+   template <size_t M, size_t N, class T>
+   template <class E> inline
+   void MatrixView<M, N, T>::assign(const E& e) {
+      T* out = data();
+      const size_t rs = this->_rowStride, cs = this->_colStride;
+      const auto columns = [&e, out, rs, cs](const size_t& begin, const size_t& end) {
+         for (size_t j = begin; j < end; ++j) {
+            for (size_t i = 0; i < M; ++i)
+               out[i * rs + j * cs] = e.coeff(i, j);
+         }
+      };
+
+      // Views of stack sized blocks are always evaluated inline.
+      if (MatrixChunk<M, N, T>::Location == Heap)
+         parallel_for(0, N, M, columns);
+      else
+         columns(0, N);
+   }
+
+   template <size_t M, size_t N, class T> inline
+   void swap(MatrixView<M, N, T> a, MatrixView<M, N, T> b) {
+      for (size_t j = 1; j <= N; ++j) {
+         for (size_t i = 1; i <= M; ++i)
+            std::swap(a(i, j), b(i, j));
+      }
+   }
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Math {
+
+   /*! Hardware events counted by @c PerfCounters.
+    */
+   enum PerfEvent {
+      Cycles,
+      Instructions,
+      L1Misses,
+      LlcMisses,
+      BranchMisses,
+      PerfEventCount
+   };
+
+   //! Event counts indexed by @c PerfEvent.
+   typedef std::array<uint64_t, PerfEventCount> PerfCounts;
+
+   /*! Unscaled reading of all counters with the time they were enabled and
+    * actually counting, so that the difference of two samples can be scaled
+    * for multiplexing.
+    */
+   struct PerfSample {
+
+      //! Raw counts since the counters were opened.
+      PerfCounts counts;
+
+      //! Nanoseconds the counters were enabled.
+      uint64_t enabled;
+
+      //! Nanoseconds the counters were counting.
+      uint64_t running;
+   };
+
+   /*! Hardware performance counters of the calling thread, read through
+    * Linux @c perf_event_open: CPU cycles, retired instructions, L1 data
+    * cache read misses, last level cache misses and mispredicted branches.
+    * Only user space is counted. Events the processor, the kernel settings
+    * or the platform do not support are unavailable and read as zero, so
+    * that code using counters runs everywhere.
+    *
+    * Counters belong to the thread that opened them and do not include work
+    * run on other threads, such as the @c ThreadPool workers of large
+    * products and decompositions. When the kernel multiplexes more events
+    * than the processor has counters, counts are scaled up from the time
+    * they were actually counted within the measured interval.
+    */
+   class PerfCounters {
+   public:
+
+      /*! Opens counters for the calling thread. Counting starts at once.
+       */
+      PerfCounters();
+
+      /*! Closes the counters.
+       */
+      ~PerfCounters();
+
+      PerfCounters(const PerfCounters&) = delete;
+      PerfCounters& operator =(const PerfCounters&) = delete;
+
+      /*! Gets the counters of the calling thread, opened on first use.
+       *
+       * @return Counters of the calling thread.
+       */
+      static PerfCounters& thread();
+
+      /*! Tells whether any event is counted.
+       *
+       * @return @c true if at least one event is available.
+       */
+      bool available() const;
+
+      /*! Tells whether an event is counted.
+       *
+       * @param event Event to check.
+       * @return @c true if the event is available.
+       */
+      bool available(const PerfEvent& event) const;
+
+      /*! Tells which events are counted.
+       *
+       * @return Bit 1 << event set for every available event.
+       */
+      unsigned events() const;
+
+      /*! Reads all counters at once.
+       *
+       * @return Counts since the counters were opened, scaled for
+       *         multiplexing, zero for unavailable events.
+       */
+      PerfCounts read() const;
+
+      /*! Reads all counters at once without scaling.
+       *
+       * @return Raw counts and times since the counters were opened.
+       */
+      PerfSample sample() const;
+
+      /*! Tells the events counted between two samples. Counts are scaled by
+       * the time the counters were enabled over the time they were counting
+       * between the samples.
+       *
+       * @param start Earlier sample.
+       * @param end Later sample.
+       * @param multiplexed Set to @c true if the events were not counted the
+       *                    whole interval and the counts are estimates.
+       * @return Events counted between the samples.
+       */
+      static PerfCounts difference(const PerfSample& start, const PerfSample& end, bool& multiplexed);
+
+   private:
+      int _leader;
+      std::array<int, PerfEventCount> _fds;
+      std::array<size_t, PerfEventCount> _slots;
+      size_t _opened;
+   };
+
+   /*! Accumulated counts of a named region.
+    */
+   struct PerfRecord {
+
+      //! Region name.
+      std::string name;
+
+      //! Number of times the region was run.
+      uint64_t calls;
+
+      //! Wall clock time spent in the region.
+      double seconds;
+
+      //! Event counts spent in the region.
+      PerfCounts counts;
+
+      //! Bit 1 << event set for events counted in at least one call.
+      unsigned events;
+
+      //! Number of calls whose counts were scaled because of multiplexing.
+      uint64_t multiplexed;
+   };
+
+   /*! Collects the counts of named regions from all threads. Nested regions
+    * are counted inclusively.
+    */
+   class PerfRegistry {
+   public:
+
+      /*! Gets the registry used by @c PerfScope.
+       *
+       * @return The shared registry.
+       */
+      static PerfRegistry& instance();
+
+      /*! Adds one run of a region.
+       *
+       * @param name Region name.
+       * @param counts Events counted during the run.
+       * @param events Bit 1 << event set for events counted.
+       * @param seconds Wall clock time of the run.
+       * @param multiplexed Whether the counts were scaled.
+       */
+      void add(const char* name, const PerfCounts& counts, const unsigned& events, const double& seconds, const bool& multiplexed);
+
+      /*! Copies the records.
+       *
+       * @return Records ordered by region name.
+       */
+      std::vector<PerfRecord> snapshot() const;
+
+      /*! Clears all records.
+       */
+      void reset();
+
+      /*! Writes a table of calls, time and events per call of every region,
+       * with instructions per cycle and the number of calls with multiplexed
+       * counts. Unavailable events are shown as "-".
+       *
+       * @param out Output stream.
+       */
+      void dump(std::ostream& out) const;
+
+   private:
+      mutable std::mutex _mutex;
+      std::map<std::string, PerfRecord> _records;
+   };
+
+   /*! Counts the events of the calling thread from construction to
+    * destruction and adds them to @c PerfRegistry under the given name.
+    * Work the region hands to other threads is not counted, so regions
+    * above the parallel threshold report the share of the calling thread
+    * only; profile with MATH_NUM_THREADS=1 to count all of it.
+    */
+   class PerfScope {
+   public:
+
+      /*! Starts counting a region.
+       *
+       * @param name Region name, must outlive the scope.
+       */
+      explicit PerfScope(const char* name);
+
+      /*! Adds the region to the registry.
+       */
+      ~PerfScope();
+
+      PerfScope(const PerfScope&) = delete;
+      PerfScope& operator =(const PerfScope&) = delete;
+
+   private:
+      const char* _name;
+      const PerfCounters& _counters;
+      PerfSample _start;
+      std::chrono::steady_clock::time_point _time;
+   };
+}
+
+/*! Counts the rest of the enclosing block as a named region when
+ * MATH_PERF_COUNTERS is defined, and does nothing otherwise. Each region
+ * reads the counters of the calling thread twice through system calls, so
+ * the library's own regions are meant for profiling builds.
+ */
+#if defined(MATH_PERF_COUNTERS)
+#define MATH_PERF_SCOPE(name) ::Math::PerfScope math_perf_scope_(name)
+#else
+#define MATH_PERF_SCOPE(name)
+#endif
+
+#include "perfcounters.inl"
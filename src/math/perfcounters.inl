@@ -0,0 +1,268 @@
+#include <cstring>
+#include <iomanip>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Math {
+
+   namespace Detail {
+
+#if defined(__linux__)
+      /*! Opens one counter of the calling thread.
+       *
+       * @param event Event to count.
+       * @param leader Group leader, or -1 to start a group.
+       * @return File descriptor, or -1 if the event is unavailable.
+       */
+      inline int open_perf_event(const PerfEvent& event, const int& leader) {
+         perf_event_attr attr;
+         std::memset(&attr, 0, sizeof(attr));
+
+         attr.size = sizeof(attr);
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.exclude_kernel = 1;
+         attr.exclude_hv = 1;
+         attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+         switch (event) {
+         case Cycles:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+         case Instructions:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+         case L1Misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+         case LlcMisses:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+         default:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+         }
+
+         return (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+      }
+#endif
+   }
+
+   inline PerfCounters::PerfCounters() : _leader(-1), _opened(0) {
+      _fds.fill(-1);
+      _slots.fill(0);
+
+#if defined(__linux__)
+      // Events join the group of the first one that opens, so that all of
+      // them are read with one system call and cover the same interval.
+      for (size_t e = 0; e < PerfEventCount; ++e) {
+         _fds[e] = Detail::open_perf_event((PerfEvent)e, _leader);
+
+         if (_fds[e] < 0)
+            continue;
+
+         if (_leader < 0)
+            _leader = _fds[e];
+
+         _slots[e] = _opened++;
+      }
+#endif
+   }
+
+   inline PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+      for (size_t e = PerfEventCount; e-- > 0;) {
+         if (_fds[e] >= 0)
+            close(_fds[e]);
+      }
+#endif
+   }
+
+   inline PerfCounters& PerfCounters::thread() {
+      static thread_local PerfCounters counters;
+      return counters;
+   }
+
+   inline bool PerfCounters::available() const {
+      return _opened > 0;
+   }
+
+   inline bool PerfCounters::available(const PerfEvent& event) const {
+      return _fds[event] >= 0;
+   }
+
+   inline unsigned PerfCounters::events() const {
+      unsigned mask = 0;
+
+      for (size_t e = 0; e < PerfEventCount; ++e)
+         mask |= _fds[e] >= 0 ? 1u << e : 0u;
+
+      return mask;
+   }
+
+   inline PerfCounts PerfCounters::read() const {
+      PerfSample opened;
+      opened.counts.fill(0);
+      opened.enabled = 0;
+      opened.running = 0;
+
+      bool multiplexed;
+      return difference(opened, sample(), multiplexed);
+   }
+
+   inline PerfSample PerfCounters::sample() const {
+      PerfSample out;
+      out.counts.fill(0);
+      out.enabled = 0;
+      out.running = 0;
+
+#if defined(__linux__)
+      if (_leader < 0)
+         return out;
+
+      // Group reads give the number of events, the time the group was
+      // enabled and running, then the values.
+      uint64_t values[PerfEventCount + 3];
+      const ssize_t size = (ssize_t)((_opened + 3) * sizeof(uint64_t));
+
+      if (::read(_leader, values, size) != size)
+         return out;
+
+      out.enabled = values[1];
+      out.running = values[2];
+
+      for (size_t e = 0; e < PerfEventCount; ++e) {
+         if (_fds[e] >= 0)
+            out.counts[e] = values[_slots[e] + 3];
+      }
+#endif
+
+      return out;
+   }
+
+   inline PerfCounts PerfCounters::difference(const PerfSample& start, const PerfSample& end, bool& multiplexed) {
+      const uint64_t enabled = end.enabled - start.enabled;
+      const uint64_t running = end.running - start.running;
+      PerfCounts counts;
+
+      // Multiplexed groups only counted while running.
+      multiplexed = running < enabled;
+
+      const double scale = multiplexed && running > 0 ? (double)enabled / (double)running : 1.0;
+
+      for (size_t e = 0; e < PerfEventCount; ++e) {
+         const uint64_t delta = end.counts[e] - start.counts[e];
+         counts[e] = multiplexed ? (uint64_t)((double)delta * scale) : delta;
+      }
+
+      return counts;
+   }
+
+   inline PerfRegistry& PerfRegistry::instance() {
+      static PerfRegistry registry;
+      return registry;
+   }
+
+   inline void PerfRegistry::add(const char* name, const PerfCounts& counts, const unsigned& events, const double& seconds, const bool& multiplexed) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _records.find(name);
+
+      if (it == _records.end()) {
+         PerfRecord record;
+         record.name = name;
+         record.calls = 0;
+         record.seconds = 0.0;
+         record.counts.fill(0);
+         record.events = 0;
+         record.multiplexed = 0;
+
+         it = _records.insert(std::make_pair(record.name, record)).first;
+      }
+
+      PerfRecord& record = it->second;
+
+      record.calls += 1;
+      record.seconds += seconds;
+      record.events |= events;
+      record.multiplexed += multiplexed ? 1 : 0;
+
+      for (size_t e = 0; e < PerfEventCount; ++e)
+         record.counts[e] += counts[e];
+   }
+
+   inline std::vector<PerfRecord> PerfRegistry::snapshot() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::vector<PerfRecord> out;
+
+      out.reserve(_records.size());
+
+      for (const auto& item : _records)
+         out.push_back(item.second);
+
+      return out;
+   }
+
+   inline void PerfRegistry::reset() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _records.clear();
+   }
+
+   inline void PerfRegistry::dump(std::ostream& out) const {
+      static const char* const headers[PerfEventCount] = { "cycles", "instructions", "l1-misses", "llc-misses", "branch-misses" };
+      const std::vector<PerfRecord> records = snapshot();
+      const std::ios::fmtflags flags = out.flags();
+      const std::streamsize precision = out.precision();
+
+      out << std::left << std::setw(24) << "region" << std::right << std::setw(12) << "calls" << std::setw(14) << "ns/call";
+
+      for (size_t e = 0; e < PerfEventCount; ++e)
+         out << std::setw(15) << headers[e];
+
+      out << std::setw(8) << "ipc" << std::setw(13) << "multiplexed" << "\n" << std::fixed << std::setprecision(1);
+
+      for (const PerfRecord& r : records) {
+         const double calls = r.calls > 0 ? (double)r.calls : 1.0;
+
+         out << std::left << std::setw(24) << r.name << std::right << std::setw(12) << r.calls << std::setw(14) << r.seconds * 1e9 / calls;
+
+         for (size_t e = 0; e < PerfEventCount; ++e) {
+            if (r.events & (1u << e))
+               out << std::setw(15) << (double)r.counts[e] / calls;
+            else
+               out << std::setw(15) << "-";
+         }
+
+         const unsigned both = (1u << Cycles) | (1u << Instructions);
+
+         if ((r.events & both) == both && r.counts[Cycles] > 0)
+            out << std::setw(8) << std::setprecision(2) << (double)r.counts[Instructions] / (double)r.counts[Cycles] << std::setprecision(1);
+         else
+            out << std::setw(8) << "-";
+
+         out << std::setw(13) << r.multiplexed << "\n";
+      }
+
+      out.flags(flags);
+      out.precision(precision);
+   }
+
+   inline PerfScope::PerfScope(const char* name)
+      : _name(name), _counters(PerfCounters::thread()), _start(_counters.sample()), _time(std::chrono::steady_clock::now())
+   {
+
+   }
+
+   inline PerfScope::~PerfScope() {
+      const PerfSample end = _counters.sample();
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _time).count();
+      bool multiplexed;
+      const PerfCounts counts = PerfCounters::difference(_start, end, multiplexed);
+
+      PerfRegistry::instance().add(_name, counts, _counters.events(), seconds, multiplexed);
+   }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "linearalgebra.hpp"
+
+namespace Math {
+
+   /*! Calculates a QR decomposition m = q * r using Householder reflections.
+    *
+    * @param m Subject matrix.
+    * @param q Orthogonal element matrix.
+    * @param r Upper triangulation element matrix.
+    */
+   template <size_t M, size_t N, class T, class C> void qr(const Matrix<M, N, T, C>& m, Matrix<M, M, T>& q, Matrix<M, N, T>& r);
+
+   /*! Calculates a thin QR decomposition m = q * r of a matrix with at least
+    * as many rows as columns, keeping only the first N columns of q.
+    *
+    * @param m Subject matrix.
+    * @param q Element matrix with orthonormal columns.
+    * @param r Square upper triangulation element matrix.
+    */
+   template <size_t M, size_t N, class T, class C> void thinqr(const Matrix<M, N, T, C>& m, Matrix<M, N, T>& q, Matrix<N, N, T>& r);
+
+   /*! Solves an overdetermined linear system in the least squares sense,
+    * minimizing the norm of a * x - b for every column, using a QR
+    * decomposition of the coefficient matrix. The coefficient matrix must
+    * have full column rank.
+    *
+    * @param a Coefficient matrix with at least as many rows as columns.
+    * @param b Right hand side columns.
+    * @return Solved columns.
+    */
+   template <size_t M, size_t N, size_t P, class T, class C, class D> Matrix<N, P, T> lstsq(const Matrix<M, N, T, C>& a, const Matrix<M, P, T, D>& b);
+}
+
+#include "qr.inl"
@@ -0,0 +1,348 @@
+namespace Math {
+
+   namespace Detail {
+
+      //! Columns of the panels of blocked QR decompositions.
+      const size_t QrBlock = 32;
+
+      /*! Computes a Householder reflection H = I - tau * v * ~v with
+       * v[0] = 1, so that H * x = (beta, 0, ..., 0).
+       *
+       * @param n Number of elements of x.
+       * @param x Subject vector; overwritten by beta and the elements of v
+       *          after the first one.
+       * @param tau Receives the scalar factor of the reflection, zero if x
+       *            already has the required form.
+       */
+      template <class T> inline
+      void householder(const size_t& n, T* x, T& tau) {
+         auto s = (T)0;
+
+         for (size_t i = 1; i < n; ++i)
+            s += x[i] * x[i];
+
+         if (s == (T)0) {
+            tau = (T)0;
+            return;
+         }
+
+         const T alpha = x[0];
+         const T norm = Math::Sqrt(alpha * alpha + s);
+         const T beta = alpha >= (T)0 ? -norm : norm;
+         const T r = (T)1 / (alpha - beta);
+
+         for (size_t i = 1; i < n; ++i)
+            x[i] *= r;
+
+         tau = (beta - alpha) / beta;
+         x[0] = beta;
+      }
+
+      /*! Applies a Householder reflection from the left.
+       *
+       * @param m Number of rows of C.
+       * @param n Number of columns of C.
+       * @param v Reflection vector; its first element is taken as one.
+       * @param tau Scalar factor of the reflection.
+       * @param c Matrix C.
+       * @param ldc Distance between columns of @p c.
+       */
+      template <class T> inline
+      void larf(const size_t& m, const size_t& n, const T* v, const T& tau, T* c, const size_t& ldc) {
+         if (tau == (T)0)
+            return;
+
+         for (size_t j = 0; j < n; ++j) {
+            T* const x = c + j * ldc;
+            auto w = x[0];
+
+            for (size_t i = 1; i < m; ++i)
+               w += v[i] * x[i];
+
+            w *= tau;
+            x[0] -= w;
+
+            for (size_t i = 1; i < m; ++i)
+               x[i] -= v[i] * w;
+         }
+      }
+
+      /*! Calculates a QR decomposition in place, one column at a time. R is
+       * stored on and above the diagonal, the reflection vectors below it.
+       *
+       * @param m Number of rows.
+       * @param n Number of columns.
+       * @param a Matrix to decompose.
+       * @param lda Distance between columns of @p a.
+       * @param tau Receives min(m, n) reflection factors.
+       */
+      template <class T> inline
+      void geqr2(const size_t& m, const size_t& n, T* a, const size_t& lda, T* tau) {
+         for (size_t j = 0; j < std::min(m, n); ++j) {
+            T* const x = a + j * lda + j;
+
+            householder(m - j, x, tau[j]);
+            larf(m - j, n - j - 1, x, tau[j], x + lda, lda);
+         }
+      }
+
+      /*! Forms the triangular factor T of a block of k reflections, so that
+       * H1 * H2 * ... * Hk = I - V * T * ~V (compact WY representation).
+       *
+       * @param m Number of rows of V.
+       * @param k Number of reflections.
+       * @param v Reflection vectors, stored below the diagonal.
+       * @param ldv Distance between columns of @p v.
+       * @param tau Reflection factors.
+       * @param t Receives the upper triangular k x k factor.
+       */
+      template <class T> inline
+      void larft(const size_t& m, const size_t& k, const T* v, const size_t& ldv, const T* tau, T* t) {
+         for (size_t i = 0; i < k; ++i) {
+            T* const ti = t + i * k;
+
+            // t(0:i, i) = -tau(i) * ~V(:, 0:i) * v(i).
+            for (size_t l = 0; l < i; ++l) {
+               const T* vl = v + l * ldv;
+               const T* vi = v + i * ldv;
+               auto s = vl[i];
+
+               for (size_t r = i + 1; r < m; ++r)
+                  s += vl[r] * vi[r];
+
+               ti[l] = -tau[i] * s;
+            }
+
+            // t(0:i, i) = T(0:i, 0:i) * t(0:i, i).
+            for (size_t l = 0; l < i; ++l) {
+               auto s = (T)0;
+
+               for (size_t r = l; r < i; ++r)
+                  s += t[r * k + l] * ti[r];
+
+               ti[l] = s;
+            }
+
+            ti[i] = tau[i];
+
+            for (size_t l = i + 1; l < k; ++l)
+               ti[l] = (T)0;
+         }
+      }
+
+      /*! Applies a block of reflections I - V * T * ~V, or its transpose,
+       * from the left using matrix products.
+       *
+       * @param m Number of rows of C and V.
+       * @param n Number of columns of C.
+       * @param k Number of reflections.
+       * @param v Reflection vectors, stored below the diagonal.
+       * @param ldv Distance between columns of @p v.
+       * @param t Triangular factor from @c larft.
+       * @param c Matrix C.
+       * @param ldc Distance between columns of @p c.
+       * @param transpose @c true to apply the transposed block.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void larfb(const size_t& m, const size_t& n, const size_t& k, const T* v, const size_t& ldv, const T* t, T* c, const size_t& ldc, const bool& transpose, const bool& parallel) {
+         std::vector<T, AlignedAllocator<T> > vf(m * k), vt(k * m), w(k * n);
+
+         // Explicit unit lower trapezoidal V and its transpose.
+         for (size_t l = 0; l < k; ++l) {
+            for (size_t i = 0; i < m; ++i) {
+               const T x = i < l ? (T)0 : i == l ? (T)1 : v[l * ldv + i];
+               vf[l * m + i] = x;
+               vt[i * k + l] = x;
+            }
+         }
+
+         // W = ~V * C.
+         gemm(k, n, m, (T)1, vt.data(), k, c, ldc, (T)0, w.data(), k, parallel);
+
+         // W = ~T * W or W = T * W.
+         for (size_t j = 0; j < n; ++j) {
+            T* const x = w.data() + j * k;
+
+            if (transpose) {
+               for (size_t i = k; i-- > 0; ) {
+                  auto s = (T)0;
+
+                  for (size_t l = 0; l <= i; ++l)
+                     s += t[i * k + l] * x[l];
+
+                  x[i] = s;
+               }
+            }
+            else {
+               for (size_t i = 0; i < k; ++i) {
+                  auto s = (T)0;
+
+                  for (size_t l = i; l < k; ++l)
+                     s += t[l * k + i] * x[l];
+
+                  x[i] = s;
+               }
+            }
+         }
+
+         // C = C - V * W.
+         gemm(m, n, k, (T)-1, vf.data(), m, w.data(), k, (T)1, c, ldc, parallel);
+      }
+
+      /*! Calculates a QR decomposition in place, see @c geqr2. Large
+       * matrices are decomposed in panels of @c QrBlock columns, and the
+       * reflections of each panel are applied to the trailing matrix as a
+       * block with matrix products.
+       *
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void geqrf(const size_t& m, const size_t& n, T* a, const size_t& lda, T* tau, const bool& parallel) {
+         const size_t k = std::min(m, n);
+
+         if (k <= 2 * QrBlock) {
+            geqr2(m, n, a, lda, tau);
+            return;
+         }
+
+         std::vector<T> t(QrBlock * QrBlock);
+
+         for (size_t j = 0; j < k; j += QrBlock) {
+            const size_t jb = std::min(QrBlock, k - j);
+            T* const p = a + j * lda + j;
+
+            geqr2(m - j, jb, p, lda, tau + j);
+
+            if (j + jb < n) {
+               larft(m - j, jb, p, lda, tau + j, t.data());
+               larfb(m - j, n - j - jb, jb, p, lda, t.data(), p + jb * lda, lda, true, parallel);
+            }
+         }
+      }
+
+      /*! Applies the transposed orthogonal matrix of a QR decomposition,
+       * ~Q = Hk * ... * H2 * H1, to C from the left.
+       *
+       * @param m Number of rows of C and of the decomposed matrix.
+       * @param n Number of columns of C.
+       * @param k Number of reflections.
+       * @param a Decomposition from @c geqrf.
+       * @param lda Distance between columns of @p a.
+       * @param tau Reflection factors.
+       * @param c Matrix C.
+       * @param ldc Distance between columns of @p c.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void ormqr(const size_t& m, const size_t& n, const size_t& k, const T* a, const size_t& lda, const T* tau, T* c, const size_t& ldc, const bool& parallel) {
+         if (k <= 2 * QrBlock) {
+            for (size_t j = 0; j < k; ++j)
+               larf(m - j, n, a + j * lda + j, tau[j], c + j, ldc);
+
+            return;
+         }
+
+         std::vector<T> t(QrBlock * QrBlock);
+
+         for (size_t j = 0; j < k; j += QrBlock) {
+            const size_t jb = std::min(QrBlock, k - j);
+            const T* p = a + j * lda + j;
+
+            larft(m - j, jb, p, lda, tau + j, t.data());
+            larfb(m - j, n, jb, p, lda, t.data(), c + j, ldc, true, parallel);
+         }
+      }
+
+      /*! Forms the first n columns of the orthogonal matrix of a QR
+       * decomposition, Q = H1 * H2 * ... * Hk.
+       *
+       * @param m Number of rows of Q.
+       * @param n Number of columns of Q, at least @p k.
+       * @param k Number of reflections.
+       * @param a Decomposition from @c geqrf.
+       * @param lda Distance between columns of @p a.
+       * @param tau Reflection factors.
+       * @param q Receives Q.
+       * @param ldq Distance between columns of @p q.
+       * @param parallel @c true to allow splitting the work across threads.
+       */
+      template <class T> inline
+      void orgqr(const size_t& m, const size_t& n, const size_t& k, const T* a, const size_t& lda, const T* tau, T* q, const size_t& ldq, const bool& parallel) {
+         for (size_t j = 0; j < n; ++j) {
+            for (size_t i = 0; i < m; ++i)
+               q[j * ldq + i] = i == j ? (T)1 : (T)0;
+         }
+
+         // Columns before a reflection are still unit vectors that it does
+         // not change.
+         if (k <= 2 * QrBlock) {
+            for (size_t j = k; j-- > 0; )
+               larf(m - j, n - j, a + j * lda + j, tau[j], q + j * ldq + j, ldq);
+
+            return;
+         }
+
+         std::vector<T> t(QrBlock * QrBlock);
+
+         for (size_t end = k; end > 0; ) {
+            const size_t j = end > QrBlock ? end - QrBlock : 0;
+            const T* p = a + j * lda + j;
+
+            larft(m - j, end - j, p, lda, tau + j, t.data());
+            larfb(m - j, n - j, end - j, p, lda, t.data(), q + j * ldq + j, ldq, false, parallel);
+
+            end = j;
+         }
+      }
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   void qr(const Matrix<M, N, T, C>& m, Matrix<M, M, T>& q, Matrix<M, N, T>& r) {
+      const size_t K = M < N ? M : N;
+      const bool parallel = MatrixChunk<M, N, T>::Location == Heap;
+      T tau[K];
+
+      r = m;
+      Detail::geqrf(M, N, r.data(), M, tau, parallel);
+      Detail::orgqr(M, M, K, r.data(), M, tau, q.data(), M, parallel);
+
+      for (size_t j = 1; j <= N; ++j) {
+         for (size_t i = j + 1; i <= M; ++i)
+            r(i, j) = (T)0;
+      }
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   void thinqr(const Matrix<M, N, T, C>& m, Matrix<M, N, T>& q, Matrix<N, N, T>& r) {
+      static_assert(M >= N, "Thin QR decomposition requires at least as many rows as columns");
+      const bool parallel = MatrixChunk<M, N, T>::Location == Heap;
+      Matrix<M, N, T> a(m);
+      T tau[N];
+
+      Detail::geqrf(M, N, a.data(), M, tau, parallel);
+      Detail::orgqr(M, N, N, a.data(), M, tau, q.data(), M, parallel);
+
+      for (size_t j = 1; j <= N; ++j) {
+         for (size_t i = 1; i <= N; ++i)
+            r(i, j) = i <= j ? a(i, j) : (T)0;
+      }
+   }
+
+   template <size_t M, size_t N, size_t P, class T, class C, class D> inline
+   Matrix<N, P, T> lstsq(const Matrix<M, N, T, C>& a, const Matrix<M, P, T, D>& b) {
+      static_assert(M >= N, "Least squares solution requires at least as many rows as columns");
+      const bool parallel = MatrixChunk<M, N, T>::Location == Heap;
+      Matrix<M, N, T> f(a);
+      Matrix<M, P, T> x(b);
+      T tau[N];
+
+      Detail::geqrf(M, N, f.data(), M, tau, parallel);
+
+      // R * x = ~Q * b, where only the first N rows of ~Q * b are used.
+      Detail::ormqr(M, P, N, f.data(), M, tau, x.data(), M, parallel);
+      Detail::trsm_upper(N, P, f.data(), M, x.data(), M, parallel);
+
+      return Matrix<N, P, T>(x.template sub<N, P>(1, 1));
+   }
+}
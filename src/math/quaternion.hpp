@@ -0,0 +1,270 @@
+#pragma once
+
+#include "vector.hpp"
+#include "batch.hpp"
+#include "functions.hpp"
+#include "unit.hpp"
+
+namespace Math {
+
+   /*! Quaternion representing a rotation in three dimensions. Elements are
+    * ordered x, y, z, w like in four dimensional vectors, w being the real
+    * part. Composing rotations and rotating vectors costs fewer operations
+    * than with rotation matrices, and rounding errors are removed by
+    * normalizing.
+    */
+   template <class T = double> class Quaternion {
+   public:
+
+      //! Type alias for element types.
+      typedef T type;
+
+      /*! Constructs an identity rotation.
+       */
+      Quaternion();
+
+      /*! Constructs a quaternion from elements.
+       *
+       * @param x Imaginary i element value.
+       * @param y Imaginary j element value.
+       * @param z Imaginary k element value.
+       * @param w Real element value.
+       */
+      Quaternion(const T& x, const T& y, const T& z, const T& w);
+
+      /*! Constructs a rotation about an axis.
+       *
+       * @param axis Rotation axis, need not be normalized.
+       * @param angle Rotation angle, counterclockwise when looking against
+       *              the axis.
+       */
+      Quaternion(const Vector<3, T>& axis, const Degree<T>& angle);
+
+      /*! Converts a vector with elements x, y, z and w to quaternion.
+       *
+       * @param v Vector to convert.
+       */
+      explicit Quaternion(const Vector<4, T>& v);
+
+      /*! Converts a rotation matrix to quaternion.
+       *
+       * @param m Orthonormal rotation matrix.
+       */
+      template <class C> explicit Quaternion(const Matrix<3, 3, T, C>& m);
+
+      /*! Converts the rotation part of a transformation matrix to
+       * quaternion.
+       *
+       * @param m Transformation matrix whose upper left 3x3 block is an
+       *          orthonormal rotation matrix.
+       */
+      template <class C> explicit Quaternion(const Matrix<4, 4, T, C>& m);
+
+      /*! Gets X element of quaternion.
+       *
+       * @return Reference to X element.
+       */
+      T& x();
+
+      /*! Gets Y element of quaternion.
+       *
+       * @return Reference to Y element.
+       */
+      T& y();
+
+      /*! Gets Z element of quaternion.
+       *
+       * @return Reference to Z element.
+       */
+      T& z();
+
+      /*! Gets W element of quaternion.
+       *
+       * @return Reference to W element.
+       */
+      T& w();
+
+      /*! Gets X element of quaternion.
+       *
+       * @return Const reference to X element.
+       */
+      const T& x() const;
+
+      /*! Gets Y element of quaternion.
+       *
+       * @return Const reference to Y element.
+       */
+      const T& y() const;
+
+      /*! Gets Z element of quaternion.
+       *
+       * @return Const reference to Z element.
+       */
+      const T& z() const;
+
+      /*! Gets W element of quaternion.
+       *
+       * @return Const reference to W element.
+       */
+      const T& w() const;
+
+      /*! Gets the rotation axis.
+       *
+       * @return Normalized rotation axis, or X axis for identity rotation.
+       */
+      Vector<3, T> axis() const;
+
+      /*! Gets the rotation angle.
+       *
+       * @return Rotation angle between 0 and 360 degrees.
+       */
+      Degree<T> angle() const;
+
+      /*! Converts to vector with elements x, y, z and w.
+       *
+       * @return Converted vector.
+       */
+      Vector<4, T> vector() const;
+
+      /*! Converts a unit quaternion to rotation matrix.
+       *
+       * @return Rotation matrix.
+       */
+      Matrix<3, 3, T> matrix3() const;
+
+      /*! Converts a unit quaternion to transformation matrix.
+       *
+       * @return Rotation matrix extended with zero translation.
+       */
+      Matrix<4, 4, T> matrix4() const;
+
+   private:
+      T _x;
+      T _y;
+      T _z;
+      T _w;
+   };
+
+   typedef Quaternion<double> quat;
+   typedef Quaternion<float> quatf;
+
+   /*! Calculates the conjugate, which is the inverse rotation of a unit
+    * quaternion.
+    *
+    * @param q Quaternion.
+    * @return Conjugate quaternion.
+    */
+   template <class T> Quaternion<T> conjugate(const Quaternion<T>& q);
+
+   /*! Calculates the inverse of a quaternion.
+    *
+    * @param q Quaternion, must not be zero.
+    * @return Inverse quaternion.
+    */
+   template <class T> Quaternion<T> inv(const Quaternion<T>& q);
+
+   /*! Calculates the magnitude of a quaternion.
+    *
+    * @param q Quaternion.
+    * @return Magnitude of the quaternion.
+    */
+   template <class T> T length(const Quaternion<T>& q);
+
+   /*! Normalizes a quaternion to unit length, e.g. to remove drift after
+    * repeated composition.
+    *
+    * @param q Quaternion.
+    * @return Unit quaternion.
+    */
+   template <class T> Quaternion<T> normalize(const Quaternion<T>& q);
+
+   /*! Calculates the dot product of two quaternions.
+    *
+    * @param a Quaternion.
+    * @param b Quaternion.
+    * @return Dot product.
+    */
+   template <class T> T dot(const Quaternion<T>& a, const Quaternion<T>& b);
+
+   /*! Interpolates unit quaternions linearly and normalizes the result. The
+    * shorter arc is followed.
+    *
+    * @param a Rotation at @p t = 0.
+    * @param b Rotation at @p t = 1.
+    * @param t Interpolation parameter.
+    * @return Interpolated rotation.
+    */
+   template <class T> Quaternion<T> nlerp(const Quaternion<T>& a, const Quaternion<T>& b, const T& t);
+
+   /*! Interpolates unit quaternions spherically, at constant angular
+    * velocity. The shorter arc is followed.
+    *
+    * @param a Rotation at @p t = 0.
+    * @param b Rotation at @p t = 1.
+    * @param t Interpolation parameter.
+    * @return Interpolated rotation.
+    */
+   template <class T> Quaternion<T> slerp(const Quaternion<T>& a, const Quaternion<T>& b, const T& t);
+
+   /*! Interpolates batches of unit quaternions, stored as x, y, z and w,
+    * linearly and normalizes the results.
+    *
+    * @param a Rotations at @p t = 0.
+    * @param b Rotations at @p t = 1.
+    * @param t Interpolation parameter.
+    * @return Batch of interpolated rotations.
+    */
+   template <class T> MatrixBatch<4, 1, T> nlerp(const ConstMatrixBatchView<4, 1, T>& a, const ConstMatrixBatchView<4, 1, T>& b, const T& t);
+
+   /*! Interpolates batches of unit quaternions, stored as x, y, z and w,
+    * spherically.
+    *
+    * @param a Rotations at @p t = 0.
+    * @param b Rotations at @p t = 1.
+    * @param t Interpolation parameter.
+    * @return Batch of interpolated rotations.
+    */
+   template <class T> MatrixBatch<4, 1, T> slerp(const ConstMatrixBatchView<4, 1, T>& a, const ConstMatrixBatchView<4, 1, T>& b, const T& t);
+}
+
+/*! Composes two rotations. The result rotates by @p rhs first and then by
+ * @p lhs, like the product of rotation matrices.
+ *
+ * @param lhs Left hand side quaternion.
+ * @param rhs Right hand side quaternion.
+ * @return Product quaternion.
+ */
+template <class T> Math::Quaternion<T> operator *(const Math::Quaternion<T>& lhs, const Math::Quaternion<T>& rhs);
+
+/*! Rotates a vector.
+ *
+ * @param lhs Unit quaternion.
+ * @param rhs Vector to rotate.
+ * @return Rotated vector.
+ */
+template <class T> Math::Vector<3, T> operator *(const Math::Quaternion<T>& lhs, const Math::Vector<3, T>& rhs);
+
+/*! Multiplies a quaternion by a scalar.
+ *
+ * @param lhs Quaternion.
+ * @param rhs Scalar.
+ * @return Scaled quaternion.
+ */
+template <class T> Math::Quaternion<T> operator *(const Math::Quaternion<T>& lhs, const T& rhs);
+
+/*! Adds two quaternions.
+ *
+ * @param lhs Left hand side quaternion.
+ * @param rhs Right hand side quaternion.
+ * @return Sum quaternion.
+ */
+template <class T> Math::Quaternion<T> operator +(const Math::Quaternion<T>& lhs, const Math::Quaternion<T>& rhs);
+
+/*! Negates a quaternion, which represents the same rotation.
+ *
+ * @param q Quaternion.
+ * @return Negated quaternion.
+ */
+template <class T> Math::Quaternion<T> operator -(const Math::Quaternion<T>& q);
+
+#include "quaternion.inl"
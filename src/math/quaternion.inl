@@ -0,0 +1,321 @@
+namespace Math {
+
+   template <class T> inline
+   Quaternion<T>::Quaternion() : _x(0), _y(0), _z(0), _w(1) {
+
+   }
+
+   template <class T> inline
+   Quaternion<T>::Quaternion(const T& x, const T& y, const T& z, const T& w) : _x(x), _y(y), _z(z), _w(w) {
+
+   }
+
+   template <class T> inline
+   Quaternion<T>::Quaternion(const Vector<3, T>& axis, const Degree<T>& angle) {
+      const Degree<T> half((T)angle / (T)2);
+      const T s = Sin(half) / length(axis);
+
+      _x = axis.x() * s;
+      _y = axis.y() * s;
+      _z = axis.z() * s;
+      _w = Cos(half);
+   }
+
+   template <class T> inline
+   Quaternion<T>::Quaternion(const Vector<4, T>& v) : _x(v.x()), _y(v.y()), _z(v.z()), _w(v.w()) {
+
+   }
+
+   template <class T>
+   template <class C> inline
+   Quaternion<T>::Quaternion(const Matrix<3, 3, T, C>& m) {
+      const T trace = m(1, 1) + m(2, 2) + m(3, 3);
+
+      // The largest of w, x, y and z is computed from the diagonal, and the
+      // others from off-diagonal sums and differences divided by it.
+      if (trace > (T)0) {
+         const T s = Sqrt(trace + (T)1) * (T)2;
+         _w = s / (T)4;
+         _x = (m(3, 2) - m(2, 3)) / s;
+         _y = (m(1, 3) - m(3, 1)) / s;
+         _z = (m(2, 1) - m(1, 2)) / s;
+      }
+      else if (m(1, 1) > m(2, 2) && m(1, 1) > m(3, 3)) {
+         const T s = Sqrt((T)1 + m(1, 1) - m(2, 2) - m(3, 3)) * (T)2;
+         _w = (m(3, 2) - m(2, 3)) / s;
+         _x = s / (T)4;
+         _y = (m(1, 2) + m(2, 1)) / s;
+         _z = (m(1, 3) + m(3, 1)) / s;
+      }
+      else if (m(2, 2) > m(3, 3)) {
+         const T s = Sqrt((T)1 + m(2, 2) - m(1, 1) - m(3, 3)) * (T)2;
+         _w = (m(1, 3) - m(3, 1)) / s;
+         _x = (m(1, 2) + m(2, 1)) / s;
+         _y = s / (T)4;
+         _z = (m(2, 3) + m(3, 2)) / s;
+      }
+      else {
+         const T s = Sqrt((T)1 + m(3, 3) - m(1, 1) - m(2, 2)) * (T)2;
+         _w = (m(2, 1) - m(1, 2)) / s;
+         _x = (m(1, 3) + m(3, 1)) / s;
+         _y = (m(2, 3) + m(3, 2)) / s;
+         _z = s / (T)4;
+      }
+   }
+
+   template <class T>
+   template <class C> inline
+   Quaternion<T>::Quaternion(const Matrix<4, 4, T, C>& m) : Quaternion(m.template get_sub<3, 3>(1, 1)) {
+
+   }
+
+   template <class T> inline
+   T& Quaternion<T>::x() {
+      return _x;
+   }
+
+   template <class T> inline
+   T& Quaternion<T>::y() {
+      return _y;
+   }
+
+   template <class T> inline
+   T& Quaternion<T>::z() {
+      return _z;
+   }
+
+   template <class T> inline
+   T& Quaternion<T>::w() {
+      return _w;
+   }
+
+   template <class T> inline
+   const T& Quaternion<T>::x() const {
+      return _x;
+   }
+
+   template <class T> inline
+   const T& Quaternion<T>::y() const {
+      return _y;
+   }
+
+   template <class T> inline
+   const T& Quaternion<T>::z() const {
+      return _z;
+   }
+
+   template <class T> inline
+   const T& Quaternion<T>::w() const {
+      return _w;
+   }
+
+   template <class T> inline
+   Vector<3, T> Quaternion<T>::axis() const {
+      const T s = Sqrt(_x * _x + _y * _y + _z * _z);
+
+      if (s == (T)0)
+         return Vector<3, T>(1, 0, 0);
+
+      return Vector<3, T>(_x / s, _y / s, _z / s);
+   }
+
+   template <class T> inline
+   Degree<T> Quaternion<T>::angle() const {
+      const T c = Clamp(_w / length(*this), (T)-1, (T)1);
+      return (T)ACos(c) * (T)2;
+   }
+
+   template <class T> inline
+   Vector<4, T> Quaternion<T>::vector() const {
+      return Vector<4, T>(_x, _y, _z, _w);
+   }
+
+   template <class T> inline
+   Matrix<3, 3, T> Quaternion<T>::matrix3() const {
+      const T xx = _x * _x, yy = _y * _y, zz = _z * _z;
+      const T xy = _x * _y, xz = _x * _z, yz = _y * _z;
+      const T wx = _w * _x, wy = _w * _y, wz = _w * _z;
+
+      Matrix<3, 3, T> out(false);
+
+      out(1, 1) = (T)1 - (T)2 * (yy + zz);
+      out(1, 2) = (T)2 * (xy - wz);
+      out(1, 3) = (T)2 * (xz + wy);
+      out(2, 1) = (T)2 * (xy + wz);
+      out(2, 2) = (T)1 - (T)2 * (xx + zz);
+      out(2, 3) = (T)2 * (yz - wx);
+      out(3, 1) = (T)2 * (xz - wy);
+      out(3, 2) = (T)2 * (yz + wx);
+      out(3, 3) = (T)1 - (T)2 * (xx + yy);
+
+      return out;
+   }
+
+   template <class T> inline
+   Matrix<4, 4, T> Quaternion<T>::matrix4() const {
+      Matrix<4, 4, T> out;
+
+      out.set_sub(1, 1, matrix3());
+      out(4, 4) = (T)1;
+
+      return out;
+   }
+
+   template <class T> inline
+   Quaternion<T> conjugate(const Quaternion<T>& q) {
+      return Quaternion<T>(-q.x(), -q.y(), -q.z(), q.w());
+   }
+
+   template <class T> inline
+   Quaternion<T> inv(const Quaternion<T>& q) {
+      return conjugate(q) * ((T)1 / dot(q, q));
+   }
+
+   template <class T> inline
+   T length(const Quaternion<T>& q) {
+      return Sqrt(dot(q, q));
+   }
+
+   template <class T> inline
+   Quaternion<T> normalize(const Quaternion<T>& q) {
+      return q * ((T)1 / length(q));
+   }
+
+   template <class T> inline
+   T dot(const Quaternion<T>& a, const Quaternion<T>& b) {
+      return a.x() * b.x() + a.y() * b.y() + a.z() * b.z() + a.w() * b.w();
+   }
+
+   template <class T> inline
+   Quaternion<T> nlerp(const Quaternion<T>& a, const Quaternion<T>& b, const T& t) {
+      const T s = dot(a, b) < (T)0 ? -t : t;
+      return normalize(a * ((T)1 - t) + b * s);
+   }
+
+   template <class T> inline
+   Quaternion<T> slerp(const Quaternion<T>& a, const Quaternion<T>& b, const T& t) {
+      const T d = dot(a, b);
+      const T c = Abs(d);
+
+      // Nearly equal rotations are interpolated linearly, since the angle
+      // between them cannot be computed accurately.
+      if (c > (T)0.9995)
+         return nlerp(a, b, t);
+
+      const T theta = std::acos(c);
+      const T s = (T)1 / std::sin(theta);
+      const T wb = std::sin(t * theta) * s;
+
+      return a * (std::sin(((T)1 - t) * theta) * s) + b * (d < (T)0 ? -wb : wb);
+   }
+
+   template <class T> inline
+   MatrixBatch<4, 1, T> nlerp(const ConstMatrixBatchView<4, 1, T>& a, const ConstMatrixBatchView<4, 1, T>& b, const T& t) {
+      assert(a.size() == b.size());
+
+      MatrixBatch<4, 1, T> out(a.size(), false);
+      const DynamicVector<T> d = dot(a, b);
+      const T* pd = d.data();
+      const T u = (T)1 - t;
+
+      // Each component is blended by a branch-free loop over the batch.
+      for (size_t i = 1; i <= 4; ++i) {
+         const T* pa = a.component(i);
+         const T* pb = b.component(i);
+         T* o = out.component(i);
+
+         for (size_t k = 0; k < a.size(); ++k)
+            o[k] = pa[k] * u + pb[k] * (pd[k] < (T)0 ? -t : t);
+      }
+
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+      kernels.batch_normalize(out.size(), 4, out.data(), out.stride(), out.data(), out.stride());
+
+      return std::move(out);
+   }
+
+   template <class T> inline
+   MatrixBatch<4, 1, T> slerp(const ConstMatrixBatchView<4, 1, T>& a, const ConstMatrixBatchView<4, 1, T>& b, const T& t) {
+      assert(a.size() == b.size());
+
+      MatrixBatch<4, 1, T> out(a.size(), false);
+      DynamicVector<T> wa = dot(a, b), wb(a.size(), false);
+      T* pa = wa.data();
+      T* pb = wb.data();
+
+      // Weights are computed in one pass over the batch, and then applied
+      // to each component.
+      for (size_t k = 0; k < a.size(); ++k) {
+         const T d = pa[k];
+         const T c = Abs(d);
+
+         if (c > (T)0.9995) {
+            pa[k] = (T)1 - t;
+            pb[k] = t;
+         }
+         else {
+            const T theta = std::acos(c);
+            const T s = (T)1 / std::sin(theta);
+
+            pa[k] = std::sin(((T)1 - t) * theta) * s;
+            pb[k] = std::sin(t * theta) * s;
+         }
+
+         if (d < (T)0)
+            pb[k] = -pb[k];
+      }
+
+      for (size_t i = 1; i <= 4; ++i) {
+         const T* qa = a.component(i);
+         const T* qb = b.component(i);
+         T* o = out.component(i);
+
+         for (size_t k = 0; k < a.size(); ++k)
+            o[k] = qa[k] * pa[k] + qb[k] * pb[k];
+      }
+
+      // Linearly interpolated rotations need normalizing; the others are
+      // already of unit length.
+      const SimdKernels<T>& kernels = simd_kernels<T>();
+      kernels.batch_normalize(out.size(), 4, out.data(), out.stride(), out.data(), out.stride());
+
+      return std::move(out);
+   }
+}
+
+template <class T> inline
+Math::Quaternion<T> operator *(const Math::Quaternion<T>& lhs, const Math::Quaternion<T>& rhs) {
+   return Math::Quaternion<T>(
+      lhs.w() * rhs.x() + lhs.x() * rhs.w() + lhs.y() * rhs.z() - lhs.z() * rhs.y(),
+      lhs.w() * rhs.y() - lhs.x() * rhs.z() + lhs.y() * rhs.w() + lhs.z() * rhs.x(),
+      lhs.w() * rhs.z() + lhs.x() * rhs.y() - lhs.y() * rhs.x() + lhs.z() * rhs.w(),
+      lhs.w() * rhs.w() - lhs.x() * rhs.x() - lhs.y() * rhs.y() - lhs.z() * rhs.z());
+}
+
+template <class T> inline
+Math::Vector<3, T> operator *(const Math::Quaternion<T>& lhs, const Math::Vector<3, T>& rhs) {
+   // v' = v + w t + q x t with t = 2 q x v, where q is the imaginary part.
+   const T tx = (T)2 * (lhs.y() * rhs.z() - lhs.z() * rhs.y());
+   const T ty = (T)2 * (lhs.z() * rhs.x() - lhs.x() * rhs.z());
+   const T tz = (T)2 * (lhs.x() * rhs.y() - lhs.y() * rhs.x());
+
+   return Math::Vector<3, T>(
+      rhs.x() + lhs.w() * tx + lhs.y() * tz - lhs.z() * ty,
+      rhs.y() + lhs.w() * ty + lhs.z() * tx - lhs.x() * tz,
+      rhs.z() + lhs.w() * tz + lhs.x() * ty - lhs.y() * tx);
+}
+
+template <class T> inline
+Math::Quaternion<T> operator *(const Math::Quaternion<T>& lhs, const T& rhs) {
+   return Math::Quaternion<T>(lhs.x() * rhs, lhs.y() * rhs, lhs.z() * rhs, lhs.w() * rhs);
+}
+
+template <class T> inline
+Math::Quaternion<T> operator +(const Math::Quaternion<T>& lhs, const Math::Quaternion<T>& rhs) {
+   return Math::Quaternion<T>(lhs.x() + rhs.x(), lhs.y() + rhs.y(), lhs.z() + rhs.z(), lhs.w() + rhs.w());
+}
+
+template <class T> inline
+Math::Quaternion<T> operator -(const Math::Quaternion<T>& q) {
+   return Math::Quaternion<T>(-q.x(), -q.y(), -q.z(), -q.w());
+}
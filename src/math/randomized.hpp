@@ -0,0 +1,151 @@
+#pragma once
+
+#include "dynamicmatrix.hpp"
+#include "dynamicvector.hpp"
+#include "gemm.hpp"
+#include "qr.hpp"
+#include "svd.hpp"
+#include <cstdint>
+#include <vector>
+#include <cassert>
+
+namespace Math {
+
+   /*! Parameters of randomized low-rank approximations. Each power
+    * iteration costs two more passes over the matrix and sharpens the
+    * approximation when the singular values decay slowly.
+    */
+   struct RandomizedOptions {
+
+      /*! Constructs options.
+       *
+       * @param oversampling Number of extra sample vectors.
+       * @param powerIterations Number of power iterations.
+       * @param seed Seed of the random test matrix.
+       */
+      RandomizedOptions(const size_t& oversampling = 10, const size_t& powerIterations = 2, const uint64_t& seed = 0);
+
+      //! Number of sample vectors beyond the requested rank.
+      size_t oversampling;
+
+      //! Number of power iterations, passes over the matrix are 2 * power_iterations + 2.
+      size_t power_iterations;
+
+      //! Seed of the random test matrix; equal seeds give equal results.
+      uint64_t seed;
+   };
+
+   /*! Randomized range finder fed with blocks of rows, so that matrices
+    * need not be held in memory at once. Every pass visits all rows of the
+    * matrix in any order:
+    *
+    *    RandomizedSketch<double> sketch(rows, cols, k);
+    *
+    *    while (sketch.next_pass()) {
+    *       for (each block of rows starting at row i)
+    *          sketch.add(i, block);
+    *    }
+    *
+    *    sketch.svd(u, s, v);
+    *
+    * The first pass samples the range with a Gaussian test matrix, the
+    * following passes alternate between the row and column space for the
+    * power iterations, and the last one projects the matrix onto the
+    * sampled range. Products run on the blocked matrix multiplication.
+    */
+   template <class T = double> class RandomizedSketch {
+   public:
+
+      /*! Constructs a sketch.
+       *
+       * @param rows Number of matrix rows.
+       * @param cols Number of matrix columns.
+       * @param rank Number of singular triplets or eigenpairs wanted.
+       * @param options Oversampling, power iterations and seed.
+       */
+      RandomizedSketch(const size_t& rows, const size_t& cols, const size_t& rank, const RandomizedOptions& options = RandomizedOptions());
+
+      /*! Tells the number of passes over the matrix.
+       *
+       * @return Number of passes.
+       */
+      size_t passes() const;
+
+      /*! Completes the current pass and starts the next one.
+       *
+       * @return @c true if a pass was started, @c false when all passes
+       *         are done.
+       */
+      bool next_pass();
+
+      /*! Adds a block of rows in the current pass.
+       *
+       * @param row Index of the first row of the block, 1-based.
+       * @param block Rows of the matrix with all columns.
+       */
+      void add(const size_t& row, const ConstDynamicMatrixView<T>& block);
+
+      /*! Gets an orthonormal basis of the sampled range, complete after
+       * the first pass.
+       *
+       * @return Matrix with orthonormal columns.
+       */
+      const DynamicMatrix<T>& range() const;
+
+      /*! Calculates the approximate truncated singular value decomposition
+       * after all passes.
+       *
+       * @param u Left singular vectors in orthonormal columns.
+       * @param s Singular values in descending order.
+       * @param v Right singular vectors in orthonormal columns.
+       */
+      void svd(DynamicMatrix<T>& u, DynamicVector<T>& s, DynamicMatrix<T>& v) const;
+
+      /*! Calculates the approximate eigenvalues of largest magnitude and
+       * their eigenvectors of a symmetric matrix after all passes.
+       *
+       * @param values Eigenvalues in descending order.
+       * @param vectors Orthonormal eigenvectors in the columns, in the
+       *                order of @p values.
+       */
+      void eigsym(DynamicVector<T>& values, DynamicMatrix<T>& vectors) const;
+
+   private:
+      size_t _rows;
+      size_t _cols;
+      size_t _rank;
+      size_t _pass;
+      RandomizedOptions _options;
+      DynamicMatrix<T> _range;
+      DynamicMatrix<T> _sample;
+      DynamicMatrix<T> _projection;
+      DynamicMatrix<T> _transposed;
+   };
+
+   /*! Calculates an approximate truncated singular value decomposition by
+    * randomized range finding.
+    *
+    * @param a Subject matrix.
+    * @param k Number of singular triplets, at most min(rows, cols).
+    * @param u Left singular vectors in orthonormal columns.
+    * @param s Singular values in descending order.
+    * @param v Right singular vectors in orthonormal columns.
+    * @param options Oversampling, power iterations and seed.
+    */
+   template <class T> void rsvd(const ConstDynamicMatrixView<typename DynamicMatrix<T>::type>& a, const size_t& k, DynamicMatrix<T>& u, DynamicVector<T>& s, DynamicMatrix<T>& v, const RandomizedOptions& options = RandomizedOptions());
+
+   /*! Calculates approximate eigenvalues of largest magnitude and their
+    * eigenvectors of a symmetric matrix, e.g. the principal components of
+    * a covariance matrix, by randomized range finding.
+    *
+    * @param a Symmetric subject matrix.
+    * @param k Number of eigenpairs, at most the matrix order.
+    * @param values Eigenvalues in descending order.
+    * @param vectors Orthonormal eigenvectors in the columns, in the order
+    *                of @p values.
+    * @param options Oversampling, power iterations and seed.
+    */
+   template <class T> void reigsym(const ConstDynamicMatrixView<typename DynamicMatrix<T>::type>& a, const size_t& k, DynamicVector<T>& values, DynamicMatrix<T>& vectors, const RandomizedOptions& options = RandomizedOptions());
+}
+
+#include "randomized.inl"
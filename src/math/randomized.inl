@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Math {
+
+   namespace Detail {
+
+      /*! Scrambles the bits of a number with the splitmix64 finalizer.
+       */
+      inline uint64_t mix_bits(uint64_t x) {
+         x += 0x9e3779b97f4a7c15ull;
+         x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+         x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+         return x ^ (x >> 31);
+      }
+
+      /*! Gets a standard normally distributed number by the Box-Muller
+       * transform. The number depends only on the seed and the index, so
+       * that test matrices are equal on all platforms and can be filled in
+       * any order.
+       *
+       * @param seed Random seed.
+       * @param index Number of the element.
+       * @return Random number.
+       */
+      template <class T> inline
+      T gaussian(const uint64_t& seed, const uint64_t& index) {
+         const double scale = 1.0 / 9007199254740992.0;
+         const uint64_t a = mix_bits(seed ^ mix_bits(2 * index));
+         const uint64_t b = mix_bits(seed ^ mix_bits(2 * index + 1));
+         const double u1 = (double)((a >> 11) + 1) * scale;
+         const double u2 = (double)(b >> 11) * scale;
+
+         return (T)(std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2));
+      }
+
+      /*! Replaces the columns of a matrix with an orthonormal basis of
+       * their span by a blocked Householder QR decomposition.
+       *
+       * @param m Number of rows, at least @p n.
+       * @param n Number of columns.
+       * @param a Matrix.
+       * @param lda Distance between columns of @p a.
+       */
+      template <class T> inline
+      void orthonormalize(const size_t& m, const size_t& n, T* a, const size_t& lda) {
+         std::vector<T> r(m * n);
+         std::vector<T> tau(n);
+
+         for (size_t j = 0; j < n; ++j)
+            std::copy(a + j * lda, a + j * lda + m, r.data() + j * m);
+
+         geqrf(m, n, r.data(), m, tau.data(), true);
+         orgqr(m, n, n, r.data(), m, tau.data(), a, lda, true);
+      }
+
+      /*! Transposes a column-major matrix into another one.
+       */
+      template <class T> inline
+      void transpose_into(const size_t& m, const size_t& n, const T* a, const size_t& lda, T* b, const size_t& ldb) {
+         for (size_t j = 0; j < n; ++j) {
+            for (size_t i = 0; i < m; ++i)
+               b[i * ldb + j] = a[j * lda + i];
+         }
+      }
+   }
+
+   inline
+   RandomizedOptions::RandomizedOptions(const size_t& oversampling, const size_t& powerIterations, const uint64_t& seed)
+      : oversampling(oversampling), power_iterations(powerIterations), seed(seed) {
+
+   }
+
+   template <class T> inline
+   RandomizedSketch<T>::RandomizedSketch(const size_t& rows, const size_t& cols, const size_t& rank, const RandomizedOptions& options)
+      : _rows(rows), _cols(cols), _rank(rank), _pass(0), _options(options)
+   {
+      assert(rank >= 1 && rank <= std::min(rows, cols));
+
+      const size_t width = std::min(rank + options.oversampling, std::min(rows, cols));
+
+      _range = DynamicMatrix<T>(rows, width, false);
+      _sample = DynamicMatrix<T>(cols, width, false);
+
+      T* omega = _sample.data();
+
+      for (size_t i = 0; i < cols * width; ++i)
+         omega[i] = Detail::gaussian<T>(options.seed, i);
+   }
+
+   template <class T> inline
+   size_t RandomizedSketch<T>::passes() const {
+      return 2 * _options.power_iterations + 2;
+   }
+
+   template <class T> inline
+   bool RandomizedSketch<T>::next_pass() {
+      if (_pass > passes())
+         return false;
+
+      const size_t width = _range.cols();
+
+      // Range passes fill the samples A * X, projection passes accumulate
+      // ~Q * A, whose transpose spans the row space for the next range
+      // pass.
+      if (_pass > 0 && (_pass - 1) % 2 == 0)
+         Detail::orthonormalize(_rows, width, _range.data(), _rows);
+      else if (_pass > 0 && _pass < passes()) {
+         Detail::transpose_into(width, _cols, _projection.data(), width, _sample.data(), _cols);
+         Detail::orthonormalize(_cols, width, _sample.data(), _cols);
+      }
+
+      if (_pass++ == passes())
+         return false;
+
+      if ((_pass - 1) % 2 == 1)
+         _projection = DynamicMatrix<T>(width, _cols);
+
+      return true;
+   }
+
+   template <class T> inline
+   void RandomizedSketch<T>::add(const size_t& row, const ConstDynamicMatrixView<T>& block) {
+      assert(_pass >= 1 && _pass <= passes());
+      assert(block.cols() == _cols && row >= 1 && row - 1 + block.rows() <= _rows);
+
+      const size_t width = _range.cols();
+      const size_t h = block.rows();
+      DynamicMatrix<T> tmp;
+      const T* p;
+      const size_t ld = Detail::gemm_operand(block, tmp, p);
+
+      if ((_pass - 1) % 2 == 0) {
+         gemm(h, width, _cols, (T)1, p, ld, _sample.data(), _cols, (T)0, _range.data() + row - 1, _rows);
+         return;
+      }
+
+      if (_transposed.rows() != width || _transposed.cols() < h)
+         _transposed = DynamicMatrix<T>(width, h, false);
+
+      Detail::transpose_into(h, width, _range.data() + row - 1, _rows, _transposed.data(), width);
+      gemm(width, _cols, h, (T)1, _transposed.data(), width, p, ld, (T)1, _projection.data(), width);
+   }
+
+   template <class T> inline
+   const DynamicMatrix<T>& RandomizedSketch<T>::range() const {
+      return _range;
+   }
+
+   template <class T> inline
+   void RandomizedSketch<T>::svd(DynamicMatrix<T>& u, DynamicVector<T>& s, DynamicMatrix<T>& v) const {
+      assert(_pass > passes());
+
+      // ~B = ~(~Q * A) = V * S * ~W gives A ~ (Q * W) * S * ~V.
+      const size_t width = _range.cols();
+      DynamicMatrix<T> bt(_cols, width, false), vb(_cols, width, false), wb(width, width, false);
+      DynamicVector<T> sb(width, false);
+      std::vector<T> work(4 * width + _cols);
+
+      Detail::transpose_into(width, _cols, _projection.data(), width, bt.data(), _cols);
+      Detail::gesvd(_cols, width, bt.data(), _cols, sb.data(), vb.data(), _cols, width, wb.data(), width, work.data());
+
+      u = DynamicMatrix<T>(_rows, _rank, false);
+      s = DynamicVector<T>(_rank, false);
+      v = DynamicMatrix<T>(_cols, _rank, false);
+
+      gemm(_rows, _rank, width, (T)1, _range.data(), _rows, wb.data(), width, (T)0, u.data(), _rows);
+      std::copy(sb.data(), sb.data() + _rank, s.data());
+      std::copy(vb.data(), vb.data() + _cols * _rank, v.data());
+   }
+
+   template <class T> inline
+   void RandomizedSketch<T>::eigsym(DynamicVector<T>& values, DynamicMatrix<T>& vectors) const {
+      assert(_pass > passes());
+      assert(_rows == _cols);
+
+      // The matrix projected onto the sampled range, ~Q * A * Q.
+      const size_t width = _range.cols();
+      DynamicMatrix<T> c(width, width, false), z(width, width, false), zk(width, _rank, false);
+      std::vector<T> d(width), work(3 * width);
+
+      gemm(width, width, _cols, (T)1, _projection.data(), width, _range.data(), _cols, (T)0, c.data(), width);
+
+      for (size_t j = 0; j < width; ++j) {
+         for (size_t i = 0; i < j; ++i) {
+            const T mean = (c.data()[j * width + i] + c.data()[i * width + j]) / (T)2;
+            c.data()[j * width + i] = c.data()[i * width + j] = mean;
+         }
+      }
+
+      Detail::syev(width, c.data(), d.data(), z.data(), work.data());
+
+      // The sampled range captures the eigenvalues of largest magnitude.
+      std::vector<size_t> order(width);
+      std::iota(order.begin(), order.end(), (size_t)0);
+      std::stable_sort(order.begin(), order.end(), [&d](const size_t& a, const size_t& b) { return Abs(d[a]) > Abs(d[b]); });
+      std::stable_sort(order.begin(), order.begin() + _rank, [&d](const size_t& a, const size_t& b) { return d[a] > d[b]; });
+
+      values = DynamicVector<T>(_rank, false);
+      vectors = DynamicMatrix<T>(_rows, _rank, false);
+
+      for (size_t j = 0; j < _rank; ++j) {
+         values.data()[j] = d[order[j]];
+         std::copy(z.data() + order[j] * width, z.data() + (order[j] + 1) * width, zk.data() + j * width);
+      }
+
+      gemm(_rows, _rank, width, (T)1, _range.data(), _rows, zk.data(), width, (T)0, vectors.data(), _rows);
+   }
+
+   template <class T> inline
+   void rsvd(const ConstDynamicMatrixView<typename DynamicMatrix<T>::type>& a, const size_t& k, DynamicMatrix<T>& u, DynamicVector<T>& s, DynamicMatrix<T>& v, const RandomizedOptions& options) {
+      RandomizedSketch<T> sketch(a.rows(), a.cols(), k, options);
+
+      while (sketch.next_pass())
+         sketch.add(1, a);
+
+      sketch.svd(u, s, v);
+   }
+
+   template <class T> inline
+   void reigsym(const ConstDynamicMatrixView<typename DynamicMatrix<T>::type>& a, const size_t& k, DynamicVector<T>& values, DynamicMatrix<T>& vectors, const RandomizedOptions& options) {
+      RandomizedSketch<T> sketch(a.rows(), a.cols(), k, options);
+
+      while (sketch.next_pass())
+         sketch.add(1, a);
+
+      sketch.eigsym(values, vectors);
+   }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MATH_SIMD_X86
+#endif
+
+#if defined(MATH_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MATH_TARGET_SSE2 __attribute__((target("sse2")))
+#define MATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MATH_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#else
+#define MATH_TARGET_SSE2
+#define MATH_TARGET_AVX2
+#define MATH_TARGET_AVX512
+#endif
+
+namespace Math {
+
+   /*! Instruction sets with dedicated kernels.
+    */
+   enum SimdIsa {
+      Scalar,
+      Sse2,
+      Avx2,
+      Avx512
+   };
+
+   /*! Detects the widest instruction set supported by the processor and the
+    * operating system. Detection is done once, on first use.
+    *
+    * @return Detected instruction set.
+    */
+   SimdIsa simd_isa();
+
+   /*! Describes SIMD support of an element type.
+    */
+   template <class T> struct SimdTraits {
+
+      //! Tells whether the element type has SIMD kernels.
+      static const bool Enabled = std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+      //! Operations on fewer elements than this use inlined scalar loops.
+      static const size_t Threshold = 64;
+   };
+
+   //! Largest number of elements of matrices processed by the batch kernels,
+   //! enough for 6x6 matrices.
+   const size_t BatchMaxElements = 36;
+
+   /*! Table of kernels for one instruction set and element type. All arrays
+    * are contiguous; loads and stores are unaligned.
+    */
+   template <class T> struct SimdKernels {
+
+      //! Instruction set of the kernels.
+      SimdIsa isa;
+
+      //! Computes out = a + b.
+      void (*add)(const size_t& n, const T* a, const T* b, T* out);
+
+      //! Computes out = a - b.
+      void (*subtract)(const size_t& n, const T* a, const T* b, T* out);
+
+      //! Computes out = -a.
+      void (*negate)(const size_t& n, const T* a, T* out);
+
+      //! Computes out = a * s.
+      void (*scale)(const size_t& n, const T* a, const T& s, T* out);
+
+      //! Computes the dot product of a and b.
+      T (*dot)(const size_t& n, const T* a, const T* b);
+
+      //! Register tile rows of the matrix multiplication micro-kernel.
+      size_t mr;
+
+      //! Register tile columns of the matrix multiplication micro-kernel.
+      size_t nr;
+
+      //! Matrix multiplication micro-kernel, see @c Detail::GemmKernel.
+      void (*gemm)(const size_t& kc, const T* a, const T* b, T* c, const size_t& ldc, const T& alpha, const T& beta, const size_t& m, const size_t& n);
+
+      // Batch kernels work across batches of small matrices stored as
+      // arrays of components: element (i, j) of an m-row matrix k is at
+      // offset (j * m + i) * stride + k. Outputs may overlap inputs exactly.
+
+      //! Computes out_k = a_k * b_k for mxl matrices a_k and lxn matrices b_k.
+      void (*batch_multiply)(const size_t& count, const size_t& m, const size_t& l, const size_t& n, const T* a, const size_t& as, const T* b, const size_t& bs, T* out, const size_t& os);
+
+      //! Computes out_k = a * b_k + t for a column-major mxl matrix a, an
+      //! optional m-vector t added to each column and lxn matrices b_k.
+      void (*batch_transform)(const size_t& count, const size_t& m, const size_t& l, const size_t& n, const T* a, const T* t, const T* b, const size_t& bs, T* out, const size_t& os);
+
+      //! Computes out[k] = a_k . b_k for n-vectors.
+      void (*batch_dot)(const size_t& count, const size_t& n, const T* a, const size_t& as, const T* b, const size_t& bs, T* out);
+
+      //! Computes out_k = a_k x b_k for 3-vectors.
+      void (*batch_cross)(const size_t& count, const T* a, const size_t& as, const T* b, const size_t& bs, T* out, const size_t& os);
+
+      //! Computes out[k] = |a_k| for n-vectors.
+      void (*batch_length)(const size_t& count, const size_t& n, const T* a, const size_t& as, T* out);
+
+      //! Computes out_k = a_k / |a_k| for n-vectors.
+      void (*batch_normalize)(const size_t& count, const size_t& n, const T* a, const size_t& as, T* out, const size_t& os);
+
+      //! Solves a_k x_k = b_k with partial pivoting for nxn matrices a_k and
+      //! nxp matrices b_k, or the identity if b is null. Determinants are
+      //! stored to det unless it is null.
+      void (*batch_solve)(const size_t& count, const size_t& n, const size_t& p, const T* a, const size_t& as, const T* b, const size_t& bs, T* x, const size_t& xs, T* det);
+   };
+
+   /*! Gets kernels for given instruction set. Instruction sets the processor
+    * does not support must not be requested.
+    *
+    * @param isa Instruction set.
+    * @return Kernel table.
+    */
+   template <class T> SimdKernels<T> simd_kernels(const SimdIsa& isa);
+
+   /*! Gets kernels for the widest instruction set of the processor. The
+    * table is selected once, on first use.
+    *
+    * @return Kernel table.
+    */
+   template <class T> const SimdKernels<T>& simd_kernels();
+}
+
+#include "simd.inl"
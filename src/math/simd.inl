@@ -0,0 +1,539 @@
+#include <cmath>
+#include <utility>
+
+#if defined(MATH_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
+namespace Math {
+
+   namespace Detail {
+
+      template <class T> inline
+      void scalar_add(const size_t& n, const T* a, const T* b, T* out) {
+         for (size_t i = 0; i < n; ++i)
+            out[i] = a[i] + b[i];
+      }
+
+      template <class T> inline
+      void scalar_subtract(const size_t& n, const T* a, const T* b, T* out) {
+         for (size_t i = 0; i < n; ++i)
+            out[i] = a[i] - b[i];
+      }
+
+      template <class T> inline
+      void scalar_negate(const size_t& n, const T* a, T* out) {
+         for (size_t i = 0; i < n; ++i)
+            out[i] = -a[i];
+      }
+
+      template <class T> inline
+      void scalar_scale(const size_t& n, const T* a, const T& s, T* out) {
+         for (size_t i = 0; i < n; ++i)
+            out[i] = a[i] * s;
+      }
+
+      template <class T> inline
+      T scalar_dot(const size_t& n, const T* a, const T* b) {
+         T out = (T)0;
+
+         for (size_t i = 0; i < n; ++i)
+            out += a[i] * b[i];
+
+         return out;
+      }
+
+      template <class T> inline
+      void scalar_batch_multiply(const size_t& count, const size_t& m, const size_t& l, const size_t& n, const T* a, const size_t& as, const T* b, const size_t& bs, T* out, const size_t& os) {
+         for (size_t k = 0; k < count; ++k) {
+            T r[BatchMaxElements];
+
+            for (size_t j = 0; j < n; ++j) {
+               for (size_t i = 0; i < m; ++i) {
+                  T acc = (T)0;
+
+                  for (size_t p = 0; p < l; ++p)
+                     acc += a[(p * m + i) * as + k] * b[(j * l + p) * bs + k];
+
+                  r[j * m + i] = acc;
+               }
+            }
+
+            for (size_t c = 0; c < m * n; ++c)
+               out[c * os + k] = r[c];
+         }
+      }
+
+      template <class T> inline
+      void scalar_batch_transform(const size_t& count, const size_t& m, const size_t& l, const size_t& n, const T* a, const T* t, const T* b, const size_t& bs, T* out, const size_t& os) {
+         for (size_t k = 0; k < count; ++k) {
+            T r[BatchMaxElements];
+
+            for (size_t j = 0; j < n; ++j) {
+               for (size_t i = 0; i < m; ++i) {
+                  T acc = t ? t[i] : (T)0;
+
+                  for (size_t p = 0; p < l; ++p)
+                     acc += a[p * m + i] * b[(j * l + p) * bs + k];
+
+                  r[j * m + i] = acc;
+               }
+            }
+
+            for (size_t c = 0; c < m * n; ++c)
+               out[c * os + k] = r[c];
+         }
+      }
+
+      template <class T> inline
+      void scalar_batch_dot(const size_t& count, const size_t& n, const T* a, const size_t& as, const T* b, const size_t& bs, T* out) {
+         for (size_t k = 0; k < count; ++k) {
+            T acc = (T)0;
+
+            for (size_t i = 0; i < n; ++i)
+               acc += a[i * as + k] * b[i * bs + k];
+
+            out[k] = acc;
+         }
+      }
+
+      template <class T> inline
+      void scalar_batch_cross(const size_t& count, const T* a, const size_t& as, const T* b, const size_t& bs, T* out, const size_t& os) {
+         for (size_t k = 0; k < count; ++k) {
+            const T ax = a[k], ay = a[as + k], az = a[2 * as + k];
+            const T bx = b[k], by = b[bs + k], bz = b[2 * bs + k];
+
+            out[k] = ay * bz - az * by;
+            out[os + k] = az * bx - ax * bz;
+            out[2 * os + k] = ax * by - ay * bx;
+         }
+      }
+
+      template <class T> inline
+      void scalar_batch_length(const size_t& count, const size_t& n, const T* a, const size_t& as, T* out) {
+         scalar_batch_dot(count, n, a, as, a, as, out);
+
+         for (size_t k = 0; k < count; ++k)
+            out[k] = (T)std::sqrt(out[k]);
+      }
+
+      template <class T> inline
+      void scalar_batch_normalize(const size_t& count, const size_t& n, const T* a, const size_t& as, T* out, const size_t& os) {
+         for (size_t k = 0; k < count; ++k) {
+            T acc = (T)0;
+
+            for (size_t i = 0; i < n; ++i)
+               acc += a[i * as + k] * a[i * as + k];
+
+            const T r = (T)1 / (T)std::sqrt(acc);
+
+            for (size_t i = 0; i < n; ++i)
+               out[i * os + k] = a[i * as + k] * r;
+         }
+      }
+
+      template <class T> inline
+      void scalar_batch_solve(const size_t& count, const size_t& n, const size_t& p, const T* a, const size_t& as, const T* b, const size_t& bs, T* x, const size_t& xs, T* det) {
+         for (size_t k = 0; k < count; ++k) {
+            T m[BatchMaxElements], r[BatchMaxElements];
+            T d = (T)1;
+
+            for (size_t c = 0; c < n * n; ++c)
+               m[c] = a[c * as + k];
+
+            for (size_t j = 0; j < p; ++j) {
+               for (size_t i = 0; i < n; ++i)
+                  r[j * n + i] = b ? b[(j * n + i) * bs + k] : (T)(i == j ? 1 : 0);
+            }
+
+            for (size_t j = 0; j < n; ++j) {
+               size_t row = j;
+
+               for (size_t i = j + 1; i < n; ++i) {
+                  if (std::abs(m[j * n + i]) > std::abs(m[j * n + row]))
+                     row = i;
+               }
+
+               if (row != j) {
+                  for (size_t c = j; c < n; ++c)
+                     std::swap(m[c * n + j], m[c * n + row]);
+
+                  for (size_t c = 0; c < p; ++c)
+                     std::swap(r[c * n + j], r[c * n + row]);
+
+                  d = -d;
+               }
+
+               d *= m[j * n + j];
+               const T pivot = (T)1 / m[j * n + j];
+               m[j * n + j] = pivot;
+
+               for (size_t i = j + 1; i < n; ++i) {
+                  const T l = m[j * n + i] * pivot;
+
+                  for (size_t c = j + 1; c < n; ++c)
+                     m[c * n + i] -= l * m[c * n + j];
+
+                  for (size_t c = 0; c < p; ++c)
+                     r[c * n + i] -= l * r[c * n + j];
+               }
+            }
+
+            for (size_t c = 0; c < p; ++c) {
+               for (size_t i = n; i-- > 0;) {
+                  T v = r[c * n + i];
+
+                  for (size_t q = i + 1; q < n; ++q)
+                     v -= m[q * n + i] * r[c * n + q];
+
+                  x[(c * n + i) * xs + k] = r[c * n + i] = v * m[i * n + i];
+               }
+            }
+
+            if (det)
+               det[k] = d;
+         }
+      }
+
+      template <class T, size_t MR, size_t NR>
+      void gemm_micro(const size_t& kc, const T* a, const T* b, T* c, const size_t& ldc, const T& alpha, const T& beta, const size_t& m, const size_t& n);
+
+      template <class T> inline
+      SimdKernels<T> scalar_kernels() {
+         SimdKernels<T> k = {
+            Scalar,
+            &scalar_add<T>, &scalar_subtract<T>, &scalar_negate<T>, &scalar_scale<T>, &scalar_dot<T>,
+            4, 4, &gemm_micro<T, 4, 4>,
+            &scalar_batch_multiply<T>, &scalar_batch_transform<T>, &scalar_batch_dot<T>,
+            &scalar_batch_cross<T>, &scalar_batch_length<T>, &scalar_batch_normalize<T>,
+            &scalar_batch_solve<T>
+         };
+
+         return k;
+      }
+
+#if defined(MATH_SIMD_X86)
+
+      namespace Sse2Kernels {
+
+         template <class T> struct Packet;
+
+         template <> struct Packet<double> {
+            typedef __m128d type;
+            static const size_t Size = 2;
+
+            MATH_TARGET_SSE2 static type zero() { return _mm_setzero_pd(); }
+            MATH_TARGET_SSE2 static type set1(const double& v) { return _mm_set1_pd(v); }
+            MATH_TARGET_SSE2 static type load(const double* p) { return _mm_loadu_pd(p); }
+            MATH_TARGET_SSE2 static void store(double* p, const type& v) { _mm_storeu_pd(p, v); }
+            MATH_TARGET_SSE2 static type add(const type& a, const type& b) { return _mm_add_pd(a, b); }
+            MATH_TARGET_SSE2 static type sub(const type& a, const type& b) { return _mm_sub_pd(a, b); }
+            MATH_TARGET_SSE2 static type mul(const type& a, const type& b) { return _mm_mul_pd(a, b); }
+            MATH_TARGET_SSE2 static type fmadd(const type& a, const type& b, const type& c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+            MATH_TARGET_SSE2 static type neg(const type& a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+            MATH_TARGET_SSE2 static type div(const type& a, const type& b) { return _mm_div_pd(a, b); }
+            MATH_TARGET_SSE2 static type sqrt(const type& a) { return _mm_sqrt_pd(a); }
+            MATH_TARGET_SSE2 static type abs(const type& a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+            MATH_TARGET_SSE2 static type select_greater(const type& x, const type& y, const type& a, const type& b) { return select(_mm_cmpgt_pd(x, y), a, b); }
+            MATH_TARGET_SSE2 static type select_equal(const type& x, const type& y, const type& a, const type& b) { return select(_mm_cmpeq_pd(x, y), a, b); }
+            MATH_TARGET_SSE2 static type select(const type& m, const type& a, const type& b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+            MATH_TARGET_SSE2 static double sum(const type& a) { return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a))); }
+         };
+
+         template <> struct Packet<float> {
+            typedef __m128 type;
+            static const size_t Size = 4;
+
+            MATH_TARGET_SSE2 static type zero() { return _mm_setzero_ps(); }
+            MATH_TARGET_SSE2 static type set1(const float& v) { return _mm_set1_ps(v); }
+            MATH_TARGET_SSE2 static type load(const float* p) { return _mm_loadu_ps(p); }
+            MATH_TARGET_SSE2 static void store(float* p, const type& v) { _mm_storeu_ps(p, v); }
+            MATH_TARGET_SSE2 static type add(const type& a, const type& b) { return _mm_add_ps(a, b); }
+            MATH_TARGET_SSE2 static type sub(const type& a, const type& b) { return _mm_sub_ps(a, b); }
+            MATH_TARGET_SSE2 static type mul(const type& a, const type& b) { return _mm_mul_ps(a, b); }
+            MATH_TARGET_SSE2 static type fmadd(const type& a, const type& b, const type& c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+            MATH_TARGET_SSE2 static type neg(const type& a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+            MATH_TARGET_SSE2 static type div(const type& a, const type& b) { return _mm_div_ps(a, b); }
+            MATH_TARGET_SSE2 static type sqrt(const type& a) { return _mm_sqrt_ps(a); }
+            MATH_TARGET_SSE2 static type abs(const type& a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+            MATH_TARGET_SSE2 static type select_greater(const type& x, const type& y, const type& a, const type& b) { return select(_mm_cmpgt_ps(x, y), a, b); }
+            MATH_TARGET_SSE2 static type select_equal(const type& x, const type& y, const type& a, const type& b) { return select(_mm_cmpeq_ps(x, y), a, b); }
+            MATH_TARGET_SSE2 static type select(const type& m, const type& a, const type& b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+            MATH_TARGET_SSE2 static float sum(const type& a) {
+               const type t = _mm_add_ps(a, _mm_movehl_ps(a, a));
+               return _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+            }
+         };
+
+         //! Register tile columns of the micro-kernel.
+         static const size_t GemmNR = 4;
+
+#define MATH_SIMD_TARGET MATH_TARGET_SSE2
+#define MATH_SIMD_ISA Sse2
+#include "simdkernels.inl"
+#undef MATH_SIMD_ISA
+#undef MATH_SIMD_TARGET
+      }
+
+      namespace Avx2Kernels {
+
+         template <class T> struct Packet;
+
+         template <> struct Packet<double> {
+            typedef __m256d type;
+            static const size_t Size = 4;
+
+            MATH_TARGET_AVX2 static type zero() { return _mm256_setzero_pd(); }
+            MATH_TARGET_AVX2 static type set1(const double& v) { return _mm256_set1_pd(v); }
+            MATH_TARGET_AVX2 static type load(const double* p) { return _mm256_loadu_pd(p); }
+            MATH_TARGET_AVX2 static void store(double* p, const type& v) { _mm256_storeu_pd(p, v); }
+            MATH_TARGET_AVX2 static type add(const type& a, const type& b) { return _mm256_add_pd(a, b); }
+            MATH_TARGET_AVX2 static type sub(const type& a, const type& b) { return _mm256_sub_pd(a, b); }
+            MATH_TARGET_AVX2 static type mul(const type& a, const type& b) { return _mm256_mul_pd(a, b); }
+            MATH_TARGET_AVX2 static type fmadd(const type& a, const type& b, const type& c) { return _mm256_fmadd_pd(a, b, c); }
+            MATH_TARGET_AVX2 static type neg(const type& a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+            MATH_TARGET_AVX2 static type div(const type& a, const type& b) { return _mm256_div_pd(a, b); }
+            MATH_TARGET_AVX2 static type sqrt(const type& a) { return _mm256_sqrt_pd(a); }
+            MATH_TARGET_AVX2 static type abs(const type& a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+            MATH_TARGET_AVX2 static type select_greater(const type& x, const type& y, const type& a, const type& b) { return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, y, _CMP_GT_OQ)); }
+            MATH_TARGET_AVX2 static type select_equal(const type& x, const type& y, const type& a, const type& b) { return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, y, _CMP_EQ_OQ)); }
+
+            MATH_TARGET_AVX2 static double sum(const type& a) {
+               const __m128d t = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+               return _mm_cvtsd_f64(_mm_add_sd(t, _mm_unpackhi_pd(t, t)));
+            }
+         };
+
+         template <> struct Packet<float> {
+            typedef __m256 type;
+            static const size_t Size = 8;
+
+            MATH_TARGET_AVX2 static type zero() { return _mm256_setzero_ps(); }
+            MATH_TARGET_AVX2 static type set1(const float& v) { return _mm256_set1_ps(v); }
+            MATH_TARGET_AVX2 static type load(const float* p) { return _mm256_loadu_ps(p); }
+            MATH_TARGET_AVX2 static void store(float* p, const type& v) { _mm256_storeu_ps(p, v); }
+            MATH_TARGET_AVX2 static type add(const type& a, const type& b) { return _mm256_add_ps(a, b); }
+            MATH_TARGET_AVX2 static type sub(const type& a, const type& b) { return _mm256_sub_ps(a, b); }
+            MATH_TARGET_AVX2 static type mul(const type& a, const type& b) { return _mm256_mul_ps(a, b); }
+            MATH_TARGET_AVX2 static type fmadd(const type& a, const type& b, const type& c) { return _mm256_fmadd_ps(a, b, c); }
+            MATH_TARGET_AVX2 static type neg(const type& a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+            MATH_TARGET_AVX2 static type div(const type& a, const type& b) { return _mm256_div_ps(a, b); }
+            MATH_TARGET_AVX2 static type sqrt(const type& a) { return _mm256_sqrt_ps(a); }
+            MATH_TARGET_AVX2 static type abs(const type& a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+            MATH_TARGET_AVX2 static type select_greater(const type& x, const type& y, const type& a, const type& b) { return _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, y, _CMP_GT_OQ)); }
+            MATH_TARGET_AVX2 static type select_equal(const type& x, const type& y, const type& a, const type& b) { return _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, y, _CMP_EQ_OQ)); }
+
+            MATH_TARGET_AVX2 static float sum(const type& a) {
+               const __m128 h = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+               const __m128 t = _mm_add_ps(h, _mm_movehl_ps(h, h));
+               return _mm_cvtss_f32(_mm_add_ss(t, _mm_shuffle_ps(t, t, 1)));
+            }
+         };
+
+         //! Register tile columns of the micro-kernel.
+         static const size_t GemmNR = 6;
+
+#define MATH_SIMD_TARGET MATH_TARGET_AVX2
+#define MATH_SIMD_ISA Avx2
+#include "simdkernels.inl"
+#undef MATH_SIMD_ISA
+#undef MATH_SIMD_TARGET
+      }
+
+      namespace Avx512Kernels {
+
+         template <class T> struct Packet;
+
+         template <> struct Packet<double> {
+            typedef __m512d type;
+            static const size_t Size = 8;
+
+            MATH_TARGET_AVX512 static type zero() { return _mm512_setzero_pd(); }
+            MATH_TARGET_AVX512 static type set1(const double& v) { return _mm512_set1_pd(v); }
+            MATH_TARGET_AVX512 static type load(const double* p) { return _mm512_loadu_pd(p); }
+            MATH_TARGET_AVX512 static void store(double* p, const type& v) { _mm512_storeu_pd(p, v); }
+            MATH_TARGET_AVX512 static type add(const type& a, const type& b) { return _mm512_add_pd(a, b); }
+            MATH_TARGET_AVX512 static type sub(const type& a, const type& b) { return _mm512_sub_pd(a, b); }
+            MATH_TARGET_AVX512 static type mul(const type& a, const type& b) { return _mm512_mul_pd(a, b); }
+            MATH_TARGET_AVX512 static type fmadd(const type& a, const type& b, const type& c) { return _mm512_fmadd_pd(a, b, c); }
+            MATH_TARGET_AVX512 static type div(const type& a, const type& b) { return _mm512_div_pd(a, b); }
+            MATH_TARGET_AVX512 static type sqrt(const type& a) { return _mm512_mask_sqrt_pd(a, (__mmask8)0xFF, a); }
+            MATH_TARGET_AVX512 static type abs(const type& a) { return _mm512_abs_pd(a); }
+            MATH_TARGET_AVX512 static type select_greater(const type& x, const type& y, const type& a, const type& b) { return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, y, _CMP_GT_OQ), b, a); }
+            MATH_TARGET_AVX512 static type select_equal(const type& x, const type& y, const type& a, const type& b) { return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, y, _CMP_EQ_OQ), b, a); }
+
+            MATH_TARGET_AVX512 static double sum(const type& a) {
+               double t[Size];
+               _mm512_storeu_pd(t, a);
+               return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+            }
+
+            MATH_TARGET_AVX512 static type neg(const type& a) {
+               return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_set1_epi64((long long)0x8000000000000000ULL)));
+            }
+         };
+
+         template <> struct Packet<float> {
+            typedef __m512 type;
+            static const size_t Size = 16;
+
+            MATH_TARGET_AVX512 static type zero() { return _mm512_setzero_ps(); }
+            MATH_TARGET_AVX512 static type set1(const float& v) { return _mm512_set1_ps(v); }
+            MATH_TARGET_AVX512 static type load(const float* p) { return _mm512_loadu_ps(p); }
+            MATH_TARGET_AVX512 static void store(float* p, const type& v) { _mm512_storeu_ps(p, v); }
+            MATH_TARGET_AVX512 static type add(const type& a, const type& b) { return _mm512_add_ps(a, b); }
+            MATH_TARGET_AVX512 static type sub(const type& a, const type& b) { return _mm512_sub_ps(a, b); }
+            MATH_TARGET_AVX512 static type mul(const type& a, const type& b) { return _mm512_mul_ps(a, b); }
+            MATH_TARGET_AVX512 static type fmadd(const type& a, const type& b, const type& c) { return _mm512_fmadd_ps(a, b, c); }
+            MATH_TARGET_AVX512 static type div(const type& a, const type& b) { return _mm512_div_ps(a, b); }
+            MATH_TARGET_AVX512 static type sqrt(const type& a) { return _mm512_mask_sqrt_ps(a, (__mmask16)0xFFFF, a); }
+            MATH_TARGET_AVX512 static type abs(const type& a) { return _mm512_abs_ps(a); }
+            MATH_TARGET_AVX512 static type select_greater(const type& x, const type& y, const type& a, const type& b) { return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, y, _CMP_GT_OQ), b, a); }
+            MATH_TARGET_AVX512 static type select_equal(const type& x, const type& y, const type& a, const type& b) { return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, y, _CMP_EQ_OQ), b, a); }
+
+            MATH_TARGET_AVX512 static float sum(const type& a) {
+               float t[Size];
+               _mm512_storeu_ps(t, a);
+
+               for (size_t i = 8; i > 0; i /= 2) {
+                  for (size_t j = 0; j < i; ++j)
+                     t[j] += t[j + i];
+               }
+
+               return t[0];
+            }
+
+            MATH_TARGET_AVX512 static type neg(const type& a) {
+               return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_set1_epi32((int)0x80000000U)));
+            }
+         };
+
+         //! Register tile columns of the micro-kernel.
+         static const size_t GemmNR = 6;
+
+#define MATH_SIMD_TARGET MATH_TARGET_AVX512
+#define MATH_SIMD_ISA Avx512
+#include "simdkernels.inl"
+#undef MATH_SIMD_ISA
+#undef MATH_SIMD_TARGET
+      }
+
+      inline void cpuid(const unsigned int& leaf, const unsigned int& subleaf, unsigned int (&regs)[4]) {
+#if defined(_MSC_VER)
+         int r[4];
+         __cpuidex(r, (int)leaf, (int)subleaf);
+
+         for (size_t i = 0; i < 4; ++i)
+            regs[i] = (unsigned int)r[i];
+#else
+         __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+      }
+
+      inline unsigned long long xgetbv() {
+#if defined(_MSC_VER)
+         return _xgetbv(0);
+#else
+         unsigned int lo, hi;
+         __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+         return ((unsigned long long)hi << 32) | lo;
+#endif
+      }
+
+#endif
+
+      inline SimdIsa detect_simd_isa() {
+#if defined(MATH_SIMD_X86)
+         unsigned int regs[4];
+
+         cpuid(0, 0, regs);
+         const unsigned int leaves = regs[0];
+
+         cpuid(1, 0, regs);
+
+         if (!(regs[3] & (1u << 26)))
+            return Scalar;
+
+         const bool osxsave = (regs[2] & (1u << 27)) != 0;
+         const bool avx = (regs[2] & (1u << 28)) != 0;
+         const bool fma = (regs[2] & (1u << 12)) != 0;
+
+         if (!osxsave || !avx || !fma || leaves < 7)
+            return Sse2;
+
+         // The operating system must save the extended register state on
+         // context switches: XMM and YMM for AVX, opmask and ZMM for AVX-512.
+         const unsigned long long xcr0 = xgetbv();
+
+         if ((xcr0 & 0x6) != 0x6)
+            return Sse2;
+
+         cpuid(7, 0, regs);
+
+         if (!(regs[1] & (1u << 5)))
+            return Sse2;
+
+         if ((regs[1] & (1u << 16)) && (xcr0 & 0xe6) == 0xe6)
+            return Avx512;
+
+         return Avx2;
+#else
+         return Scalar;
+#endif
+      }
+
+      template <class T> inline
+      SimdKernels<T> simd_kernels(const SimdIsa& isa, std::true_type) {
+         switch (isa) {
+#if defined(MATH_SIMD_X86)
+         case Avx512:
+            return Avx512Kernels::kernels<T>();
+         case Avx2:
+            return Avx2Kernels::kernels<T>();
+         case Sse2:
+            return Sse2Kernels::kernels<T>();
+#endif
+         default:
+            return scalar_kernels<T>();
+         }
+      }
+
+      template <class T> inline
+      SimdKernels<T> simd_kernels(const SimdIsa&, std::false_type) {
+         return scalar_kernels<T>();
+      }
+
+      /*! Computes a dot product of contiguous arrays. Short arrays are
+       * computed inline, others with the kernel of the processor.
+       */
+      template <class T> inline
+      T dot(const size_t& n, const T* a, const T* b) {
+         if (SimdTraits<T>::Enabled && n >= SimdTraits<T>::Threshold)
+            return Math::simd_kernels<T>().dot(n, a, b);
+
+         return scalar_dot(n, a, b);
+      }
+   }
+
+   inline SimdIsa simd_isa() {
+      static const SimdIsa isa = Detail::detect_simd_isa();
+      return isa;
+   }
+
+   template <class T> inline
+   SimdKernels<T> simd_kernels(const SimdIsa& isa) {
+      return Detail::simd_kernels<T>(isa, std::integral_constant<bool, SimdTraits<T>::Enabled>());
+   }
+
+   template <class T> inline
+   const SimdKernels<T>& simd_kernels() {
+      static const SimdKernels<T> kernels = simd_kernels<T>(simd_isa());
+      return kernels;
+   }
+}
@@ -0,0 +1,387 @@
+// Kernel bodies shared by all instruction sets. This file is included once
+// per instruction set, inside its namespace, with MATH_SIMD_TARGET defined
+// to the matching function attribute and Packet<T> and GemmNR declared.
+
+template <class T> MATH_SIMD_TARGET inline
+void add(const size_t& n, const T* a, const T* b, T* out) {
+   typedef Packet<T> P;
+   size_t i = 0;
+
+   for (; i + P::Size <= n; i += P::Size)
+      P::store(out + i, P::add(P::load(a + i), P::load(b + i)));
+
+   for (; i < n; ++i)
+      out[i] = a[i] + b[i];
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void subtract(const size_t& n, const T* a, const T* b, T* out) {
+   typedef Packet<T> P;
+   size_t i = 0;
+
+   for (; i + P::Size <= n; i += P::Size)
+      P::store(out + i, P::sub(P::load(a + i), P::load(b + i)));
+
+   for (; i < n; ++i)
+      out[i] = a[i] - b[i];
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void negate(const size_t& n, const T* a, T* out) {
+   typedef Packet<T> P;
+   size_t i = 0;
+
+   for (; i + P::Size <= n; i += P::Size)
+      P::store(out + i, P::neg(P::load(a + i)));
+
+   for (; i < n; ++i)
+      out[i] = -a[i];
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void scale(const size_t& n, const T* a, const T& s, T* out) {
+   typedef Packet<T> P;
+   const typename P::type vs = P::set1(s);
+   size_t i = 0;
+
+   for (; i + P::Size <= n; i += P::Size)
+      P::store(out + i, P::mul(P::load(a + i), vs));
+
+   for (; i < n; ++i)
+      out[i] = a[i] * s;
+}
+
+template <class T> MATH_SIMD_TARGET inline
+T dot(const size_t& n, const T* a, const T* b) {
+   typedef Packet<T> P;
+   typename P::type acc0 = P::zero(), acc1 = P::zero();
+   size_t i = 0;
+
+   // Two independent accumulators hide the latency of the multiply-add.
+   for (; i + 2 * P::Size <= n; i += 2 * P::Size) {
+      acc0 = P::fmadd(P::load(a + i), P::load(b + i), acc0);
+      acc1 = P::fmadd(P::load(a + i + P::Size), P::load(b + i + P::Size), acc1);
+   }
+
+   for (; i + P::Size <= n; i += P::Size)
+      acc0 = P::fmadd(P::load(a + i), P::load(b + i), acc0);
+
+   T out = P::sum(P::add(acc0, acc1));
+
+   for (; i < n; ++i)
+      out += a[i] * b[i];
+
+   return out;
+}
+
+// Computes a (2 * Packet<T>::Size) x NR tile of the product from packed
+// panels, see Detail::GemmKernel.
+template <class T, size_t NR> MATH_SIMD_TARGET inline
+void gemm(const size_t& kc, const T* a, const T* b, T* c, const size_t& ldc, const T& alpha, const T& beta, const size_t& m, const size_t& n) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   const size_t MR = 2 * P::Size;
+
+   V c0[NR], c1[NR];
+
+   for (size_t j = 0; j < NR; ++j)
+      c0[j] = c1[j] = P::zero();
+
+   for (size_t p = 0; p < kc; ++p) {
+      const V a0 = P::load(a);
+      const V a1 = P::load(a + P::Size);
+
+      for (size_t j = 0; j < NR; ++j) {
+         const V bj = P::set1(b[j]);
+         c0[j] = P::fmadd(a0, bj, c0[j]);
+         c1[j] = P::fmadd(a1, bj, c1[j]);
+      }
+
+      a += MR;
+      b += NR;
+   }
+
+   const V va = P::set1(alpha);
+
+   if (m == MR && n == NR) {
+      if (beta == (T)0) {
+         for (size_t j = 0; j < NR; ++j) {
+            T* cj = c + j * ldc;
+            P::store(cj, P::mul(va, c0[j]));
+            P::store(cj + P::Size, P::mul(va, c1[j]));
+         }
+      }
+      else {
+         const V vb = P::set1(beta);
+
+         for (size_t j = 0; j < NR; ++j) {
+            T* cj = c + j * ldc;
+            P::store(cj, P::fmadd(va, c0[j], P::mul(vb, P::load(cj))));
+            P::store(cj + P::Size, P::fmadd(va, c1[j], P::mul(vb, P::load(cj + P::Size))));
+         }
+      }
+   }
+   else {
+      // Partial tiles at matrix edges go through a temporary.
+      T tile[2 * P::Size * NR];
+
+      for (size_t j = 0; j < NR; ++j) {
+         P::store(tile + j * MR, P::mul(va, c0[j]));
+         P::store(tile + j * MR + P::Size, P::mul(va, c1[j]));
+      }
+
+      for (size_t j = 0; j < n; ++j) {
+         T* cj = c + j * ldc;
+
+         if (beta == (T)0) {
+            for (size_t i = 0; i < m; ++i)
+               cj[i] = tile[j * MR + i];
+         }
+         else {
+            for (size_t i = 0; i < m; ++i)
+               cj[i] = tile[j * MR + i] + beta * cj[i];
+         }
+      }
+   }
+}
+
+// Batch kernels process Packet<T>::Size matrices at once, one component of
+// all of them per register, and leave the remainder to the scalar kernels.
+
+template <class T> MATH_SIMD_TARGET inline
+void batch_multiply(const size_t& count, const size_t& m, const size_t& l, const size_t& n, const T* a, const size_t& as, const T* b, const size_t& bs, T* out, const size_t& os) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   size_t k = 0;
+
+   for (; k + P::Size <= count; k += P::Size) {
+      V r[BatchMaxElements];
+
+      for (size_t j = 0; j < n; ++j) {
+         for (size_t i = 0; i < m; ++i) {
+            V acc = P::zero();
+
+            for (size_t p = 0; p < l; ++p)
+               acc = P::fmadd(P::load(a + (p * m + i) * as + k), P::load(b + (j * l + p) * bs + k), acc);
+
+            r[j * m + i] = acc;
+         }
+      }
+
+      for (size_t c = 0; c < m * n; ++c)
+         P::store(out + c * os + k, r[c]);
+   }
+
+   scalar_batch_multiply(count - k, m, l, n, a + k, as, b + k, bs, out + k, os);
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void batch_transform(const size_t& count, const size_t& m, const size_t& l, const size_t& n, const T* a, const T* t, const T* b, const size_t& bs, T* out, const size_t& os) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   V vt[BatchMaxElements];
+   size_t k = 0;
+
+   // Matrix elements are broadcast from memory where they are used, which
+   // costs no more than a load and holds for matrices of any size.
+   for (size_t i = 0; i < m; ++i)
+      vt[i] = t ? P::set1(t[i]) : P::zero();
+
+   for (; k + P::Size <= count; k += P::Size) {
+      V r[BatchMaxElements];
+
+      for (size_t j = 0; j < n; ++j) {
+         for (size_t i = 0; i < m; ++i) {
+            V acc = vt[i];
+
+            for (size_t p = 0; p < l; ++p)
+               acc = P::fmadd(P::set1(a[p * m + i]), P::load(b + (j * l + p) * bs + k), acc);
+
+            r[j * m + i] = acc;
+         }
+      }
+
+      for (size_t c = 0; c < m * n; ++c)
+         P::store(out + c * os + k, r[c]);
+   }
+
+   scalar_batch_transform(count - k, m, l, n, a, t, b + k, bs, out + k, os);
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void batch_dot(const size_t& count, const size_t& n, const T* a, const size_t& as, const T* b, const size_t& bs, T* out) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   size_t k = 0;
+
+   for (; k + P::Size <= count; k += P::Size) {
+      V acc = P::zero();
+
+      for (size_t i = 0; i < n; ++i)
+         acc = P::fmadd(P::load(a + i * as + k), P::load(b + i * bs + k), acc);
+
+      P::store(out + k, acc);
+   }
+
+   scalar_batch_dot(count - k, n, a + k, as, b + k, bs, out + k);
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void batch_cross(const size_t& count, const T* a, const size_t& as, const T* b, const size_t& bs, T* out, const size_t& os) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   size_t k = 0;
+
+   for (; k + P::Size <= count; k += P::Size) {
+      const V ax = P::load(a + k), ay = P::load(a + as + k), az = P::load(a + 2 * as + k);
+      const V bx = P::load(b + k), by = P::load(b + bs + k), bz = P::load(b + 2 * bs + k);
+
+      P::store(out + k, P::sub(P::mul(ay, bz), P::mul(az, by)));
+      P::store(out + os + k, P::sub(P::mul(az, bx), P::mul(ax, bz)));
+      P::store(out + 2 * os + k, P::sub(P::mul(ax, by), P::mul(ay, bx)));
+   }
+
+   scalar_batch_cross(count - k, a + k, as, b + k, bs, out + k, os);
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void batch_length(const size_t& count, const size_t& n, const T* a, const size_t& as, T* out) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   size_t k = 0;
+
+   for (; k + P::Size <= count; k += P::Size) {
+      V acc = P::zero();
+
+      for (size_t i = 0; i < n; ++i) {
+         const V ai = P::load(a + i * as + k);
+         acc = P::fmadd(ai, ai, acc);
+      }
+
+      P::store(out + k, P::sqrt(acc));
+   }
+
+   scalar_batch_length(count - k, n, a + k, as, out + k);
+}
+
+template <class T> MATH_SIMD_TARGET inline
+void batch_normalize(const size_t& count, const size_t& n, const T* a, const size_t& as, T* out, const size_t& os) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   const V one = P::set1((T)1);
+   size_t k = 0;
+
+   for (; k + P::Size <= count; k += P::Size) {
+      V acc = P::zero();
+
+      for (size_t i = 0; i < n; ++i) {
+         const V ai = P::load(a + i * as + k);
+         acc = P::fmadd(ai, ai, acc);
+      }
+
+      const V r = P::div(one, P::sqrt(acc));
+
+      for (size_t i = 0; i < n; ++i)
+         P::store(out + i * os + k, P::mul(P::load(a + i * as + k), r));
+   }
+
+   scalar_batch_normalize(count - k, n, a + k, as, out + k, os);
+}
+
+// Solves Packet<T>::Size systems at once. Each lane picks its own pivot row,
+// and rows are exchanged with selects instead of branches, so that all lanes
+// run the same instructions.
+template <class T> MATH_SIMD_TARGET inline
+void batch_solve(const size_t& count, const size_t& n, const size_t& p, const T* a, const size_t& as, const T* b, const size_t& bs, T* x, const size_t& xs, T* det) {
+   typedef Packet<T> P;
+   typedef typename P::type V;
+   const V one = P::set1((T)1);
+   size_t k = 0;
+
+   for (; k + P::Size <= count; k += P::Size) {
+      V m[BatchMaxElements], r[BatchMaxElements];
+      V d = one;
+
+      for (size_t c = 0; c < n * n; ++c)
+         m[c] = P::load(a + c * as + k);
+
+      for (size_t j = 0; j < p; ++j) {
+         for (size_t i = 0; i < n; ++i)
+            r[j * n + i] = b ? P::load(b + (j * n + i) * bs + k) : (i == j ? one : P::zero());
+      }
+
+      for (size_t j = 0; j < n; ++j) {
+         V best = P::abs(m[j * n + j]);
+         V row = P::set1((T)j);
+
+         for (size_t i = j + 1; i < n; ++i) {
+            const V v = P::abs(m[j * n + i]);
+            row = P::select_greater(v, best, P::set1((T)i), row);
+            best = P::select_greater(v, best, v, best);
+         }
+
+         for (size_t i = j + 1; i < n; ++i) {
+            const V s = P::set1((T)i);
+
+            for (size_t c = j; c < n; ++c) {
+               const V t = m[c * n + j];
+               m[c * n + j] = P::select_equal(row, s, m[c * n + i], t);
+               m[c * n + i] = P::select_equal(row, s, t, m[c * n + i]);
+            }
+
+            for (size_t c = 0; c < p; ++c) {
+               const V t = r[c * n + j];
+               r[c * n + j] = P::select_equal(row, s, r[c * n + i], t);
+               r[c * n + i] = P::select_equal(row, s, t, r[c * n + i]);
+            }
+
+            d = P::select_equal(row, s, P::neg(d), d);
+         }
+
+         d = P::mul(d, m[j * n + j]);
+         const V pivot = P::div(one, m[j * n + j]);
+         m[j * n + j] = pivot;
+
+         for (size_t i = j + 1; i < n; ++i) {
+            const V l = P::mul(m[j * n + i], pivot);
+
+            for (size_t c = j + 1; c < n; ++c)
+               m[c * n + i] = P::sub(m[c * n + i], P::mul(l, m[c * n + j]));
+
+            for (size_t c = 0; c < p; ++c)
+               r[c * n + i] = P::sub(r[c * n + i], P::mul(l, r[c * n + j]));
+         }
+      }
+
+      for (size_t c = 0; c < p; ++c) {
+         for (size_t i = n; i-- > 0;) {
+            V v = r[c * n + i];
+
+            for (size_t q = i + 1; q < n; ++q)
+               v = P::sub(v, P::mul(m[q * n + i], r[c * n + q]));
+
+            r[c * n + i] = P::mul(v, m[i * n + i]);
+            P::store(x + (c * n + i) * xs + k, r[c * n + i]);
+         }
+      }
+
+      if (det)
+         P::store(det + k, d);
+   }
+
+   scalar_batch_solve(count - k, n, p, a + k, as, b ? b + k : b, bs, x ? x + k : x, xs, det ? det + k : det);
+}
+
+template <class T> inline
+SimdKernels<T> kernels() {
+   SimdKernels<T> k = {
+      MATH_SIMD_ISA,
+      &add<T>, &subtract<T>, &negate<T>, &scale<T>, &dot<T>,
+      2 * Packet<T>::Size, GemmNR, &gemm<T, GemmNR>,
+      &batch_multiply<T>, &batch_transform<T>, &batch_dot<T>,
+      &batch_cross<T>, &batch_length<T>, &batch_normalize<T>,
+      &batch_solve<T>
+   };
+
+   return k;
+}
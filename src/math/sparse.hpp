@@ -0,0 +1,287 @@
+#pragma once
+
+#include "matrix.hpp"
+#include "dynamicmatrix.hpp"
+#include "dynamicvector.hpp"
+#include "allocator.hpp"
+#include "functions.hpp"
+#include "threadpool.hpp"
+#include <algorithm>
+#include <vector>
+#include <cassert>
+
+namespace Math {
+
+   //! Storage order of compressed sparse matrices.
+   enum SparseFormat {
+      //! Compressed sparse rows.
+      Csr,
+      //! Compressed sparse columns.
+      Csc
+   };
+
+   /*! Collects the nonzero elements of a sparse matrix as (row, column,
+    * value) triplets in any order, to be compressed into a SparseMatrix.
+    */
+   template <class T = double> class SparseBuilder {
+   public:
+
+      //! Type alias for element types.
+      typedef T type;
+
+      /*! Constructs a builder of an all-zero matrix.
+       *
+       * @param rows Number of rows.
+       * @param cols Number of columns.
+       */
+      SparseBuilder(const size_t& rows, const size_t& cols);
+
+      /*! Tells the number of rows.
+       *
+       * @return Number of rows.
+       */
+      size_t rows() const;
+
+      /*! Tells the number of columns.
+       *
+       * @return Number of columns.
+       */
+      size_t cols() const;
+
+      /*! Tells the number of triplets added so far.
+       *
+       * @return Number of triplets.
+       */
+      size_t size() const;
+
+      /*! Reserves space for triplets.
+       *
+       * @param size Expected number of triplets.
+       */
+      void reserve(const size_t& size);
+
+      /*! Adds an element. Elements added to the same location are summed.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @param value Element value.
+       */
+      void add(const size_t& i, const size_t& j, const T& value);
+
+      /*! Gets row numbers of the triplets, 0-based.
+       *
+       * @return Row numbers in insertion order.
+       */
+      const std::vector<size_t>& row_indices() const;
+
+      /*! Gets column numbers of the triplets, 0-based.
+       *
+       * @return Column numbers in insertion order.
+       */
+      const std::vector<size_t>& col_indices() const;
+
+      /*! Gets values of the triplets.
+       *
+       * @return Values in insertion order.
+       */
+      const std::vector<T>& values() const;
+
+   private:
+      size_t _rows;
+      size_t _cols;
+      std::vector<size_t> _i;
+      std::vector<size_t> _j;
+      std::vector<T> _values;
+   };
+
+   /*! Sparse matrix in compressed form. With the Csr format the nonzero
+    * elements of each row are stored contiguously, ordered by column; with
+    * Csc the same holds for columns. Pointer k (0-based) tells where the
+    * elements of row or column k + 1 begin, and the last pointer equals
+    * the number of nonzeros. Products with dense matrices run in parallel,
+    * split into chunks holding equal numbers of nonzeros.
+    */
+   template <class T = double, SparseFormat F = Csr> class SparseMatrix {
+   public:
+
+      //! Type alias for element types.
+      typedef T type;
+
+      //! Storage format constant.
+      static const SparseFormat Format = F;
+
+      //! Type alias for the container holding nonzero elements.
+      typedef std::vector<T, AlignedAllocator<T> > container;
+
+      /*! Constructs an empty matrix.
+       */
+      SparseMatrix();
+
+      /*! Constructs an all-zero matrix.
+       *
+       * @param rows Number of rows.
+       * @param cols Number of columns.
+       */
+      SparseMatrix(const size_t& rows, const size_t& cols);
+
+      /*! Compresses triplets, summing duplicates.
+       *
+       * @param builder Triplets to compress.
+       */
+      explicit SparseMatrix(const SparseBuilder<T>& builder);
+
+      /*! Converts a sparse matrix of another format.
+       *
+       * @param other Matrix to convert.
+       */
+      template <SparseFormat G> explicit SparseMatrix(const SparseMatrix<T, G>& other);
+
+      /*! Converts a dense matrix, dropping small elements.
+       *
+       * @param m Matrix or view to convert.
+       * @param tolerance Elements whose magnitude is at most this are
+       *                  dropped.
+       */
+      explicit SparseMatrix(const ConstDynamicMatrixView<T>& m, const T& tolerance = T());
+
+      /*! Converts a dense matrix, dropping small elements.
+       *
+       * @param m Matrix to convert.
+       * @param tolerance Elements whose magnitude is at most this are
+       *                  dropped.
+       */
+      template <size_t M, size_t N, class C> explicit SparseMatrix(const Matrix<M, N, T, C>& m, const T& tolerance = T());
+
+      /*! Tells the number of rows.
+       *
+       * @return Number of rows.
+       */
+      size_t rows() const;
+
+      /*! Tells the number of columns.
+       *
+       * @return Number of columns.
+       */
+      size_t cols() const;
+
+      /*! Tells the number of stored elements.
+       *
+       * @return Number of nonzeros.
+       */
+      size_t nonzeros() const;
+
+      /*! Looks up an element by binary search.
+       *
+       * @param i Row number, 1-based.
+       * @param j Column number, 1-based.
+       * @return Element value, zero when not stored.
+       */
+      T operator ()(const size_t& i, const size_t& j) const;
+
+      /*! Gets the start offsets of rows (Csr) or columns (Csc).
+       *
+       * @return Pointer to rows + 1 or cols + 1 offsets.
+       */
+      const size_t* pointers() const;
+
+      /*! Gets the column (Csr) or row (Csc) numbers of stored elements,
+       * 0-based.
+       *
+       * @return Pointer to nonzeros indices.
+       */
+      const size_t* indices() const;
+
+      /*! Gets the stored elements.
+       *
+       * @return Data pointer to nonzeros values.
+       */
+      T* values();
+
+      /*! Gets the stored elements.
+       *
+       * @return Const data pointer to nonzeros values.
+       */
+      const T* values() const;
+
+      /*! Converts to dense matrix.
+       *
+       * @return Dense matrix.
+       */
+      DynamicMatrix<T> dense() const;
+
+   private:
+      template <class U, SparseFormat G> friend class SparseMatrix;
+      template <class U, SparseFormat G> friend SparseMatrix<U, G == Csr ? Csc : Csr> transpose(const SparseMatrix<U, G>& m);
+
+      size_t _rows;
+      size_t _cols;
+      std::vector<size_t> _pointers;
+      std::vector<size_t> _indices;
+      container _values;
+   };
+
+   typedef SparseMatrix<double, Csr> csrXd;
+   typedef SparseMatrix<float, Csr> csrXf;
+   typedef SparseMatrix<double, Csc> cscXd;
+   typedef SparseMatrix<float, Csc> cscXf;
+
+   /*! Transposes a sparse matrix by reinterpreting its storage in the other
+    * format, without sorting.
+    *
+    * @param m Matrix to transpose.
+    * @return Transposed matrix.
+    */
+   template <class T, SparseFormat F> SparseMatrix<T, F == Csr ? Csc : Csr> transpose(const SparseMatrix<T, F>& m);
+
+   /*! Multiplies a dense matrix or vector by a sparse matrix, y = a x.
+    *
+    * @param a Sparse matrix.
+    * @param x Dense matrix with a.cols() rows.
+    * @param y Output with a.rows() rows and as many columns as @p x. Must
+    *          not overlap @p x.
+    */
+   template <class T, SparseFormat F> void multiply(const SparseMatrix<T, F>& a, const ConstDynamicMatrixView<typename SparseMatrix<T, F>::type>& x, DynamicMatrixView<typename SparseMatrix<T, F>::type> y);
+
+   /*! Multiplies a dense matrix or vector by the transpose of a sparse
+    * matrix, y = a' x, without forming the transpose.
+    *
+    * @param a Sparse matrix.
+    * @param x Dense matrix with a.rows() rows.
+    * @param y Output with a.cols() rows and as many columns as @p x. Must
+    *          not overlap @p x.
+    */
+   template <class T, SparseFormat F> void multiply_transposed(const SparseMatrix<T, F>& a, const ConstDynamicMatrixView<typename SparseMatrix<T, F>::type>& x, DynamicMatrixView<typename SparseMatrix<T, F>::type> y);
+}
+
+/*! Multiplies a vector by a sparse matrix.
+ *
+ * @param lhs Sparse matrix.
+ * @param rhs Vector with lhs.cols() elements.
+ * @return Product vector.
+ */
+template <class T, Math::SparseFormat F> Math::DynamicVector<T> operator *(const Math::SparseMatrix<T, F>& lhs, const Math::DynamicVector<T>& rhs);
+
+/*! Multiplies a dense matrix by a sparse matrix.
+ *
+ * @param lhs Sparse matrix.
+ * @param rhs Matrix with lhs.cols() rows.
+ * @return Product matrix.
+ */
+template <class T, Math::SparseFormat F> Math::DynamicMatrix<T> operator *(const Math::SparseMatrix<T, F>& lhs, const Math::DynamicMatrix<T>& rhs);
+
+/*! Multiplies a fixed size matrix or vector by a sparse matrix.
+ *
+ * @param lhs Sparse matrix.
+ * @param rhs Matrix with lhs.cols() rows.
+ * @return Product matrix.
+ */
+template <class T, Math::SparseFormat F, size_t N, size_t P, class C> Math::DynamicMatrix<T> operator *(const Math::SparseMatrix<T, F>& lhs, const Math::Matrix<N, P, T, C>& rhs);
+
+/*! Transposes a sparse matrix.
+ *
+ * @param m Matrix to transpose.
+ * @return Transposed matrix in the other format.
+ */
+template <class T, Math::SparseFormat F> Math::SparseMatrix<T, F == Math::Csr ? Math::Csc : Math::Csr> operator ~(const Math::SparseMatrix<T, F>& m);
+
+#include "sparse.inl"
@@ -0,0 +1,471 @@
+namespace Math {
+
+   namespace Detail {
+
+      /*! Moves compressed elements from outer to inner order, like turning
+       * Csr storage into Csc. Elements of each output segment are ordered
+       * by their outer index.
+       */
+      template <class T, class A> inline
+      void transpose_compressed(const size_t& outer, const size_t& inner, const size_t* pointers, const size_t* indices, const T* values, std::vector<size_t>& outPointers, std::vector<size_t>& outIndices, std::vector<T, A>& outValues) {
+         const size_t nonzeros = pointers[outer];
+
+         outPointers.assign(inner + 1, 0);
+         outIndices.resize(nonzeros);
+         outValues.resize(nonzeros);
+
+         for (size_t k = 0; k < nonzeros; ++k)
+            ++outPointers[indices[k] + 1];
+
+         for (size_t i = 0; i < inner; ++i)
+            outPointers[i + 1] += outPointers[i];
+
+         std::vector<size_t> next(outPointers.begin(), outPointers.end() - 1);
+
+         for (size_t o = 0; o < outer; ++o) {
+            for (size_t k = pointers[o]; k < pointers[o + 1]; ++k) {
+               const size_t at = next[indices[k]]++;
+               outIndices[at] = o;
+               outValues[at] = values[k];
+            }
+         }
+      }
+
+      /*! Finds the outer indices whose elements start within a range of
+       * nonzeros, so that chunks of nonzeros map to disjoint outer ranges.
+       * The chunk ending at the last nonzero also takes trailing empty
+       * segments.
+       */
+      inline void outer_range(const size_t* pointers, const size_t& outer, const size_t& begin, const size_t& end, size_t& first, size_t& last) {
+         first = std::lower_bound(pointers, pointers + outer, begin) - pointers;
+         last = end == pointers[outer] ? outer : std::lower_bound(pointers, pointers + outer, end) - pointers;
+      }
+
+      /*! Computes y = s x for compressed storage s, where output row o is
+       * the dot product of segment o with each column of x. Runs in
+       * parallel over chunks of nonzeros.
+       */
+      template <class T> inline
+      void sparse_gather(const size_t& outer, const size_t* pointers, const size_t* indices, const T* values, const ConstDynamicMatrixView<T>& x, DynamicMatrixView<T>& y) {
+         const size_t nonzeros = pointers[outer];
+         const size_t p = x.cols();
+         const T* px = x.data();
+         T* py = y.data();
+         const size_t xr = x.row_stride(), xc = x.col_stride();
+         const size_t yr = y.row_stride(), yc = y.col_stride();
+
+         if (nonzeros == 0) {
+            for (size_t c = 0; c < p; ++c) {
+               for (size_t o = 0; o < outer; ++o)
+                  py[o * yr + c * yc] = T();
+            }
+
+            return;
+         }
+
+         parallel_for(0, nonzeros, 2 * p, [=](const size_t& begin, const size_t& end) {
+            size_t first, last;
+            outer_range(pointers, outer, begin, end, first, last);
+
+            for (size_t c = 0; c < p; ++c) {
+               const T* xcol = px + c * xc;
+               T* ycol = py + c * yc;
+
+               for (size_t o = first; o < last; ++o) {
+                  T sum = T();
+
+                  for (size_t k = pointers[o]; k < pointers[o + 1]; ++k)
+                     sum += values[k] * xcol[indices[k] * xr];
+
+                  ycol[o * yr] = sum;
+               }
+            }
+         });
+      }
+
+      /*! Buffer of partial sums kept by every thread for @c sparse_scatter.
+       */
+      template <class T> struct ScatterWorkspace {
+         std::vector<T, AlignedAllocator<T> > buffer;
+         bool busy;
+      };
+
+      /*! Gets the scatter buffer of the calling thread.
+       */
+      template <class T> inline
+      ScatterWorkspace<T>& scatter_workspace() {
+         static thread_local ScatterWorkspace<T> workspace = { std::vector<T, AlignedAllocator<T> >(), false };
+         return workspace;
+      }
+
+      /*! Computes y = s' x for compressed storage s, where segment o is
+       * scaled by row o of x and accumulated into the rows of y named by its
+       * indices. Parallel chunks accumulate into private buffers, which are
+       * summed afterwards.
+       */
+      template <class T> inline
+      void sparse_scatter(const size_t& outer, const size_t& inner, const size_t* pointers, const size_t* indices, const T* values, const ConstDynamicMatrixView<T>& x, DynamicMatrixView<T>& y) {
+         const size_t nonzeros = pointers[outer];
+         const size_t p = x.cols();
+         const T* px = x.data();
+         T* py = y.data();
+         const size_t xr = x.row_stride(), xc = x.col_stride();
+         const size_t yr = y.row_stride(), yc = y.col_stride();
+         const size_t concurrency = ThreadPool::instance().concurrency();
+
+         // Every part sums into an inner by p buffer, so parts are limited to
+         // keep the buffers within the size of the product itself.
+         const size_t parts = std::min(concurrency, std::max(nonzeros / (inner > 0 ? inner : 1), (size_t)1));
+
+         for (size_t c = 0; c < p; ++c) {
+            for (size_t i = 0; i < inner; ++i)
+               py[i * yr + c * yc] = T();
+         }
+
+         if (parts <= 1 || nonzeros * 2 * p < parallel_threshold()) {
+            for (size_t c = 0; c < p; ++c) {
+               for (size_t o = 0; o < outer; ++o) {
+                  const T s = px[o * xr + c * xc];
+
+                  for (size_t k = pointers[o]; k < pointers[o + 1]; ++k)
+                     py[indices[k] * yr + c * yc] += values[k] * s;
+               }
+            }
+
+            return;
+         }
+
+         // Each part covers an equal share of nonzeros and owns an inner by
+         // p buffer, so parts never write to the same elements.
+         // The thread's buffer is reused across calls unless this thread is
+         // already scattering further up the stack, which happens when it
+         // runs other pool tasks while waiting.
+         ScatterWorkspace<T>& workspace = scatter_workspace<T>();
+         std::vector<T, AlignedAllocator<T> > local;
+         std::vector<T, AlignedAllocator<T> >& buffers = workspace.busy ? local : workspace.buffer;
+
+         struct Release {
+            ScatterWorkspace<T>& workspace;
+            const bool busy;
+            ~Release() { workspace.busy = busy; }
+         } release = { workspace, workspace.busy };
+
+         workspace.busy = true;
+         buffers.assign(parts * inner * p, T());
+         T* pb = buffers.data();
+
+         ThreadPool::instance().parallel_for(0, parts, 1, [=](const size_t& begin, const size_t& end) {
+            for (size_t part = begin; part < end; ++part) {
+               T* buffer = pb + part * inner * p;
+               size_t first, last;
+               outer_range(pointers, outer, nonzeros * part / parts, nonzeros * (part + 1) / parts, first, last);
+
+               for (size_t c = 0; c < p; ++c) {
+                  for (size_t o = first; o < last; ++o) {
+                     const T s = px[o * xr + c * xc];
+
+                     for (size_t k = pointers[o]; k < pointers[o + 1]; ++k)
+                        buffer[c * inner + indices[k]] += values[k] * s;
+                  }
+               }
+            }
+         });
+
+         parallel_for(0, inner, parts * p, [=](const size_t& begin, const size_t& end) {
+            for (size_t c = 0; c < p; ++c) {
+               for (size_t i = begin; i < end; ++i) {
+                  T sum = T();
+
+                  for (size_t part = 0; part < parts; ++part)
+                     sum += pb[(part * p + c) * inner + i];
+
+                  py[i * yr + c * yc] = sum;
+               }
+            }
+         });
+      }
+   }
+
+   template <class T> inline
+   SparseBuilder<T>::SparseBuilder(const size_t& rows, const size_t& cols) : _rows(rows), _cols(cols) {
+
+   }
+
+   template <class T> inline
+   size_t SparseBuilder<T>::rows() const {
+      return _rows;
+   }
+
+   template <class T> inline
+   size_t SparseBuilder<T>::cols() const {
+      return _cols;
+   }
+
+   template <class T> inline
+   size_t SparseBuilder<T>::size() const {
+      return _values.size();
+   }
+
+   template <class T> inline
+   void SparseBuilder<T>::reserve(const size_t& size) {
+      _i.reserve(size);
+      _j.reserve(size);
+      _values.reserve(size);
+   }
+
+   template <class T> inline
+   void SparseBuilder<T>::add(const size_t& i, const size_t& j, const T& value) {
+      assert(i > 0 && i <= _rows && j > 0 && j <= _cols);
+
+      _i.push_back(i - 1);
+      _j.push_back(j - 1);
+      _values.push_back(value);
+   }
+
+   template <class T> inline
+   const std::vector<size_t>& SparseBuilder<T>::row_indices() const {
+      return _i;
+   }
+
+   template <class T> inline
+   const std::vector<size_t>& SparseBuilder<T>::col_indices() const {
+      return _j;
+   }
+
+   template <class T> inline
+   const std::vector<T>& SparseBuilder<T>::values() const {
+      return _values;
+   }
+
+   template <class T, SparseFormat F> inline
+   SparseMatrix<T, F>::SparseMatrix() : _rows(0), _cols(0), _pointers(1, 0) {
+
+   }
+
+   template <class T, SparseFormat F> inline
+   SparseMatrix<T, F>::SparseMatrix(const size_t& rows, const size_t& cols) : _rows(rows), _cols(cols), _pointers((F == Csr ? rows : cols) + 1, 0) {
+
+   }
+
+   template <class T, SparseFormat F> inline
+   SparseMatrix<T, F>::SparseMatrix(const SparseBuilder<T>& builder) : _rows(builder.rows()), _cols(builder.cols()) {
+      const size_t outer = F == Csr ? _rows : _cols;
+      const size_t inner = F == Csr ? _cols : _rows;
+      const std::vector<size_t>& outerIndices = F == Csr ? builder.row_indices() : builder.col_indices();
+      const std::vector<size_t>& innerIndices = F == Csr ? builder.col_indices() : builder.row_indices();
+      const size_t count = builder.size();
+
+      // Triplets are sorted by inner index first, and the stable transpose
+      // back to outer order leaves every segment sorted.
+      std::vector<size_t> pointers(inner + 1, 0), indices(count);
+      container values(count);
+
+      for (size_t k = 0; k < count; ++k)
+         ++pointers[innerIndices[k] + 1];
+
+      for (size_t i = 0; i < inner; ++i)
+         pointers[i + 1] += pointers[i];
+
+      std::vector<size_t> next(pointers.begin(), pointers.end() - 1);
+
+      for (size_t k = 0; k < count; ++k) {
+         const size_t at = next[innerIndices[k]]++;
+         indices[at] = outerIndices[k];
+         values[at] = builder.values()[k];
+      }
+
+      Detail::transpose_compressed(inner, outer, pointers.data(), indices.data(), values.data(), _pointers, _indices, _values);
+
+      // Duplicates are now adjacent and are summed in place.
+      size_t at = 0;
+
+      for (size_t o = 0; o < outer; ++o) {
+         const size_t begin = _pointers[o], end = _pointers[o + 1];
+         _pointers[o] = at;
+
+         for (size_t k = begin; k < end; ++k) {
+            if (at > _pointers[o] && _indices[at - 1] == _indices[k])
+               _values[at - 1] += _values[k];
+            else {
+               _indices[at] = _indices[k];
+               _values[at] = _values[k];
+               ++at;
+            }
+         }
+      }
+
+      _pointers[outer] = at;
+      _indices.resize(at);
+      _values.resize(at);
+   }
+
+   template <class T, SparseFormat F>
+   template <SparseFormat G> inline
+   SparseMatrix<T, F>::SparseMatrix(const SparseMatrix<T, G>& other) : _rows(other._rows), _cols(other._cols) {
+      if (F == G) {
+         _pointers = other._pointers;
+         _indices = other._indices;
+         _values = other._values;
+      }
+      else {
+         const size_t outer = G == Csr ? _rows : _cols;
+         const size_t inner = G == Csr ? _cols : _rows;
+         Detail::transpose_compressed(outer, inner, other.pointers(), other.indices(), other.values(), _pointers, _indices, _values);
+      }
+   }
+
+   template <class T, SparseFormat F> inline
+   SparseMatrix<T, F>::SparseMatrix(const ConstDynamicMatrixView<T>& m, const T& tolerance) : _rows(m.rows()), _cols(m.cols()) {
+      const size_t outer = F == Csr ? _rows : _cols;
+      const size_t inner = F == Csr ? _cols : _rows;
+      const size_t os = F == Csr ? m.row_stride() : m.col_stride();
+      const size_t is = F == Csr ? m.col_stride() : m.row_stride();
+      const T* data = m.data();
+
+      _pointers.reserve(outer + 1);
+      _pointers.push_back(0);
+
+      for (size_t o = 0; o < outer; ++o) {
+         for (size_t i = 0; i < inner; ++i) {
+            const T value = data[o * os + i * is];
+
+            if (Abs(value) > tolerance) {
+               _indices.push_back(i);
+               _values.push_back(value);
+            }
+         }
+
+         _pointers.push_back(_indices.size());
+      }
+   }
+
+   template <class T, SparseFormat F>
+   template <size_t M, size_t N, class C> inline
+   SparseMatrix<T, F>::SparseMatrix(const Matrix<M, N, T, C>& m, const T& tolerance) : SparseMatrix(ConstDynamicMatrixView<T>(m.data(), M, N, 1, M), tolerance) {
+
+   }
+
+   template <class T, SparseFormat F> inline
+   size_t SparseMatrix<T, F>::rows() const {
+      return _rows;
+   }
+
+   template <class T, SparseFormat F> inline
+   size_t SparseMatrix<T, F>::cols() const {
+      return _cols;
+   }
+
+   template <class T, SparseFormat F> inline
+   size_t SparseMatrix<T, F>::nonzeros() const {
+      return _values.size();
+   }
+
+   template <class T, SparseFormat F> inline
+   T SparseMatrix<T, F>::operator ()(const size_t& i, const size_t& j) const {
+      assert(i > 0 && i <= _rows && j > 0 && j <= _cols);
+
+      const size_t o = (F == Csr ? i : j) - 1;
+      const size_t n = (F == Csr ? j : i) - 1;
+      const size_t* begin = _indices.data() + _pointers[o];
+      const size_t* end = _indices.data() + _pointers[o + 1];
+      const size_t* at = std::lower_bound(begin, end, n);
+
+      return at != end && *at == n ? _values[at - _indices.data()] : T();
+   }
+
+   template <class T, SparseFormat F> inline
+   const size_t* SparseMatrix<T, F>::pointers() const {
+      return _pointers.data();
+   }
+
+   template <class T, SparseFormat F> inline
+   const size_t* SparseMatrix<T, F>::indices() const {
+      return _indices.data();
+   }
+
+   template <class T, SparseFormat F> inline
+   T* SparseMatrix<T, F>::values() {
+      return _values.data();
+   }
+
+   template <class T, SparseFormat F> inline
+   const T* SparseMatrix<T, F>::values() const {
+      return _values.data();
+   }
+
+   template <class T, SparseFormat F> inline
+   DynamicMatrix<T> SparseMatrix<T, F>::dense() const {
+      DynamicMatrix<T> out(_rows, _cols);
+      const size_t outer = F == Csr ? _rows : _cols;
+
+      for (size_t o = 0; o < outer; ++o) {
+         for (size_t k = _pointers[o]; k < _pointers[o + 1]; ++k) {
+            if (F == Csr)
+               out(o + 1, _indices[k] + 1) = _values[k];
+            else
+               out(_indices[k] + 1, o + 1) = _values[k];
+         }
+      }
+
+      return std::move(out);
+   }
+
+   template <class T, SparseFormat F> inline
+   SparseMatrix<T, F == Csr ? Csc : Csr> transpose(const SparseMatrix<T, F>& m) {
+      SparseMatrix<T, F == Csr ? Csc : Csr> out;
+
+      out._rows = m._cols;
+      out._cols = m._rows;
+      out._pointers = m._pointers;
+      out._indices = m._indices;
+      out._values = m._values;
+
+      return std::move(out);
+   }
+
+   template <class T, SparseFormat F> inline
+   void multiply(const SparseMatrix<T, F>& a, const ConstDynamicMatrixView<typename SparseMatrix<T, F>::type>& x, DynamicMatrixView<typename SparseMatrix<T, F>::type> y) {
+      assert(x.rows() == a.cols() && y.rows() == a.rows() && y.cols() == x.cols());
+
+      if (F == Csr)
+         Detail::sparse_gather(a.rows(), a.pointers(), a.indices(), a.values(), x, y);
+      else
+         Detail::sparse_scatter(a.cols(), a.rows(), a.pointers(), a.indices(), a.values(), x, y);
+   }
+
+   template <class T, SparseFormat F> inline
+   void multiply_transposed(const SparseMatrix<T, F>& a, const ConstDynamicMatrixView<typename SparseMatrix<T, F>::type>& x, DynamicMatrixView<typename SparseMatrix<T, F>::type> y) {
+      assert(x.rows() == a.rows() && y.rows() == a.cols() && y.cols() == x.cols());
+
+      if (F == Csr)
+         Detail::sparse_scatter(a.rows(), a.cols(), a.pointers(), a.indices(), a.values(), x, y);
+      else
+         Detail::sparse_gather(a.cols(), a.pointers(), a.indices(), a.values(), x, y);
+   }
+}
+
+template <class T, Math::SparseFormat F> inline
+Math::DynamicVector<T> operator *(const Math::SparseMatrix<T, F>& lhs, const Math::DynamicVector<T>& rhs) {
+   Math::DynamicVector<T> out(lhs.rows(), false);
+   Math::multiply(lhs, rhs, out);
+   return std::move(out);
+}
+
+template <class T, Math::SparseFormat F> inline
+Math::DynamicMatrix<T> operator *(const Math::SparseMatrix<T, F>& lhs, const Math::DynamicMatrix<T>& rhs) {
+   Math::DynamicMatrix<T> out(lhs.rows(), rhs.cols(), false);
+   Math::multiply(lhs, rhs, out);
+   return std::move(out);
+}
+
+template <class T, Math::SparseFormat F, size_t N, size_t P, class C> inline
+Math::DynamicMatrix<T> operator *(const Math::SparseMatrix<T, F>& lhs, const Math::Matrix<N, P, T, C>& rhs) {
+   Math::DynamicMatrix<T> out(lhs.rows(), P, false);
+   Math::multiply(lhs, Math::ConstDynamicMatrixView<T>(rhs.data(), N, P, 1, N), out);
+   return std::move(out);
+}
+
+template <class T, Math::SparseFormat F> inline
+Math::SparseMatrix<T, F == Math::Csr ? Math::Csc : Math::Csr> operator ~(const Math::SparseMatrix<T, F>& m) {
+   return Math::transpose(m);
+}
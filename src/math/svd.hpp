@@ -0,0 +1,84 @@
+#pragma once
+
+#include "eigen.hpp"
+#include <algorithm>
+
+namespace Math {
+
+   /*! Calculates a singular value decomposition m = u * diag(s) * ~v.
+    * Matrices with at most 8 rows or columns are decomposed by one-sided
+    * Jacobi rotations, larger ones by Householder bidiagonalization and
+    * the implicit shift QR method.
+    *
+    * @param m Subject matrix.
+    * @param u Orthogonal matrix of left singular vectors.
+    * @param s Singular values in descending order.
+    * @param v Orthogonal matrix of right singular vectors.
+    */
+   template <size_t M, size_t N, class T, class C> void svd(const Matrix<M, N, T, C>& m, Matrix<M, M, T>& u, Vector<(M < N ? M : N), T>& s, Matrix<N, N, T>& v);
+
+   /*! Calculates a thin singular value decomposition, keeping only the
+    * min(M, N) singular vectors that multiply singular values.
+    *
+    * @param m Subject matrix.
+    * @param u Left singular vectors in orthonormal columns.
+    * @param s Singular values in descending order.
+    * @param v Right singular vectors in orthonormal columns.
+    */
+   template <size_t M, size_t N, class T, class C> void thinsvd(const Matrix<M, N, T, C>& m, Matrix<M, (M < N ? M : N), T>& u, Vector<(M < N ? M : N), T>& s, Matrix<N, (M < N ? M : N), T>& v);
+
+   /*! Calculates the singular values of a matrix without forming singular
+    * vectors.
+    *
+    * @param m Subject matrix.
+    * @return Singular values in descending order.
+    */
+   template <size_t M, size_t N, class T, class C> Vector<(M < N ? M : N), T> svdvals(const Matrix<M, N, T, C>& m);
+
+   /*! Calculates the K largest singular values and their singular vectors.
+    * For larger matrices the singular values of the bidiagonal form are
+    * found first, and vectors only for the selected ones by inverse
+    * iteration.
+    *
+    * @tparam K Number of singular triplets, at most min(M, N).
+    * @param m Subject matrix.
+    * @param u Left singular vectors in orthonormal columns.
+    * @param s Singular values in descending order.
+    * @param v Right singular vectors in orthonormal columns.
+    */
+   template <size_t K, size_t M, size_t N, class T, class C> void topsvd(const Matrix<M, N, T, C>& m, Matrix<M, K, T>& u, Vector<K, T>& s, Matrix<N, K, T>& v);
+
+   /*! Calculates the Moore-Penrose pseudo-inverse. Singular values up to
+    * max(M, N) * epsilon times the largest one are treated as zero.
+    *
+    * @param m Subject matrix.
+    * @return Pseudo-inverse.
+    */
+   template <size_t M, size_t N, class T, class C> Matrix<N, M, T> pinv(const Matrix<M, N, T, C>& m);
+
+   /*! Calculates the Moore-Penrose pseudo-inverse.
+    *
+    * @param m Subject matrix.
+    * @param tolerance Singular values up to this are treated as zero.
+    * @return Pseudo-inverse.
+    */
+   template <size_t M, size_t N, class T, class C> Matrix<N, M, T> pinv(const Matrix<M, N, T, C>& m, const T& tolerance);
+
+   /*! Tells the numerical rank of a matrix, the number of singular values
+    * above max(M, N) * epsilon times the largest one.
+    *
+    * @param m Subject matrix.
+    * @return Rank.
+    */
+   template <size_t M, size_t N, class T, class C> size_t rank(const Matrix<M, N, T, C>& m);
+
+   /*! Tells the numerical rank of a matrix.
+    *
+    * @param m Subject matrix.
+    * @param tolerance Singular values up to this are treated as zero.
+    * @return Number of singular values above @p tolerance.
+    */
+   template <size_t M, size_t N, class T, class C> size_t rank(const Matrix<M, N, T, C>& m, const T& tolerance);
+}
+
+#include "svd.inl"
@@ -0,0 +1,689 @@
+namespace Math {
+
+   namespace Detail {
+
+      //! Largest number of columns decomposed by one-sided Jacobi rotations.
+      const size_t JacobiSvdLimit = 8;
+
+      /*! Sorts singular values in descending order, permuting the columns
+       * of U and V along when given.
+       */
+      template <class T> inline
+      void sort_svd(const size_t& m, const size_t& n, T* s, T* u, const size_t& ldu, T* v, const size_t& ldv) {
+         for (size_t i = 0; i + 1 < n; ++i) {
+            size_t k = i;
+
+            for (size_t j = i + 1; j < n; ++j) {
+               if (s[j] > s[k])
+                  k = j;
+            }
+
+            if (k == i)
+               continue;
+
+            std::swap(s[i], s[k]);
+
+            if (u)
+               std::swap_ranges(u + i * ldu, u + i * ldu + m, u + k * ldu);
+
+            if (v)
+               std::swap_ranges(v + i * ldv, v + i * ldv + n, v + k * ldv);
+         }
+      }
+
+      /*! Replaces columns k to total - 1 of an m-row matrix with orthonormal
+       * vectors orthogonal to the first k columns, which must be
+       * orthonormal.
+       */
+      template <class T> inline
+      void complete_basis(const size_t& m, const size_t& k, const size_t& total, T* u, const size_t& ldu) {
+         for (size_t j = k; j < total; ++j) {
+            T* x = u + j * ldu;
+
+            // The unit vector with the largest part outside the known
+            // columns is orthogonalized against them.
+            size_t candidate = 0;
+            T best = (T)-1;
+
+            for (size_t i = 0; i < m; ++i) {
+               T length = (T)1;
+
+               for (size_t c = 0; c < j; ++c)
+                  length -= u[c * ldu + i] * u[c * ldu + i];
+
+               if (length > best) {
+                  best = length;
+                  candidate = i;
+               }
+            }
+
+            for (size_t i = 0; i < m; ++i)
+               x[i] = i == candidate ? (T)1 : (T)0;
+
+            for (size_t pass = 0; pass < 2; ++pass) {
+               for (size_t c = 0; c < j; ++c) {
+                  const T* y = u + c * ldu;
+                  T d = (T)0;
+
+                  for (size_t i = 0; i < m; ++i)
+                     d += x[i] * y[i];
+
+                  for (size_t i = 0; i < m; ++i)
+                     x[i] -= d * y[i];
+               }
+            }
+
+            T length = (T)0;
+
+            for (size_t i = 0; i < m; ++i)
+               length += x[i] * x[i];
+
+            length = (T)1 / Sqrt(length);
+
+            for (size_t i = 0; i < m; ++i)
+               x[i] *= length;
+         }
+      }
+
+      /*! Calculates a singular value decomposition by one-sided Jacobi
+       * rotations, which orthogonalize the columns of A. The singular
+       * values are the column lengths afterwards.
+       *
+       * @param m Number of rows, at least @p n.
+       * @param n Number of columns.
+       * @param a Matrix, destroyed.
+       * @param lda Distance between columns of @p a.
+       * @param s Receives the unordered singular values.
+       * @param v Null, or matrix receiving the right singular vectors.
+       * @param ldv Distance between columns of @p v.
+       */
+      template <class T> inline
+      void gesvj(const size_t& m, const size_t& n, T* a, const size_t& lda, T* s, T* v, const size_t& ldv) {
+         const T eps = std::numeric_limits<T>::epsilon();
+
+         if (v) {
+            for (size_t j = 0; j < n; ++j) {
+               for (size_t i = 0; i < n; ++i)
+                  v[j * ldv + i] = i == j ? (T)1 : (T)0;
+            }
+         }
+
+         for (size_t sweep = 0; sweep < 60; ++sweep) {
+            bool rotated = false;
+
+            for (size_t q = 1; q < n; ++q) {
+               for (size_t p = 0; p < q; ++p) {
+                  T* ap = a + p * lda;
+                  T* aq = a + q * lda;
+                  T alpha = (T)0, beta = (T)0, gamma = (T)0;
+
+                  for (size_t i = 0; i < m; ++i) {
+                     alpha += ap[i] * ap[i];
+                     beta += aq[i] * aq[i];
+                     gamma += ap[i] * aq[i];
+                  }
+
+                  if (Abs(gamma) <= eps * Sqrt(alpha * beta))
+                     continue;
+
+                  rotated = true;
+
+                  // The rotation diagonalizes the 2x2 Gram matrix of the
+                  // two columns.
+                  const T zeta = (beta - alpha) / ((T)2 * gamma);
+                  const T t = (zeta >= (T)0 ? (T)1 : (T)-1) / (Abs(zeta) + Sqrt(zeta * zeta + (T)1));
+                  const T c = (T)1 / Sqrt(t * t + (T)1);
+                  const T sn = t * c;
+
+                  for (size_t i = 0; i < m; ++i) {
+                     const T x = ap[i], y = aq[i];
+                     ap[i] = c * x - sn * y;
+                     aq[i] = sn * x + c * y;
+                  }
+
+                  if (v) {
+                     T* vp = v + p * ldv;
+                     T* vq = v + q * ldv;
+
+                     for (size_t i = 0; i < n; ++i) {
+                        const T x = vp[i], y = vq[i];
+                        vp[i] = c * x - sn * y;
+                        vq[i] = sn * x + c * y;
+                     }
+                  }
+               }
+            }
+
+            if (!rotated)
+               break;
+         }
+
+         for (size_t j = 0; j < n; ++j) {
+            T length = (T)0;
+
+            for (size_t i = 0; i < m; ++i)
+               length += a[j * lda + i] * a[j * lda + i];
+
+            s[j] = Sqrt(length);
+         }
+      }
+
+      /*! Reduces a matrix with at least as many rows as columns to upper
+       * bidiagonal form B = ~Q * A * P with Householder reflections from
+       * both sides. The left reflection vectors are stored below the
+       * diagonal, the right ones right of the superdiagonal.
+       *
+       * @param m Number of rows.
+       * @param n Number of columns.
+       * @param a Matrix to reduce.
+       * @param lda Distance between columns of @p a.
+       * @param d Receives the n diagonal elements.
+       * @param e Receives the superdiagonal elements, e[k] being B(k - 1, k)
+       *          and e[0] zero.
+       * @param tauq Receives the n left reflection factors.
+       * @param taup Receives the n right reflection factors.
+       * @param work Work space of m + n elements.
+       */
+      template <class T> inline
+      void gebrd(const size_t& m, const size_t& n, T* a, const size_t& lda, T* d, T* e, T* tauq, T* taup, T* work) {
+         T* row = work;
+         T* w = work + n;
+
+         e[0] = (T)0;
+
+         for (size_t k = 0; k < n; ++k) {
+            householder(m - k, a + k * lda + k, tauq[k]);
+            d[k] = a[k * lda + k];
+            larf(m - k, n - k - 1, a + k * lda + k, tauq[k], a + (k + 1) * lda + k, lda);
+
+            taup[k] = (T)0;
+
+            if (k + 1 >= n)
+               continue;
+
+            // The row right of the diagonal is reflected from the right.
+            const size_t r = n - k - 1;
+
+            for (size_t j = 0; j < r; ++j)
+               row[j] = a[(k + 1 + j) * lda + k];
+
+            householder(r, row, taup[k]);
+            e[k + 1] = row[0];
+
+            for (size_t j = 0; j < r; ++j)
+               a[(k + 1 + j) * lda + k] = row[j];
+
+            if (taup[k] == (T)0)
+               continue;
+
+            // A2 = A2 - tau * (A2 * v) * ~v for the rows below.
+            const size_t h = m - k - 1;
+            T* a2 = a + (k + 1) * lda + k + 1;
+
+            row[0] = (T)1;
+
+            for (size_t i = 0; i < h; ++i)
+               w[i] = (T)0;
+
+            for (size_t j = 0; j < r; ++j) {
+               const T* column = a2 + j * lda;
+
+               for (size_t i = 0; i < h; ++i)
+                  w[i] += column[i] * row[j];
+            }
+
+            for (size_t j = 0; j < r; ++j) {
+               T* column = a2 + j * lda;
+               const T f = taup[k] * row[j];
+
+               for (size_t i = 0; i < h; ++i)
+                  column[i] -= w[i] * f;
+            }
+         }
+      }
+
+      /*! Multiplies an m-row matrix by the left orthogonal matrix of
+       * @c gebrd, Z = Q * Z.
+       */
+      template <class T> inline
+      void ormbr_q(const size_t& m, const size_t& n, const T* a, const size_t& lda, const T* tauq, const size_t& k, T* z, const size_t& ldz) {
+         for (size_t j = n; j-- > 0;)
+            larf(m - j, k, a + j * lda + j, tauq[j], z + j, ldz);
+      }
+
+      /*! Multiplies an n-row matrix by the right orthogonal matrix of
+       * @c gebrd, Z = P * Z.
+       */
+      template <class T> inline
+      void ormbr_p(const size_t& n, const T* a, const size_t& lda, const T* taup, const size_t& k, T* z, const size_t& ldz, T* work) {
+         for (size_t j = n > 1 ? n - 1 : 0; j-- > 0;) {
+            const size_t r = n - j - 1;
+
+            for (size_t i = 1; i < r; ++i)
+               work[i] = a[(j + 1 + i) * lda + j];
+
+            larf(r, k, work, taup[j], z + j + 1, ldz);
+         }
+      }
+
+      /*! Calculates the singular values of an upper bidiagonal matrix by
+       * the implicit shift QR method. The rotations are applied to the
+       * columns of U and V when given.
+       *
+       * @param n Order of the matrix.
+       * @param d Diagonal elements; receive the unordered singular values.
+       * @param e Superdiagonal elements as returned by @c gebrd; destroyed.
+       * @param m Number of rows of U.
+       * @param u Null, or matrix of which the first n columns are rotated.
+       * @param ldu Distance between columns of @p u.
+       * @param v Null, or n-row matrix of which columns are rotated.
+       * @param ldv Distance between columns of @p v.
+       */
+      template <class T> inline
+      void bdsqr(const size_t& n, T* d, T* e, const size_t& m, T* u, const size_t& ldu, T* v, const size_t& ldv) {
+         const auto rotate = [](const size_t& rows, T* x, T* y, const T& c, const T& s) {
+            for (size_t i = 0; i < rows; ++i) {
+               const T a = x[i], b = y[i];
+               x[i] = a * c + b * s;
+               y[i] = b * c - a * s;
+            }
+         };
+
+         T norm = (T)0;
+
+         for (size_t i = 0; i < n; ++i) {
+            const T t = Abs(d[i]) + Abs(e[i]);
+            norm = t > norm ? t : norm;
+         }
+
+         for (size_t k = n; k-- > 0;) {
+            for (size_t iteration = 0; iteration < 75; ++iteration) {
+               bool cancel = true;
+               size_t l = k;
+
+               // Looks for a split, e[0] being zero ends the search.
+               for (;; --l) {
+                  if (Abs(e[l]) + norm == norm) {
+                     cancel = false;
+                     break;
+                  }
+
+                  if (Abs(d[l - 1]) + norm == norm)
+                     break;
+               }
+
+               // A negligible d[l - 1] lets e[l] be chased out of the
+               // matrix by rotations from the left.
+               if (cancel) {
+                  T c = (T)0, s = (T)1;
+
+                  for (size_t i = l; i <= k; ++i) {
+                     const T f = s * e[i];
+                     e[i] *= c;
+
+                     if (Abs(f) + norm == norm)
+                        break;
+
+                     const T g = d[i];
+                     const T h = std::hypot(f, g);
+
+                     d[i] = h;
+                     c = g / h;
+                     s = -f / h;
+
+                     if (u)
+                        rotate(m, u + (l - 1) * ldu, u + i * ldu, c, s);
+                  }
+               }
+
+               T z = d[k];
+
+               if (l == k) {
+                  if (z < (T)0) {
+                     d[k] = -z;
+
+                     for (size_t i = 0; v && i < n; ++i)
+                        v[k * ldv + i] = -v[k * ldv + i];
+                  }
+
+                  break;
+               }
+
+               // The shift is the eigenvalue of the trailing 2x2 block of
+               // ~B * B closer to its last diagonal element.
+               T x = d[l], y = d[k - 1], g = e[k - 1], h = e[k];
+               T f = ((y - z) * (y + z) + (g - h) * (g + h)) / ((T)2 * h * y);
+
+               g = std::hypot(f, (T)1);
+               f = ((x - z) * (x + z) + h * ((y / (f + (f >= (T)0 ? g : -g))) - h)) / x;
+
+               T c = (T)1, s = (T)1;
+
+               for (size_t j = l; j < k; ++j) {
+                  const size_t i = j + 1;
+
+                  g = e[i];
+                  y = d[i];
+                  h = s * g;
+                  g = c * g;
+                  z = std::hypot(f, h);
+                  e[j] = z;
+                  c = f / z;
+                  s = h / z;
+                  f = x * c + g * s;
+                  g = g * c - x * s;
+                  h = y * s;
+                  y *= c;
+
+                  if (v)
+                     rotate(n, v + j * ldv, v + i * ldv, c, s);
+
+                  z = std::hypot(f, h);
+                  d[j] = z;
+
+                  if (z != (T)0) {
+                     c = f / z;
+                     s = h / z;
+                  }
+
+                  f = c * g + s * y;
+                  x = c * y - s * g;
+
+                  if (u)
+                     rotate(m, u + j * ldu, u + i * ldu, c, s);
+               }
+
+               e[l] = (T)0;
+               e[k] = f;
+               d[k] = x;
+            }
+         }
+      }
+
+      /*! Calculates a singular value decomposition of a matrix with at
+       * least as many rows as columns, choosing the method by its size.
+       *
+       * @param m Number of rows.
+       * @param n Number of columns.
+       * @param a Matrix, destroyed.
+       * @param lda Distance between columns of @p a.
+       * @param s Receives the singular values in descending order.
+       * @param u Null, or matrix receiving left singular vectors.
+       * @param ldu Distance between columns of @p u.
+       * @param ucols Number of left singular vectors, n or m.
+       * @param v Null, or matrix receiving right singular vectors.
+       * @param ldv Distance between columns of @p v.
+       * @param work Work space of 4 * n + m elements.
+       */
+      template <class T> inline
+      void gesvd(const size_t& m, const size_t& n, T* a, const size_t& lda, T* s, T* u, const size_t& ldu, const size_t& ucols, T* v, const size_t& ldv, T* work) {
+         if (n <= JacobiSvdLimit) {
+            gesvj(m, n, a, lda, s, v, ldv);
+            sort_svd(m, n, s, u ? a : (T*)nullptr, lda, v, ldv);
+
+            if (!u)
+               return;
+
+            // Columns of negligible length are replaced by a completion of
+            // the basis rather than normalized noise.
+            const T small = (T)m * std::numeric_limits<T>::epsilon() * s[0];
+            size_t r = 0;
+
+            for (; r < n && s[r] > small; ++r) {
+               const T f = (T)1 / s[r];
+
+               for (size_t i = 0; i < m; ++i)
+                  u[r * ldu + i] = a[r * lda + i] * f;
+            }
+
+            complete_basis(m, r, ucols, u, ldu);
+            return;
+         }
+
+         T* e = work;
+         T* tauq = e + n;
+         T* taup = tauq + n;
+         T* w = taup + n;
+
+         gebrd(m, n, a, lda, s, e, tauq, taup, w);
+
+         if (u) {
+            for (size_t j = 0; j < ucols; ++j) {
+               for (size_t i = 0; i < m; ++i)
+                  u[j * ldu + i] = i == j ? (T)1 : (T)0;
+            }
+
+            ormbr_q(m, n, a, lda, tauq, ucols, u, ldu);
+         }
+
+         if (v) {
+            for (size_t j = 0; j < n; ++j) {
+               for (size_t i = 0; i < n; ++i)
+                  v[j * ldv + i] = i == j ? (T)1 : (T)0;
+            }
+
+            ormbr_p(n, a, lda, taup, n, v, ldv, w);
+         }
+
+         bdsqr(n, s, e, m, u, ldu, v, ldv);
+         sort_svd(m, n, s, u, ldu, v, ldv);
+      }
+
+      /*! Calculates the k largest singular triplets of a matrix with at
+       * least as many rows as columns. The singular values of the
+       * bidiagonal form are found first; the vectors of the selected ones
+       * are eigenvectors of the Golub-Kahan tridiagonal matrix, which has
+       * a zero diagonal and d[0], e[1], d[1], ... off the diagonal, and
+       * interleaves the right and left singular vectors.
+       */
+      template <class T> inline
+      void gesvd_top(const size_t& m, const size_t& n, T* a, const size_t& lda, const size_t& k, T* s, T* u, const size_t& ldu, T* v, const size_t& ldv) {
+         std::vector<T> work(m + 24 * n + 2 * n * k);
+         T* d = work.data();
+         T* e = d + n;
+         T* tauq = e + n;
+         T* taup = tauq + n;
+         T* values = taup + n;
+         T* f = values + n;
+         T* zero = f + n;
+         T* off = zero + 2 * n;
+         T* z = off + 2 * n;
+         T* w = z + 2 * n * k;
+
+         gebrd(m, n, a, lda, d, e, tauq, taup, w);
+
+         std::copy(d, d + n, values);
+         std::copy(e, e + n, f);
+         bdsqr(n, values, f, m, (T*)nullptr, 0, (T*)nullptr, 0);
+         sort_svd(m, n, values, (T*)nullptr, 0, (T*)nullptr, 0);
+
+         for (size_t i = 0; i < n; ++i) {
+            zero[2 * i] = zero[2 * i + 1] = (T)0;
+            off[2 * i] = d[i];
+            off[2 * i + 1] = i + 1 < n ? e[i + 1] : (T)0;
+         }
+
+         stein(2 * n, zero, off, k, values, z, 2 * n, w);
+
+         for (size_t j = 0; j < k; ++j) {
+            const T* x = z + j * 2 * n;
+            T* uj = u + j * ldu;
+            T* vj = v + j * ldv;
+            T lu = (T)0, lv = (T)0;
+
+            for (size_t i = 0; i < n; ++i) {
+               vj[i] = x[2 * i];
+               uj[i] = x[2 * i + 1];
+               lv += vj[i] * vj[i];
+               lu += uj[i] * uj[i];
+            }
+
+            lu = lu > (T)0 ? (T)1 / Sqrt(lu) : (T)0;
+            lv = lv > (T)0 ? (T)1 / Sqrt(lv) : (T)0;
+
+            for (size_t i = 0; i < n; ++i) {
+               uj[i] *= lu;
+               vj[i] *= lv;
+            }
+
+            for (size_t i = n; i < m; ++i)
+               uj[i] = (T)0;
+
+            s[j] = values[j];
+         }
+
+         ormbr_q(m, n, a, lda, tauq, k, u, ldu);
+         ormbr_p(n, a, lda, taup, k, v, ldv, w);
+      }
+
+      /*! Tells the default tolerance of singular values treated as zero.
+       */
+      template <size_t M, size_t N, class T> inline
+      T svd_tolerance(const T& largest) {
+         return (T)(M > N ? M : N) * std::numeric_limits<T>::epsilon() * largest;
+      }
+
+      /*! Counts the singular values above a tolerance.
+       */
+      template <class T> inline
+      size_t count_above(const size_t& k, const T* s, const T& tolerance) {
+         size_t r = 0;
+
+         for (size_t j = 0; j < k; ++j) {
+            if (s[j] > tolerance)
+               ++r;
+         }
+
+         return r;
+      }
+
+      /*! Computes the pseudo-inverse from the thin SVD, treating singular
+       * values up to max(tolerance, relative * largest) as zero.
+       */
+      template <size_t M, size_t N, class T, class C> inline
+      Matrix<N, M, T> pinv(const Matrix<M, N, T, C>& m, const T& tolerance, const T& relative) {
+         const size_t K = M < N ? M : N;
+         Matrix<M, K, T> u(false);
+         Vector<K, T> s(false);
+         Matrix<N, K, T> v(false);
+
+         thinsvd(m, u, s, v);
+
+         const T limit = std::max(tolerance, relative * s[1]);
+
+         for (size_t j = 1; j <= K; ++j) {
+            const T f = s[j] > limit ? (T)1 / s[j] : (T)0;
+
+            for (size_t i = 1; i <= N; ++i)
+               v(i, j) *= f;
+         }
+
+         return Matrix<N, M, T>(v * ~u);
+      }
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   void svd(const Matrix<M, N, T, C>& m, Matrix<M, M, T>& u, Vector<(M < N ? M : N), T>& s, Matrix<N, N, T>& v) {
+      const size_t K = M < N ? M : N;
+      T work[4 * K + (M < N ? N : M)];
+
+      if (M >= N) {
+         Matrix<M, N, T> a(m);
+         Detail::gesvd(M, N, a.data(), M, s.data(), u.data(), M, M, v.data(), N, work);
+      }
+      else {
+         Matrix<N, M, T> a(~m);
+         Detail::gesvd(N, M, a.data(), N, s.data(), v.data(), N, N, u.data(), M, work);
+      }
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   void thinsvd(const Matrix<M, N, T, C>& m, Matrix<M, (M < N ? M : N), T>& u, Vector<(M < N ? M : N), T>& s, Matrix<N, (M < N ? M : N), T>& v) {
+      const size_t K = M < N ? M : N;
+      T work[4 * K + (M < N ? N : M)];
+
+      if (M >= N) {
+         Matrix<M, N, T> a(m);
+         Detail::gesvd(M, N, a.data(), M, s.data(), u.data(), M, K, v.data(), N, work);
+      }
+      else {
+         Matrix<N, M, T> a(~m);
+         Detail::gesvd(N, M, a.data(), N, s.data(), v.data(), N, K, u.data(), M, work);
+      }
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   Vector<(M < N ? M : N), T> svdvals(const Matrix<M, N, T, C>& m) {
+      const size_t K = M < N ? M : N;
+      Vector<K, T> s(false);
+      T work[4 * K + (M < N ? N : M)];
+
+      if (M >= N) {
+         Matrix<M, N, T> a(m);
+         Detail::gesvd(M, N, a.data(), M, s.data(), (T*)nullptr, M, K, (T*)nullptr, N, work);
+      }
+      else {
+         Matrix<N, M, T> a(~m);
+         Detail::gesvd(N, M, a.data(), N, s.data(), (T*)nullptr, N, K, (T*)nullptr, M, work);
+      }
+
+      return std::move(s);
+   }
+
+   template <size_t K, size_t M, size_t N, class T, class C> inline
+   void topsvd(const Matrix<M, N, T, C>& m, Matrix<M, K, T>& u, Vector<K, T>& s, Matrix<N, K, T>& v) {
+      const size_t L = M < N ? M : N;
+      static_assert(K >= 1 && K <= L, "Number of singular triplets must be between 1 and min(M, N)");
+
+      if (L <= Detail::JacobiSvdLimit || K == L) {
+         Matrix<M, L, T> tu(false);
+         Vector<L, T> ts(false);
+         Matrix<N, L, T> tv(false);
+
+         thinsvd(m, tu, ts, tv);
+
+         for (size_t j = 1; j <= K; ++j) {
+            s[j] = ts[j];
+
+            for (size_t i = 1; i <= M; ++i)
+               u(i, j) = tu(i, j);
+
+            for (size_t i = 1; i <= N; ++i)
+               v(i, j) = tv(i, j);
+         }
+
+         return;
+      }
+
+      if (M >= N) {
+         Matrix<M, N, T> a(m);
+         Detail::gesvd_top(M, N, a.data(), M, K, s.data(), u.data(), M, v.data(), N);
+      }
+      else {
+         Matrix<N, M, T> a(~m);
+         Detail::gesvd_top(N, M, a.data(), N, K, s.data(), v.data(), N, u.data(), M);
+      }
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   Matrix<N, M, T> pinv(const Matrix<M, N, T, C>& m) {
+      return Detail::pinv(m, (T)0, Detail::svd_tolerance<M, N>((T)1));
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   Matrix<N, M, T> pinv(const Matrix<M, N, T, C>& m, const T& tolerance) {
+      return Detail::pinv(m, tolerance, (T)0);
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   size_t rank(const Matrix<M, N, T, C>& m) {
+      const auto s = svdvals(m);
+      return Detail::count_above(M < N ? M : N, s.data(), Detail::svd_tolerance<M, N>(s[1]));
+   }
+
+   template <size_t M, size_t N, class T, class C> inline
+   size_t rank(const Matrix<M, N, T, C>& m, const T& tolerance) {
+      const auto s = svdvals(m);
+      return Detail::count_above(M < N ? M : N, s.data(), tolerance);
+   }
+}
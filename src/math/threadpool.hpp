@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+namespace Math {
+
+   class TaskGroup;
+
+   /*! Work-stealing thread pool used to split large matrix operations
+    * across cores. Every worker owns a task queue; workers take their own
+    * newest tasks first and steal the oldest tasks of other workers when
+    * they run out of work. Threads waiting for a task group run queued
+    * tasks meanwhile, so operations can be nested.
+    */
+   class ThreadPool {
+   public:
+
+      /*! Constructs a thread pool.
+       *
+       * @param concurrency Number of threads running tasks, including the
+       *                    thread waiting for them.
+       */
+      explicit ThreadPool(const size_t& concurrency);
+
+      /*! Waits for the workers to finish and stops them.
+       */
+      ~ThreadPool();
+
+      /*! Gets the pool used by the library. By default it runs as many
+       * threads as there are hardware threads, or the number given in the
+       * @c MATH_NUM_THREADS environment variable.
+       *
+       * @return The shared thread pool.
+       */
+      static ThreadPool& instance();
+
+      /*! Tells the number of threads running tasks, including the thread
+       * waiting for them.
+       *
+       * @return Number of threads.
+       */
+      size_t concurrency() const;
+
+      /*! Changes the number of threads. Must not be called while tasks are
+       * running.
+       *
+       * @param concurrency Number of threads running tasks, including the
+       *                    thread waiting for them. 1 runs all tasks inline.
+       */
+      void set_concurrency(const size_t& concurrency);
+
+      /*! Splits a range into chunks and runs them in parallel. Returns when
+       * all chunks are done, then rethrows the first exception thrown by a
+       * chunk.
+       *
+       * @param begin Range begin.
+       * @param end Range end.
+       * @param grain Minimum chunk size.
+       * @param f Function called with the begin and end of each chunk.
+       */
+      template <class F> void parallel_for(const size_t& begin, const size_t& end, const size_t& grain, const F& f);
+
+   private:
+      friend class TaskGroup;
+
+      struct Task {
+         std::function<void()> function;
+         TaskGroup* group;
+      };
+
+      struct Worker {
+         std::mutex mutex;
+         std::deque<Task> tasks;
+         std::thread thread;
+      };
+
+      ThreadPool(const ThreadPool&);
+      ThreadPool& operator =(const ThreadPool&);
+
+      void start(const size_t& concurrency);
+      void stop();
+      void push(Task task);
+      bool pop(const size_t& index, Task& task);
+      bool run_one();
+      void run(const size_t& index);
+      static void execute(Task& task);
+      static size_t& current_index();
+      static ThreadPool*& current_pool();
+
+      std::vector<Worker*> _workers;
+      std::mutex _mutex;
+      std::condition_variable _wake;
+      std::atomic<size_t> _queued;
+      std::atomic<size_t> _next;
+      bool _stop;
+   };
+
+   /*! A group of tasks run by a thread pool that can be waited for.
+    */
+   class TaskGroup {
+   public:
+
+      /*! Constructs a task group.
+       *
+       * @param pool Pool running the tasks.
+       */
+      explicit TaskGroup(ThreadPool& pool = ThreadPool::instance());
+
+      /*! Waits for all tasks of the group. Exceptions thrown by the tasks
+       * are dropped.
+       */
+      ~TaskGroup();
+
+      /*! Queues a task. Runs it immediately if the pool has no workers.
+       *
+       * @param f Task function.
+       */
+      template <class F> void run(const F& f);
+
+      /*! Waits for all queued tasks, running queued tasks of the pool
+       * meanwhile, then rethrows the first exception thrown by a task.
+       */
+      void wait();
+
+   private:
+      friend class ThreadPool;
+
+      TaskGroup(const TaskGroup&);
+      TaskGroup& operator =(const TaskGroup&);
+
+      void join();
+      void fail(const std::exception_ptr& error);
+
+      ThreadPool& _pool;
+      std::atomic<size_t> _pending;
+      std::mutex _mutex;
+      std::exception_ptr _error;
+   };
+
+   /*! Gets the amount of work, in element operations, above which heap
+    * allocated matrix operations are split across threads.
+    *
+    * @return Current threshold.
+    */
+   size_t parallel_threshold();
+
+   /*! Sets the amount of work, in element operations, above which heap
+    * allocated matrix operations are split across threads.
+    *
+    * @param threshold New threshold.
+    */
+   void set_parallel_threshold(const size_t& threshold);
+
+   /*! Runs a function over a range in parallel on the shared pool when the
+    * amount of work reaches @c parallel_threshold, otherwise inline.
+    *
+    * @param begin Range begin.
+    * @param end Range end.
+    * @param work Amount of work per range element, in element operations.
+    * @param f Function called with the begin and end of each chunk. The
+    *          first exception it throws is rethrown once all chunks are done.
+    */
+   template <class F> void parallel_for(const size_t& begin, const size_t& end, const size_t& work, const F& f);
+}
+
+#include "threadpool.inl"
@@ -0,0 +1,284 @@
+#include <cstdlib>
+
+namespace Math {
+
+   inline ThreadPool::ThreadPool(const size_t& concurrency) : _queued(0), _next(0), _stop(false) {
+      start(concurrency);
+   }
+
+   inline ThreadPool::~ThreadPool() {
+      stop();
+   }
+
+   inline ThreadPool& ThreadPool::instance() {
+      static ThreadPool pool([]() -> size_t {
+         const char* env = std::getenv("MATH_NUM_THREADS");
+
+         if (env && std::atoi(env) > 0)
+            return (size_t)std::atoi(env);
+
+         const size_t hardware = std::thread::hardware_concurrency();
+         return hardware > 0 ? hardware : 1;
+      }());
+
+      return pool;
+   }
+
+   inline size_t ThreadPool::concurrency() const {
+      return _workers.size() + 1;
+   }
+
+   inline void ThreadPool::set_concurrency(const size_t& concurrency) {
+      stop();
+      start(concurrency);
+   }
+
+   template <class F> inline
+   void ThreadPool::parallel_for(const size_t& begin, const size_t& end, const size_t& grain, const F& f) {
+      if (end <= begin)
+         return;
+
+      const size_t n = end - begin;
+      const size_t g = grain > 0 ? grain : 1;
+
+      // A few chunks per thread balance uneven progress of the threads.
+      size_t chunks = (n + g - 1) / g;
+
+      if (chunks > 4 * concurrency())
+         chunks = 4 * concurrency();
+
+      if (chunks <= 1 || _workers.empty()) {
+         f(begin, end);
+         return;
+      }
+
+      const size_t size = n / chunks, rest = n % chunks;
+      TaskGroup group(*this);
+      size_t first = begin;
+
+      for (size_t i = 0; i < chunks; ++i) {
+         const size_t last = first + size + (i < rest ? 1 : 0);
+
+         if (i > 0)
+            group.run([&f, first, last]() { f(first, last); });
+
+         first = last;
+      }
+
+      f(begin, begin + size + (rest > 0 ? 1 : 0));
+      group.wait();
+   }
+
+   inline void ThreadPool::start(const size_t& concurrency) {
+      _stop = false;
+
+      for (size_t i = 1; i < concurrency; ++i)
+         _workers.push_back(new Worker());
+
+      for (size_t i = 0; i < _workers.size(); ++i)
+         _workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+   }
+
+   inline void ThreadPool::stop() {
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _stop = true;
+      }
+
+      _wake.notify_all();
+
+      for (size_t i = 0; i < _workers.size(); ++i) {
+         _workers[i]->thread.join();
+         delete _workers[i];
+      }
+
+      _workers.clear();
+   }
+
+   inline void ThreadPool::push(Task task) {
+      const size_t index = current_pool() == this ? current_index() : _next++ % _workers.size();
+
+      {
+         std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+         _workers[index]->tasks.push_back(std::move(task));
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         ++_queued;
+      }
+
+      _wake.notify_one();
+   }
+
+   inline bool ThreadPool::pop(const size_t& index, Task& task) {
+      const size_t n = _workers.size();
+
+      // Take the newest own task, which is most likely still in cache.
+      if (index < n) {
+         std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+
+         if (!_workers[index]->tasks.empty()) {
+            task = std::move(_workers[index]->tasks.back());
+            _workers[index]->tasks.pop_back();
+            --_queued;
+            return true;
+         }
+      }
+
+      // Steal the oldest task of another worker.
+      for (size_t i = 1; i <= n; ++i) {
+         Worker& victim = *_workers[(index + i) % n];
+         std::lock_guard<std::mutex> lock(victim.mutex);
+
+         if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --_queued;
+            return true;
+         }
+      }
+
+      return false;
+   }
+
+   inline bool ThreadPool::run_one() {
+      Task task;
+
+      if (_queued == 0 || !pop(current_pool() == this ? current_index() : _workers.size(), task))
+         return false;
+
+      execute(task);
+      return true;
+   }
+
+   inline void ThreadPool::run(const size_t& index) {
+      current_pool() = this;
+      current_index() = index;
+
+      for (;;) {
+         Task task;
+
+         if (pop(index, task)) {
+            execute(task);
+            continue;
+         }
+
+         std::unique_lock<std::mutex> lock(_mutex);
+         _wake.wait(lock, [this]() { return _stop || _queued > 0; });
+
+         if (_stop && _queued == 0)
+            return;
+      }
+   }
+
+   inline void ThreadPool::execute(Task& task) {
+      // The group is done with the task even if it throws, otherwise its
+      // waiting thread would spin forever.
+      struct Done {
+         TaskGroup* group;
+         ~Done() { --group->_pending; }
+      } done = { task.group };
+
+      try {
+         task.function();
+      }
+      catch (...) {
+         task.group->fail(std::current_exception());
+      }
+   }
+
+   inline size_t& ThreadPool::current_index() {
+      static thread_local size_t index = 0;
+      return index;
+   }
+
+   inline ThreadPool*& ThreadPool::current_pool() {
+      static thread_local ThreadPool* pool = nullptr;
+      return pool;
+   }
+
+
+   inline TaskGroup::TaskGroup(ThreadPool& pool) : _pool(pool), _pending(0) {
+
+   }
+
+   inline TaskGroup::~TaskGroup() {
+      join();
+   }
+
+   template <class F> inline
+   void TaskGroup::run(const F& f) {
+      if (_pool._workers.empty()) {
+         f();
+         return;
+      }
+
+      ++_pending;
+
+      ThreadPool::Task task;
+      task.function = f;
+      task.group = this;
+      _pool.push(std::move(task));
+   }
+
+   inline void TaskGroup::wait() {
+      join();
+
+      std::exception_ptr error;
+
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         std::swap(error, _error);
+      }
+
+      if (error)
+         std::rethrow_exception(error);
+   }
+
+   inline void TaskGroup::join() {
+      while (_pending > 0) {
+         if (!_pool.run_one())
+            std::this_thread::yield();
+      }
+   }
+
+   inline void TaskGroup::fail(const std::exception_ptr& error) {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      if (!_error)
+         _error = error;
+   }
+
+
+   namespace Detail {
+
+      inline std::atomic<size_t>& parallel_threshold() {
+         static std::atomic<size_t> threshold(1 << 18);
+         return threshold;
+      }
+   }
+
+   inline size_t parallel_threshold() {
+      return Detail::parallel_threshold();
+   }
+
+   inline void set_parallel_threshold(const size_t& threshold) {
+      Detail::parallel_threshold() = threshold;
+   }
+
+   template <class F> inline
+   void parallel_for(const size_t& begin, const size_t& end, const size_t& work, const F& f) {
+      const size_t threshold = parallel_threshold();
+      const size_t w = work > 0 ? work : 1;
+
+      if (end <= begin || (end - begin) * w < threshold) {
+         f(begin, end);
+         return;
+      }
+
+      // Chunks carry at least a fraction of the threshold worth of work, so
+      // that scheduling costs stay small compared to the work itself.
+      ThreadPool::instance().parallel_for(begin, end, (threshold / 8 + w - 1) / w, f);
+   }
+}
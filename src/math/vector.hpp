@@ -23,6 +23,18 @@ namespace Math {
        * @param other Matrix to convert.
        */
       Vector(const Matrix<N, 1, T>& other) : Matrix<N, 1, T>(other) {};
+
+      /*! Converts a matrix to vector, taking over its storage.
+       *
+       * @param other Matrix to convert.
+       */
+      Vector(Matrix<N, 1, T>&& other) : Matrix<N, 1, T>(std::move(other)) {};
+
+      /*! Converts a matrix expression to vector.
+       *
+       * @param other Expression to evaluate.
+       */
+      template <class E> Vector(const MatrixExpression<E>& other, typename std::enable_if<E::Rows == N && E::Cols == 1>::type* = nullptr) : Matrix<N, 1, T>(other) {};
    };
 
    /*! Specialized four dimensional vector.
@@ -52,6 +64,12 @@ namespace Math {
        */
       Vector(const Matrix<4, 1, T>& other);
 
+      /*! Converts a matrix expression to vector.
+       *
+       * @param other Expression to evaluate.
+       */
+      template <class E> Vector(const MatrixExpression<E>& other, typename std::enable_if<E::Rows == 4 && E::Cols == 1>::type* = nullptr);
+
       /*! Converts a 3-dimensional vector to 4-dimensional one.
        *
        * @param other Vector to convert.
@@ -133,6 +151,12 @@ namespace Math {
        */
       Vector(const Matrix<3, 1, T>& other);
 
+      /*! Converts a matrix expression to vector.
+       *
+       * @param other Expression to evaluate.
+       */
+      template <class E> Vector(const MatrixExpression<E>& other, typename std::enable_if<E::Rows == 3 && E::Cols == 1>::type* = nullptr);
+
       /*! Converts a 4-dimensional vector to 3-dimensional one.
        *
        * @param other Vector to convert.
@@ -201,6 +225,12 @@ namespace Math {
        */
       Vector(const Matrix<2, 1, T>& other);
 
+      /*! Converts a matrix expression to vector.
+       *
+       * @param other Expression to evaluate.
+       */
+      template <class E> Vector(const MatrixExpression<E>& other, typename std::enable_if<E::Rows == 2 && E::Cols == 1>::type* = nullptr);
+
       /*! Converts a 3-dimensional vector to 2-dimensional one.
        *
        * @param other Vector to convert.
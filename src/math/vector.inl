@@ -21,6 +21,12 @@ namespace Math {
 
    }
 
+   template <class T>
+   template <class E> inline
+   Vector<4, T>::Vector(const MatrixExpression<E>& other, typename std::enable_if<E::Rows == 4 && E::Cols == 1>::type*) : Matrix<4, 1, T>(other) {
+
+   }
+
    template <class T> inline
    Vector<4, T>::Vector(const Vector<3, T>& other, const T& w)
       : Matrix<4, 1, T>(false)
@@ -91,6 +97,12 @@ namespace Math {
 
    }
 
+   template <class T>
+   template <class E> inline
+   Vector<3, T>::Vector(const MatrixExpression<E>& other, typename std::enable_if<E::Rows == 3 && E::Cols == 1>::type*) : Matrix<3, 1, T>(other) {
+
+   }
+
    template <class T> inline
    Vector<3, T>::Vector(const Vector<4, T>& other) : Matrix<3, 1, T>(false) {
       this->x() = other.x();
@@ -145,6 +157,12 @@ namespace Math {
 
    }
 
+   template <class T>
+   template <class E> inline
+   Vector<2, T>::Vector(const MatrixExpression<E>& other, typename std::enable_if<E::Rows == 2 && E::Cols == 1>::type*) : Matrix<2, 1, T>(other) {
+
+   }
+
    template <class T> inline
    Vector<2, T>::Vector(const Vector<3, T>& other) : Matrix<2, 1, T>(false) {
       this->x() = other.x();
@@ -191,7 +209,7 @@ namespace Math {
 
 template <size_t N, class T> inline
 T operator *(const Math::Vector<N, T>& lhs, const Math::Vector<N, T>& rhs) {
-   return ~lhs * rhs;
+   return Math::Detail::dot(N, lhs.data(), rhs.data());
 }
 
 template <class T> inline